@@ -0,0 +1,156 @@
+#ifndef BRA_BYTECODE_HPP
+# define BRA_BYTECODE_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <cstring>
+# include <vector>
+# include <string>
+# include <memory>
+# include <stdexcept>
+
+# include <ket/qubit.hpp>
+# include <ket/control.hpp>
+
+# include <bra/types.hpp>
+# include <bra/state.hpp>
+# include <bra/utility/binary_io.hpp>
+
+// memory-mapped I/O is used to load bytecode files on POSIX systems
+# if !defined(BRA_NO_MMAP) && !(defined(__unix__) || defined(__APPLE__))
+#   define BRA_NO_MMAP
+# endif
+
+
+namespace bra
+{
+  namespace gate
+  {
+    class gate;
+  } // namespace gate
+
+  class wrong_bytecode_file_error
+    : public std::runtime_error
+  {
+   public:
+    wrong_bytecode_file_error(std::string const& filename, std::string const& reason);
+  }; // class wrong_bytecode_file_error
+
+  struct bytecode_t { }; // struct bytecode_t
+  constexpr bytecode_t bytecode{};
+
+  // Only frequently used gates without variables have their opcodes, and the others are applied by their gate objects
+  enum class opcode : std::uint8_t
+  {
+    gate, hadamard, not_, pauli_x, pauli_y, pauli_z, s_gate, adj_s_gate, t_gate, adj_t_gate, u1, adj_u1,
+    controlled_not, controlled_pauli_z, swap, controlled_u1, adj_controlled_u1, exponential_pauli_z, adj_exponential_pauli_z
+  }; // enum class opcode
+
+  // Instructions are stored in contiguous arrays and written into bytecode files as they are, so this should be trivially copyable.
+  // The i-th instruction of a circuit corresponds to the i-th gate of the circuit
+  struct instruction
+  {
+    ::bra::opcode opcode;
+    bool is_diagonal;
+    ::bra::bit_integer_type qubits[2u]; // in the same order as operands of the mnemonic, e.g. the control qubit and the target qubit of CNOT
+    ::bra::real_type phase;
+  }; // struct instruction
+
+  namespace bytecode_detail
+  {
+    inline auto qubit(::bra::instruction const& instruction, std::size_t const index) -> ::bra::qubit_type
+    { return ket::make_qubit< ::bra::state_integer_type >(instruction.qubits[index]); }
+
+    inline auto control(::bra::instruction const& instruction, std::size_t const index) -> ::bra::control_qubit_type
+    { return ket::make_control(qubit(instruction, index)); }
+  } // namespace bytecode_detail
+
+  // instruction.opcode should not be opcode::gate
+  inline auto execute(::bra::state& state, ::bra::instruction const& instruction) -> ::bra::state&
+  {
+    using ::bra::bytecode_detail::qubit;
+    using ::bra::bytecode_detail::control;
+    switch (instruction.opcode)
+    {
+     case ::bra::opcode::hadamard: return state.hadamard(qubit(instruction, 0u));
+     case ::bra::opcode::not_: return state.not_(qubit(instruction, 0u));
+     case ::bra::opcode::pauli_x: return state.pauli_x(qubit(instruction, 0u));
+     case ::bra::opcode::pauli_y: return state.pauli_y(qubit(instruction, 0u));
+     case ::bra::opcode::pauli_z: return state.pauli_z(control(instruction, 0u));
+     case ::bra::opcode::s_gate: return state.sqrt_pauli_z(control(instruction, 0u));
+     case ::bra::opcode::adj_s_gate: return state.adj_sqrt_pauli_z(control(instruction, 0u));
+     case ::bra::opcode::t_gate: return state.phase_shift(3, control(instruction, 0u));
+     case ::bra::opcode::adj_t_gate: return state.adj_phase_shift(3, control(instruction, 0u));
+     case ::bra::opcode::u1: return state.u1(instruction.phase, control(instruction, 0u));
+     case ::bra::opcode::adj_u1: return state.adj_u1(instruction.phase, control(instruction, 0u));
+     case ::bra::opcode::controlled_not: return state.controlled_not(qubit(instruction, 1u), control(instruction, 0u));
+     case ::bra::opcode::controlled_pauli_z: return state.controlled_pauli_z(control(instruction, 0u), control(instruction, 1u));
+     case ::bra::opcode::swap: return state.swap(qubit(instruction, 0u), qubit(instruction, 1u));
+     case ::bra::opcode::controlled_u1: return state.controlled_u1(instruction.phase, control(instruction, 0u), control(instruction, 1u));
+     case ::bra::opcode::adj_controlled_u1: return state.adj_controlled_u1(instruction.phase, control(instruction, 0u), control(instruction, 1u));
+     case ::bra::opcode::exponential_pauli_z: return state.exponential_pauli_z(instruction.phase, qubit(instruction, 0u));
+     case ::bra::opcode::adj_exponential_pauli_z: return state.adj_exponential_pauli_z(instruction.phase, qubit(instruction, 0u));
+     case ::bra::opcode::gate: break;
+    }
+
+    return state;
+  }
+
+  // the number of qubits in instruction.qubits
+  auto num_operated_qubits(::bra::opcode const opcode) -> std::size_t;
+  // generates the gate corresponding to the instruction, whose opcode should not be opcode::gate
+  auto make_gate(::bra::instruction const& instruction) -> std::unique_ptr< ::bra::gate::gate >;
+
+  // Read-only view of a whole file, which is mapped into memory if possible
+  class mapped_file
+  {
+    char const* data_;
+    std::size_t size_;
+# ifdef BRA_NO_MMAP
+    std::string buffer_;
+# endif // BRA_NO_MMAP
+
+   public:
+    explicit mapped_file(std::string const& filename);
+    ~mapped_file();
+    mapped_file(mapped_file const&) = delete;
+    mapped_file& operator=(mapped_file const&) = delete;
+
+    auto data() const -> char const* { return data_; }
+    auto size() const -> std::size_t { return size_; }
+  }; // class mapped_file
+
+  namespace bytecode_detail
+  {
+    // A bytecode file consists of the magic number, the version, sizes of types, and the data written by ::bra::interpreter::save_bytecode.
+    // All values are stored in the native byte order
+    constexpr char magic[8u] = {'B', 'R', 'A', 'C', 'O', 'D', 'E', '\0'};
+    constexpr std::uint64_t version = 1u;
+
+    using ::bra::utility::binary_io::write;
+    using ::bra::utility::binary_io::write_string;
+    using ::bra::utility::binary_io::write_array;
+
+    auto header_bytes() -> std::string;
+
+    using reader = ::bra::utility::binary_io::reader< ::bra::wrong_bytecode_file_error >;
+
+    // bool has no valid values other than false and true, so flags read from files are checked as bytes before they are used
+    inline auto has_valid_flags(::bra::instruction const& instruction) -> bool
+    {
+      static_assert(sizeof(bool) == 1u, "bool should be one byte");
+      auto is_diagonal_byte = static_cast<unsigned char>(0u);
+      std::memcpy(std::addressof(is_diagonal_byte), std::addressof(instruction.is_diagonal), sizeof(bool));
+      return is_diagonal_byte <= 1u;
+    }
+
+    // throws wrong_bytecode_file_error if the header is not written by header_bytes() in the same environment
+    auto read_header(::bra::bytecode_detail::reader& bytecode_reader, std::string const& filename) -> void;
+  } // namespace bytecode_detail
+
+  // returns true if the file starts with the magic number of bytecode files
+  auto is_bytecode_file(std::string const& filename) -> bool;
+} // namespace bra
+
+
+#endif // BRA_BYTECODE_HPP
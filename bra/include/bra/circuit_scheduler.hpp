@@ -0,0 +1,67 @@
+#ifndef BRA_CIRCUIT_SCHEDULER_HPP
+# define BRA_CIRCUIT_SCHEDULER_HPP
+
+# ifdef BRA_NO_MPI
+#   include <cstdint>
+#   include <vector>
+#   include <atomic>
+#   include <thread>
+#   include <mutex>
+#   include <condition_variable>
+#   include <functional>
+#   include <exception>
+
+
+namespace bra
+{
+  // Runs independent tasks, e.g. applications of circuits until they wait for each other, on groups of threads.
+  // Each group has its leading thread (the calling thread of run() leads the 0th group) which takes tasks one by one,
+  // and loops in the tasks are parallelized by the workers of the group, so that tasks are run in parallel and each of them is also parallelized.
+  // With OpenMP, every leader (including the calling thread of the constructor) sets its number of threads to num_threads_per_group.
+  // Without OpenMP, the workers of a group are its own ket::utility::scoped_thread_pool, and threads of the i-th group are pinned to
+  // CPUs from i * num_threads_per_group if KET_PIN_POOL_THREADS is defined
+  class circuit_scheduler
+  {
+    int num_groups_;
+    unsigned int num_threads_per_group_;
+    std::vector<std::thread> leaders_; // of groups other than the 0th
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::condition_variable finished_condition_;
+    std::uint64_t generation_;
+    bool is_stopping_;
+    int num_running_leaders_;
+
+    std::function<void(int)> const* task_ptr_;
+    int num_tasks_;
+    std::atomic<int> next_task_index_;
+    std::exception_ptr exception_;
+
+   public:
+    circuit_scheduler(int const num_groups, unsigned int const num_threads_per_group);
+    ~circuit_scheduler();
+
+    circuit_scheduler(circuit_scheduler const&) = delete;
+    circuit_scheduler& operator=(circuit_scheduler const&) = delete;
+    circuit_scheduler(circuit_scheduler&&) = delete;
+    circuit_scheduler& operator=(circuit_scheduler&&) = delete;
+
+    auto num_groups() const -> int { return num_groups_; }
+
+    // Calls task(task_index) for each task_index in [0, num_tasks) and returns after all calls, where tasks are taken in increasing order.
+    // If there is only one group, tasks are called one after another by the calling thread.
+    // The first exception thrown by task is rethrown after all calls
+    auto run(int const num_tasks, std::function<void(int)> const& task) -> void;
+
+   private:
+    auto run_tasks() -> void;
+    auto use_threads_of_group() const -> void;
+    auto lead(int const group_index) -> void;
+  }; // class circuit_scheduler
+} // namespace bra
+
+
+# endif // BRA_NO_MPI
+
+#endif // BRA_CIRCUIT_SCHEDULER_HPP
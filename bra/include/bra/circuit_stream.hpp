@@ -0,0 +1,85 @@
+#ifndef BRA_CIRCUIT_STREAM_HPP
+# define BRA_CIRCUIT_STREAM_HPP
+
+# include <cstddef>
+# include <vector>
+# include <deque>
+# include <string>
+# include <fstream>
+# include <ios>
+# include <memory>
+# include <mutex>
+# include <condition_variable>
+# include <thread>
+# include <exception>
+# include <functional>
+
+# include <bra/gate/gate.hpp>
+
+// A reader thread pushes chunks of at most this number of gates, and blocks while BRA_STREAMING_MAX_NUM_CHUNKS chunks are not applied
+# ifndef BRA_STREAMING_CHUNK_SIZE
+#   define BRA_STREAMING_CHUNK_SIZE 4096u
+# endif // BRA_STREAMING_CHUNK_SIZE
+# ifndef BRA_STREAMING_MAX_NUM_CHUNKS
+#   define BRA_STREAMING_MAX_NUM_CHUNKS 16u
+# endif // BRA_STREAMING_MAX_NUM_CHUNKS
+
+
+namespace bra
+{
+  struct streaming_t { }; // struct streaming_t
+  constexpr streaming_t streaming{};
+
+  // Gates of one circuit which are read from a qcx file by a reader thread and applied by the caller.
+  // The reader is started at next_offset(), and it saves the offset of the first unread line when it is stopped,
+  // so a circuit in a waiting state can be resumed, and JUMP restarts the reader at the offset of its label
+  class circuit_stream
+  {
+   public:
+    using gate_pointer = std::unique_ptr< ::bra::gate::gate >;
+    using chunk_type = std::vector<gate_pointer>;
+
+   private:
+    std::ifstream input_stream_;
+    std::streamoff next_offset_;
+    bool is_in_circuit_; // true if next_offset_ is in BEGIN CIRCUIT ... END CIRCUIT
+
+    std::mutex mutex_;
+    std::condition_variable condition_variable_;
+    std::deque<chunk_type> chunks_;
+    bool is_stop_requested_;
+    bool is_reader_running_;
+    bool is_end_of_circuit_;
+    std::exception_ptr exception_ptr_;
+    std::thread reader_;
+
+   public:
+    circuit_stream(std::string const& filename, std::streamoff const first_offset, bool const is_in_circuit);
+    ~circuit_stream();
+    circuit_stream(circuit_stream const&) = delete;
+    circuit_stream& operator=(circuit_stream const&) = delete;
+
+    auto input_stream() -> std::ifstream& { return input_stream_; }
+    auto next_offset() const -> std::streamoff { return next_offset_; }
+    auto is_in_circuit() const -> bool { return is_in_circuit_; }
+    auto is_end_of_circuit() const -> bool { return is_end_of_circuit_; }
+
+    // read(*this) is called in the reader thread, and it should call push and finish
+    auto start(std::function<void(circuit_stream&)> read) -> void;
+    // queued chunks are kept, and the reader is going to be started at the saved offset
+    auto stop() -> void;
+    // stops the reader, discards queued chunks, and sets the offset at which the reader is started next
+    auto restart_at(std::streamoff const offset, bool const is_in_circuit) -> void;
+
+    // called by the reader: returns false if the reader should stop after saving the offset by finish
+    auto push(chunk_type&& chunk) -> bool;
+    auto is_stop_requested() -> bool;
+    auto finish(std::streamoff const next_offset, bool const is_in_circuit, bool const is_end_of_circuit) -> void;
+
+    // called by the consumer: returns false if no gate is left, and rethrows an exception thrown in the reader
+    auto pop(chunk_type& chunk) -> bool;
+  }; // class circuit_stream
+} // namespace bra
+
+
+#endif // BRA_CIRCUIT_STREAM_HPP
@@ -0,0 +1,124 @@
+#ifndef BRA_COMPILED_PAULI_STRING_SPACE_HPP
+# define BRA_COMPILED_PAULI_STRING_SPACE_HPP
+
+# include <cstddef>
+# include <complex>
+# include <vector>
+# include <array>
+# include <algorithm>
+# include <iterator>
+
+# include <ket/gate/utility/index_with_qubits.hpp>
+# include <ket/gate/utility/pauli_index_coeff.hpp>
+
+# include <bra/types.hpp>
+# include <bra/pauli_string_space.hpp>
+
+
+namespace bra
+{
+  // Observable of ket::expectation_value, ket::inner_product and ket::fidelity (and their MPI versions) for a Pauli string space.
+  // Pauli strings are compiled into ket::gate::utility::pauli_masks once, and terms with the same X mask share loads of amplitudes.
+  class compiled_pauli_string_space
+  {
+    using pauli_masks_type = ket::gate::utility::pauli_masks< ::bra::state_integer_type, ::bra::complex_type >;
+    std::vector<pauli_masks_type> terms_; // sorted by x_mask
+    std::vector<std::size_t> group_first_indices_; // terms_[group_first_indices_[i]], ..., terms_[group_first_indices_[i + 1] - 1] have the same x_mask
+    ::bra::state_integer_type qubits_value_mask_;
+
+   public:
+    explicit compiled_pauli_string_space(::bra::pauli_string_space const& pauli_string_space)
+      : terms_{}, group_first_indices_{},
+        qubits_value_mask_{(::bra::state_integer_type{1u} << pauli_string_space.num_qubits()) - ::bra::state_integer_type{1u}}
+    {
+      terms_.reserve(pauli_string_space.size());
+      for (auto const& basis_scalar: pauli_string_space)
+        if (basis_scalar.second != ::bra::complex_type{::bra::real_type{0}})
+          terms_.push_back(ket::gate::utility::make_pauli_masks< ::bra::state_integer_type >(basis_scalar.first, basis_scalar.second));
+
+      using std::begin;
+      using std::end;
+      std::sort(
+        begin(terms_), end(terms_),
+        [](pauli_masks_type const& lhs, pauli_masks_type const& rhs) { return lhs.x_mask < rhs.x_mask; });
+
+      for (auto index = std::size_t{0u}; index < terms_.size(); ++index)
+        if (index == std::size_t{0u} or terms_[index].x_mask != terms_[index - 1u].x_mask)
+          group_first_indices_.push_back(index);
+      group_first_indices_.push_back(terms_.size());
+    }
+
+    // sum_n <Psi|n> <n|A|Psi> for n in a group of amplitudes
+    template <typename RandomAccessIterator, typename StateInteger, typename Qubits, typename SortedQubits>
+    auto operator()(
+      RandomAccessIterator const first, StateInteger const index_wo_qubits,
+      Qubits const& unsorted_qubits_or_masks, SortedQubits const& sorted_qubits_or_index_masks) const
+    -> ::bra::complex_type
+    { return (*this)(first, first, index_wo_qubits, unsorted_qubits_or_masks, sorted_qubits_or_index_masks); }
+
+    // sum_n <Phi|n> <n|A|Psi> for n in a group of amplitudes, where Psi is ket and Phi is bra
+    template <typename RandomAccessIterator1, typename RandomAccessIterator2, typename StateInteger, typename Qubits, typename SortedQubits>
+    auto operator()(
+      RandomAccessIterator1 const ket_first, RandomAccessIterator2 const bra_first, StateInteger const index_wo_qubits,
+      Qubits const& unsorted_qubits_or_masks, SortedQubits const& sorted_qubits_or_index_masks) const
+    -> ::bra::complex_type
+    {
+      auto const deposit
+        = [&unsorted_qubits_or_masks, &sorted_qubits_or_index_masks](StateInteger const index, StateInteger const qubits_value)
+          {
+            using std::begin;
+            using std::end;
+            return ket::gate::utility::index_with_qubits(
+              index, qubits_value,
+              begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
+              begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
+          };
+
+      // Indices in this group are first_index bitor (any submask of qubits_mask)
+      auto const first_index = deposit(index_wo_qubits, StateInteger{0u});
+      auto const qubits_mask = deposit(StateInteger{0u}, static_cast<StateInteger>(qubits_value_mask_));
+
+      auto result = ::bra::complex_type{};
+      auto const num_groups = group_first_indices_.size() - 1u;
+      for (auto group_index = std::size_t{0u}; group_index < num_groups; ++group_index)
+      {
+        auto const x_mask = deposit(StateInteger{0u}, static_cast<StateInteger>(terms_[group_first_indices_[group_index]].x_mask));
+
+        // Terms are processed in chunks to keep deposited Z masks on stack
+        constexpr auto chunk_size = std::size_t{32u};
+        auto z_masks = std::array<StateInteger, chunk_size>{};
+        for (auto term_first = group_first_indices_[group_index], group_last = group_first_indices_[group_index + 1u];
+             term_first < group_last; term_first += chunk_size)
+        {
+          auto const term_last = std::min(term_first + chunk_size, group_last);
+          for (auto term_index = term_first; term_index < term_last; ++term_index)
+            z_masks[term_index - term_first] = deposit(StateInteger{0u}, static_cast<StateInteger>(terms_[term_index].z_mask));
+
+          auto submask = StateInteger{0u};
+          do
+          {
+            auto const bra_index = first_index bitor submask;
+
+            auto coefficient = ::bra::complex_type{};
+            for (auto term_index = term_first; term_index < term_last; ++term_index)
+              if (ket::gate::utility::has_odd_parity(submask bitand z_masks[term_index - term_first]))
+                coefficient -= terms_[term_index].coefficient;
+              else
+                coefficient += terms_[term_index].coefficient;
+
+            using std::conj;
+            result += coefficient * (conj(*(bra_first + bra_index)) * *(ket_first + (bra_index xor x_mask)));
+
+            submask = (submask - qubits_mask) bitand qubits_mask;
+          }
+          while (submask != StateInteger{0u});
+        }
+      }
+
+      return result;
+    }
+  }; // class compiled_pauli_string_space
+} // namespace bra
+
+
+#endif // BRA_COMPILED_PAULI_STRING_SPACE_HPP
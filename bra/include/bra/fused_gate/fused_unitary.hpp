@@ -0,0 +1,141 @@
+#ifndef BRA_FUSED_GATE_FUSED_UNITARY_HPP
+# define BRA_FUSED_GATE_FUSED_UNITARY_HPP
+
+# include <cstddef>
+# include <vector>
+# include <memory>
+
+# include <boost/range/size.hpp>
+
+# include <ket/gate/utility/index_with_qubits.hpp>
+# include <ket/utility/integer_exp2.hpp>
+
+# include <bra/types.hpp>
+# include <bra/fused_gate/fused_gate.hpp>
+
+# ifndef BRA_MAX_NUM_FUSED_UNITARY_QUBITS
+#   define BRA_MAX_NUM_FUSED_UNITARY_QUBITS 10
+# endif // BRA_MAX_NUM_FUSED_UNITARY_QUBITS
+
+
+namespace bra
+{
+  namespace fused_gate
+  {
+    // A dense 2^k x 2^k unitary matrix equivalent to a sequence of fused gates on k fused qubits.
+    // Applying it costs 2^k complex multiply-adds per amplitude, whereas the per-gate path costs some index arithmetic and a virtual call per gate and amplitude.
+    class fused_unitary
+    {
+      ::bra::bit_integer_type num_fused_qubits_;
+      ::bra::state_integer_type num_fused_indices_;
+      std::vector< ::bra::complex_type > matrix_; // row-major
+      // Each thread uses the num_fused_indices_ elements from (thread_index * num_fused_indices_)-th element
+      mutable std::vector< ::bra::complex_type > amplitude_buffer_;
+      mutable std::vector< ::bra::state_integer_type > index_buffer_;
+
+     public:
+      fused_unitary(
+        std::vector<std::unique_ptr< ::bra::fused_gate::fused_gate< ::bra::data_type::iterator > >> const& fused_gates,
+        ::bra::bit_integer_type const num_fused_qubits,
+        std::vector< ::bra::bit_integer_type > const& to_qubit_index_in_fused_gates,
+        unsigned int const num_threads);
+
+      auto num_fused_qubits() const noexcept -> ::bra::bit_integer_type { return num_fused_qubits_; }
+
+      template <typename RandomAccessIterator, typename UnsortedFusedQubitsOrMasks, typename SortedFusedQubitsWithSentinelOrIndexMasks>
+      auto call(
+        RandomAccessIterator const first, ::bra::state_integer_type const index_wo_qubits,
+        UnsortedFusedQubitsOrMasks const& unsorted_fused_qubits_or_masks,
+        SortedFusedQubitsWithSentinelOrIndexMasks const& sorted_fused_qubits_with_sentinel_or_index_masks,
+        int const thread_index) const
+      -> void
+      {
+        auto const buffer_offset = static_cast<std::size_t>(thread_index) * static_cast<std::size_t>(num_fused_indices_);
+        auto const amplitude_first = amplitude_buffer_.begin() + buffer_offset;
+        auto const index_first = index_buffer_.begin() + buffer_offset;
+
+        for (auto i = ::bra::state_integer_type{0u}; i < num_fused_indices_; ++i)
+        {
+          index_first[i]
+            = ::ket::gate::utility::ranges::index_with_qubits(
+                index_wo_qubits, i, unsorted_fused_qubits_or_masks, sorted_fused_qubits_with_sentinel_or_index_masks);
+          amplitude_first[i] = *(first + index_first[i]);
+        }
+
+        auto row_first = matrix_.cbegin();
+        for (auto i = ::bra::state_integer_type{0u}; i < num_fused_indices_; ++i, row_first += num_fused_indices_)
+        {
+          auto value = ::bra::complex_type{};
+          for (auto j = ::bra::state_integer_type{0u}; j < num_fused_indices_; ++j)
+            value += row_first[j] * amplitude_first[j];
+          *(first + index_first[i]) = value;
+        }
+      }
+    }; // class fused_unitary
+
+    // Costs of fusion per amplitude in units of a complex multiply-add in the matrix-vector product of fused_unitary.
+    // They are estimated from sweeps of a 22-qubit state vector on one core, and shared by is_fused_unitary_preferable and is_fusion_preferable
+    namespace fusion_cost
+    {
+      constexpr auto gate_sweep = std::size_t{1u}; // a memory-bound sweep of the state vector with one gate
+      constexpr auto fused_sweep = std::size_t{4u}; // a sweep with fused gates except for applying them, e.g. gathering amplitudes
+      constexpr auto fused_gate = std::size_t{16u}; // applying one fused gate one by one
+    } // namespace fusion_cost
+
+    inline auto is_fused_unitary_preferable(::bra::bit_integer_type const num_fused_qubits, std::size_t const num_fused_gates) -> bool
+    {
+      return num_fused_qubits > ::bra::bit_integer_type{0u}
+        and num_fused_qubits <= ::bra::bit_integer_type{BRA_MAX_NUM_FUSED_UNITARY_QUBITS}
+        and ::ket::utility::integer_exp2<std::size_t>(num_fused_qubits) <= ::bra::fused_gate::fusion_cost::fused_gate * num_fused_gates;
+    }
+
+    // the cost per amplitude of a sweep with fused gates, by fused_unitary or one by one whichever is preferable
+    inline auto fused_sweep_cost(::bra::bit_integer_type const num_fused_qubits, std::size_t const num_fused_gates) -> std::size_t
+    {
+      return ::bra::fused_gate::fusion_cost::fused_sweep
+        + (::bra::fused_gate::is_fused_unitary_preferable(num_fused_qubits, num_fused_gates)
+           ? ::ket::utility::integer_exp2<std::size_t>(num_fused_qubits)
+           : ::bra::fused_gate::fusion_cost::fused_gate * num_fused_gates);
+    }
+
+    inline auto is_fusion_preferable(::bra::bit_integer_type const num_fused_qubits, std::size_t const num_fused_gates) -> bool
+    { return ::bra::fused_gate::fused_sweep_cost(num_fused_qubits, num_fused_gates) <= ::bra::fused_gate::fusion_cost::gate_sweep * num_fused_gates; }
+
+    // Applies fused_unitary if the number of qubits given by gate functions is the same as that of fused_unitary, otherwise calls fused gates one by one
+    template <typename Function>
+    class fused_unitary_caller
+    {
+      ::bra::fused_gate::fused_unitary const& fused_unitary_;
+      Function const& call_fused_gates_;
+
+     public:
+      fused_unitary_caller(::bra::fused_gate::fused_unitary const& fused_unitary, Function const& call_fused_gates)
+        : fused_unitary_{fused_unitary}, call_fused_gates_{call_fused_gates}
+      { }
+
+      template <typename RandomAccessIterator, typename UnsortedFusedQubitsOrMasks, typename SortedFusedQubitsWithSentinelOrIndexMasks>
+      auto operator()(
+        RandomAccessIterator const first, ::bra::state_integer_type const index_wo_qubits,
+        UnsortedFusedQubitsOrMasks const& unsorted_fused_qubits_or_masks,
+        SortedFusedQubitsWithSentinelOrIndexMasks const& sorted_fused_qubits_with_sentinel_or_index_masks,
+        int const thread_index) const
+      -> void
+      {
+        if (static_cast< ::bra::bit_integer_type >(boost::size(unsorted_fused_qubits_or_masks)) == fused_unitary_.num_fused_qubits())
+          fused_unitary_.call(
+            first, index_wo_qubits, unsorted_fused_qubits_or_masks, sorted_fused_qubits_with_sentinel_or_index_masks, thread_index);
+        else
+          call_fused_gates_(
+            first, index_wo_qubits, unsorted_fused_qubits_or_masks, sorted_fused_qubits_with_sentinel_or_index_masks, thread_index);
+      }
+    }; // class fused_unitary_caller<Function>
+
+    template <typename Function>
+    inline auto make_fused_unitary_caller(::bra::fused_gate::fused_unitary const& fused_unitary, Function const& call_fused_gates)
+    -> ::bra::fused_gate::fused_unitary_caller<Function>
+    { return {fused_unitary, call_fused_gates}; }
+  } // namespace fused_gate
+} // namespace bra
+
+
+#endif // BRA_FUSED_GATE_FUSED_UNITARY_HPP
@@ -41,6 +41,7 @@ namespace bra
       std::string const& do_name() const override;
       std::string do_representation(
         std::ostringstream& repr_stream, int const parameter_width) const override;
+      bool do_is_diagonal() const override { return true; }
     }; // class adj_multi_controlled_t_gate
   } // namespace gate
 } // namespace bra
@@ -37,6 +37,8 @@ namespace bra
       std::string const& do_name() const override;
       std::string do_representation(
         std::ostringstream& repr_stream, int const parameter_width) const override;
+      bool do_is_diagonal() const override { return true; }
+      bool do_lower(::bra::instruction& instruction) const override;
     }; // class adj_s_gate
   } // namespace gate
 } // namespace bra
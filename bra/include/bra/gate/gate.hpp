@@ -8,6 +8,7 @@
 # include <boost/variant/static_visitor.hpp>
 
 # include <bra/state.hpp>
+# include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -41,12 +42,21 @@ namespace bra
       ::bra::state& apply(::bra::state& state) const { return do_apply(state); }
       std::string const& name() const { return do_name(); }
       std::string representation() const;
+      // Diagonal gates are gathered by ::bra::state between begin_diagonal_accumulation and end_diagonal_accumulation
+      bool is_diagonal() const { return do_is_diagonal(); }
+      // Gates which have their opcodes fill the instruction and return true, and the others return false
+      bool lower(::bra::instruction& instruction) const { return do_lower(instruction); }
+      // Gates operating qubits may be put into BEGIN FUSION ... END FUSION by ::bra::interpreter::plan_fusion unless they return false
+      bool is_fusable() const { return do_is_fusable(); }
 
      protected:
       virtual ::bra::state& do_apply(::bra::state& state) const = 0;
       virtual std::string const& do_name() const = 0;
       virtual std::string do_representation(
         std::ostringstream& repr_stream, int const parameter_width) const = 0;
+      virtual bool do_is_diagonal() const { return false; }
+      virtual bool do_lower(::bra::instruction&) const { return false; }
+      virtual bool do_is_fusable() const { return true; }
     }; // class gate
 
     inline ::bra::state& operator<<(::bra::state& state, ::bra::gate::gate const& gate)
@@ -40,6 +40,7 @@ namespace bra
       std::string const& do_name() const override;
       std::string do_representation(
         std::ostringstream& repr_stream, int const parameter_width) const override;
+      bool do_is_fusable() const override { return false; }
     }; // class inner_product_with_op
   } // namespace gate
 } // namespace bra
@@ -0,0 +1,45 @@
+#ifndef BRA_GATE_LOAD_STATE_HPP
+# define BRA_GATE_LOAD_STATE_HPP
+
+# include <string>
+# include <iosfwd>
+
+# include <bra/gate/gate.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    class load_state final
+      : public ::bra::gate::gate
+    {
+     public:
+      using qubit_type = ::bra::state::qubit_type;
+
+     private:
+      std::string filename_;
+
+      static std::string const name_;
+
+     public:
+      explicit load_state(std::string const& filename);
+
+      ~load_state() = default;
+      load_state(load_state const&) = delete;
+      load_state& operator=(load_state const&) = delete;
+      load_state(load_state&&) = delete;
+      load_state& operator=(load_state&&) = delete;
+
+     private:
+      ::bra::state& do_apply(::bra::state& state) const override;
+      std::string const& do_name() const override;
+      std::string do_representation(
+        std::ostringstream& repr_stream, int const parameter_width) const override;
+    }; // class load_state
+  } // namespace gate
+} // namespace bra
+
+
+#endif // BRA_GATE_LOAD_STATE_HPP
@@ -37,6 +37,7 @@ namespace bra
       std::string const& do_name() const override;
       std::string do_representation(
         std::ostringstream& repr_stream, int const parameter_width) const override;
+      bool do_lower(::bra::instruction& instruction) const override;
     }; // class pauli_x
   } // namespace gate
 } // namespace bra
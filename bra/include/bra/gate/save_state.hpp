@@ -0,0 +1,46 @@
+#ifndef BRA_GATE_SAVE_STATE_HPP
+# define BRA_GATE_SAVE_STATE_HPP
+
+# include <string>
+# include <iosfwd>
+
+# include <bra/gate/gate.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    class save_state final
+      : public ::bra::gate::gate
+    {
+     public:
+      using qubit_type = ::bra::state::qubit_type;
+
+     private:
+      std::string filename_;
+      int next_instruction_index_; // the index of the instruction after this SAVE STATE
+
+      static std::string const name_;
+
+     public:
+      save_state(std::string const& filename, int const next_instruction_index);
+
+      ~save_state() = default;
+      save_state(save_state const&) = delete;
+      save_state& operator=(save_state const&) = delete;
+      save_state(save_state&&) = delete;
+      save_state& operator=(save_state&&) = delete;
+
+     private:
+      ::bra::state& do_apply(::bra::state& state) const override;
+      std::string const& do_name() const override;
+      std::string do_representation(
+        std::ostringstream& repr_stream, int const parameter_width) const override;
+    }; // class save_state
+  } // namespace gate
+} // namespace bra
+
+
+#endif // BRA_GATE_SAVE_STATE_HPP
@@ -3,6 +3,7 @@
 
 # include <cassert>
 # include <iosfwd>
+# include <ios>
 # include <vector>
 # include <unordered_map>
 # include <string>
@@ -29,6 +30,12 @@
 # include <bra/types.hpp>
 # include <bra/state.hpp>
 # include <bra/gate/gate.hpp>
+# include <bra/circuit_stream.hpp>
+# include <bra/bytecode.hpp>
+# include <bra/profiler.hpp>
+# ifndef BRA_NO_MPI
+#   include <bra/remapping_plan.hpp>
+# endif // BRA_NO_MPI
 
 # if __cplusplus >= 201703L
 #   define BRA_is_nothrow_swappable std::is_nothrow_swappable
@@ -83,6 +90,9 @@ namespace bra
     std::vector<circuit_type> circuits_;
     std::vector<std::unordered_map<std::string, int>> label_maps_;
     std::vector<int> first_indices_;
+    // operated_qubits_[circuit_index][gate_index]: qubits operated by the gate. Gates in fusion have no operated qubits and their END FUSION has all of them
+    std::vector<std::vector<std::vector< ::bra::bit_integer_type >>> operated_qubits_;
+    int fusion_first_index_;
 
    public:
     using columns_type = wrong_mnemonics_error::columns_type;
@@ -113,6 +123,27 @@ namespace bra
     ::bra::real_type depolarizing_pz_;
     int depolarizing_seed_;
 
+    int checkpoint_interval_; // no checkpoint if checkpoint_interval_ <= 0
+    std::string checkpoint_filename_;
+    std::vector<int> num_uncheckpointed_instructions_;
+
+    // In streaming mode, gates are generated by reader threads while applying circuits, and circuits_[circuit_index] is the chunk being read
+    bool is_streaming_;
+    std::string filename_;
+    std::streamoff end_offset_; // reading is stopped at this offset, e.g. after EXIT
+    // label_offsets_[circuit_index][label]: the offset of the line next to the label, and whether the line is in BEGIN CIRCUIT ... END CIRCUIT
+    std::vector<std::unordered_map<std::string, std::pair<std::streamoff, bool>>> label_offsets_;
+    std::vector<std::unique_ptr< ::bra::circuit_stream >> circuit_streams_;
+    std::vector<circuit_type> streamed_chunks_; // streamed_chunks_[circuit_index][first_indices_[circuit_index]] is applied next
+
+    // bytecodes_[circuit_index][gate_index]: the lowered gate, whose opcode is opcode::gate if the gate itself should be applied
+    std::vector<std::vector< ::bra::instruction >> bytecodes_;
+    // Lines saved into bytecode files with bytecodes_ to restore gates of opcode::gate without reading the whole qcx file
+    std::vector<std::string> header_lines_;
+    std::vector<std::vector<std::string>> fallback_lines_; // fallback_lines_[circuit_index]: lines generating gates of opcode::gate
+
+    ::bra::profiler* profiler_ptr_; // not owned, and gates are not profiled if nullptr
+
    public:
     using size_type = circuit_type::size_type;
     using const_circuit_iterator = circuit_type::const_iterator;
@@ -133,6 +164,30 @@ namespace bra
     interpreter(std::istream& input_stream, size_type const num_reserved_gates);
 # endif // BRA_NO_MPI
 
+    // Only headers and labels are read by constructors, and gates are read while applying circuits
+# ifndef BRA_NO_MPI
+    interpreter(
+      std::string const& filename, ::bra::streaming_t const,
+      ::bra::bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+      yampi::environment const& environment,
+      yampi::rank const root = yampi::rank{},
+      yampi::communicator const& total_communicator = yampi::communicator{::yampi::tags::world_communicator});
+# else // BRA_NO_MPI
+    interpreter(std::string const& filename, ::bra::streaming_t const);
+# endif // BRA_NO_MPI
+
+    // Circuits are loaded from the bytecode file generated by save_bytecode
+# ifndef BRA_NO_MPI
+    interpreter(
+      std::string const& filename, ::bra::bytecode_t const,
+      ::bra::bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+      yampi::environment const& environment,
+      yampi::rank const root = yampi::rank{},
+      yampi::communicator const& total_communicator = yampi::communicator{::yampi::tags::world_communicator});
+# else // BRA_NO_MPI
+    interpreter(std::string const& filename, ::bra::bytecode_t const);
+# endif // BRA_NO_MPI
+
     auto operator==(interpreter const& other) const -> bool;
 
     auto num_qubits() const -> ::bra::bit_integer_type const& { return num_qubits_; }
@@ -142,7 +197,10 @@ namespace bra
     auto num_processes_per_unit() const -> unsigned int const& { return num_processes_per_unit_; }
 # endif
     auto largest_num_operated_qubits() const -> std::size_t { return largest_num_operated_qubits_; }
+    auto is_streaming() const -> bool { return is_streaming_; }
     auto num_circuits() const -> std::size_t { return circuits_.size(); }
+    auto operated_qubits(int const circuit_index) const -> std::vector<std::vector< ::bra::bit_integer_type >> const&
+    { return operated_qubits_[circuit_index]; }
     auto initial_state_value() const -> ::bra::state_integer_type const& { return initial_state_value_; }
 # ifndef BRA_NO_MPI
     auto initial_permutation() const -> std::vector< ::bra::permutated_qubit_type > const& { return initial_permutation_; }
@@ -154,6 +212,24 @@ namespace bra
     auto depolarizing_pz() const -> ::bra::real_type { return depolarizing_pz_; }
     auto depolarizing_seed() const -> int { return depolarizing_seed_; }
 
+    // saves the circuits read by invoke into the file which is loaded by the constructor taking ::bra::bytecode
+    auto save_bytecode(std::string const& filename) const -> void;
+
+    auto checkpoint_interval() const -> int { return checkpoint_interval_; }
+    // saves states into checkpoint files every new_checkpoint_interval instructions
+    auto checkpoint(int const new_checkpoint_interval, std::string const& checkpoint_filename) -> void;
+    // checkpoint_filename is suffixed by ".<circuit_index>" if there are two or more circuits
+    auto checkpoint_filename(int const circuit_index) const -> std::string;
+
+    // gates applied by apply_circuit are measured by the profiler, which should live until the last apply_circuit
+    auto profile(::bra::profiler& profiler) -> void { profiler_ptr_ = std::addressof(profiler); }
+
+    // puts runs of gates into BEGIN FUSION ... END FUSION blocks operating at most max_num_fused_qubits qubits. Runs are split by
+    // measurements, labels, JUMPs, non-gate instructions, existing fusion blocks and (in the MPI version) gates on initially global qubits.
+    // Blocks with too few gates to pay for fusion are not fused. This should be called before restart_circuit and apply_circuit,
+    // and fused circuits cannot be saved by save_bytecode
+    auto plan_fusion(::bra::bit_integer_type const max_num_fused_qubits) -> void;
+
 # ifndef BRA_NO_MPI
     auto num_qubits(
       ::bra::bit_integer_type const new_num_qubits,
@@ -186,6 +262,35 @@ namespace bra
       size_type const num_reserved_gates = size_type{0u}) -> void;
 # endif // BRA_NO_MPI
 
+   private:
+# ifndef BRA_NO_MPI
+    auto scan(std::istream& input_stream, yampi::environment const& environment, yampi::communicator const& communicator) -> void;
+    auto interpret_header_statement(
+      columns_type& columns, yampi::environment const& environment, yampi::communicator const& communicator,
+      size_type const num_reserved_gates) -> bool;
+# else // BRA_NO_MPI
+    auto scan(std::istream& input_stream) -> void;
+    auto interpret_header_statement(columns_type& columns, size_type const num_reserved_gates) -> bool;
+# endif // BRA_NO_MPI
+    // returns false if the rest of input is not read, e.g. after EXIT
+    auto interpret_instruction(columns_type& columns) -> bool;
+    auto read_streaming_circuit(::bra::circuit_stream& stream, int const circuit_index) -> void;
+    // lowers gates generated from the line into bytecodes_[circuit_index], where circuits_[circuit_index] had num_gates gates before the line
+    auto lower_gates(int const circuit_index, size_type const num_gates, std::string const& line) -> void;
+    auto is_fusable_gate(int const circuit_index, size_type const index) const -> bool;
+    // returns the largest number of qubits operated by a planned block
+    auto plan_circuit_fusion(int const circuit_index, ::bra::bit_integer_type const max_num_fused_qubits) -> ::bra::bit_integer_type;
+# ifndef BRA_NO_MPI
+    auto load_bytecode(std::string const& filename, yampi::environment const& environment, yampi::communicator const& communicator) -> void;
+# else // BRA_NO_MPI
+    auto load_bytecode(std::string const& filename) -> void;
+# endif // BRA_NO_MPI
+    void apply_streaming_circuit(::bra::state& state, int const circuit_index);
+    auto profile_key(
+      ::bra::state const& state, int const circuit_index, int const index, ::bra::gate::gate const& gate) const
+    -> ::bra::profiler::key_type;
+
+   public:
     auto circuit(int const circuit_index) const -> circuit_type const& { return circuits_[circuit_index]; }
     auto circuit_at(int const circuit_index) const -> circuit_type const& { return circuits_.at(circuit_index); }
     auto front_circuit() const -> circuit_type const& { return circuits_.front(); }
@@ -203,9 +308,22 @@ namespace bra
         and BRA_is_nothrow_swappable< ::bra::state_integer_type >::value
         and BRA_is_nothrow_swappable< ::bra::qubit_type >::value);
 
+    // loads the checkpoint file of the circuit, and the circuit is going to be resumed from the saved instruction
+    void restart_circuit(::bra::state& state, int const circuit_index);
     void apply_circuit(::bra::state& state, int const circuit_index);
+# ifndef BRA_NO_MPI
+    // interchanges qubits according to plan, and counts actual interchanges
+    void apply_circuit(::bra::state& state, int const circuit_index, ::bra::remapping_plan& plan);
+# endif // BRA_NO_MPI
 
    private:
+    void save_checkpoint_if_needed(::bra::state& state, int const circuit_index, int const next_index);
+    // starts gathering diagonal gates if the index-th gate and the next one are diagonal, and applies gathered ones before a non-diagonal gate
+    void update_diagonal_accumulation(::bra::state& state, circuit_type const& circuit, int const index) const;
+    void update_diagonal_accumulation(::bra::state& state, std::vector< ::bra::instruction > const& bytecode, int const index) const;
+
+    ::bra::qubit_type make_operated_qubit(::bra::bit_integer_type const bit);
+
     ::bra::bit_integer_type read_num_qubits(columns_type const& columns) const;
     ::bra::state_integer_type read_initial_state_value(columns_type& columns) const;
     ::bra::bit_integer_type read_num_mpi_processes(columns_type const& columns) const;
@@ -417,6 +535,8 @@ namespace bra
     void add_fidelity(columns_type const& columns);
     void add_clear(columns_type const& columns);
     void add_set(columns_type const& columns);
+    void add_save_state(columns_type const& columns);
+    void add_load_state(columns_type const& columns);
 
     void interpret_controlled_gates(columns_type const& columns, std::string const& mnemonic);
     void add_ci(columns_type const& columns, int const num_control_qubits);
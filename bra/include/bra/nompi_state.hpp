@@ -5,13 +5,18 @@
 #   include <vector>
 #   include <string>
 #   include <memory>
+#   include <functional>
 
 #   include <ket/gate/projective_measurement.hpp>
 #   if defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
 #     include <ket/gate/utility/cache_aware_iterator.hpp>
 #   endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
+#   include <ket/gate/cache_blocking.hpp>
 #   include <ket/utility/integer_exp2.hpp>
 #   include <ket/utility/parallel/loop_n.hpp>
+#   ifdef BRA_USE_SPLIT_LAYOUT
+#     include <ket/gate/split/layout.hpp>
+#   endif // BRA_USE_SPLIT_LAYOUT
 
 #   include <bra/types.hpp>
 #   include <bra/state.hpp>
@@ -121,6 +126,19 @@ namespace bra
 
     using data_type = ::bra::data_type;
     data_type data_;
+#   ifdef BRA_USE_SPLIT_LAYOUT
+    bool is_data_in_split_layout_; // see ket::gate::split
+#   endif // BRA_USE_SPLIT_LAYOUT
+
+    // Gates in apply_gate are deferred while their operated qubits fit in a cache block, and the run of them is applied block by block
+    // when a gate breaks the run or other operations need data_ (see ket::gate::cache_block_layout).
+    // If BRA_USE_SPLIT_LAYOUT is defined and data_ can be in split layout, gates are not deferred but applied by split-layout kernels
+    using cache_block_layout_type = ket::gate::cache_block_layout< ::bra::state_integer_type, ::bra::bit_integer_type >;
+    // A gate is applied to the whole state vector in parallel if the pointer to the layout is null, and to a block otherwise
+    using cache_blocked_gate_type = std::function<void(data_type::iterator, data_type::iterator, cache_block_layout_type const*)>;
+    cache_block_layout_type cache_block_layout_; // no cache blocking if the number of block qubits is 0
+    std::vector<cache_blocked_gate_type> cache_blocked_gates_;
+    data_type cache_block_buffer_;
 #   if defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && defined(KET_USE_ON_CACHE_STATE_VECTOR)
     data_type on_cache_data_;
 #   endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && defined(KET_USE_ON_CACHE_STATE_VECTOR)
@@ -156,14 +174,33 @@ namespace bra
       ::bra::state::state_integer_type const initial_integer,
       unsigned int const total_num_qubits)
     {
-      auto result
-        = data_type(
-            ket::utility::integer_exp2<state_integer_type>(total_num_qubits),
-            complex_type{real_type{0}});
+      // Amplitudes are zero-filled in parallel so that pages are first touched by the threads applying gates to them
+      auto result = data_type(ket::utility::integer_exp2<state_integer_type>(total_num_qubits));
+      ket::utility::ranges::fill(parallel_policy_, result, complex_type{real_type{0}});
       result[initial_integer] = complex_type{real_type{1}};
       return result;
     }
 
+    // Gates on one or two qubits are applied by split-layout kernels if BRA_USE_SPLIT_LAYOUT is defined, and data_ stays in split layout until other operations need it
+    auto interleaved_data() -> data_type&
+    {
+#   ifdef BRA_USE_SPLIT_LAYOUT
+      if (is_data_in_split_layout_)
+      {
+        ket::gate::split::ranges::to_interleaved_layout(parallel_policy_, data_);
+        is_data_in_split_layout_ = false;
+      }
+#   endif // BRA_USE_SPLIT_LAYOUT
+      apply_cache_blocked_gates();
+      return data_;
+    }
+
+    auto apply_cache_blocked_gates() -> void;
+
+    // gate(parallel_policy, state, qubits...) should apply the gate on qubits, where each element of qubits is ::bra::qubit_type or ::bra::control_qubit_type
+    template <typename Gate, typename... Qubits>
+    auto apply_gate(Gate const& gate, Qubits const... qubits) -> void;
+
    public:
     ~nompi_state() = default;
     nompi_state(nompi_state const&) = default;
@@ -175,8 +212,6 @@ namespace bra
     auto do_is_waiting() const -> bool override;
     auto do_cancel_waiting() -> void override;
 
-    auto generate_probability() -> real_type override;
-
     auto do_send_real_variable(int const circuit_index, std::string const& variable_name, int const num_elements) const -> void override;
     auto do_send_complex_variable(int const circuit_index, std::string const& variable_name, int const num_elements) const -> void override;
     auto do_send_int_variable(int const circuit_index, std::string const& variable_name, int const num_elements) const -> void override;
@@ -296,8 +331,10 @@ namespace bra
       std::vector<qubit_type> const& modular_exponentiation_qubits) override;
     void do_begin_fusion() override;
     void do_end_fusion() override;
+    void do_diagonal(::ket::gate::diagonal_accumulator<complex_type, state_integer_type> const& accumulator) override;
     void do_clear(qubit_type const qubit) override;
     void do_set(qubit_type const qubit) override;
+    auto do_local_amplitude_ranges() -> std::vector<std::pair<complex_type*, std::size_t>> override;
 
     void do_controlled_i_gate(
       qubit_type const target_qubit, control_qubit_type const control_qubit) override;
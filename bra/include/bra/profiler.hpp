@@ -0,0 +1,121 @@
+#ifndef BRA_PROFILER_HPP
+# define BRA_PROFILER_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+# include <map>
+# include <string>
+# include <tuple>
+# include <chrono>
+
+# ifndef BRA_NO_MPI
+#   include <yampi/communicator.hpp>
+#   include <yampi/environment.hpp>
+# endif // BRA_NO_MPI
+
+# include <ket/utility/profiler.hpp>
+
+# include <bra/types.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  // Aggregated costs of gates for each mnemonic, number of operated qubits and class (whether some operated qubits are global).
+  // Interchange and barrier times and moved bytes are counted by ket::utility::profiler inside ket,
+  // and the rest of the elapsed time of a gate is regarded as its compute time.
+  // Gates in fusion have no operated qubits, and their compute is counted by END FUSION
+  class profiler
+  {
+   public:
+    // (mnemonic, number of operated qubits, whether some operated qubits are global)
+    using key_type = std::tuple<std::string, ::bra::bit_integer_type, bool>;
+
+    struct record_type
+    {
+      std::uint64_t count;
+      double compute_time;
+      double interchange_time;
+      double barrier_time;
+      std::uint64_t num_moved_bytes;
+    }; // struct record_type
+
+    struct fusion_record_type
+    {
+      std::uint64_t num_blocks;
+      std::uint64_t num_fused_gates;
+      std::uint64_t max_num_fused_gates; // in one block
+    }; // struct fusion_record_type
+
+   private:
+    // records_[circuit_index]: ordered by keys so that records of MPI processes in the same circuit are in the same order
+    std::vector<std::map<key_type, record_type>> records_;
+    std::vector<fusion_record_type> fusion_records_;
+    std::vector<std::uint64_t> num_gates_in_fusion_; // in the present block of each circuit
+
+   public:
+    explicit profiler(std::size_t const num_circuits);
+
+    // takes counters of ket::utility::profiler accumulated while applying the gate, whose total elapsed time is seconds
+    auto add(int const circuit_index, key_type const& key, double const seconds) -> void;
+    auto observe_fusion(int const circuit_index, bool const was_in_fusion, bool const is_in_fusion) -> void;
+
+    auto records(int const circuit_index) const -> std::map<key_type, record_type> const& { return records_[circuit_index]; }
+    auto fusion_record(int const circuit_index) const -> fusion_record_type const& { return fusion_records_[circuit_index]; }
+
+    // The format is JSON if filename ends with ".json", and CSV otherwise.
+# ifndef BRA_NO_MPI
+    // Records of the circuit are gathered to the root of circuit_communicator, which writes records of each process and reduced ones
+    // (maximum times and total bytes). Processes in the same circuit are assumed to apply the same gates
+    auto write(
+      std::string const& filename, int const circuit_index,
+      yampi::communicator const& circuit_communicator, yampi::environment const& environment) const -> void;
+# else // BRA_NO_MPI
+    auto write(std::string const& filename) const -> void;
+# endif // BRA_NO_MPI
+  }; // class profiler
+
+  // Measures one gate if profiler_ptr is not nullptr. make_key is called only in that case
+  class gate_profile_guard
+  {
+    ::bra::profiler* profiler_ptr_;
+    ::bra::state const& state_;
+    int circuit_index_;
+    ::bra::profiler::key_type key_;
+    bool was_in_fusion_;
+    ket::utility::profiler::clock_type::time_point start_time_;
+
+   public:
+    template <typename MakeKey>
+    gate_profile_guard(::bra::profiler* const profiler_ptr, ::bra::state const& state, int const circuit_index, MakeKey make_key)
+      : profiler_ptr_{profiler_ptr}, state_{state}, circuit_index_{circuit_index}, key_{}, was_in_fusion_{false}, start_time_{}
+    {
+      if (profiler_ptr_ == nullptr)
+        return;
+
+      key_ = make_key();
+      was_in_fusion_ = state_.is_in_fusion();
+      ket::utility::profiler::instance().take(); // discards counters out of gates
+      start_time_ = ket::utility::profiler::clock_type::now();
+    }
+
+    ~gate_profile_guard()
+    {
+      if (profiler_ptr_ == nullptr)
+        return;
+
+      profiler_ptr_->add(
+        circuit_index_, key_, std::chrono::duration<double>{ket::utility::profiler::clock_type::now() - start_time_}.count());
+      profiler_ptr_->observe_fusion(circuit_index_, was_in_fusion_, state_.is_in_fusion());
+    }
+
+    gate_profile_guard(gate_profile_guard const&) = delete;
+    gate_profile_guard& operator=(gate_profile_guard const&) = delete;
+    gate_profile_guard(gate_profile_guard&&) = delete;
+    gate_profile_guard& operator=(gate_profile_guard&&) = delete;
+  }; // class gate_profile_guard
+} // namespace bra
+
+
+#endif // BRA_PROFILER_HPP
@@ -0,0 +1,181 @@
+#ifndef BRA_REMAPPING_PLAN_HPP
+# define BRA_REMAPPING_PLAN_HPP
+
+# ifndef BRA_NO_MPI
+#   include <cstddef>
+#   include <vector>
+#   include <algorithm>
+#   include <iterator>
+#   include <utility>
+
+#   include <ket/qubit.hpp>
+
+#   include <bra/types.hpp>
+#   include <bra/state.hpp>
+
+#   ifndef BRA_MAX_NUM_INTERCHANGED_QUBITS
+#     define BRA_MAX_NUM_INTERCHANGED_QUBITS 3u
+#   endif // BRA_MAX_NUM_INTERCHANGED_QUBITS
+
+
+namespace bra
+{
+  namespace remapping_plan_detail
+  {
+    // Positions of qubits, which follow changes of ket::mpi::qubit_permutation by ket::mpi::utility::runtime::maybe_interchange_qubits in simple MPI mode
+    class layout
+    {
+      std::vector< ::bra::bit_integer_type > positions_;
+      std::vector< ::bra::bit_integer_type > qubits_;
+      ::bra::bit_integer_type num_local_qubits_;
+      std::size_t num_local_swaps_;
+
+     public:
+      layout(
+        std::vector< ::bra::permutated_qubit_type > const& initial_permutation,
+        ::bra::bit_integer_type const num_local_qubits)
+        : positions_(initial_permutation.size()), qubits_(initial_permutation.size()), num_local_qubits_{num_local_qubits}, num_local_swaps_{0u}
+      {
+        for (auto qubit = ::bra::bit_integer_type{0u}; qubit < initial_permutation.size(); ++qubit)
+        {
+          positions_[qubit] = static_cast< ::bra::bit_integer_type >(initial_permutation[qubit].qubit());
+          qubits_[positions_[qubit]] = qubit;
+        }
+      }
+
+      auto is_global(::bra::bit_integer_type const qubit) const -> bool { return positions_[qubit] >= num_local_qubits_; }
+      auto position(::bra::bit_integer_type const qubit) const -> ::bra::bit_integer_type { return positions_[qubit]; }
+      auto qubit(::bra::bit_integer_type const position) const -> ::bra::bit_integer_type { return qubits_[position]; }
+      // the number of swaps of two local qubits, each of which sweeps the local state vector, made to move local qubits to be global
+      auto num_local_swaps() const -> std::size_t { return num_local_swaps_; }
+
+      // Returns true if some qubits are interchanged between global and local qubits
+      auto interchange(std::vector< ::bra::bit_integer_type > const& operated_qubits) -> bool
+      {
+        auto global_operated_qubits = std::vector< ::bra::bit_integer_type >{};
+        auto local_operated_qubits = std::vector< ::bra::bit_integer_type >{};
+        using std::begin;
+        using std::end;
+        std::partition_copy(
+          begin(operated_qubits), end(operated_qubits),
+          std::back_inserter(global_operated_qubits), std::back_inserter(local_operated_qubits),
+          [this](::bra::bit_integer_type const qubit) { return is_global(qubit); });
+
+        if (global_operated_qubits.empty())
+          return false;
+
+        auto const is_unswappable
+          = [&local_operated_qubits](::bra::bit_integer_type const qubit)
+            {
+              using std::begin;
+              using std::end;
+              return std::find(begin(local_operated_qubits), end(local_operated_qubits), qubit) != end(local_operated_qubits);
+            };
+
+        // same as initialize_swap_qubits and make_local_swap_qubit in ket/mpi/utility/simple_mpi.hpp
+        auto swap_qubits = std::vector< ::bra::bit_integer_type >{};
+        swap_qubits.reserve(global_operated_qubits.size());
+        for (auto index = std::size_t{0u}; index < global_operated_qubits.size(); ++index)
+        {
+          auto const swap_position = static_cast< ::bra::bit_integer_type >(num_local_qubits_ - 1u - index);
+          if (is_unswappable(qubits_[swap_position]))
+          {
+            auto other_position = swap_position;
+            do
+              --other_position;
+            while (is_unswappable(qubits_[other_position]));
+
+            swap_positions(qubits_[swap_position], qubits_[other_position]);
+            ++num_local_swaps_;
+          }
+
+          swap_qubits.push_back(qubits_[swap_position]);
+        }
+
+        // same as update_permutation in ket/mpi/utility/simple_mpi.hpp
+        for (auto index = std::size_t{0u}; index < global_operated_qubits.size(); ++index)
+          swap_positions(global_operated_qubits[index], swap_qubits[index]);
+
+        return true;
+      }
+
+      // follows the permutation of a state if qubits are moved in other ways
+      auto assign(::bra::state::permutation_type const& permutation) -> void
+      {
+        for (auto qubit = ::bra::bit_integer_type{0u}; qubit < positions_.size(); ++qubit)
+        {
+          positions_[qubit] = static_cast< ::bra::bit_integer_type >(permutation[ket::make_qubit< ::bra::state_integer_type >(qubit)].qubit());
+          qubits_[positions_[qubit]] = qubit;
+        }
+      }
+
+     private:
+      auto swap_positions(::bra::bit_integer_type const qubit1, ::bra::bit_integer_type const qubit2) -> void
+      {
+        using std::swap;
+        swap(positions_[qubit1], positions_[qubit2]);
+        qubits_[positions_[qubit1]] = qubit1;
+        qubits_[positions_[qubit2]] = qubit2;
+      }
+    }; // class layout
+  } // namespace remapping_plan_detail
+
+  // Schedule of interchanges of qubits in simple MPI mode, which is made by scanning a whole circuit in advance.
+  // ket::mpi::utility::maybe_interchange_qubits makes global qubits of a gate local just before the gate, and local qubits to be global are chosen only by their positions.
+  // This plan chooses local qubits whose next uses are the furthest (Belady's algorithm),
+  // and also makes global qubits which are used soon local in the same interchange if BRA_MAX_NUM_INTERCHANGED_QUBITS allows.
+  // The chosen local qubits are moved to the positions to be global by swaps of local qubits, which are counted separately from interchanges.
+  // Jumps are not taken into account, that is, gates are assumed to be applied in the order of the circuit.
+  // operated_qubits should outlive the plan
+  class remapping_plan
+  {
+   public:
+    using qubits_type = std::vector< ::bra::qubit_type >;
+    using operated_qubits_type = std::vector<std::vector< ::bra::bit_integer_type >>;
+
+   private:
+    operated_qubits_type const& operated_qubits_;
+    ::bra::bit_integer_type num_qubits_;
+    ::bra::bit_integer_type num_local_qubits_;
+    std::vector<qubits_type> remapped_qubits_; // remapped_qubits_[gate_index] is empty if no interchange is planned before the gate
+    std::size_t num_greedy_interchanges_;
+    std::size_t num_planned_interchanges_;
+    std::size_t num_actual_interchanges_;
+    std::size_t num_greedy_local_swaps_;
+    std::size_t num_planned_local_swaps_;
+    ::bra::remapping_plan_detail::layout actual_layout_; // follows the permutation of the state to count actual local swaps
+    std::vector<bool> is_global_qubit_; // used to count actual interchanges
+
+   public:
+    remapping_plan(
+      operated_qubits_type const& operated_qubits,
+      ::bra::bit_integer_type const num_qubits, ::bra::bit_integer_type const num_local_qubits,
+      std::vector< ::bra::permutated_qubit_type > const& initial_permutation);
+
+    auto is_remapped_before(int const gate_index) const -> bool
+    { return static_cast<std::size_t>(gate_index) < remapped_qubits_.size() and not remapped_qubits_[gate_index].empty(); }
+    auto remapped_qubits(int const gate_index) const -> qubits_type const& { return remapped_qubits_[gate_index]; }
+
+    // predicted numbers of interchanges and local swaps without and with this plan
+    auto num_greedy_interchanges() const -> std::size_t { return num_greedy_interchanges_; }
+    auto num_planned_interchanges() const -> std::size_t { return num_planned_interchanges_; }
+    auto num_actual_interchanges() const -> std::size_t { return num_actual_interchanges_; }
+    auto num_greedy_local_swaps() const -> std::size_t { return num_greedy_local_swaps_; }
+    auto num_planned_local_swaps() const -> std::size_t { return num_planned_local_swaps_; }
+    auto num_actual_local_swaps() const -> std::size_t { return actual_layout_.num_local_swaps(); }
+
+    // count an interchange if global qubits are changed since the last call, and local swaps made by it,
+    // after the remapping before the gate_index-th gate and after the gate_index-th gate, respectively
+    auto observe_remapping(int const gate_index, ::bra::state::permutation_type const& permutation) -> void;
+    auto observe(int const gate_index, ::bra::state::permutation_type const& permutation) -> void;
+
+   private:
+    auto do_observe(
+      std::vector< ::bra::bit_integer_type > const& unswappable_qubits, ::bra::state::permutation_type const& permutation) -> void;
+  }; // class remapping_plan
+} // namespace bra
+
+
+# endif // BRA_NO_MPI
+
+#endif // BRA_REMAPPING_PLAN_HPP
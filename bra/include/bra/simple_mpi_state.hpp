@@ -99,8 +99,6 @@ namespace bra
       ::bra::state::state_integer_type const initial_integer,
       yampi::communicator const& circuit_communicator, yampi::environment const& environment) const;
 
-    auto generate_probability() -> real_type override;
-
     auto do_send_real_variable(int const circuit_index, std::string const& variable_name, int const num_elements) const -> void override;
     auto do_send_complex_variable(int const circuit_index, std::string const& variable_name, int const num_elements) const -> void override;
     auto do_send_int_variable(int const circuit_index, std::string const& variable_name, int const num_elements) const -> void override;
@@ -119,6 +117,7 @@ namespace bra
 
     unsigned int do_num_page_qubits() const override;
     unsigned int do_num_pages() const override;
+    void do_remap_qubits(std::vector<qubit_type> const& qubits) override;
 
     void do_i_gate(qubit_type const qubit) override;
     void do_ic_gate(control_qubit_type const control_qubit) override;
@@ -224,8 +223,10 @@ namespace bra
       std::vector<qubit_type> const& modular_exponentiation_qubits) override;
     void do_begin_fusion() override;
     void do_end_fusion() override;
+    void do_diagonal(::ket::gate::diagonal_accumulator<complex_type, state_integer_type> const& accumulator) override;
     void do_clear(qubit_type const qubit) override;
     void do_set(qubit_type const qubit) override;
+    auto do_local_amplitude_ranges() -> std::vector<std::pair<complex_type*, std::size_t>> override;
 
     void do_controlled_i_gate(
       qubit_type const target_qubit, control_qubit_type const control_qubit) override;
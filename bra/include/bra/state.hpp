@@ -2,6 +2,7 @@
 # define BRA_STATE_HPP
 
 # include <cstddef>
+# include <cstdint>
 # include <complex>
 # include <string>
 # include <vector>
@@ -21,6 +22,7 @@
 # include <ket/qubit.hpp>
 # include <ket/control.hpp>
 # include <ket/gate/projective_measurement.hpp>
+# include <ket/gate/diagonal.hpp>
 # include <ket/utility/generate_phase_coefficients.hpp>
 # ifndef BRA_NO_MPI
 #   include <ket/mpi/permutated.hpp>
@@ -95,6 +97,13 @@ namespace bra
     wrong_pauli_string_length_error(std::size_t const num_operated_qubits, std::size_t const pauli_string_length);
   }; // class wrong_pauli_string_length_error
 
+  class wrong_state_file_error
+    : public std::runtime_error
+  {
+   public:
+    wrong_state_file_error(std::string const& filename, std::string const& reason);
+  }; // class wrong_state_file_error
+
   namespace state_detail
   {
     template <typename StateInteger, typename BitInteger>
@@ -474,6 +483,8 @@ namespace bra
     ::bra::complex_type result_; // return value of ket(::mpi)::expectation_value, ket(::mpi)::inner_product, or ket(::mpi)::fidelity
     bool is_in_fusion_; // related to begin_fusion/end_fusion
     std::vector< ::bra::found_qubit > found_qubits_; // related to begin_fusion/end_fusion
+    bool is_accumulating_diagonal_gates_; // related to begin_diagonal_accumulation/end_diagonal_accumulation
+    ::ket::gate::diagonal_accumulator<complex_type, state_integer_type> diagonal_accumulator_; // related to begin_diagonal_accumulation/end_diagonal_accumulation
     int circuit_index_;
     mutable ::bra::wait_reason wait_reason_;
     random_number_generator_type random_number_generator_;
@@ -482,7 +493,13 @@ namespace bra
     real_type depolarizing_py_;
     real_type depolarizing_pz_;
     bool uses_depolarizing_seed_;
-    random_number_generator_type depolarizing_random_number_generator_;
+    seed_type noise_key_; // the key of the counter-based generator for the depolarizing channel
+    std::uint64_t noise_gate_index_; // the counter of the counter-based generator for the depolarizing channel
+    // The state is pauli_frame_phase_ (X^{x_0} Z^{z_0}) (X^{x_1} Z^{z_1}) ... applied to the state vector, where x_i (z_i) is the i-th bit of pauli_frame_x_mask_ (pauli_frame_z_mask_)
+    bool is_tracking_pauli_frame_; // related to track_pauli_frame
+    state_integer_type pauli_frame_x_mask_;
+    state_integer_type pauli_frame_z_mask_;
+    complex_type pauli_frame_phase_;
 # ifndef BRA_NO_MPI
 
     permutation_type permutation_;
@@ -491,6 +508,8 @@ namespace bra
     yampi::communicator const& intercircuit_communicator_;
     std::vector<yampi::intercommunicator> const& intercommunicators_;
     yampi::environment const& environment_;
+# else // BRA_NO_MPI
+    std::vector<qubit_type> physical_qubits_; // physical_qubits_[qubit]: the position of qubit in the state vector, which is changed by SWAP
 # endif // BRA_NO_MPI
 
     BRA_clock::time_point start_time_;
@@ -639,6 +658,14 @@ namespace bra
     boost::optional<std::string> const& maybe_label() const { return maybe_label_; }
     void delete_label() { maybe_label_ = boost::none; }
 
+    bool is_in_fusion() const { return is_in_fusion_; }
+
+    // If tracked, Pauli gates and Pauli noises are multiplied to a Pauli frame instead of being applied to the state vector.
+    // The frame is conjugated by H, S, S+, CNOT, CZ and SWAP, and it changes parameters of U1, T and EZ instead.
+    // It is applied to the operated qubits of other gates before them and to the whole state vector before the state is read
+    void track_pauli_frame(bool const is_tracking);
+    bool is_tracking_pauli_frame() const { return is_tracking_pauli_frame_; }
+    bool is_accumulating_diagonal_gates() const { return is_accumulating_diagonal_gates_; }
     auto is_waiting() const -> bool { return do_is_waiting(); }
     ::bra::wait_reason const& wait_reason() const { return wait_reason_; }
     void cancel_waiting() { do_cancel_waiting(); wait_reason_ = ::bra::wait_reason{::bra::wait_reason::no_wait_t{}}; }
@@ -652,6 +679,9 @@ namespace bra
 # ifndef BRA_NO_MPI
     unsigned int num_page_qubits() const { return do_num_page_qubits(); }
     unsigned int num_pages() const { return do_num_pages(); }
+
+    // makes all qubits local in one interchange of qubits
+    void remap_qubits(std::vector<qubit_type> const& qubits) { do_remap_qubits(qubits); }
 # endif // BRA_NO_MPI
 
    protected:
@@ -734,9 +764,11 @@ namespace bra
     state& u1(
       boost::variant<real_type, std::string> const& phase,
       control_qubit_type const control_qubit);
+    state& u1(real_type const phase, control_qubit_type const control_qubit);
     state& adj_u1(
       boost::variant<real_type, std::string> const& phase,
       control_qubit_type const control_qubit);
+    state& adj_u1(real_type const phase, control_qubit_type const control_qubit);
     state& u2(
       boost::variant<real_type, std::string> const& phase1,
       boost::variant<real_type, std::string> const& phase2,
@@ -804,9 +836,11 @@ namespace bra
     state& exponential_pauli_z(
       boost::variant<real_type, std::string> const& phase,
       qubit_type const qubit);
+    state& exponential_pauli_z(real_type const phase, qubit_type const qubit);
     state& adj_exponential_pauli_z(
       boost::variant<real_type, std::string> const& phase,
       qubit_type const qubit);
+    state& adj_exponential_pauli_z(real_type const phase, qubit_type const qubit);
     state& exponential_pauli_zz(
       boost::variant<real_type, std::string> const& phase,
       qubit_type const qubit1, qubit_type const qubit2);
@@ -852,9 +886,25 @@ namespace bra
     state& begin_fusion();
     state& end_fusion();
 
+    // Diagonal gates (Z, U1, CnU1, eZ...Z, ...) between them are gathered and applied in one sweep by end_diagonal_accumulation.
+    // begin_diagonal_accumulation does nothing in gate fusion or with noises, and diagonal gates are applied one by one then
+    state& begin_diagonal_accumulation();
+    state& end_diagonal_accumulation();
+
     state& clear(qubit_type const qubit);
     state& set(qubit_type const qubit);
 
+    // Binary snapshots of the state vector, the qubit permutation, the random number generators and the variables.
+    // next_instruction_index is the index of the instruction from which the circuit is resumed after loading the snapshot
+    state& save_state(std::string const& filename, int const next_instruction_index);
+    state& load_state(std::string const& filename);
+    state& load_state(std::string const& filename, int& next_instruction_index);
+
+   private:
+    auto generate_state_metadata(int const next_instruction_index) const -> std::string;
+    auto restore_state_metadata(std::string const& filename, std::string const& metadata) -> int;
+
+   public:
     state& controlled_i_gate(qubit_type const target_qubit, control_qubit_type const control_qubit);
     state& controlled_ic_gate(control_qubit_type const control_qubit1, control_qubit_type const control_qubit2);
     state& multi_controlled_in_gate(std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits);
@@ -900,9 +950,11 @@ namespace bra
     state& controlled_u1(
       boost::variant<real_type, std::string> const& phase,
       control_qubit_type const control_qubit1, control_qubit_type const control_qubit2);
+    state& controlled_u1(real_type const phase, control_qubit_type const control_qubit1, control_qubit_type const control_qubit2);
     state& adj_controlled_u1(
       boost::variant<real_type, std::string> const& phase,
       control_qubit_type const control_qubit1, control_qubit_type const control_qubit2);
+    state& adj_controlled_u1(real_type const phase, control_qubit_type const control_qubit1, control_qubit_type const control_qubit2);
     state& multi_controlled_u1(
       boost::variant<real_type, std::string> const& phase,
       std::vector<control_qubit_type> const& control_qubits);
@@ -1003,23 +1055,92 @@ namespace bra
       qubit_type const target_qubit1, qubit_type const target_qubit2, std::vector<control_qubit_type> const& control_qubits);
 
    protected:
-    auto apply_noise(qubit_type const qubit) -> void;
-    auto apply_noise(control_qubit_type const control_qubit) -> void { apply_noise(control_qubit.qubit()); }
+    auto apply_noise(qubit_type const qubit) -> void { apply_noises(qubit); }
+    auto apply_noise(control_qubit_type const control_qubit) -> void { apply_noises(control_qubit.qubit()); }
+
+    // Noises of a gate are determined by (noise_key_, noise_gate_index_, qubit), so all processes get the same noises without communication
+    template <typename... Qubits>
+    auto apply_noises(Qubits const&... qubits) -> void
+    {
+      if (not is_depolarizing_channel_)
+        return;
+
+      apply_noise_to_each_qubit(qubits...);
+      ++noise_gate_index_;
+    }
 
-    auto apply_noises() -> void { }
+   private:
+    auto apply_noise_to_qubit(qubit_type const qubit) -> void;
+    auto apply_noise_to_qubit(control_qubit_type const control_qubit) -> void { apply_noise_to_qubit(control_qubit.qubit()); }
+
+    auto apply_noise_to_each_qubit() -> void { }
     template <typename Qubit, typename... Qubits>
-    auto apply_noises(Qubit const qubit, Qubits const... qubits) -> void
-    { apply_noise(qubit); apply_noises(qubits...); }
+    auto apply_noise_to_each_qubit(Qubit const qubit, Qubits const&... qubits) -> void
+    { apply_noise_to_qubit(qubit); apply_noise_to_each_qubit(qubits...); }
     template <typename Qubit, typename Allocator, typename... Qubits>
-    auto apply_noises(std::vector<Qubit, Allocator> const& qubit_sequence, Qubits const... qubits) -> void
+    auto apply_noise_to_each_qubit(std::vector<Qubit, Allocator> const& qubit_sequence, Qubits const&... qubits) -> void
     {
       for (auto const qubit: qubit_sequence)
-        apply_noise(qubit);
-      apply_noises(qubits...);
+        apply_noise_to_qubit(qubit);
+      apply_noise_to_each_qubit(qubits...);
     }
 
-   private:
-    virtual auto generate_probability() -> real_type = 0;
+    auto generate_probability(qubit_type const qubit) const -> real_type;
+
+    // Qubits are passed to do_ functions as their positions in the state vector.
+    // In the MPI version, the positions are held in permutation_ and resolved by ket::mpi
+# ifndef BRA_NO_MPI
+    auto physical(qubit_type const qubit) const -> qubit_type { return qubit; }
+    auto physical(control_qubit_type const control_qubit) const -> control_qubit_type { return control_qubit; }
+    template <typename Qubit>
+    auto physical(std::vector<Qubit> const& qubits) const -> std::vector<Qubit> const& { return qubits; }
+    auto resolve_physical_qubits() -> void { }
+# else // BRA_NO_MPI
+    auto physical(qubit_type const qubit) const -> qubit_type { return physical_qubits_[static_cast<bit_integer_type>(qubit)]; }
+    auto physical(control_qubit_type const control_qubit) const -> control_qubit_type { return ket::make_control(physical(control_qubit.qubit())); }
+    template <typename Qubit>
+    auto physical(std::vector<Qubit> const& qubits) const -> std::vector<Qubit>
+    {
+      auto result = qubits;
+      for (auto& qubit: result)
+        qubit = physical(qubit);
+      return result;
+    }
+
+    // moves amplitudes so that each qubit is at its own position, before the whole state vector is read or written
+    auto resolve_physical_qubits() -> void;
+# endif // BRA_NO_MPI
+
+    auto is_absorbing_paulis() const -> bool { return is_tracking_pauli_frame_ and not is_in_fusion_; }
+    auto is_flipped_by_pauli_frame(qubit_type const qubit) const -> bool
+    { return (pauli_frame_x_mask_ bitand (state_integer_type{1u} << static_cast<bit_integer_type>(qubit))) != state_integer_type{0u}; }
+    auto absorb_pauli_x(qubit_type const qubit) -> void;
+    auto absorb_pauli_y(qubit_type const qubit) -> void;
+    auto absorb_pauli_z(qubit_type const qubit) -> void;
+    auto conjugate_pauli_frame_by_hadamard(qubit_type const qubit) -> void;
+    auto conjugate_pauli_frame_by_sqrt_pauli_z(qubit_type const qubit, complex_type const& phase_if_flipped) -> void;
+    auto conjugate_pauli_frame_by_controlled_not(qubit_type const target_qubit, qubit_type const control_qubit) -> void;
+    auto conjugate_pauli_frame_by_controlled_pauli_z(qubit_type const qubit1, qubit_type const qubit2) -> void;
+    auto conjugate_pauli_frame_by_swap(qubit_type const qubit1, qubit_type const qubit2) -> void;
+
+    // applies the whole Pauli frame to the state vector
+    auto materialize_pauli_frame() -> void;
+
+    // applies the factors of the Pauli frame on the qubits to the state vector, which are left out of the frame
+    auto materialize_pauli_frame_on_qubit(qubit_type const qubit) -> void;
+    auto materialize_pauli_frame_on_qubit(control_qubit_type const control_qubit) -> void { materialize_pauli_frame_on_qubit(control_qubit.qubit()); }
+
+    auto materialize_pauli_frame_on() -> void { }
+    template <typename Qubit, typename... Qubits>
+    auto materialize_pauli_frame_on(Qubit const qubit, Qubits const&... qubits) -> void
+    { materialize_pauli_frame_on_qubit(qubit); materialize_pauli_frame_on(qubits...); }
+    template <typename Qubit, typename Allocator, typename... Qubits>
+    auto materialize_pauli_frame_on(std::vector<Qubit, Allocator> const& qubit_sequence, Qubits const&... qubits) -> void
+    {
+      for (auto const qubit: qubit_sequence)
+        materialize_pauli_frame_on_qubit(qubit);
+      materialize_pauli_frame_on(qubits...);
+    }
 
     virtual auto do_is_waiting() const -> bool { return false; }
     virtual auto do_cancel_waiting() -> void { }
@@ -1043,6 +1164,7 @@ namespace bra
 # ifndef BRA_NO_MPI
     virtual unsigned int do_num_page_qubits() const = 0;
     virtual unsigned int do_num_pages() const = 0;
+    virtual void do_remap_qubits(std::vector<qubit_type> const&) { }
 
 # endif
     virtual void do_i_gate(qubit_type const qubit) = 0;
@@ -1158,8 +1280,11 @@ namespace bra
       std::vector<qubit_type> const& modular_exponentiation_qubits) = 0;
     virtual void do_begin_fusion() = 0;
     virtual void do_end_fusion() = 0;
+    virtual void do_diagonal(::ket::gate::diagonal_accumulator<complex_type, state_integer_type> const& accumulator) = 0;
     virtual void do_clear(qubit_type const qubit) = 0;
     virtual void do_set(qubit_type const qubit) = 0;
+    // contiguous ranges of local amplitudes in ascending order of their local indices
+    virtual auto do_local_amplitude_ranges() -> std::vector<std::pair<complex_type*, std::size_t>> = 0;
 
     virtual void do_controlled_i_gate(
       qubit_type const target_qubit, control_qubit_type const control_qubit) = 0;
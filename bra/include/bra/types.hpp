@@ -7,6 +7,7 @@
 
 # include <ket/qubit.hpp>
 # include <ket/control.hpp>
+# include <ket/utility/first_touch_allocator.hpp>
 # ifndef BRA_NO_MPI
 #   include <ket/mpi/permutated.hpp>
 #   include <ket/mpi/state.hpp>
@@ -40,9 +41,10 @@ namespace bra
   using complex_type = std::complex<real_type>;
   using int_type = int;
 
-  using data_type = std::vector<complex_type>;
+  // Amplitudes are left uninitialized on allocation and filled by the threads applying gates to them
+  using data_type = std::vector<complex_type, ket::utility::first_touch_allocator<complex_type>>;
 # ifndef BRA_NO_MPI
-  using paged_data_type = ket::mpi::state<complex_type, true>;
+  using paged_data_type = ket::mpi::state<complex_type, true, ket::utility::first_touch_allocator<complex_type>>;
 # endif // BRA_NO_MPI
 } // namespace bra
 
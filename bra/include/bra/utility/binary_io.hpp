@@ -0,0 +1,109 @@
+#ifndef BRA_UTILITY_BINARY_IO_HPP
+# define BRA_UTILITY_BINARY_IO_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <cstring>
+# include <string>
+# include <vector>
+# include <memory>
+# include <type_traits>
+
+
+namespace bra
+{
+  namespace utility
+  {
+    // Values are written as they are in the native byte order, and strings and arrays are preceded by their sizes as std::uint64_t.
+    // This format is shared by bytecode files and state files
+    namespace binary_io
+    {
+      template <typename Value>
+      inline auto write(std::string& bytes, Value const& value) -> void
+      {
+        static_assert(std::is_trivially_copyable<Value>::value, "Value should be trivially copyable");
+        bytes.append(reinterpret_cast<char const*>(std::addressof(value)), sizeof(Value));
+      }
+
+      inline auto write_string(std::string& bytes, std::string const& value) -> void
+      {
+        ::bra::utility::binary_io::write(bytes, static_cast<std::uint64_t>(value.size()));
+        bytes.append(value);
+      }
+
+      template <typename Value>
+      inline auto write_array(std::string& bytes, Value const* const first, std::size_t const size) -> void
+      {
+        static_assert(std::is_trivially_copyable<Value>::value, "Value should be trivially copyable");
+        ::bra::utility::binary_io::write(bytes, static_cast<std::uint64_t>(size));
+        bytes.append(reinterpret_cast<char const*>(first), size * sizeof(Value));
+      }
+
+      // Reads values written by the above functions from [data, data + size), and throws Error{filename, reason} at the end of data
+      template <typename Error>
+      class reader
+      {
+        std::string const& filename_;
+        char const* data_;
+        std::size_t size_;
+        std::size_t position_;
+
+       public:
+        reader(std::string const& filename, char const* const data, std::size_t const size)
+          : filename_{filename}, data_{data}, size_{size}, position_{0u}
+        { }
+
+        auto ensure(std::uint64_t const size) const -> void
+        {
+          if (size > static_cast<std::uint64_t>(size_ - position_))
+            throw Error{filename_, "unexpected end of data"};
+        }
+
+        auto read_bytes(void* const first, std::uint64_t const size) -> void
+        {
+          ensure(size);
+          if (size == 0u)
+            return;
+
+          std::memcpy(first, data_ + position_, static_cast<std::size_t>(size));
+          position_ += static_cast<std::size_t>(size);
+        }
+
+        template <typename Value>
+        auto read() -> Value
+        {
+          static_assert(std::is_trivially_copyable<Value>::value, "Value should be trivially copyable");
+          auto result = Value{};
+          read_bytes(std::addressof(result), sizeof(Value));
+          return result;
+        }
+
+        auto read_string() -> std::string
+        {
+          auto const size = read<std::uint64_t>();
+          ensure(size);
+          auto result = std::string{data_ + position_, static_cast<std::size_t>(size)};
+          position_ += static_cast<std::size_t>(size);
+          return result;
+        }
+
+        template <typename Value>
+        auto read_array(std::vector<Value>& values) -> void
+        {
+          static_assert(std::is_trivially_copyable<Value>::value, "Value should be trivially copyable");
+          auto const size = read<std::uint64_t>();
+          if (size > static_cast<std::uint64_t>(size_ - position_) / sizeof(Value))
+            throw Error{filename_, "unexpected end of data"};
+
+          values.resize(static_cast<std::size_t>(size));
+          read_bytes(values.data(), size * sizeof(Value));
+        }
+
+        auto is_end() const -> bool { return position_ == size_; }
+      }; // class reader<Error>
+    } // namespace binary_io
+  } // namespace utility
+} // namespace bra
+
+
+#endif // BRA_UTILITY_BINARY_IO_HPP
@@ -0,0 +1,73 @@
+#ifndef BRA_UTILITY_PHILOX_HPP
+# define BRA_UTILITY_PHILOX_HPP
+
+# include <cstdint>
+# include <array>
+
+
+namespace bra
+{
+  namespace utility
+  {
+    // Philox4x32-10 counter-based random number generator (Salmon et al., SC'11).
+    // The same (counter, key) pair always gives the same four 32-bit random numbers, so no state has to be shared among processes.
+    namespace philox_detail
+    {
+      inline auto multiply_high_low(std::uint32_t const lhs, std::uint32_t const rhs, std::uint32_t& high) -> std::uint32_t
+      {
+        auto const product = static_cast<std::uint64_t>(lhs) * static_cast<std::uint64_t>(rhs);
+        high = static_cast<std::uint32_t>(product >> 32u);
+        return static_cast<std::uint32_t>(product);
+      }
+
+      inline auto round(std::array<std::uint32_t, 4u> const& counter, std::array<std::uint32_t, 2u> const& key)
+      -> std::array<std::uint32_t, 4u>
+      {
+        auto high0 = std::uint32_t{};
+        auto const low0 = multiply_high_low(std::uint32_t{0xD2511F53u}, counter[0u], high0);
+        auto high1 = std::uint32_t{};
+        auto const low1 = multiply_high_low(std::uint32_t{0xCD9E8D57u}, counter[2u], high1);
+
+        return {high1 xor counter[1u] xor key[0u], low1, high0 xor counter[3u] xor key[1u], low0};
+      }
+    } // namespace philox_detail
+
+    inline auto philox4x32_10(std::array<std::uint32_t, 4u> counter, std::array<std::uint32_t, 2u> key)
+    -> std::array<std::uint32_t, 4u>
+    {
+      constexpr auto num_rounds = 10;
+      for (auto round_index = 0; round_index < num_rounds; ++round_index)
+      {
+        if (round_index > 0)
+        {
+          key[0u] += std::uint32_t{0x9E3779B9u};
+          key[1u] += std::uint32_t{0xBB67AE85u};
+        }
+
+        counter = ::bra::utility::philox_detail::round(counter, key);
+      }
+
+      return counter;
+    }
+
+    // Returns a uniform random number in [0, 1) with 53 random bits
+    template <typename FloatingPoint>
+    inline auto philox_canonical(std::uint64_t const counter_high, std::uint64_t const counter_low, std::uint64_t const key)
+    -> FloatingPoint
+    {
+      auto const random_numbers
+        = ::bra::utility::philox4x32_10(
+            {static_cast<std::uint32_t>(counter_low), static_cast<std::uint32_t>(counter_low >> 32u),
+             static_cast<std::uint32_t>(counter_high), static_cast<std::uint32_t>(counter_high >> 32u)},
+            {static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32u)});
+
+      auto const bits
+        = ((static_cast<std::uint64_t>(random_numbers[0u]) << 32u) bitor static_cast<std::uint64_t>(random_numbers[1u])) >> 11u;
+      constexpr auto two_to_the_minus_53 = 1.0 / 9007199254740992.0;
+      return static_cast<FloatingPoint>(static_cast<double>(bits) * two_to_the_minus_53);
+    }
+  } // namespace utility
+} // namespace bra
+
+
+#endif // BRA_UTILITY_PHILOX_HPP
@@ -9,6 +9,7 @@
 #include <bra/gate/gate.hpp>
 #include <bra/gate/adj_t_gate.hpp>
 #include <bra/state.hpp>
+#include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -34,5 +35,15 @@ namespace bra
         << std::setw(parameter_width) << control_qubit_;
       return repr_stream.str();
     }
+
+    bool adj_t_gate::do_lower(::bra::instruction& instruction) const
+    {
+      instruction
+        = ::bra::instruction{
+            ::bra::opcode::adj_t_gate, do_is_diagonal(),
+            {static_cast< ::bra::bit_integer_type >(control_qubit_.qubit()), 0u},
+            ::bra::real_type{}};
+      return true;
+    }
   } // namespace gate
 } // namespace bra
@@ -19,19 +19,27 @@
 # include <yampi/communicator.hpp>
 # include <yampi/rank.hpp>
 # include <yampi/scatter.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/broadcast.hpp>
 # include <yampi/wall_clock.hpp>
 #endif
 
 #include <ket/utility/integer_exp2.hpp>
 #include <ket/utility/integer_log2.hpp>
+#include <ket/utility/num_on_cache_qubits.hpp>
 
 #include <bra/interpreter.hpp>
+#include <bra/bytecode.hpp>
 #include <bra/state.hpp>
+#include <bra/types.hpp>
+#include <bra/profiler.hpp>
 #ifndef BRA_NO_MPI
 # include <bra/make_simple_mpi_state.hpp>
 # include <bra/make_unit_mpi_state.hpp>
+# include <bra/remapping_plan.hpp>
 #else
 # include <bra/nompi_state.hpp>
+# include <bra/circuit_scheduler.hpp>
 #endif
 
 
@@ -64,13 +72,23 @@ int main(int argc, char* argv[])
     ("m,mode", "set mode, \"simple\" or \"unit\"", cxxopts::value<std::string>()->default_value("simple"))
     ("f,file", "set the name of input qcx file, or read from standard input if this option is unspecified", cxxopts::value<std::string>())
 #ifdef BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
-    ("buffer-size", "set the number of complex numbers in buffer (meaningful only if the value of page-qubits is 0)", cxxopts::value<unsigned int>()->default_value("65536"))
+    ("buffer-size", "set the number of complex numbers in buffer, which is divided into chunks of pipelined communications (meaningful only if the value of page-qubits is 0)", cxxopts::value<unsigned int>()->default_value("65536"))
 #endif // BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
     ("unit-qubits", "set the number of unit qubits (meaningful only for unit mode)", cxxopts::value<unsigned int>())
     ("unit-processes", "set the number of MPI processes for each unit (meaningful only for unit mode)", cxxopts::value<unsigned int>())
     ("threads", "set the number of threads per process", cxxopts::value<unsigned int>()->default_value("1"))
     ("page-qubits", "set the number of page qubits", cxxopts::value<unsigned int>()->default_value("2"))
+    ("pauli-frame", "track Pauli gates and Pauli errors of the depolarizing channel in a Pauli frame instead of applying them to the state vector")
+    ("on-cache-qubits", "set the number of qubits whose amplitudes are treated as on cache, which is detected from the cache size if this option is unspecified", cxxopts::value<unsigned int>())
+    ("fusion-qubits", "put runs of gates into gate fusion blocks operating at most the given number of qubits (reduced to the number of qubits any gate may operate), where commuting gates may be reordered (gates on global qubits are not fused)", cxxopts::value<unsigned int>())
+    ("plan-remapping", "plan interchanges of qubits by looking ahead the circuit, and print predicted and actual numbers of interchanges and swaps of local qubits (meaningful only for simple mode)")
     ("seed", "set seed of random number generator", cxxopts::value<seed_type>()->default_value("1"))
+    ("checkpoint-every", "save the state into the checkpoint file every given number of instructions (no checkpoint if 0)", cxxopts::value<int>()->default_value("0"))
+    ("checkpoint-file", "set the name of checkpoint file, which is suffixed by \".<circuit index>\" if there are two or more circuits", cxxopts::value<std::string>()->default_value("bra.checkpoint"))
+    ("restart", "load the checkpoint file and resume the circuit from the saved instruction")
+    ("streaming", "read gates of the input qcx file while applying them instead of reading all gates in advance (--file is required)")
+    ("compile", "save circuits into the given bytecode file and exit, and the bytecode file is loaded by --file without parsing", cxxopts::value<std::string>())
+    ("profile", "measure compute, interchange and barrier times and moved bytes for each kind of gate, and save them with fusion statistics into the given file (JSON if its name ends with \".json\", CSV otherwise), which is suffixed by \".<circuit index>\" if there are two or more circuits", cxxopts::value<std::string>())
     ("h,help", "print this information")
     ;
 #else // BRA_NO_MPI
@@ -78,7 +96,17 @@ int main(int argc, char* argv[])
   options.add_options()
     ("f,file", "set the name of input qcx file, or read from standard input if this option is unspecified", cxxopts::value<std::string>())
     ("threads", "set the number of threads", cxxopts::value<unsigned int>()->default_value("1"))
+    ("concurrent-circuits", "set the number of circuits applied concurrently, among which threads are divided (meaningful only if there are two or more circuits)", cxxopts::value<unsigned int>()->default_value("1"))
+    ("pauli-frame", "track Pauli gates and Pauli errors of the depolarizing channel in a Pauli frame instead of applying them to the state vector")
+    ("on-cache-qubits", "set the number of qubits whose amplitudes are treated as on cache, which is detected from the cache size if this option is unspecified", cxxopts::value<unsigned int>())
+    ("fusion-qubits", "put runs of gates into gate fusion blocks operating at most the given number of qubits (reduced to the number of qubits any gate may operate), where commuting gates may be reordered", cxxopts::value<unsigned int>())
     ("seed", "set seed of random number generator", cxxopts::value<seed_type>()->default_value("1"))
+    ("checkpoint-every", "save the state into the checkpoint file every given number of instructions (no checkpoint if 0)", cxxopts::value<int>()->default_value("0"))
+    ("checkpoint-file", "set the name of checkpoint file, which is suffixed by \".<circuit index>\" if there are two or more circuits", cxxopts::value<std::string>()->default_value("bra.checkpoint"))
+    ("restart", "load the checkpoint file and resume the circuit from the saved instruction")
+    ("streaming", "read gates of the input qcx file while applying them instead of reading all gates in advance (--file is required)")
+    ("compile", "save circuits into the given bytecode file and exit, and the bytecode file is loaded by --file without parsing", cxxopts::value<std::string>())
+    ("profile", "measure compute time for each kind of gate, and save it with fusion statistics into the given file (JSON if its name ends with \".json\", CSV otherwise)", cxxopts::value<std::string>())
     ("h,help", "print this information")
     ;
 #endif // BRA_NO_MPI
@@ -143,6 +171,44 @@ int main(int argc, char* argv[])
 #endif // BRA_NO_MPI
 
   auto const num_threads_per_process = parse_result["threads"].as<unsigned int>();
+
+  // The number of on-cache qubits is detected from the cache topology in sysfs, or measured by a microbenchmark if it is unavailable
+  if (parse_result.count("on-cache-qubits"))
+  {
+    auto const num_on_cache_qubits = parse_result["on-cache-qubits"].as<unsigned int>();
+    if (num_on_cache_qubits == 0u)
+    {
+#ifndef BRA_NO_MPI
+      if (is_io_root_rank)
+        std::cerr << "Error: on-cache-qubits should be greater than 0\n" << options.help() << std::flush;
+#else // BRA_NO_MPI
+      std::cerr << "Error: on-cache-qubits should be greater than 0\n" << options.help() << std::flush;
+#endif // BRA_NO_MPI
+      return EXIT_FAILURE;
+    }
+
+    ket::utility::set_num_on_cache_qubits(num_on_cache_qubits);
+  }
+  else
+  {
+#ifndef BRA_NO_MPI
+    // The root decides the number because the checks and the fusion below depend on it and every process should go the same way
+    constexpr auto root_rank = yampi::rank{0};
+    auto num_on_cache_qubits = 0u;
+    if (world_rank == root_rank)
+    {
+      num_on_cache_qubits = ket::utility::detect_num_on_cache_qubits(sizeof(bra::complex_type));
+      if (num_on_cache_qubits == 0u)
+        num_on_cache_qubits = ket::utility::tune_num_on_cache_qubits<bra::complex_type>(10u, 22u);
+    }
+    yampi::broadcast(yampi::make_buffer(num_on_cache_qubits), root_rank, world_communicator, environment);
+    ket::utility::set_num_on_cache_qubits(num_on_cache_qubits);
+#else // BRA_NO_MPI
+    auto const num_on_cache_qubits = ket::utility::detect_num_on_cache_qubits(sizeof(bra::complex_type));
+    ket::utility::set_num_on_cache_qubits(
+      num_on_cache_qubits > 0u ? num_on_cache_qubits : ket::utility::tune_num_on_cache_qubits<bra::complex_type>(10u, 22u));
+#endif // BRA_NO_MPI
+  }
   auto const given_seed = parse_result["seed"].as<seed_type>();
 
   std::ifstream possible_input_stream;
@@ -165,15 +231,84 @@ int main(int argc, char* argv[])
     }
   }
 
+  auto const is_streaming = parse_result.count("streaming") > 0u;
+  auto const is_bytecode = parse_result.count("file") > 0u and bra::is_bytecode_file(parse_result["file"].as<std::string>());
+#ifndef BRA_NO_MPI
+  if (is_streaming
+      and ((not parse_result.count("file")) or is_bytecode or parse_result.count("compile")
+           or parse_result["checkpoint-every"].as<int>() > 0 or parse_result.count("restart") or parse_result.count("plan-remapping")
+           or parse_result.count("fusion-qubits")))
+  {
+    if (is_io_root_rank)
+      std::cerr << "Error: streaming requires qcx file, and cannot be used with compile, checkpoint-every, restart, plan-remapping or fusion-qubits\n" << options.help() << std::flush;
+    return EXIT_FAILURE;
+  }
+#else // BRA_NO_MPI
+  if (is_streaming
+      and ((not parse_result.count("file")) or is_bytecode or parse_result.count("compile")
+           or parse_result["checkpoint-every"].as<int>() > 0 or parse_result.count("restart") or parse_result.count("fusion-qubits")))
+  {
+    std::cerr << "Error: streaming requires qcx file, and cannot be used with compile, checkpoint-every, restart or fusion-qubits\n" << options.help() << std::flush;
+    return EXIT_FAILURE;
+  }
+
+  auto const num_given_concurrent_circuits = parse_result["concurrent-circuits"].as<unsigned int>();
+  if (num_given_concurrent_circuits == 0u)
+  {
+    std::cerr << "Error: concurrent-circuits should be greater than 0\n" << options.help() << std::flush;
+    return EXIT_FAILURE;
+  }
+  if (num_given_concurrent_circuits > 1u and (is_streaming or parse_result.count("profile")))
+  {
+    std::cerr << "Error: concurrent-circuits cannot be used with streaming or profile\n" << options.help() << std::flush;
+    return EXIT_FAILURE;
+  }
+  // Outputs of concurrent circuits are written by one call of operator<< each, which does not race if std::cout is synchronized with stdio
+  if (num_given_concurrent_circuits > 1u)
+    std::ios::sync_with_stdio(true);
+#endif // BRA_NO_MPI
+
 
 #ifndef BRA_NO_MPI
-  auto interpreter = bra::interpreter{parse_result.count("file") ? possible_input_stream : std::cin, num_unit_qubits, num_processes_per_unit, environment, 0_r, world_communicator};
+  auto interpreter
+    = is_streaming
+      ? bra::interpreter{parse_result["file"].as<std::string>(), bra::streaming, num_unit_qubits, num_processes_per_unit, environment, 0_r, world_communicator}
+      : is_bytecode
+        ? bra::interpreter{parse_result["file"].as<std::string>(), bra::bytecode, num_unit_qubits, num_processes_per_unit, environment, 0_r, world_communicator}
+        : bra::interpreter{parse_result.count("file") ? possible_input_stream : std::cin, num_unit_qubits, num_processes_per_unit, environment, 0_r, world_communicator};
+  if (parse_result.count("compile"))
+  {
+    if (is_io_root_rank)
+      interpreter.save_bytecode(parse_result["compile"].as<std::string>());
+    return EXIT_SUCCESS;
+  }
+  // Fused blocks are limited to the numbers of qubits checked below, so that a valid circuit is not rejected because of its fusion
+  if (parse_result.count("fusion-qubits"))
+  {
+    auto max_num_fused_qubits
+      = std::min(
+          static_cast<bra::bit_integer_type>(parse_result["fusion-qubits"].as<unsigned int>()),
+          static_cast<bra::bit_integer_type>(interpreter.num_lqubits() - num_page_qubits));
+#ifdef KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
+    max_num_fused_qubits = std::min(max_num_fused_qubits, static_cast<bra::bit_integer_type>(ket::utility::num_on_cache_qubits() - 1u));
+#endif // KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
+    interpreter.plan_fusion(max_num_fused_qubits);
+  }
+
   if (interpreter.largest_num_operated_qubits() > interpreter.num_lqubits() - num_page_qubits)
   {
     if (is_io_root_rank)
       std::cerr << "Error: the largest number of operated qubits " << interpreter.largest_num_operated_qubits() << " should be less than the number of non-page qubits " << (interpreter.num_lqubits() - num_page_qubits) << '\n' << options.help() << std::flush;
     return EXIT_FAILURE;
   }
+#ifdef KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
+  if (interpreter.largest_num_operated_qubits() >= ket::utility::num_on_cache_qubits())
+  {
+    if (is_io_root_rank)
+      std::cerr << "Error: the largest number of operated qubits " << interpreter.largest_num_operated_qubits() << " should be less than the number of on-cache qubits " << ket::utility::num_on_cache_qubits() << '\n' << options.help() << std::flush;
+    return EXIT_FAILURE;
+  }
+#endif // KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
 
   auto const num_circuits = interpreter.num_circuits();
   if (num_processes % num_circuits != 0u)
@@ -283,18 +418,85 @@ int main(int argc, char* argv[])
           interpreter.is_depolarizing_channel(), interpreter.depolarizing_px(), interpreter.depolarizing_py(), interpreter.depolarizing_pz(), interpreter.depolarizing_seed() > 0, depolarizing_seed,
           num_elements_in_buffer, circuit_communicator, intercircuit_communicator, circuit_index, intercommunicators, environment);
 # endif // BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
+  state_ptr->track_pauli_frame(parse_result.count("pauli-frame") > 0u);
+
+  interpreter.checkpoint(parse_result["checkpoint-every"].as<int>(), parse_result["checkpoint-file"].as<std::string>());
+  if (parse_result.count("restart"))
+    interpreter.restart_circuit(*state_ptr, circuit_index);
+
+  auto profiler_ptr = std::unique_ptr<bra::profiler>{};
+  if (parse_result.count("profile"))
+  {
+    profiler_ptr = std::make_unique<bra::profiler>(num_circuits);
+    interpreter.profile(*profiler_ptr);
+  }
+
+  if (is_simple and parse_result.count("plan-remapping"))
+  {
+    auto plan
+      = bra::remapping_plan{
+          interpreter.operated_qubits(circuit_index), interpreter.num_qubits(), interpreter.num_lqubits(), interpreter.initial_permutation()};
+    interpreter.apply_circuit(*state_ptr, circuit_index, plan);
+
+    if (is_io_root_rank)
+      std::cout
+        << "Interchanges of qubits: " << plan.num_actual_interchanges()
+        << " (predicted: " << plan.num_planned_interchanges() << ", predicted without plan: " << plan.num_greedy_interchanges() << ")\n"
+        << "Swaps of local qubits: " << plan.num_actual_local_swaps()
+        << " (predicted: " << plan.num_planned_local_swaps() << ", predicted without plan: " << plan.num_greedy_local_swaps() << ")"
+        << std::endl;
+  }
+  else
+    interpreter.apply_circuit(*state_ptr, circuit_index);
 
-  interpreter.apply_circuit(*state_ptr, circuit_index);
+  // All processes of the circuit take part in writing the profile
+  if (profiler_ptr)
+  {
+    auto const profile_filename = parse_result["profile"].as<std::string>();
+    profiler_ptr->write(
+      num_circuits <= 1u ? profile_filename : profile_filename + "." + std::to_string(circuit_index),
+      circuit_index, circuit_communicator, environment);
+  }
 
   if (not is_io_root_rank)
     return EXIT_SUCCESS;
 #else // BRA_NO_MPI
-  auto interpreter = bra::interpreter{parse_result.count("file") ? possible_input_stream : std::cin};
+  auto interpreter
+    = is_streaming
+      ? bra::interpreter{parse_result["file"].as<std::string>(), bra::streaming}
+      : is_bytecode
+        ? bra::interpreter{parse_result["file"].as<std::string>(), bra::bytecode}
+        : bra::interpreter{parse_result.count("file") ? possible_input_stream : std::cin};
+  if (parse_result.count("compile"))
+  {
+    interpreter.save_bytecode(parse_result["compile"].as<std::string>());
+    return EXIT_SUCCESS;
+  }
+  // Fused blocks are limited to the numbers of qubits checked below, so that a valid circuit is not rejected because of its fusion
+  if (parse_result.count("fusion-qubits"))
+  {
+    auto max_num_fused_qubits
+      = std::min(
+          static_cast<bra::bit_integer_type>(parse_result["fusion-qubits"].as<unsigned int>()),
+          static_cast<bra::bit_integer_type>(interpreter.num_qubits()));
+#ifdef KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
+    max_num_fused_qubits = std::min(max_num_fused_qubits, static_cast<bra::bit_integer_type>(ket::utility::num_on_cache_qubits() - 1u));
+#endif // KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
+    interpreter.plan_fusion(max_num_fused_qubits);
+  }
+
   if (interpreter.largest_num_operated_qubits() > interpreter.num_qubits())
   {
     std::cerr << "Error: the largest number of operated qubits " << interpreter.largest_num_operated_qubits() << " should be less than the number of qubits " << interpreter.num_qubits() << '\n' << options.help() << std::flush;
     return EXIT_FAILURE;
   }
+#ifdef KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
+  if (interpreter.largest_num_operated_qubits() >= ket::utility::num_on_cache_qubits())
+  {
+    std::cerr << "Error: the largest number of operated qubits " << interpreter.largest_num_operated_qubits() << " should be less than the number of on-cache qubits " << ket::utility::num_on_cache_qubits() << '\n' << options.help() << std::flush;
+    return EXIT_FAILURE;
+  }
+#endif // KET_ENABLE_CACHE_AWARE_GATE_FUNCTION
 
   auto const num_circuits = interpreter.num_circuits();
   auto seed_generator = rng_type{given_seed};
@@ -312,23 +514,47 @@ int main(int argc, char* argv[])
         return result;
       };
 
+  // Circuits are applied concurrently by groups of threads, and gates of each circuit are applied by threads of its group
+  auto const num_concurrent_circuits = std::min(num_given_concurrent_circuits, static_cast<unsigned int>(num_circuits));
+  auto const num_threads_per_circuit = std::max(1u, num_threads_per_process / num_concurrent_circuits);
+  bra::circuit_scheduler scheduler{static_cast<int>(num_concurrent_circuits), num_threads_per_circuit};
+
   auto nompi_states = std::vector< ::bra::nompi_state >{};
   nompi_states.reserve(num_circuits);
   nompi_states.emplace_back(
-    interpreter.initial_state_value(), interpreter.num_qubits(), num_threads_per_process, given_seed,
+    interpreter.initial_state_value(), interpreter.num_qubits(), num_threads_per_circuit, given_seed,
     interpreter.is_depolarizing_channel(), interpreter.depolarizing_px(), interpreter.depolarizing_py(), interpreter.depolarizing_pz(), interpreter.depolarizing_seed() > 0, static_cast<seed_type>(interpreter.depolarizing_seed()),
     0);
   for (auto circuit_index = 1; circuit_index < static_cast<int>(num_circuits); ++circuit_index)
     nompi_states.emplace_back(
-      interpreter.initial_state_value(), interpreter.num_qubits(), num_threads_per_process, seed_generator(),
+      interpreter.initial_state_value(), interpreter.num_qubits(), num_threads_per_circuit, seed_generator(),
       interpreter.is_depolarizing_channel(), interpreter.depolarizing_px(), interpreter.depolarizing_py(), interpreter.depolarizing_pz(), interpreter.depolarizing_seed() > 0, depolarizing_seed_generator(),
       circuit_index);
+  for (auto& nompi_state: nompi_states)
+    nompi_state.track_pauli_frame(parse_result.count("pauli-frame") > 0u);
+
+  interpreter.checkpoint(parse_result["checkpoint-every"].as<int>(), parse_result["checkpoint-file"].as<std::string>());
+  if (parse_result.count("restart"))
+    for (auto circuit_index = 0; circuit_index < static_cast<int>(num_circuits); ++circuit_index)
+      interpreter.restart_circuit(nompi_states[circuit_index], circuit_index);
+
+  auto profiler_ptr = std::unique_ptr<bra::profiler>{};
+  if (parse_result.count("profile"))
+  {
+    profiler_ptr = std::make_unique<bra::profiler>(num_circuits);
+    interpreter.profile(*profiler_ptr);
+  }
 
   while (true)
   {
-    for (auto circuit_index = 0; circuit_index < static_cast<int>(num_circuits); ++circuit_index)
-      if (not nompi_states[circuit_index].is_waiting())
-        interpreter.apply_circuit(nompi_states[circuit_index], circuit_index);
+    // Circuits are synchronized only when all of them are waiting or finished
+    scheduler.run(
+      static_cast<int>(num_circuits),
+      [&interpreter, &nompi_states](int const circuit_index)
+      {
+        if (not nompi_states[circuit_index].is_waiting())
+          interpreter.apply_circuit(nompi_states[circuit_index], circuit_index);
+      });
 
     using std::begin;
     using std::end;
@@ -952,6 +1178,9 @@ int main(int argc, char* argv[])
       continue;
     }
   }
+
+  if (profiler_ptr)
+    profiler_ptr->write(parse_result["profile"].as<std::string>());
 #endif // BRA_NO_MPI
 }
 
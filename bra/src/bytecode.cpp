@@ -0,0 +1,194 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#ifndef BRA_NO_MMAP
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif // BRA_NO_MMAP
+
+#include <bra/types.hpp>
+#include <bra/bytecode.hpp>
+#include <bra/gate/gate.hpp>
+#include <bra/gate/hadamard.hpp>
+#include <bra/gate/not_.hpp>
+#include <bra/gate/pauli_x.hpp>
+#include <bra/gate/pauli_y.hpp>
+#include <bra/gate/pauli_z.hpp>
+#include <bra/gate/s_gate.hpp>
+#include <bra/gate/adj_s_gate.hpp>
+#include <bra/gate/t_gate.hpp>
+#include <bra/gate/adj_t_gate.hpp>
+#include <bra/gate/u1.hpp>
+#include <bra/gate/adj_u1.hpp>
+#include <bra/gate/controlled_not.hpp>
+#include <bra/gate/controlled_pauli_z.hpp>
+#include <bra/gate/swap.hpp>
+#include <bra/gate/controlled_u1.hpp>
+#include <bra/gate/adj_controlled_u1.hpp>
+#include <bra/gate/exponential_pauli_z.hpp>
+#include <bra/gate/adj_exponential_pauli_z.hpp>
+
+
+namespace bra
+{
+  wrong_bytecode_file_error::wrong_bytecode_file_error(std::string const& filename, std::string const& reason)
+    : std::runtime_error{(std::string{"wrong bytecode file \""} + filename + "\": " + reason).c_str()}
+  { }
+
+  auto num_operated_qubits(::bra::opcode const opcode) -> std::size_t
+  {
+    switch (opcode)
+    {
+     case ::bra::opcode::gate:
+      return 0u;
+
+     case ::bra::opcode::controlled_not:
+     case ::bra::opcode::controlled_pauli_z:
+     case ::bra::opcode::swap:
+     case ::bra::opcode::controlled_u1:
+     case ::bra::opcode::adj_controlled_u1:
+      return 2u;
+
+     default:
+      return 1u;
+    }
+  }
+
+  auto make_gate(::bra::instruction const& instruction) -> std::unique_ptr< ::bra::gate::gate >
+  {
+    using ::bra::bytecode_detail::qubit;
+    using ::bra::bytecode_detail::control;
+    switch (instruction.opcode)
+    {
+     case ::bra::opcode::hadamard: return std::make_unique< ::bra::gate::hadamard >(qubit(instruction, 0u));
+     case ::bra::opcode::not_: return std::make_unique< ::bra::gate::not_ >(qubit(instruction, 0u));
+     case ::bra::opcode::pauli_x: return std::make_unique< ::bra::gate::pauli_x >(qubit(instruction, 0u));
+     case ::bra::opcode::pauli_y: return std::make_unique< ::bra::gate::pauli_y >(qubit(instruction, 0u));
+     case ::bra::opcode::pauli_z: return std::make_unique< ::bra::gate::pauli_z >(control(instruction, 0u));
+     case ::bra::opcode::s_gate: return std::make_unique< ::bra::gate::s_gate >(control(instruction, 0u));
+     case ::bra::opcode::adj_s_gate: return std::make_unique< ::bra::gate::adj_s_gate >(control(instruction, 0u));
+     case ::bra::opcode::t_gate: return std::make_unique< ::bra::gate::t_gate >(control(instruction, 0u));
+     case ::bra::opcode::adj_t_gate: return std::make_unique< ::bra::gate::adj_t_gate >(control(instruction, 0u));
+     case ::bra::opcode::u1: return std::make_unique< ::bra::gate::u1 >(instruction.phase, control(instruction, 0u));
+     case ::bra::opcode::adj_u1: return std::make_unique< ::bra::gate::adj_u1 >(instruction.phase, control(instruction, 0u));
+     case ::bra::opcode::controlled_not:
+      return std::make_unique< ::bra::gate::controlled_not >(qubit(instruction, 1u), control(instruction, 0u));
+     case ::bra::opcode::controlled_pauli_z:
+      return std::make_unique< ::bra::gate::controlled_pauli_z >(control(instruction, 0u), control(instruction, 1u));
+     case ::bra::opcode::swap: return std::make_unique< ::bra::gate::swap >(qubit(instruction, 0u), qubit(instruction, 1u));
+     case ::bra::opcode::controlled_u1:
+      return std::make_unique< ::bra::gate::controlled_u1 >(instruction.phase, control(instruction, 0u), control(instruction, 1u));
+     case ::bra::opcode::adj_controlled_u1:
+      return std::make_unique< ::bra::gate::adj_controlled_u1 >(instruction.phase, control(instruction, 0u), control(instruction, 1u));
+     case ::bra::opcode::exponential_pauli_z:
+      return std::make_unique< ::bra::gate::exponential_pauli_z >(instruction.phase, qubit(instruction, 0u));
+     case ::bra::opcode::adj_exponential_pauli_z:
+      return std::make_unique< ::bra::gate::adj_exponential_pauli_z >(instruction.phase, qubit(instruction, 0u));
+     case ::bra::opcode::gate: break;
+    }
+
+    throw std::logic_error{"no gate corresponds to opcode::gate"};
+  }
+
+#ifndef BRA_NO_MMAP
+  mapped_file::mapped_file(std::string const& filename)
+    : data_{nullptr}, size_{0u}
+  {
+    auto const file_descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+      throw std::runtime_error{(filename + " cannot be opened").c_str()};
+
+    struct ::stat file_status;
+    if (::fstat(file_descriptor, &file_status) != 0)
+    {
+      ::close(file_descriptor);
+      throw std::runtime_error{(filename + " cannot be opened").c_str()};
+    }
+
+    size_ = static_cast<std::size_t>(file_status.st_size);
+    if (size_ > 0u)
+    {
+      auto const address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+      if (address == MAP_FAILED)
+      {
+        ::close(file_descriptor);
+        throw std::runtime_error{(filename + " cannot be mapped").c_str()};
+      }
+
+      data_ = static_cast<char const*>(address);
+    }
+
+    // The mapping is valid after closing the file
+    ::close(file_descriptor);
+  }
+
+  mapped_file::~mapped_file()
+  {
+    if (data_ != nullptr)
+      ::munmap(const_cast<char*>(data_), size_);
+  }
+#else // BRA_NO_MMAP
+  mapped_file::mapped_file(std::string const& filename)
+    : data_{nullptr}, size_{0u}, buffer_{}
+  {
+    std::ifstream input_stream{filename, std::ios_base::in bitor std::ios_base::binary};
+    if (not input_stream)
+      throw std::runtime_error{(filename + " cannot be opened").c_str()};
+
+    buffer_.assign(std::istreambuf_iterator<char>{input_stream}, std::istreambuf_iterator<char>{});
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+
+  mapped_file::~mapped_file() = default;
+#endif // BRA_NO_MMAP
+
+  namespace bytecode_detail
+  {
+    auto header_bytes() -> std::string
+    {
+      auto result = std::string(magic, sizeof(magic));
+      write(result, version);
+      write(result, static_cast<std::uint64_t>(sizeof(::bra::real_type)));
+      write(result, static_cast<std::uint64_t>(sizeof(::bra::bit_integer_type)));
+      write(result, static_cast<std::uint64_t>(sizeof(::bra::instruction)));
+      return result;
+    }
+
+    auto read_header(::bra::bytecode_detail::reader& bytecode_reader, std::string const& filename) -> void
+    {
+      char file_magic[sizeof(magic)];
+      bytecode_reader.read_bytes(file_magic, sizeof(magic));
+      if (not std::equal(magic, magic + sizeof(magic), file_magic))
+        throw ::bra::wrong_bytecode_file_error{filename, "wrong magic number"};
+
+      if (bytecode_reader.read<std::uint64_t>() != version)
+        throw ::bra::wrong_bytecode_file_error{filename, "unsupported version"};
+
+      if (bytecode_reader.read<std::uint64_t>() != sizeof(::bra::real_type)
+          or bytecode_reader.read<std::uint64_t>() != sizeof(::bra::bit_integer_type)
+          or bytecode_reader.read<std::uint64_t>() != sizeof(::bra::instruction))
+        throw ::bra::wrong_bytecode_file_error{filename, "this file is compiled with different types"};
+    }
+  } // namespace bytecode_detail
+
+  auto is_bytecode_file(std::string const& filename) -> bool
+  {
+    std::ifstream input_stream{filename, std::ios_base::in bitor std::ios_base::binary};
+    char file_magic[sizeof(::bra::bytecode_detail::magic)];
+    if (not input_stream.read(file_magic, sizeof(file_magic)))
+      return false;
+
+    using std::begin;
+    using std::end;
+    return std::equal(begin(::bra::bytecode_detail::magic), end(::bra::bytecode_detail::magic), file_magic);
+  }
+} // namespace bra
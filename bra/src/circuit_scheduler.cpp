@@ -0,0 +1,155 @@
+#ifdef BRA_NO_MPI
+# include <cassert>
+# include <cstdint>
+# include <vector>
+# include <atomic>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+# include <functional>
+# include <exception>
+
+# if defined(_OPENMP) && defined(KET_USE_OPENMP)
+#   include <omp.h>
+# else // defined(_OPENMP) && defined(KET_USE_OPENMP)
+#   include <ket/utility/parallel/thread_pool.hpp>
+# endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
+
+# include <bra/circuit_scheduler.hpp>
+
+
+namespace bra
+{
+  circuit_scheduler::circuit_scheduler(int const num_groups, unsigned int const num_threads_per_group)
+    : num_groups_{num_groups}, num_threads_per_group_{num_threads_per_group}, leaders_{},
+      mutex_{}, condition_{}, finished_condition_{}, generation_{0u}, is_stopping_{false}, num_running_leaders_{0},
+      task_ptr_{nullptr}, num_tasks_{0}, next_task_index_{0}, exception_{}
+  {
+    assert(num_groups_ > 0);
+
+    use_threads_of_group();
+
+    leaders_.reserve(num_groups_ - 1);
+    for (auto group_index = 1; group_index < num_groups_; ++group_index)
+      leaders_.emplace_back([this, group_index] { this->lead(group_index); });
+  }
+
+  circuit_scheduler::~circuit_scheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      is_stopping_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto& leader: leaders_)
+      leader.join();
+  }
+
+  auto circuit_scheduler::run(int const num_tasks, std::function<void(int)> const& task) -> void
+  {
+    if (num_groups_ == 1)
+    {
+      for (auto task_index = 0; task_index < num_tasks; ++task_index)
+        task(task_index);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      task_ptr_ = &task;
+      num_tasks_ = num_tasks;
+      next_task_index_.store(0, std::memory_order_relaxed);
+      num_running_leaders_ = num_groups_ - 1;
+      ++generation_;
+    }
+    condition_.notify_all();
+
+    run_tasks();
+
+    auto exception = std::exception_ptr{};
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      finished_condition_.wait(lock, [this] { return num_running_leaders_ == 0; });
+      task_ptr_ = nullptr;
+      std::swap(exception, exception_);
+    }
+
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+
+  // Remaining tasks are skipped after an exception
+  auto circuit_scheduler::run_tasks() -> void
+  {
+    for (auto task_index = next_task_index_.fetch_add(1, std::memory_order_relaxed);
+         task_index < num_tasks_;
+         task_index = next_task_index_.fetch_add(1, std::memory_order_relaxed))
+    {
+      try
+      {
+        (*task_ptr_)(task_index);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (not exception_)
+          exception_ = std::current_exception();
+        next_task_index_.store(num_tasks_, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // OpenMP teams take their sizes from the ICV of the thread which starts them, and the ICV of a new std::thread is the default one
+  // (OMP_NUM_THREADS or the number of CPUs), so each leader sets its own
+  auto circuit_scheduler::use_threads_of_group() const -> void
+  {
+# if defined(_OPENMP) && defined(KET_USE_OPENMP)
+    omp_set_num_threads(static_cast<int>(num_threads_per_group_));
+
+#   ifndef NDEBUG
+    auto team_size = 0;
+#     pragma omp parallel
+    {
+#     pragma omp single
+      team_size = omp_get_num_threads();
+    }
+    assert(team_size <= static_cast<int>(num_threads_per_group_));
+#   endif // NDEBUG
+# endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
+  }
+
+  auto circuit_scheduler::lead(int const group_index) -> void
+  {
+# if defined(_OPENMP) && defined(KET_USE_OPENMP)
+    static_cast<void>(group_index);
+    use_threads_of_group();
+# else // defined(_OPENMP) && defined(KET_USE_OPENMP)
+    ket::utility::scoped_thread_pool const thread_pool{static_cast<unsigned int>(group_index) * num_threads_per_group_};
+# endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
+
+    auto last_generation = std::uint64_t{0u};
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        condition_.wait(lock, [this, last_generation] { return generation_ != last_generation or is_stopping_; });
+        if (is_stopping_)
+          return;
+
+        last_generation = generation_;
+      }
+
+      run_tasks();
+
+      {
+        std::lock_guard<std::mutex> lock{mutex_};
+        --num_running_leaders_;
+      }
+      finished_condition_.notify_one();
+    }
+  }
+} // namespace bra
+
+
+#endif // BRA_NO_MPI
@@ -0,0 +1,138 @@
+#include <cstddef>
+#include <string>
+#include <fstream>
+#include <ios>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <functional>
+
+#include <bra/circuit_stream.hpp>
+
+
+namespace bra
+{
+  circuit_stream::circuit_stream(std::string const& filename, std::streamoff const first_offset, bool const is_in_circuit)
+    : input_stream_{filename, std::ios_base::in bitor std::ios_base::binary},
+      next_offset_{first_offset}, is_in_circuit_{is_in_circuit},
+      mutex_{}, condition_variable_{}, chunks_{},
+      is_stop_requested_{false}, is_reader_running_{false}, is_end_of_circuit_{false}, exception_ptr_{}, reader_{}
+  { }
+
+  circuit_stream::~circuit_stream()
+  { stop(); }
+
+  auto circuit_stream::start(std::function<void(circuit_stream&)> read) -> void
+  {
+    if (is_end_of_circuit_ or reader_.joinable())
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      is_stop_requested_ = false;
+      is_reader_running_ = true;
+    }
+
+    reader_
+      = std::thread{
+          [this, read]()
+          {
+            try
+            {
+              read(*this);
+            }
+            catch (...)
+            {
+              std::lock_guard<std::mutex> lock{mutex_};
+              exception_ptr_ = std::current_exception();
+            }
+
+            {
+              std::lock_guard<std::mutex> lock{mutex_};
+              is_reader_running_ = false;
+            }
+            condition_variable_.notify_all();
+          }};
+  }
+
+  auto circuit_stream::stop() -> void
+  {
+    if (not reader_.joinable())
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      is_stop_requested_ = true;
+    }
+    condition_variable_.notify_all();
+    reader_.join();
+  }
+
+  auto circuit_stream::restart_at(std::streamoff const offset, bool const is_in_circuit) -> void
+  {
+    stop();
+
+    chunks_.clear();
+    next_offset_ = offset;
+    is_in_circuit_ = is_in_circuit;
+    is_end_of_circuit_ = false;
+    exception_ptr_ = nullptr;
+  }
+
+  // The chunk is pushed even if the queue is full when stop is requested
+  auto circuit_stream::push(chunk_type&& chunk) -> bool
+  {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      condition_variable_.wait(
+        lock, [this] { return is_stop_requested_ or chunks_.size() < std::size_t{BRA_STREAMING_MAX_NUM_CHUNKS}; });
+      chunks_.push_back(std::move(chunk));
+    }
+    condition_variable_.notify_all();
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    return not is_stop_requested_;
+  }
+
+  auto circuit_stream::is_stop_requested() -> bool
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return is_stop_requested_;
+  }
+
+  auto circuit_stream::finish(std::streamoff const next_offset, bool const is_in_circuit, bool const is_end_of_circuit) -> void
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    next_offset_ = next_offset;
+    is_in_circuit_ = is_in_circuit;
+    is_end_of_circuit_ = is_end_of_circuit;
+  }
+
+  auto circuit_stream::pop(chunk_type& chunk) -> bool
+  {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      condition_variable_.wait(lock, [this] { return not chunks_.empty() or not is_reader_running_; });
+
+      if (chunks_.empty())
+      {
+        if (exception_ptr_)
+        {
+          auto exception_ptr = exception_ptr_;
+          exception_ptr_ = nullptr;
+          std::rethrow_exception(exception_ptr);
+        }
+
+        return false;
+      }
+
+      chunk = std::move(chunks_.front());
+      chunks_.pop_front();
+    }
+    condition_variable_.notify_all();
+
+    return true;
+  }
+} // namespace bra
@@ -9,6 +9,7 @@
 #include <bra/gate/gate.hpp>
 #include <bra/gate/controlled_not.hpp>
 #include <bra/state.hpp>
+#include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -36,5 +37,15 @@ namespace bra
         << std::setw(parameter_width) << target_qubit_;
       return repr_stream.str();
     }
+
+    bool controlled_not::do_lower(::bra::instruction& instruction) const
+    {
+      instruction
+        = ::bra::instruction{
+            ::bra::opcode::controlled_not, do_is_diagonal(),
+            {static_cast< ::bra::bit_integer_type >(control_qubit_.qubit()), static_cast< ::bra::bit_integer_type >(target_qubit_)},
+            ::bra::real_type{}};
+      return true;
+    }
   } // namespace gate
 } // namespace bra
@@ -2,10 +2,12 @@
 #include <ios>
 #include <iomanip>
 #include <sstream>
+#include <memory>
 #include <utility>
 
 #include <boost/variant/variant.hpp>
 #include <boost/variant/apply_visitor.hpp>
+#include <boost/variant/get.hpp>
 
 #include <ket/qubit_io.hpp>
 #include <ket/control_io.hpp>
@@ -13,6 +15,7 @@
 #include <bra/gate/gate.hpp>
 #include <bra/gate/controlled_u1.hpp>
 #include <bra/state.hpp>
+#include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -41,5 +44,19 @@ namespace bra
         << std::setw(parameter_width) << boost::apply_visitor(::bra::gate::gate_detail::output_visitor<real_type>{}, phase_);
       return repr_stream.str();
     }
+
+    bool controlled_u1::do_lower(::bra::instruction& instruction) const
+    {
+      auto const phase = boost::get<real_type>(std::addressof(phase_));
+      if (phase == nullptr)
+        return false;
+
+      instruction
+        = ::bra::instruction{
+            ::bra::opcode::controlled_u1, do_is_diagonal(),
+            {static_cast< ::bra::bit_integer_type >(control_qubit1_.qubit()), static_cast< ::bra::bit_integer_type >(control_qubit2_.qubit())},
+            *phase};
+      return true;
+    }
   } // namespace gate
 } // namespace bra
@@ -2,16 +2,19 @@
 #include <ios>
 #include <iomanip>
 #include <sstream>
+#include <memory>
 #include <utility>
 
 #include <boost/variant/variant.hpp>
 #include <boost/variant/apply_visitor.hpp>
+#include <boost/variant/get.hpp>
 
 #include <ket/qubit_io.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/exponential_pauli_z.hpp>
 #include <bra/state.hpp>
+#include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -39,5 +42,19 @@ namespace bra
         << std::setw(parameter_width) << boost::apply_visitor(::bra::gate::gate_detail::output_visitor<real_type>{}, phase_);
       return repr_stream.str();
     }
+
+    bool exponential_pauli_z::do_lower(::bra::instruction& instruction) const
+    {
+      auto const phase = boost::get<real_type>(std::addressof(phase_));
+      if (phase == nullptr)
+        return false;
+
+      instruction
+        = ::bra::instruction{
+            ::bra::opcode::exponential_pauli_z, do_is_diagonal(),
+            {static_cast< ::bra::bit_integer_type >(qubit_), 0u},
+            *phase};
+      return true;
+    }
   } // namespace gate
 } // namespace bra
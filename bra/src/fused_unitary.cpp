@@ -0,0 +1,68 @@
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <numeric>
+
+#include <ket/qubit.hpp>
+#include <ket/utility/integer_exp2.hpp>
+
+#include <bra/types.hpp>
+#include <bra/fused_gate/fused_gate.hpp>
+#include <bra/fused_gate/fused_unitary.hpp>
+
+
+namespace bra
+{
+  namespace fused_gate
+  {
+    fused_unitary::fused_unitary(
+      std::vector<std::unique_ptr< ::bra::fused_gate::fused_gate< ::bra::data_type::iterator > >> const& fused_gates,
+      ::bra::bit_integer_type const num_fused_qubits,
+      std::vector< ::bra::bit_integer_type > const& to_qubit_index_in_fused_gates,
+      unsigned int const num_threads)
+      : num_fused_qubits_{num_fused_qubits},
+        num_fused_indices_{ket::utility::integer_exp2< ::bra::state_integer_type >(num_fused_qubits)},
+        matrix_(static_cast<std::size_t>(num_fused_indices_) * static_cast<std::size_t>(num_fused_indices_)),
+        amplitude_buffer_(static_cast<std::size_t>(num_threads) * static_cast<std::size_t>(num_fused_indices_)),
+        index_buffer_(static_cast<std::size_t>(num_threads) * static_cast<std::size_t>(num_fused_indices_))
+    {
+      assert(num_fused_qubits > ::bra::bit_integer_type{0u});
+      assert(num_threads > 0u);
+
+      // columns[(j << k) bitor i] is the i-th element of the j-th column, where k is num_fused_qubits.
+      // Fused gates are applied to all columns at once by regarding columns as a state of 2k qubits whose lower k qubits are fused qubits.
+      auto columns = ::bra::data_type(matrix_.size(), ::bra::complex_type{0});
+      for (auto j = ::bra::state_integer_type{0u}; j < num_fused_indices_; ++j)
+        columns[(j << num_fused_qubits) bitor j] = ::bra::complex_type{1};
+
+      using std::begin;
+      using std::end;
+#ifndef KET_USE_BIT_MASKS_EXPLICITLY
+      auto unsorted_fused_qubits = std::vector< ::bra::qubit_type >(num_fused_qubits);
+      std::iota(begin(unsorted_fused_qubits), end(unsorted_fused_qubits), ket::make_qubit< ::bra::state_integer_type >(::bra::bit_integer_type{0u}));
+      auto sorted_fused_qubits_with_sentinel = unsorted_fused_qubits;
+      sorted_fused_qubits_with_sentinel.push_back(ket::make_qubit< ::bra::state_integer_type >(static_cast< ::bra::bit_integer_type >(num_fused_qubits * 2u)));
+
+      for (auto const& gate_ptr: fused_gates)
+        for (auto j = ::bra::state_integer_type{0u}; j < num_fused_indices_; ++j)
+          gate_ptr->call(
+            begin(columns), j, unsorted_fused_qubits, sorted_fused_qubits_with_sentinel, to_qubit_index_in_fused_gates);
+#else // KET_USE_BIT_MASKS_EXPLICITLY
+      auto qubit_masks = std::vector< ::bra::state_integer_type >(num_fused_qubits);
+      for (auto i = ::bra::bit_integer_type{0u}; i < num_fused_qubits; ++i)
+        qubit_masks[i] = ::bra::state_integer_type{1u} << i;
+      auto index_masks = std::vector< ::bra::state_integer_type >(num_fused_qubits + 1u, ::bra::state_integer_type{0u});
+      index_masks.back() = compl ::bra::state_integer_type{0u};
+
+      for (auto const& gate_ptr: fused_gates)
+        for (auto j = ::bra::state_integer_type{0u}; j < num_fused_indices_; ++j)
+          gate_ptr->call(begin(columns), j, qubit_masks, index_masks, to_qubit_index_in_fused_gates);
+#endif // KET_USE_BIT_MASKS_EXPLICITLY
+
+      for (auto i = ::bra::state_integer_type{0u}; i < num_fused_indices_; ++i)
+        for (auto j = ::bra::state_integer_type{0u}; j < num_fused_indices_; ++j)
+          matrix_[i * num_fused_indices_ + j] = columns[(j << num_fused_qubits) bitor i];
+    }
+  } // namespace fused_gate
+} // namespace bra
@@ -1,6 +1,12 @@
+#include <cctype>
+#include <cstdint>
 #include <istream>
+#include <fstream>
+#include <ios>
+#include <limits>
 #include <string>
 #include <vector>
+#include <deque>
 #include <tuple>
 #include <utility>
 #include <algorithm>
@@ -15,13 +21,10 @@
 
 #include <boost/lexical_cast.hpp>
 
-#include <boost/range/empty.hpp>
 #include <boost/range/size.hpp>
 
 #include <boost/algorithm/string/case_conv.hpp>
-#include <boost/algorithm/string/trim.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #ifndef BRA_NO_MPI
 # include <yampi/communicator.hpp>
@@ -38,6 +41,8 @@
 #include <bra/state.hpp>
 #include <bra/utility/to_integer.hpp>
 #include <bra/gate/gate.hpp>
+#include <bra/circuit_stream.hpp>
+#include <bra/bytecode.hpp>
 #include <bra/gate/var_op.hpp>
 #include <bra/gate/let_op.hpp>
 #include <bra/gate/send_op.hpp>
@@ -124,10 +129,13 @@
 #include <bra/gate/fidelity.hpp>
 #include <bra/gate/fidelity_with_op.hpp>
 #include <bra/gate/shor_box.hpp>
+#include <bra/fused_gate/fused_unitary.hpp>
 #include <bra/gate/begin_fusion.hpp>
 #include <bra/gate/end_fusion.hpp>
 #include <bra/gate/clear.hpp>
 #include <bra/gate/set.hpp>
+#include <bra/gate/save_state.hpp>
+#include <bra/gate/load_state.hpp>
 #include <bra/gate/exit.hpp>
 #include <bra/gate/controlled_i_gate.hpp>
 #include <bra/gate/controlled_ic_gate.hpp>
@@ -245,17 +253,76 @@ namespace bra
   { }
 #endif // BRA_NO_MPI
 
+  namespace interpreter_detail
+  {
+    // Splits line into columns by whitespaces and drops a comment after '!', and returns false if no column exists.
+    // Strings in columns are reused, so no memory is allocated for short columns in most lines
+    inline auto split_columns(std::string const& line, ::bra::interpreter::columns_type& columns) -> bool
+    {
+      auto const is_space = [](char const character) { return std::isspace(static_cast<unsigned char>(character)) != 0; };
+
+      using std::begin;
+      using std::end;
+      auto const last = std::find(begin(line), end(line), '!');
+      auto num_columns = std::size_t{0u};
+      auto iter = std::find_if_not(begin(line), last, is_space);
+      while (iter != last)
+      {
+        auto const column_last = std::find_if(iter, last, is_space);
+        if (num_columns < columns.size())
+          columns[num_columns].assign(iter, column_last);
+        else
+          columns.emplace_back(iter, column_last);
+
+        ++num_columns;
+        iter = std::find_if_not(column_last, last, is_space);
+      }
+      columns.resize(num_columns);
+
+      if (num_columns == 0u)
+        return false;
+
+      boost::algorithm::to_upper(columns.front());
+      return true;
+    }
+
+    inline auto is_header_mnemonic(std::string const& mnemonic) -> bool
+    {
+      return mnemonic == "CIRCUITS" or mnemonic == "QUBITS" or mnemonic == "DEPOLARIZING" or mnemonic == "INITIAL"
+        or mnemonic == "MPIPROCESSES" or mnemonic == "MPISWAPBUFFER" or mnemonic == "BIT";
+    }
+
+    // BEGIN/END <statement>
+    inline auto is_block_statement(::bra::interpreter::columns_type const& columns, char const* statement) -> bool
+    {
+      return (columns.front() == "BEGIN" or columns.front() == "END")
+        and columns.size() >= 2u and boost::algorithm::iequals(columns[1u], statement);
+    }
+
+    // A gate is moved forward over at most this number of skipped gates into a fusion block
+    constexpr auto max_num_skipped_gates_in_fusion = std::size_t{64u};
+
+    // How skipped gates operate a qubit while a fusion block is planned
+    enum class skipped_qubit : int { not_operated, diagonal, non_diagonal };
+  } // namespace interpreter_detail
+
 #ifndef BRA_NO_MPI
   interpreter::interpreter()
-    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), num_qubits_{}, num_lqubits_{}, num_uqubits_{}, num_processes_per_unit_{1u},
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{}, num_lqubits_{}, num_uqubits_{}, num_processes_per_unit_{1u},
       initial_state_value_{}, initial_permutation_{}, root_{}, circuit_index_{0}, is_in_circuit_{false},
-      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{}
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{false}, filename_{}, end_offset_{}, label_offsets_{}, circuit_streams_{}, streamed_chunks_{},
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
   { }
 #else // BRA_NO_MPI
   interpreter::interpreter()
-    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), num_qubits_{},
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{},
       initial_state_value_{}, circuit_index_{0}, is_in_circuit_{false},
-      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{}
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{false}, filename_{}, end_offset_{}, label_offsets_{}, circuit_streams_{}, streamed_chunks_{},
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
   { }
 #endif // BRA_NO_MPI
 
@@ -266,31 +333,111 @@ namespace bra
     yampi::environment const& environment,
     yampi::rank const root, yampi::communicator const& total_communicator,
     size_type const num_reserved_gates)
-    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), num_qubits_{}, num_lqubits_{},
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{}, num_lqubits_{},
       num_uqubits_{num_uqubits}, num_processes_per_unit_{num_processes_per_unit},
       largest_num_operated_qubits_{::bra::bit_integer_type{0u}},
       initial_state_value_{}, initial_permutation_{}, root_{root}, circuit_index_{0}, is_in_circuit_{false},
-      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{}
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{false}, filename_{}, end_offset_{}, label_offsets_{}, circuit_streams_{}, streamed_chunks_{},
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
   {
     assert(num_processes_per_unit >= 1u);
     invoke(input_stream, environment, total_communicator, num_reserved_gates);
   }
 #else // BRA_NO_MPI
   interpreter::interpreter(std::istream& input_stream)
-    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), num_qubits_{},
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{},
       largest_num_operated_qubits_{::bra::bit_integer_type{0u}},
       initial_state_value_{}, circuit_index_{0}, is_in_circuit_{false},
-      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{}
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{false}, filename_{}, end_offset_{}, label_offsets_{}, circuit_streams_{}, streamed_chunks_{},
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
   { invoke(input_stream, size_type{0u}); }
 
   interpreter::interpreter(std::istream& input_stream, size_type const num_reserved_gates)
-    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), num_qubits_{},
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{},
       largest_num_operated_qubits_{::bra::bit_integer_type{0u}},
       initial_state_value_{}, circuit_index_{0}, is_in_circuit_{false},
-      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{}
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{false}, filename_{}, end_offset_{}, label_offsets_{}, circuit_streams_{}, streamed_chunks_{},
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
   { invoke(input_stream, num_reserved_gates); }
 #endif // BRA_NO_MPI
 
+#ifndef BRA_NO_MPI
+  interpreter::interpreter(
+    std::string const& filename, ::bra::streaming_t const,
+    ::bra::bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+    yampi::environment const& environment,
+    yampi::rank const root, yampi::communicator const& total_communicator)
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{}, num_lqubits_{},
+      num_uqubits_{num_uqubits}, num_processes_per_unit_{num_processes_per_unit},
+      largest_num_operated_qubits_{::bra::bit_integer_type{0u}},
+      initial_state_value_{}, initial_permutation_{}, root_{root}, circuit_index_{0}, is_in_circuit_{false},
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{true}, filename_{filename}, end_offset_{}, label_offsets_(1u), circuit_streams_{}, streamed_chunks_(1u),
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
+  {
+    assert(num_processes_per_unit >= 1u);
+
+    std::ifstream input_stream{filename, std::ios_base::in bitor std::ios_base::binary};
+    if (not input_stream)
+      throw std::runtime_error{(filename + " cannot be opened").c_str()};
+
+    scan(input_stream, environment, total_communicator);
+  }
+#else // BRA_NO_MPI
+  interpreter::interpreter(std::string const& filename, ::bra::streaming_t const)
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{},
+      largest_num_operated_qubits_{::bra::bit_integer_type{0u}},
+      initial_state_value_{}, circuit_index_{0}, is_in_circuit_{false},
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{true}, filename_{filename}, end_offset_{}, label_offsets_(1u), circuit_streams_{}, streamed_chunks_(1u),
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
+  {
+    std::ifstream input_stream{filename, std::ios_base::in bitor std::ios_base::binary};
+    if (not input_stream)
+      throw std::runtime_error{(filename + " cannot be opened").c_str()};
+
+    scan(input_stream);
+  }
+#endif // BRA_NO_MPI
+
+#ifndef BRA_NO_MPI
+  interpreter::interpreter(
+    std::string const& filename, ::bra::bytecode_t const,
+    ::bra::bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+    yampi::environment const& environment,
+    yampi::rank const root, yampi::communicator const& total_communicator)
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{}, num_lqubits_{},
+      num_uqubits_{num_uqubits}, num_processes_per_unit_{num_processes_per_unit},
+      largest_num_operated_qubits_{::bra::bit_integer_type{0u}},
+      initial_state_value_{}, initial_permutation_{}, root_{root}, circuit_index_{0}, is_in_circuit_{false},
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{false}, filename_{}, end_offset_{}, label_offsets_{}, circuit_streams_{}, streamed_chunks_{},
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
+  {
+    assert(num_processes_per_unit >= 1u);
+    load_bytecode(filename, environment, total_communicator);
+  }
+#else // BRA_NO_MPI
+  interpreter::interpreter(std::string const& filename, ::bra::bytecode_t const)
+    : circuits_(1u), label_maps_(1u), first_indices_(1u, 0), operated_qubits_(1u), fusion_first_index_{0}, num_qubits_{},
+      largest_num_operated_qubits_{::bra::bit_integer_type{0u}},
+      initial_state_value_{}, circuit_index_{0}, is_in_circuit_{false},
+      is_depolarizing_channel_{false}, depolarizing_px_{}, depolarizing_py_{}, depolarizing_pz_{}, depolarizing_seed_{},
+      checkpoint_interval_{0}, checkpoint_filename_{}, num_uncheckpointed_instructions_(1u, 0),
+      is_streaming_{false}, filename_{}, end_offset_{}, label_offsets_{}, circuit_streams_{}, streamed_chunks_{},
+      bytecodes_(1u), header_lines_{}, fallback_lines_(1u), profiler_ptr_{nullptr}
+  { load_bytecode(filename); }
+#endif // BRA_NO_MPI
+
   bool interpreter::operator==(interpreter const& other) const
   {
 #ifndef BRA_NO_MPI
@@ -382,6 +529,16 @@ namespace bra
     }
     for (auto& label_map: label_maps_)
       label_map.clear();
+    for (auto& operated_qubits: operated_qubits_)
+      operated_qubits.clear();
+    for (auto& bytecode: bytecodes_)
+    {
+      bytecode.clear();
+      bytecode.reserve(num_reserved_gates);
+    }
+    for (auto& lines: fallback_lines_)
+      lines.clear();
+    header_lines_.clear();
 
     auto line = std::string{};
     auto columns = columns_type{};
@@ -389,439 +546,1040 @@ namespace bra
 
     while (std::getline(input_stream, line))
     {
-      if (line.empty())
+      if (not ::bra::interpreter_detail::split_columns(line, columns))
         continue;
 
-      line.erase(std::find(line.begin(), line.end(), '!'), line.end());
-      boost::algorithm::trim(line);
-      if (line.empty())
+#ifndef BRA_NO_MPI
+      if (interpret_header_statement(columns, environment, total_communicator, num_reserved_gates))
+#else // BRA_NO_MPI
+      if (interpret_header_statement(columns, num_reserved_gates))
+#endif // BRA_NO_MPI
+      {
+        header_lines_.push_back(line);
         continue;
+      }
 
-      boost::algorithm::split(
-        columns, line, boost::algorithm::is_space(),
-        boost::algorithm::token_compress_on);
+      auto const circuit_index = circuit_index_;
+      auto const num_gates = circuits_[circuit_index].size();
+      auto const is_continued = interpret_instruction(columns);
+      lower_gates(circuit_index, num_gates, line);
 
-      if (boost::empty(columns))
-        continue;
+      if (not is_continued)
+        break;
+    }
+  }
 
-      boost::algorithm::to_upper(columns.front());
-      auto const& mnemonic = columns.front();
-      using std::begin;
-      using std::end;
-      if (mnemonic == "CIRCUITS")
+  auto interpreter::lower_gates(int const circuit_index, size_type const num_gates, std::string const& line) -> void
+  {
+    auto const& circuit = circuits_[circuit_index];
+    if (circuit.size() == num_gates)
+      return;
+
+    auto& bytecode = bytecodes_[circuit_index];
+    auto instruction = ::bra::instruction{};
+    if (circuit.size() == num_gates + 1u and circuit.back()->lower(instruction))
+    {
+      bytecode.push_back(instruction);
+      return;
+    }
+
+    for (auto index = num_gates; index < circuit.size(); ++index)
+      bytecode.push_back(::bra::instruction{::bra::opcode::gate, circuit[index]->is_diagonal(), {0u, 0u}, ::bra::real_type{}});
+    fallback_lines_[circuit_index].push_back(line);
+  }
+
+  auto interpreter::plan_fusion(::bra::bit_integer_type const max_num_fused_qubits) -> void
+  {
+    assert(not is_streaming_);
+    if (max_num_fused_qubits == ::bra::bit_integer_type{0u})
+      return;
+
+    for (auto circuit_index = 0; circuit_index < static_cast<int>(circuits_.size()); ++circuit_index)
+      largest_num_operated_qubits_
+        = std::max(largest_num_operated_qubits_, plan_circuit_fusion(circuit_index, max_num_fused_qubits));
+  }
+
+  auto interpreter::is_fusable_gate(int const circuit_index, size_type const index) const -> bool
+  {
+    auto const& operated_qubits = operated_qubits_[circuit_index];
+    if (index >= operated_qubits.size() or operated_qubits[index].empty() or not circuits_[circuit_index][index]->is_fusable())
+      return false;
+
+    using std::begin;
+    using std::end;
+#ifndef BRA_NO_MPI
+    return std::all_of(
+      begin(operated_qubits[index]), end(operated_qubits[index]),
+      [this](::bra::bit_integer_type const qubit)
+      { return qubit < num_qubits_ and initial_permutation_[qubit] < ::bra::permutated_qubit_type{num_lqubits_}; });
+#else // BRA_NO_MPI
+    return std::all_of(
+      begin(operated_qubits[index]), end(operated_qubits[index]),
+      [this](::bra::bit_integer_type const qubit) { return qubit < num_qubits_; });
+#endif // BRA_NO_MPI
+  }
+
+  // Gates are taken into a block in order, and a gate which does not fit in the block is skipped. A later gate is moved forward over
+  // skipped gates only if it commutes with all of them, i.e. their qubits are disjoint or both are diagonal. Skipped gates start next blocks.
+  // With the depolarizing channel, no gates are moved because errors after gates do not commute with them
+  auto interpreter::plan_circuit_fusion(int const circuit_index, ::bra::bit_integer_type const max_num_fused_qubits)
+  -> ::bra::bit_integer_type
+  {
+    auto& circuit = circuits_[circuit_index];
+    auto& bytecode = bytecodes_[circuit_index];
+    auto& operated_qubits = operated_qubits_[circuit_index];
+    auto const num_gates = circuit.size();
+    operated_qubits.resize(num_gates);
+
+    // Blocks do not cross labels because JUMP may start the circuit from there
+    auto is_labeled = std::vector<bool>(num_gates + 1u, false);
+    for (auto const& label_index: label_maps_[circuit_index])
+      is_labeled[static_cast<size_type>(label_index.second)] = true;
+
+    auto new_circuit = circuit_type{};
+    new_circuit.reserve(num_gates);
+    auto new_bytecode = std::vector< ::bra::instruction >{};
+    new_bytecode.reserve(num_gates);
+    auto new_operated_qubits = std::vector<std::vector< ::bra::bit_integer_type >>{};
+    new_operated_qubits.reserve(num_gates);
+    auto new_indices = std::vector<int>(num_gates + 1u, 0);
+
+    auto const push_gate
+      = [&circuit, &bytecode, &operated_qubits, &new_circuit, &new_bytecode, &new_operated_qubits](size_type const index)
+        {
+          new_circuit.push_back(std::move(circuit[index]));
+          new_bytecode.push_back(bytecode[index]);
+          new_operated_qubits.push_back(std::move(operated_qubits[index]));
+        };
+    auto const push_fusion_statement
+      = [&new_circuit, &new_bytecode, &new_operated_qubits](gate_pointer&& gate, std::vector< ::bra::bit_integer_type >&& qubits)
+        {
+          new_bytecode.push_back(::bra::instruction{::bra::opcode::gate, gate->is_diagonal(), {0u, 0u}, ::bra::real_type{}});
+          new_circuit.push_back(std::move(gate));
+          new_operated_qubits.push_back(std::move(qubits));
+        };
+
+    auto const max_num_skipped_gates
+      = is_depolarizing_channel_ ? std::size_t{0u} : ::bra::interpreter_detail::max_num_skipped_gates_in_fusion;
+    auto result = ::bra::bit_integer_type{0u};
+    auto run = std::deque<size_type>{}; // indices of consecutive fusable gates
+    auto block = std::vector<size_type>{};
+    auto block_qubits = std::vector< ::bra::bit_integer_type >{};
+    auto skipped = std::vector<size_type>{};
+    auto skipped_qubits = std::vector< ::bra::interpreter_detail::skipped_qubit >{};
+
+    using std::begin;
+    using std::end;
+    auto const flush_run
+      = [this, &circuit, &operated_qubits, &new_operated_qubits, max_num_fused_qubits, max_num_skipped_gates, &result,
+         &run, &block, &block_qubits, &skipped, &skipped_qubits, &push_gate, &push_fusion_statement]()
+        {
+          while (not run.empty())
+          {
+            block.clear();
+            block_qubits.clear();
+            skipped.clear();
+            skipped_qubits.assign(num_qubits_, ::bra::interpreter_detail::skipped_qubit::not_operated);
+
+            while (not run.empty() and skipped.size() <= max_num_skipped_gates)
+            {
+              auto const index = run.front();
+              run.pop_front();
+
+              auto const& qubits = operated_qubits[index];
+              auto const is_diagonal = circuit[index]->is_diagonal();
+              auto const commutes
+                = std::all_of(
+                    begin(qubits), end(qubits),
+                    [&skipped_qubits, is_diagonal](::bra::bit_integer_type const qubit)
+                    {
+                      return skipped_qubits[qubit] == ::bra::interpreter_detail::skipped_qubit::not_operated
+                        or (is_diagonal and skipped_qubits[qubit] == ::bra::interpreter_detail::skipped_qubit::diagonal);
+                    });
+              auto const num_new_qubits
+                = std::count_if(
+                    begin(qubits), end(qubits),
+                    [&block_qubits](::bra::bit_integer_type const qubit)
+                    { return std::find(begin(block_qubits), end(block_qubits), qubit) == end(block_qubits); });
+
+              if (commutes and block_qubits.size() + static_cast<std::size_t>(num_new_qubits) <= max_num_fused_qubits)
+              {
+                block.push_back(index);
+                for (auto const qubit: qubits)
+                  if (std::find(begin(block_qubits), end(block_qubits), qubit) == end(block_qubits))
+                    block_qubits.push_back(qubit);
+                continue;
+              }
+
+              skipped.push_back(index);
+              for (auto const qubit: qubits)
+                skipped_qubits[qubit]
+                  = is_diagonal and skipped_qubits[qubit] != ::bra::interpreter_detail::skipped_qubit::non_diagonal
+                    ? ::bra::interpreter_detail::skipped_qubit::diagonal
+                    : ::bra::interpreter_detail::skipped_qubit::non_diagonal;
+            }
+
+            // Skipped gates are applied after the block in their original order
+            run.insert(begin(run), begin(skipped), end(skipped));
+
+            // The first gate operates more qubits than max_num_fused_qubits
+            if (block.empty())
+            {
+              push_gate(run.front());
+              run.pop_front();
+              continue;
+            }
+
+            // Gates of a block are applied one by one if they are too few to pay for fusion
+            if (not ::bra::fused_gate::is_fusion_preferable(static_cast< ::bra::bit_integer_type >(block_qubits.size()), block.size()))
+            {
+              for (auto const index: block)
+                push_gate(index);
+              continue;
+            }
+
+            result = std::max(result, static_cast< ::bra::bit_integer_type >(block_qubits.size()));
+            push_fusion_statement(std::make_unique< ::bra::gate::begin_fusion >(), std::vector< ::bra::bit_integer_type >{});
+            for (auto const index: block)
+            {
+              push_gate(index);
+              new_operated_qubits.back().clear();
+            }
+            push_fusion_statement(std::make_unique< ::bra::gate::end_fusion >(), std::move(block_qubits));
+            block_qubits = std::vector< ::bra::bit_integer_type >{};
+          }
+        };
+
+    for (auto index = size_type{0u}; index < num_gates; ++index)
+    {
+      if (is_labeled[index])
       {
-        auto const num_circuits = read_num_circuits(columns);
-        circuits_.resize(num_circuits);
-        label_maps_.resize(num_circuits);
-        first_indices_.resize(num_circuits, 0);
-        for (auto& circuit: circuits_)
-          circuit.reserve(num_reserved_gates);
+        flush_run();
+        new_indices[index] = static_cast<int>(new_circuit.size());
       }
-      else if (mnemonic == "QUBITS")
+
+      if (is_fusable_gate(circuit_index, index))
       {
+        run.push_back(index);
+        continue;
+      }
+
+      flush_run();
+      push_gate(index);
+    }
+    flush_run();
+    new_indices[num_gates] = static_cast<int>(new_circuit.size());
+
+    for (auto& label_index: label_maps_[circuit_index])
+      label_index.second = new_indices[static_cast<size_type>(label_index.second)];
+
+    circuit = std::move(new_circuit);
+    bytecode = std::move(new_bytecode);
+    operated_qubits = std::move(new_operated_qubits);
+    return result;
+  }
+
 #ifndef BRA_NO_MPI
-        num_qubits(
-          static_cast< ::bra::bit_integer_type >(read_num_qubits(columns)),
-          total_communicator, environment);
+  auto interpreter::interpret_header_statement(
+    interpreter::columns_type& columns, yampi::environment const& environment,
+    yampi::communicator const& total_communicator, size_type const num_reserved_gates)
+  -> bool
 #else // BRA_NO_MPI
-        num_qubits(
-          static_cast< ::bra::bit_integer_type >(read_num_qubits(columns)));
+  auto interpreter::interpret_header_statement(interpreter::columns_type& columns, size_type const num_reserved_gates) -> bool
 #endif // BRA_NO_MPI
-      }
-      else if (mnemonic == "DEPOLARIZING")
-      {
-        if (boost::size(columns) <= 2u)
-          throw wrong_mnemonics_error{columns};
+  {
+    auto const& mnemonic = columns.front();
 
-        boost::algorithm::to_upper(columns[1u]);
+    if (mnemonic == "CIRCUITS")
+    {
+      auto const num_circuits = read_num_circuits(columns);
+      circuits_.resize(num_circuits);
+      label_maps_.resize(num_circuits);
+      first_indices_.resize(num_circuits, 0);
+      num_uncheckpointed_instructions_.resize(num_circuits, 0);
+      operated_qubits_.resize(num_circuits);
+      bytecodes_.resize(num_circuits);
+      fallback_lines_.resize(num_circuits);
+      for (auto& circuit: circuits_)
+        circuit.reserve(num_reserved_gates);
+    }
+    else if (mnemonic == "QUBITS")
+    {
+#ifndef BRA_NO_MPI
+      num_qubits(
+        static_cast< ::bra::bit_integer_type >(read_num_qubits(columns)),
+        total_communicator, environment);
+#else // BRA_NO_MPI
+      num_qubits(
+        static_cast< ::bra::bit_integer_type >(read_num_qubits(columns)));
+#endif // BRA_NO_MPI
+    }
+    else if (mnemonic == "DEPOLARIZING")
+    {
+      if (boost::size(columns) <= 2u)
+        throw wrong_mnemonics_error{columns};
 
-        auto statement = ::bra::depolarizing_statement{};
-        std::tie(statement, depolarizing_px_, depolarizing_py_, depolarizing_pz_, depolarizing_seed_)
-          = read_depolarizing_statement(columns);
+      boost::algorithm::to_upper(columns[1u]);
 
-        if (statement != ::bra::depolarizing_statement::channel)
-          throw unsupported_mnemonic_error{mnemonic};
+      auto statement = ::bra::depolarizing_statement{};
+      std::tie(statement, depolarizing_px_, depolarizing_py_, depolarizing_pz_, depolarizing_seed_)
+        = read_depolarizing_statement(columns);
 
-        is_depolarizing_channel_ = true;
+      if (statement != ::bra::depolarizing_statement::channel)
+        throw unsupported_mnemonic_error{mnemonic};
+
+      is_depolarizing_channel_ = true;
+    }
+    else if (mnemonic == "INITIAL") // INITIAL STATE
+      initial_state_value_
+        = static_cast< ::bra::state_integer_type >(read_initial_state_value(columns));
+    else if (mnemonic == "MPIPROCESSES")
+    {
+      read_num_mpi_processes(columns);
+      // ignore this statement
+    }
+    else if (mnemonic == "MPISWAPBUFFER")
+    {
+      read_mpi_buffer_size(columns);
+      // ignore this statement
+    }
+    else if (mnemonic == "BIT") // BIT ASSIGNMENT
+    {
+      if (boost::size(columns) <= 1u)
+        throw wrong_mnemonics_error{columns};
+      boost::algorithm::to_upper(columns[1u]);
+
+      auto const statement = read_bit_statement(columns);
+
+      if (statement == ::bra::bit_statement::assignment)
+      {
+#ifndef BRA_NO_MPI
+        initial_permutation_ = read_initial_permutation(columns);
+#endif
       }
-      else if (mnemonic == "INITIAL") // INITIAL STATE
-        initial_state_value_
-          = static_cast< ::bra::state_integer_type >(read_initial_state_value(columns));
-      else if (mnemonic == "MPIPROCESSES")
+    }
+    else
+      return false;
+
+    return true;
+  }
+
+  auto interpreter::interpret_instruction(interpreter::columns_type& columns) -> bool
+  {
+    auto const& mnemonic = columns.front();
+    using std::begin;
+    using std::end;
+    if (mnemonic == "PERMUTATION")
+      throw unsupported_mnemonic_error{mnemonic};
+    else if (mnemonic == "RANDOM") // RANDOM PERMUTATION
+      throw unsupported_mnemonic_error{mnemonic};
+    else if (mnemonic == "VAR")
+      add_var(columns);
+    else if (mnemonic == "LET")
+      add_let(columns);
+    else if (mnemonic == "SEND")
+      add_send(columns);
+    else if (mnemonic == "RECEIVE")
+      add_receive(columns);
+    else if (mnemonic == "BROADCAST")
+      add_broadcast(columns);
+    else if (mnemonic == "GATHER")
+      add_gather(columns);
+    else if (mnemonic == "SCATTER")
+      add_scatter(columns);
+    else if (mnemonic == "PRINT")
+      add_print(columns);
+    else if (mnemonic == "PRINTLN")
+      add_println(columns);
+    else if (mnemonic.front() == '@')
+      add_label(columns, mnemonic);
+    else if (mnemonic == "JUMP")
+      add_jump(columns);
+    else if (mnemonic == "JUMPIF")
+      add_jumpif(columns);
+    else if (mnemonic == "I")
+      add_i(columns);
+    else if (mnemonic == "IC")
+      add_ic(columns);
+    else if (mnemonic == "II")
+      add_ii(columns);
+    else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('I') == std::string::npos)
+      add_is(columns, mnemonic);
+    else if (mnemonic.size() >= 2u and mnemonic.front() == 'I' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
+      add_in(columns, mnemonic);
+    else if (mnemonic == "H")
+      add_h(columns);
+    else if (mnemonic == "NOT")
+      add_not(columns);
+    else if (mnemonic == "X")
+      add_x(columns);
+    else if (mnemonic == "XX")
+      add_xx(columns);
+    else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('X') == std::string::npos)
+      add_xs(columns, mnemonic);
+    else if (mnemonic.size() >= 2u and mnemonic.front() == 'X' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
+      add_xn(columns, mnemonic);
+    else if (mnemonic == "Y")
+      add_y(columns);
+    else if (mnemonic == "YY")
+      add_yy(columns);
+    else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('Y') == std::string::npos)
+      add_ys(columns, mnemonic);
+    else if (mnemonic.size() >= 2u and mnemonic.front() == 'Y' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
+      add_yn(columns, mnemonic);
+    else if (mnemonic == "Z")
+      add_z(columns);
+    else if (mnemonic == "ZZ")
+      add_zz(columns);
+    else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('Z') == std::string::npos)
+      add_zs(columns, mnemonic);
+    else if (mnemonic.size() >= 2u and mnemonic.front() == 'Z' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
+      add_zn(columns, mnemonic);
+    else if (mnemonic == "SWAP")
+      add_swap(columns);
+    else if (mnemonic == "S")
+      add_s(columns);
+    else if (mnemonic == "S+")
+      add_adj_s(columns);
+    else if (mnemonic == "T")
+      add_t(columns);
+    else if (mnemonic == "T+")
+      add_adj_t(columns);
+    else if (mnemonic == "U1")
+      add_u1(columns);
+    else if (mnemonic == "U1+")
+      add_adj_u1(columns);
+    else if (mnemonic == "U2")
+      add_u2(columns);
+    else if (mnemonic == "U2+")
+      add_adj_u2(columns);
+    else if (mnemonic == "U3")
+      add_u3(columns);
+    else if (mnemonic == "U3+")
+      add_adj_u3(columns);
+    else if (mnemonic == "R")
+      add_r(columns);
+    else if (mnemonic == "R+")
+      add_adj_r(columns);
+    else if (mnemonic == "+X")
+      add_rotx(columns);
+    else if (mnemonic == "-X")
+      add_adj_rotx(columns);
+    else if (mnemonic == "+Y")
+      add_roty(columns);
+    else if (mnemonic == "-Y")
+      add_adj_roty(columns);
+    else if (mnemonic == "U")
+      add_u(columns);
+    else if (mnemonic == "U+")
+      add_adj_u(columns);
+    else if (mnemonic == "EXIT")
+    {
+      if (boost::size(columns) != 1u)
+        throw wrong_mnemonics_error{columns};
+
+#ifndef BRA_NO_MPI
+      circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::exit >(root_));
+#else // BRA_NO_MPI
+      circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::exit >());
+#endif // BRA_NO_MPI
+      return false;
+    }
+    else if (mnemonic == "EX")
+      add_ex(columns);
+    else if (mnemonic == "EX+")
+      add_adj_ex(columns);
+    else if (mnemonic == "EXX")
+      add_exx(columns);
+    else if (mnemonic == "EXX+")
+      add_adj_exx(columns);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic.find_first_not_of('X', 1u) == std::string::npos)
+      add_exs(columns, mnemonic);
+    else if (mnemonic.size() >= 5u and mnemonic.front() == 'E' and mnemonic.back() == '+' and mnemonic.find_first_not_of('X', 1u) == mnemonic.size() - 1u)
+      add_adj_exs(columns, mnemonic);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic[1] == 'X' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
+      add_adj_exn(columns, mnemonic);
+    else if (mnemonic.size() >= 3u and mnemonic.front() == 'E' and mnemonic[1] == 'X' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
+      add_exn(columns, mnemonic);
+    else if (mnemonic == "EY")
+      add_ey(columns);
+    else if (mnemonic == "EY+")
+      add_adj_ey(columns);
+    else if (mnemonic == "EYY")
+      add_eyy(columns);
+    else if (mnemonic == "EYY+")
+      add_adj_eyy(columns);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic.find_first_not_of('Y', 1u) == std::string::npos)
+      add_eys(columns, mnemonic);
+    else if (mnemonic.size() >= 5u and mnemonic.front() == 'E' and mnemonic.back() == '+' and mnemonic.find_first_not_of('Y', 1u) == mnemonic.size() - 1u)
+      add_adj_eys(columns, mnemonic);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic[1] == 'Y' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
+      add_adj_eyn(columns, mnemonic);
+    else if (mnemonic.size() >= 3u and mnemonic.front() == 'E' and mnemonic[1] == 'Y' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
+      add_eyn(columns, mnemonic);
+    else if (mnemonic == "EZ")
+      add_ez(columns);
+    else if (mnemonic == "EZ+")
+      add_adj_ez(columns);
+    else if (mnemonic == "EZZ")
+      add_ezz(columns);
+    else if (mnemonic == "EZZ+")
+      add_adj_ezz(columns);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic.find_first_not_of('Z', 1u) == std::string::npos)
+      add_ezs(columns, mnemonic);
+    else if (mnemonic.size() >= 5u and mnemonic.front() == 'E' and mnemonic.back() == '+' and mnemonic.find_first_not_of('Z', 1u) == mnemonic.size() - 1u)
+      add_adj_ezs(columns, mnemonic);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic[1] == 'Z' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
+      add_adj_ezn(columns, mnemonic);
+    else if (mnemonic.size() >= 3u and mnemonic.front() == 'E' and mnemonic[1] == 'Z' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
+      add_ezn(columns, mnemonic);
+    else if (mnemonic == "ESWAP")
+      add_eswap(columns);
+    else if (mnemonic == "ESWAP+")
+      add_adj_eswap(columns);
+    else if (mnemonic == "TOFFOLI")
+      add_toffoli(columns);
+    else if (mnemonic == "M")
+      add_m(columns);
+    else if (mnemonic == "SHORBOX")
+      add_shor_box(columns);
+    else if (mnemonic == "BEGIN") // BEGIN MEASUREMENT/LEARNING MACHINE/FUSION/CIRCUIT
+    {
+      if (columns.size() <= 1u)
+        throw wrong_mnemonics_error{columns};
+
+      std::for_each(
+        std::next(begin(columns)), end(columns),
+        [](std::string& str) { boost::algorithm::to_upper(str); });
+
+      auto const statement = read_begin_statement(columns);
+
+      if (statement == ::bra::begin_statement::measurement)
       {
-        read_num_mpi_processes(columns);
-        // ignore this statement
+#ifndef BRA_NO_MPI
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(root_, 3));
+#else // BRA_NO_MPI
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(3));
+#endif // BRA_NO_MPI
       }
-      else if (mnemonic == "MPISWAPBUFFER")
+      else if (statement == ::bra::begin_statement::fusion)
       {
-        read_mpi_buffer_size(columns);
-        // ignore this statement
+        fusion_first_index_ = static_cast<int>(circuits_[circuit_index_].size());
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::begin_fusion >());
       }
-      else if (mnemonic == "BIT") // BIT ASSIGNMENT
+      else if (statement == ::bra::begin_statement::circuit)
       {
-        if (boost::size(columns) <= 1u)
+        if (columns.size() != 3u)
           throw wrong_mnemonics_error{columns};
-        boost::algorithm::to_upper(columns[1u]);
 
-        auto const statement = read_bit_statement(columns);
+        if (is_in_circuit_)
+          throw wrong_mnemonics_error{columns};
 
-        if (statement == ::bra::bit_statement::assignment)
-        {
-#ifndef BRA_NO_MPI
-          initial_permutation_ = read_initial_permutation(columns);
-#endif
-        }
+        using std::begin;
+        auto iter = begin(columns);
+        ++iter;
+        circuit_index_ = boost::lexical_cast<int>(*++iter);
+        is_in_circuit_ = true;
+        if (circuit_index_ < 0 or circuit_index_ >= static_cast<int>(circuits_.size()))
+          throw wrong_mnemonics_error{columns};
       }
-      else if (mnemonic == "PERMUTATION")
+      else if (statement == ::bra::begin_statement::learning_machine)
         throw unsupported_mnemonic_error{mnemonic};
-      else if (mnemonic == "RANDOM") // RANDOM PERMUTATION
+      else
         throw unsupported_mnemonic_error{mnemonic};
-      else if (mnemonic == "VAR")
-        add_var(columns);
-      else if (mnemonic == "LET")
-        add_let(columns);
-      else if (mnemonic == "SEND")
-        add_send(columns);
-      else if (mnemonic == "RECEIVE")
-        add_receive(columns);
-      else if (mnemonic == "BROADCAST")
-        add_broadcast(columns);
-      else if (mnemonic == "GATHER")
-        add_gather(columns);
-      else if (mnemonic == "SCATTER")
-        add_scatter(columns);
-      else if (mnemonic == "PRINT")
-        add_print(columns);
-      else if (mnemonic == "PRINTLN")
-        add_println(columns);
-      else if (mnemonic.front() == '@')
-        add_label(columns, mnemonic);
-      else if (mnemonic == "JUMP")
-        add_jump(columns);
-      else if (mnemonic == "JUMPIF")
-        add_jumpif(columns);
-      else if (mnemonic == "I")
-        add_i(columns);
-      else if (mnemonic == "IC")
-        add_ic(columns);
-      else if (mnemonic == "II")
-        add_ii(columns);
-      else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('I') == std::string::npos)
-        add_is(columns, mnemonic);
-      else if (mnemonic.size() >= 2u and mnemonic.front() == 'I' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
-        add_in(columns, mnemonic);
-      else if (mnemonic == "H")
-        add_h(columns);
-      else if (mnemonic == "NOT")
-        add_not(columns);
-      else if (mnemonic == "X")
-        add_x(columns);
-      else if (mnemonic == "XX")
-        add_xx(columns);
-      else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('X') == std::string::npos)
-        add_xs(columns, mnemonic);
-      else if (mnemonic.size() >= 2u and mnemonic.front() == 'X' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
-        add_xn(columns, mnemonic);
-      else if (mnemonic == "Y")
-        add_y(columns);
-      else if (mnemonic == "YY")
-        add_yy(columns);
-      else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('Y') == std::string::npos)
-        add_ys(columns, mnemonic);
-      else if (mnemonic.size() >= 2u and mnemonic.front() == 'Y' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
-        add_yn(columns, mnemonic);
-      else if (mnemonic == "Z")
-        add_z(columns);
-      else if (mnemonic == "ZZ")
-        add_zz(columns);
-      else if (mnemonic.size() >= 3u and mnemonic.find_first_not_of('Z') == std::string::npos)
-        add_zs(columns, mnemonic);
-      else if (mnemonic.size() >= 2u and mnemonic.front() == 'Z' and mnemonic.find_first_not_of("0123456789", 1u) == std::string::npos)
-        add_zn(columns, mnemonic);
-      else if (mnemonic == "SWAP")
-        add_swap(columns);
-      else if (mnemonic == "S")
-        add_s(columns);
-      else if (mnemonic == "S+")
-        add_adj_s(columns);
-      else if (mnemonic == "T")
-        add_t(columns);
-      else if (mnemonic == "T+")
-        add_adj_t(columns);
-      else if (mnemonic == "U1")
-        add_u1(columns);
-      else if (mnemonic == "U1+")
-        add_adj_u1(columns);
-      else if (mnemonic == "U2")
-        add_u2(columns);
-      else if (mnemonic == "U2+")
-        add_adj_u2(columns);
-      else if (mnemonic == "U3")
-        add_u3(columns);
-      else if (mnemonic == "U3+")
-        add_adj_u3(columns);
-      else if (mnemonic == "R")
-        add_r(columns);
-      else if (mnemonic == "R+")
-        add_adj_r(columns);
-      else if (mnemonic == "+X")
-        add_rotx(columns);
-      else if (mnemonic == "-X")
-        add_adj_rotx(columns);
-      else if (mnemonic == "+Y")
-        add_roty(columns);
-      else if (mnemonic == "-Y")
-        add_adj_roty(columns);
-      else if (mnemonic == "U")
-        add_u(columns);
-      else if (mnemonic == "U+")
-        add_adj_u(columns);
-      else if (mnemonic == "EXIT")
-      {
-        if (boost::size(columns) != 1u)
-          throw wrong_mnemonics_error{columns};
+    }
+    else if (mnemonic == "DO") // DO MEASUREMENT
+    {
+      if (columns.size() <= 1u)
+        throw wrong_mnemonics_error{columns};
+
+      std::for_each(
+        std::next(begin(columns)), end(columns),
+        [](std::string& str) { boost::algorithm::to_upper(str); });
+
+      auto const statement = read_do_statement(columns);
 
+      if (statement == ::bra::do_statement::measurement)
+      {
+        auto const precision = columns.size() == 3u ? boost::lexical_cast<int>(columns[2u]) : 3;
 #ifndef BRA_NO_MPI
-        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::exit >(root_));
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(root_, precision));
 #else // BRA_NO_MPI
-        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::exit >());
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(precision));
 #endif // BRA_NO_MPI
-        break;
       }
-      else if (mnemonic == "EX")
-        add_ex(columns);
-      else if (mnemonic == "EX+")
-        add_adj_ex(columns);
-      else if (mnemonic == "EXX")
-        add_exx(columns);
-      else if (mnemonic == "EXX+")
-        add_adj_exx(columns);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic.find_first_not_of('X', 1u) == std::string::npos)
-        add_exs(columns, mnemonic);
-      else if (mnemonic.size() >= 5u and mnemonic.front() == 'E' and mnemonic.back() == '+' and mnemonic.find_first_not_of('X', 1u) == mnemonic.size() - 1u)
-        add_adj_exs(columns, mnemonic);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic[1] == 'X' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
-        add_adj_exn(columns, mnemonic);
-      else if (mnemonic.size() >= 3u and mnemonic.front() == 'E' and mnemonic[1] == 'X' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
-        add_exn(columns, mnemonic);
-      else if (mnemonic == "EY")
-        add_ey(columns);
-      else if (mnemonic == "EY+")
-        add_adj_ey(columns);
-      else if (mnemonic == "EYY")
-        add_eyy(columns);
-      else if (mnemonic == "EYY+")
-        add_adj_eyy(columns);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic.find_first_not_of('Y', 1u) == std::string::npos)
-        add_eys(columns, mnemonic);
-      else if (mnemonic.size() >= 5u and mnemonic.front() == 'E' and mnemonic.back() == '+' and mnemonic.find_first_not_of('Y', 1u) == mnemonic.size() - 1u)
-        add_adj_eys(columns, mnemonic);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic[1] == 'Y' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
-        add_adj_eyn(columns, mnemonic);
-      else if (mnemonic.size() >= 3u and mnemonic.front() == 'E' and mnemonic[1] == 'Y' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
-        add_eyn(columns, mnemonic);
-      else if (mnemonic == "EZ")
-        add_ez(columns);
-      else if (mnemonic == "EZ+")
-        add_adj_ez(columns);
-      else if (mnemonic == "EZZ")
-        add_ezz(columns);
-      else if (mnemonic == "EZZ+")
-        add_adj_ezz(columns);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic.find_first_not_of('Z', 1u) == std::string::npos)
-        add_ezs(columns, mnemonic);
-      else if (mnemonic.size() >= 5u and mnemonic.front() == 'E' and mnemonic.back() == '+' and mnemonic.find_first_not_of('Z', 1u) == mnemonic.size() - 1u)
-        add_adj_ezs(columns, mnemonic);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'E' and mnemonic[1] == 'Z' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
-        add_adj_ezn(columns, mnemonic);
-      else if (mnemonic.size() >= 3u and mnemonic.front() == 'E' and mnemonic[1] == 'Z' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
-        add_ezn(columns, mnemonic);
-      else if (mnemonic == "ESWAP")
-        add_eswap(columns);
-      else if (mnemonic == "ESWAP+")
-        add_adj_eswap(columns);
-      else if (mnemonic == "TOFFOLI")
-        add_toffoli(columns);
-      else if (mnemonic == "M")
-        add_m(columns);
-      else if (mnemonic == "SHORBOX")
-        add_shor_box(columns);
-      else if (mnemonic == "BEGIN") // BEGIN MEASUREMENT/LEARNING MACHINE/FUSION/CIRCUIT
+      else if (statement == ::bra::do_statement::amplitudes)
       {
-        if (columns.size() <= 1u)
-          throw wrong_mnemonics_error{columns};
+        auto iter = begin(columns);
+        ++iter;
+        ++iter;
+        auto const last = end(columns);
+        auto amplitude_indices = std::vector< ::bra::state_integer_type >{};
+        amplitude_indices.reserve(last - iter);
+        for (; iter != last; ++iter)
+          amplitude_indices.push_back(boost::lexical_cast< ::bra::state_integer_type >(*iter));
 
-        std::for_each(
-          std::next(begin(columns)), end(columns),
-          [](std::string& str) { boost::algorithm::to_upper(str); });
-
-        auto const statement = read_begin_statement(columns);
-
-        if (statement == ::bra::begin_statement::measurement)
-        {
 #ifndef BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(root_, 3));
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::amplitudes >(root_, std::move(amplitude_indices)));
 #else // BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(3));
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::amplitudes >(std::move(amplitude_indices)));
 #endif // BRA_NO_MPI
-        }
-        else if (statement == ::bra::begin_statement::fusion)
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::begin_fusion >());
-        else if (statement == ::bra::begin_statement::circuit)
+      }
+      else
+        throw unsupported_mnemonic_error{mnemonic};
+    }
+    else if (mnemonic == "END") // END MEASUREMENT/LEARNING MACHINE/FUSION/CIRCUIT
+    {
+      auto const statement = read_end_statement(columns);
+
+      if (statement == ::bra::end_statement::fusion)
+      {
+        // All fused gates are applied at END FUSION
+        auto& operated_qubits = operated_qubits_[circuit_index_];
+        auto fused_qubits = std::vector< ::bra::bit_integer_type >{};
+        for (auto index = static_cast<std::size_t>(fusion_first_index_); index < operated_qubits.size(); ++index)
         {
-          if (columns.size() != 3u)
-            throw wrong_mnemonics_error{columns};
-
-          if (is_in_circuit_)
-            throw wrong_mnemonics_error{columns};
-
-          using std::begin;
-          auto iter = begin(columns);
-          ++iter;
-          circuit_index_ = boost::lexical_cast<int>(*++iter);
-          is_in_circuit_ = true;
-          if (circuit_index_ < 0 or circuit_index_ >= static_cast<int>(circuits_.size()))
-            throw wrong_mnemonics_error{columns};
+          for (auto const qubit: operated_qubits[index])
+            if (std::find(begin(fused_qubits), end(fused_qubits), qubit) == end(fused_qubits))
+              fused_qubits.push_back(qubit);
+          operated_qubits[index].clear();
         }
-        else if (statement == ::bra::begin_statement::learning_machine)
-          throw unsupported_mnemonic_error{mnemonic};
-        else
-          throw unsupported_mnemonic_error{mnemonic};
+
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::end_fusion >());
+        operated_qubits.resize(circuits_[circuit_index_].size());
+        operated_qubits.back() = std::move(fused_qubits);
       }
-      else if (mnemonic == "DO") // DO MEASUREMENT
+      else if (statement == ::bra::end_statement::circuit)
       {
-        if (columns.size() <= 1u)
+        if (not is_in_circuit_)
           throw wrong_mnemonics_error{columns};
 
-        std::for_each(
-          std::next(begin(columns)), end(columns),
-          [](std::string& str) { boost::algorithm::to_upper(str); });
+        circuit_index_ = 0;
+        is_in_circuit_ = false;
+      }
+      else
+        throw unsupported_mnemonic_error{mnemonic};
+      /*
+      auto const statement = read_end_statement(columns);
+
+      if (statement == ::bra::end_statement::measurement)
+      {
+#ifndef BRA_NO_MPI
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(root_));
+#else // BRA_NO_MPI
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >());
+#endif // BRA_NO_MPI
+      }
+      else if (statement == ::bra::end_statement::learning_machine)
+        throw unsupported_mnemonic_error{mnemonic};
+
+      throw unsupported_mnemonic_error{mnemonic};
+*/
+    }
+    else if (mnemonic == "GENERATE") // GENERATE EVENTS
+    {
+      if (boost::size(columns) != 4u)
+        throw wrong_mnemonics_error{columns};
+
+      boost::algorithm::to_upper(columns[1u]);
 
-        auto const statement = read_do_statement(columns);
+      auto statement = ::bra::generate_statement{};
+      auto num_events = int{};
+      auto seed = int{};
+      std::tie(statement, num_events, seed) = read_generate_statement(columns);
 
-        if (statement == ::bra::do_statement::measurement)
-        {
-          auto const precision = columns.size() == 3u ? boost::lexical_cast<int>(columns[2u]) : 3;
+      if (statement == ::bra::generate_statement::events)
+      {
 #ifndef BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(root_, precision));
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::generate_events >(root_, num_events, seed));
 #else // BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(precision));
+        circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::generate_events >(num_events, seed));
 #endif // BRA_NO_MPI
-        }
-        else if (statement == ::bra::do_statement::amplitudes)
-        {
-          auto iter = begin(columns);
-          ++iter;
-          ++iter;
-          auto const last = end(columns);
-          auto amplitude_indices = std::vector< ::bra::state_integer_type >{};
-          amplitude_indices.reserve(last - iter);
-          for (; iter != last; ++iter)
-            amplitude_indices.push_back(boost::lexical_cast< ::bra::state_integer_type >(*iter));
+        return false;
+      }
+    }
+    else if (mnemonic == "EXPECTATION")
+      add_expectation_value(columns);
+    else if (mnemonic == "INNERPROD")
+      add_inner_product(columns);
+    else if (mnemonic == "FIDELITY")
+      add_fidelity(columns);
+    else if (mnemonic == "CLEAR")
+      add_clear(columns);
+    else if (mnemonic == "SET")
+      add_set(columns);
+    else if (mnemonic == "SAVE") // SAVE STATE
+      add_save_state(columns);
+    else if (mnemonic == "LOAD") // LOAD STATE
+      add_load_state(columns);
+    else if (mnemonic == "SX")
+      add_sx(columns);
+    else if (mnemonic == "SX+")
+      add_adj_sx(columns);
+    else if (mnemonic == "SY")
+      add_sy(columns);
+    else if (mnemonic == "SY+")
+      add_adj_sy(columns);
+    else if (mnemonic == "SZ")
+      add_sz(columns);
+    else if (mnemonic == "SZ+")
+      add_adj_sz(columns);
+    else if (mnemonic == "SZZ")
+      add_szz(columns);
+    else if (mnemonic == "SZZ+")
+      add_adj_szz(columns);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'S' and mnemonic.find_first_not_of('Z', 1u) == std::string::npos)
+      add_szs(columns, mnemonic);
+    else if (mnemonic.size() >= 5u and mnemonic.front() == 'S' and mnemonic.back() == '+' and mnemonic.find_first_not_of('Z', 1u) == mnemonic.size() - 1u)
+      add_adj_szs(columns, mnemonic);
+    else if (mnemonic.size() >= 4u and mnemonic.front() == 'S' and mnemonic[1] == 'Z' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
+      add_adj_szn(columns, mnemonic);
+    else if (mnemonic.size() >= 3u and mnemonic.front() == 'S' and mnemonic[1] == 'Z' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
+      add_szn(columns, mnemonic);
+    else if (mnemonic.size() >= 2u and mnemonic.front() == 'C') // controlled gates
+      interpret_controlled_gates(columns, mnemonic);
+    else
+      throw unsupported_mnemonic_error{mnemonic};
 
+    return true;
+  }
+
+  // Headers are interpreted, and offsets of labels and the first lines of circuits are recorded without generating gates.
+  // Offsets are counted by characters in lines, so input files are opened in binary mode
 #ifndef BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::amplitudes >(root_, std::move(amplitude_indices)));
+  auto interpreter::scan(
+    std::istream& input_stream, yampi::environment const& environment, yampi::communicator const& total_communicator)
+  -> void
 #else // BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::amplitudes >(std::move(amplitude_indices)));
+  auto interpreter::scan(std::istream& input_stream) -> void
 #endif // BRA_NO_MPI
+  {
+    // first_offsets[circuit_index]: the offset of the line next to the first BEGIN CIRCUIT circuit_index, or -1 if it does not exist
+    auto first_offsets = std::vector<std::streamoff>{};
+
+    auto line = std::string{};
+    auto columns = columns_type{};
+    columns.reserve(10u);
+    auto offset = std::streamoff{0};
+
+    while (std::getline(input_stream, line))
+    {
+      offset += static_cast<std::streamoff>(line.size()) + std::streamoff{1};
+
+      if (not ::bra::interpreter_detail::split_columns(line, columns))
+        continue;
+
+#ifndef BRA_NO_MPI
+      if (interpret_header_statement(columns, environment, total_communicator, size_type{0u}))
+        continue;
+#else // BRA_NO_MPI
+      if (interpret_header_statement(columns, size_type{0u}))
+        continue;
+#endif // BRA_NO_MPI
+
+      auto const& mnemonic = columns.front();
+      using std::begin;
+      using std::end;
+      if (::bra::interpreter_detail::is_block_statement(columns, "CIRCUIT"))
+      {
+        interpret_instruction(columns);
+
+        if (is_in_circuit_)
+        {
+          if (first_offsets.size() <= static_cast<std::size_t>(circuit_index_))
+            first_offsets.resize(circuit_index_ + 1, std::streamoff{-1});
+          if (first_offsets[circuit_index_] < std::streamoff{0})
+            first_offsets[circuit_index_] = offset;
         }
-        else
-          throw unsupported_mnemonic_error{mnemonic};
       }
-      else if (mnemonic == "END") // END MEASUREMENT/LEARNING MACHINE/FUSION/CIRCUIT
+      else if (mnemonic.front() == '@')
       {
-        auto const statement = read_end_statement(columns);
+        if (boost::size(columns) != 1u)
+          throw wrong_mnemonics_error{columns};
 
-        if (statement == ::bra::end_statement::fusion)
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::end_fusion >());
-        else if (statement == ::bra::end_statement::circuit)
-        {
-          if (not is_in_circuit_)
-            throw wrong_mnemonics_error{columns};
+        if (label_offsets_.size() < circuits_.size())
+          label_offsets_.resize(circuits_.size());
+
+        auto& label_offsets = label_offsets_[circuit_index_];
+        auto label = std::string{std::next(begin(mnemonic)), end(mnemonic)};
+        if (label_offsets.find(label) != end(label_offsets))
+          throw wrong_mnemonics_error{columns};
+
+        label_offsets.emplace(std::move(label), std::make_pair(offset, is_in_circuit_));
+      }
+      else if (mnemonic == "EXIT")
+        break;
+      else if (mnemonic == "GENERATE" and boost::size(columns) == 4u and boost::algorithm::iequals(columns[1u], "EVENTS"))
+        break;
+    }
+
+    end_offset_ = offset;
+    circuit_index_ = 0;
+    is_in_circuit_ = false;
 
-          circuit_index_ = 0;
-          is_in_circuit_ = false;
+    auto const num_circuits = circuits_.size();
+    label_offsets_.resize(num_circuits);
+    streamed_chunks_.resize(num_circuits);
+    circuit_streams_.clear();
+    circuit_streams_.reserve(num_circuits);
+    circuit_streams_.push_back(std::make_unique< ::bra::circuit_stream >(filename_, std::streamoff{0}, false));
+    for (auto circuit_index = std::size_t{1u}; circuit_index < num_circuits; ++circuit_index)
+      circuit_streams_.push_back(
+        std::make_unique< ::bra::circuit_stream >(
+          filename_,
+          circuit_index < first_offsets.size() and first_offsets[circuit_index] >= std::streamoff{0}
+            ? first_offsets[circuit_index] : end_offset_,
+          true));
+  }
+
+  // Only one reader thread runs at a time because apply_streaming_circuit stops the reader before returning,
+  // so members of the interpreter are updated by the reader without locks
+  auto interpreter::read_streaming_circuit(::bra::circuit_stream& stream, int const circuit_index) -> void
+  {
+    auto& input_stream = stream.input_stream();
+    input_stream.clear();
+    input_stream.seekg(stream.next_offset());
+
+    auto offset = stream.next_offset();
+    circuit_index_ = circuit_index;
+    is_in_circuit_ = stream.is_in_circuit();
+
+    auto& circuit = circuits_[circuit_index];
+    auto& operated_qubits = operated_qubits_[circuit_index];
+    circuit.clear();
+    circuit.reserve(BRA_STREAMING_CHUNK_SIZE);
+    operated_qubits.clear();
+
+    auto line = std::string{};
+    auto columns = columns_type{};
+    columns.reserve(10u);
+    // gates in BEGIN FUSION ... END FUSION are pushed in one chunk because fusion_first_index_ is an index in the chunk
+    auto is_in_fusion = false;
+    auto is_end_of_circuit = true;
+
+    while (offset < end_offset_)
+    {
+      if (not is_in_fusion)
+      {
+        if (stream.is_stop_requested())
+        {
+          is_end_of_circuit = false;
+          break;
         }
-        else
-          throw unsupported_mnemonic_error{mnemonic};
-        /*
-        auto const statement = read_end_statement(columns);
 
-        if (statement == ::bra::end_statement::measurement)
+        if (circuit.size() >= BRA_STREAMING_CHUNK_SIZE)
         {
-#ifndef BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >(root_));
-#else // BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::measurement >());
-#endif // BRA_NO_MPI
+          stream.push(std::move(circuit));
+          circuit = circuit_type{};
+          circuit.reserve(BRA_STREAMING_CHUNK_SIZE);
+          operated_qubits.clear();
         }
-        else if (statement == ::bra::end_statement::learning_machine)
-          throw unsupported_mnemonic_error{mnemonic};
+      }
 
-        throw unsupported_mnemonic_error{mnemonic};
-*/
+      if (not std::getline(input_stream, line))
+        break;
+      offset += static_cast<std::streamoff>(line.size()) + std::streamoff{1};
+
+      if (not ::bra::interpreter_detail::split_columns(line, columns))
+        continue;
+
+      auto const& mnemonic = columns.front();
+      if (::bra::interpreter_detail::is_header_mnemonic(mnemonic) or mnemonic.front() == '@')
+        continue;
+
+      if (::bra::interpreter_detail::is_block_statement(columns, "CIRCUIT"))
+      {
+        interpret_instruction(columns);
+        continue;
       }
-      else if (mnemonic == "GENERATE") // GENERATE EVENTS
+
+      if (circuit_index_ != circuit_index)
+        continue;
+
+      if (::bra::interpreter_detail::is_block_statement(columns, "FUSION"))
+        is_in_fusion = mnemonic == "BEGIN";
+
+      if (not interpret_instruction(columns))
+        break;
+    }
+
+    if (not circuit.empty())
+    {
+      stream.push(std::move(circuit));
+      circuit = circuit_type{};
+    }
+    operated_qubits.clear();
+
+    stream.finish(offset, is_in_circuit_, is_end_of_circuit);
+  }
+
+  // The bytecode file has header lines, and labels, instructions and lines of gates of opcode::gate of each circuit
+  auto interpreter::save_bytecode(std::string const& filename) const -> void
+  {
+    assert(not is_streaming_);
+
+    auto bytes = ::bra::bytecode_detail::header_bytes();
+    ::bra::bytecode_detail::write(bytes, static_cast<std::uint64_t>(largest_num_operated_qubits_));
+    ::bra::bytecode_detail::write(bytes, static_cast<std::uint64_t>(header_lines_.size()));
+    for (auto const& line: header_lines_)
+      ::bra::bytecode_detail::write_string(bytes, line);
+
+    auto const num_circuits = circuits_.size();
+    ::bra::bytecode_detail::write(bytes, static_cast<std::uint64_t>(num_circuits));
+    for (auto circuit_index = std::size_t{0u}; circuit_index < num_circuits; ++circuit_index)
+    {
+      ::bra::bytecode_detail::write(bytes, static_cast<std::uint64_t>(label_maps_[circuit_index].size()));
+      for (auto const& label_index: label_maps_[circuit_index])
       {
-        if (boost::size(columns) != 4u)
-          throw wrong_mnemonics_error{columns};
+        ::bra::bytecode_detail::write_string(bytes, label_index.first);
+        ::bra::bytecode_detail::write(bytes, static_cast<std::int64_t>(label_index.second));
+      }
 
-        boost::algorithm::to_upper(columns[1u]);
+      auto const& bytecode = bytecodes_[circuit_index];
+      ::bra::bytecode_detail::write_array(bytes, bytecode.data(), bytecode.size());
 
-        auto statement = ::bra::generate_statement{};
-        auto num_events = int{};
-        auto seed = int{};
-        std::tie(statement, num_events, seed) = read_generate_statement(columns);
+      ::bra::bytecode_detail::write(bytes, static_cast<std::uint64_t>(fallback_lines_[circuit_index].size()));
+      for (auto const& line: fallback_lines_[circuit_index])
+        ::bra::bytecode_detail::write_string(bytes, line);
+    }
 
-        if (statement == ::bra::generate_statement::events)
-        {
+    std::ofstream output_stream{filename, std::ios_base::out bitor std::ios_base::binary bitor std::ios_base::trunc};
+    if (not output_stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+      throw std::runtime_error{(filename + " cannot be written").c_str()};
+  }
+
+  // Gates of opcodes other than opcode::gate are generated from instructions, and the others are generated by interpreting saved lines
 #ifndef BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::generate_events >(root_, num_events, seed));
+  auto interpreter::load_bytecode(
+    std::string const& filename, yampi::environment const& environment, yampi::communicator const& total_communicator)
+  -> void
 #else // BRA_NO_MPI
-          circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::generate_events >(num_events, seed));
+  auto interpreter::load_bytecode(std::string const& filename) -> void
 #endif // BRA_NO_MPI
-          break;
+  {
+    ::bra::mapped_file const file{filename};
+    auto bytecode_reader = ::bra::bytecode_detail::reader{filename, file.data(), file.size()};
+    ::bra::bytecode_detail::read_header(bytecode_reader, filename);
+
+    auto const largest_num_operated_qubits = bytecode_reader.read<std::uint64_t>();
+
+    auto line = std::string{};
+    auto columns = columns_type{};
+    columns.reserve(10u);
+
+    auto const num_header_lines = bytecode_reader.read<std::uint64_t>();
+    for (auto count = std::uint64_t{0u}; count < num_header_lines; ++count)
+    {
+      line = bytecode_reader.read_string();
+      if (not ::bra::interpreter_detail::split_columns(line, columns))
+        throw ::bra::wrong_bytecode_file_error{filename, "broken header"};
+
+#ifndef BRA_NO_MPI
+      if (not interpret_header_statement(columns, environment, total_communicator, size_type{0u}))
+#else // BRA_NO_MPI
+      if (not interpret_header_statement(columns, size_type{0u}))
+#endif // BRA_NO_MPI
+        throw ::bra::wrong_bytecode_file_error{filename, "broken header"};
+
+      header_lines_.push_back(line);
+    }
+
+    if (largest_num_operated_qubits > static_cast<std::uint64_t>(num_qubits_))
+      throw ::bra::wrong_bytecode_file_error{filename, "too many operated qubits"};
+
+    auto const num_circuits = bytecode_reader.read<std::uint64_t>();
+    if (num_circuits != static_cast<std::uint64_t>(circuits_.size()))
+      throw ::bra::wrong_bytecode_file_error{filename, "the number of circuits is inconsistent with the header"};
+
+    for (auto circuit_index = 0; circuit_index < static_cast<int>(num_circuits); ++circuit_index)
+    {
+      circuit_index_ = circuit_index;
+
+      // Labels are checked after instructions are read because they are indices of instructions
+      auto labels = std::vector<std::pair<std::string, std::int64_t>>{};
+      auto const num_labels = bytecode_reader.read<std::uint64_t>();
+      for (auto count = std::uint64_t{0u}; count < num_labels; ++count)
+      {
+        auto label = bytecode_reader.read_string();
+        labels.emplace_back(std::move(label), bytecode_reader.read<std::int64_t>());
+      }
+
+      auto& bytecode = bytecodes_[circuit_index];
+      bytecode_reader.read_array(bytecode);
+
+      // A label may be at the end of the circuit
+      auto& label_map = label_maps_[circuit_index];
+      for (auto& label_index: labels)
+      {
+        if (label_index.second < std::int64_t{0} or label_index.second > static_cast<std::int64_t>(bytecode.size()))
+          throw ::bra::wrong_bytecode_file_error{filename, "label out of range"};
+        if (not label_map.emplace(std::move(label_index.first), static_cast<int>(label_index.second)).second)
+          throw ::bra::wrong_bytecode_file_error{filename, "duplicate label"};
+      }
+
+      auto& circuit = circuits_[circuit_index];
+      auto& operated_qubits = operated_qubits_[circuit_index];
+      circuit.reserve(bytecode.size());
+
+      auto const num_fallback_lines = bytecode_reader.read<std::uint64_t>();
+      auto num_read_lines = std::uint64_t{0u};
+      auto const num_instructions = bytecode.size();
+      for (auto index = std::size_t{0u}; index < num_instructions; )
+      {
+        auto const& instruction = bytecode[index];
+        if (not ::bra::bytecode_detail::has_valid_flags(instruction))
+          throw ::bra::wrong_bytecode_file_error{filename, "broken instruction"};
+
+        if (instruction.opcode != ::bra::opcode::gate)
+        {
+          if (instruction.opcode > ::bra::opcode::adj_exponential_pauli_z)
+            throw ::bra::wrong_bytecode_file_error{filename, "unknown opcode"};
+
+          auto const num_operated_qubits = ::bra::num_operated_qubits(instruction.opcode);
+          for (auto qubit_index = std::size_t{0u}; qubit_index < num_operated_qubits; ++qubit_index)
+            if (instruction.qubits[qubit_index] >= num_qubits_)
+              throw ::bra::wrong_bytecode_file_error{filename, "qubit out of range"};
+          if (num_operated_qubits == 2u and instruction.qubits[0u] == instruction.qubits[1u])
+            throw ::bra::wrong_bytecode_file_error{filename, "the same qubit is operated twice"};
+
+          operated_qubits.resize(index + 1u);
+          operated_qubits.back().assign(instruction.qubits, instruction.qubits + num_operated_qubits);
+          circuit.push_back(::bra::make_gate(instruction));
+          if (circuit.back()->is_diagonal() != instruction.is_diagonal)
+            throw ::bra::wrong_bytecode_file_error{filename, "broken instruction"};
+          ++index;
+          continue;
         }
+
+        if (num_read_lines++ == num_fallback_lines)
+          throw ::bra::wrong_bytecode_file_error{filename, "lines of gates are missing"};
+
+        line = bytecode_reader.read_string();
+        if (not ::bra::interpreter_detail::split_columns(line, columns))
+          throw ::bra::wrong_bytecode_file_error{filename, "broken line of gates"};
+        interpret_instruction(columns);
+        fallback_lines_[circuit_index].push_back(line);
+
+        // interpret_instruction(columns) should generate gates of opcode::gate at index, index + 1, ...
+        if (circuit.size() <= index or circuit.size() > num_instructions or circuit_index_ != circuit_index)
+          throw ::bra::wrong_bytecode_file_error{filename, "broken line of gates"};
+        for (; index < circuit.size(); ++index)
+          if (bytecode[index].opcode != ::bra::opcode::gate
+              or not ::bra::bytecode_detail::has_valid_flags(bytecode[index])
+              or bytecode[index].is_diagonal != circuit[index]->is_diagonal())
+            throw ::bra::wrong_bytecode_file_error{filename, "broken line of gates"};
       }
-      else if (mnemonic == "EXPECTATION")
-        add_expectation_value(columns);
-      else if (mnemonic == "INNERPROD")
-        add_inner_product(columns);
-      else if (mnemonic == "FIDELITY")
-        add_fidelity(columns);
-      else if (mnemonic == "CLEAR")
-        add_clear(columns);
-      else if (mnemonic == "SET")
-        add_set(columns);
-      else if (mnemonic == "SX")
-        add_sx(columns);
-      else if (mnemonic == "SX+")
-        add_adj_sx(columns);
-      else if (mnemonic == "SY")
-        add_sy(columns);
-      else if (mnemonic == "SY+")
-        add_adj_sy(columns);
-      else if (mnemonic == "SZ")
-        add_sz(columns);
-      else if (mnemonic == "SZ+")
-        add_adj_sz(columns);
-      else if (mnemonic == "SZZ")
-        add_szz(columns);
-      else if (mnemonic == "SZZ+")
-        add_adj_szz(columns);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'S' and mnemonic.find_first_not_of('Z', 1u) == std::string::npos)
-        add_szs(columns, mnemonic);
-      else if (mnemonic.size() >= 5u and mnemonic.front() == 'S' and mnemonic.back() == '+' and mnemonic.find_first_not_of('Z', 1u) == mnemonic.size() - 1u)
-        add_adj_szs(columns, mnemonic);
-      else if (mnemonic.size() >= 4u and mnemonic.front() == 'S' and mnemonic[1] == 'Z' and mnemonic.back() == '+' and mnemonic.find_first_not_of("0123456789", 2u) == mnemonic.size() - 1u)
-        add_adj_szn(columns, mnemonic);
-      else if (mnemonic.size() >= 3u and mnemonic.front() == 'S' and mnemonic[1] == 'Z' and mnemonic.find_first_not_of("0123456789", 2u) == std::string::npos)
-        add_szn(columns, mnemonic);
-      else if (mnemonic.size() >= 2u and mnemonic.front() == 'C') // controlled gates
-        interpret_controlled_gates(columns, mnemonic);
-      else
-        throw unsupported_mnemonic_error{mnemonic};
+
+      if (num_read_lines != num_fallback_lines)
+        throw ::bra::wrong_bytecode_file_error{filename, "too many lines of gates"};
     }
+
+    if (not bytecode_reader.is_end())
+      throw ::bra::wrong_bytecode_file_error{filename, "unexpected data at the end"};
+
+    circuit_index_ = 0;
+    largest_num_operated_qubits_
+      = std::max(largest_num_operated_qubits_, static_cast< ::bra::bit_integer_type >(largest_num_operated_qubits));
   }
 
   void interpreter::swap(interpreter& other)
@@ -835,6 +1593,11 @@ namespace bra
 #ifndef BRA_NO_MPI
     swap(circuits_, other.circuits_);
     swap(label_maps_, other.label_maps_);
+    swap(operated_qubits_, other.operated_qubits_);
+    swap(bytecodes_, other.bytecodes_);
+    swap(header_lines_, other.header_lines_);
+    swap(fallback_lines_, other.fallback_lines_);
+    swap(profiler_ptr_, other.profiler_ptr_);
     swap(num_qubits_, other.num_qubits_);
     swap(num_lqubits_, other.num_lqubits_);
     swap(initial_state_value_, other.initial_state_value_);
@@ -843,17 +1606,240 @@ namespace bra
 #else // BRA_NO_MPI
     swap(circuits_, other.circuits_);
     swap(label_maps_, other.label_maps_);
+    swap(operated_qubits_, other.operated_qubits_);
+    swap(bytecodes_, other.bytecodes_);
+    swap(header_lines_, other.header_lines_);
+    swap(fallback_lines_, other.fallback_lines_);
+    swap(profiler_ptr_, other.profiler_ptr_);
     swap(num_qubits_, other.num_qubits_);
     swap(initial_state_value_, other.initial_state_value_);
 #endif // BRA_NO_MPI
   }
 
+  auto interpreter::checkpoint(int const new_checkpoint_interval, std::string const& checkpoint_filename) -> void
+  {
+    checkpoint_interval_ = new_checkpoint_interval;
+    checkpoint_filename_ = checkpoint_filename;
+
+    using std::begin;
+    using std::end;
+    std::fill(begin(num_uncheckpointed_instructions_), end(num_uncheckpointed_instructions_), 0);
+  }
+
+  auto interpreter::checkpoint_filename(int const circuit_index) const -> std::string
+  {
+    if (circuits_.size() <= 1u)
+      return checkpoint_filename_;
+
+    return checkpoint_filename_ + "." + std::to_string(circuit_index);
+  }
+
+  void interpreter::restart_circuit(::bra::state& state, int const circuit_index)
+  {
+    assert(not is_streaming_);
+
+    auto next_index = int{};
+    state.load_state(checkpoint_filename(circuit_index), next_index);
+    if (next_index < 0 or next_index > static_cast<int>(circuits_[circuit_index].size()))
+      throw ::bra::wrong_state_file_error{checkpoint_filename(circuit_index), "the saved instruction is out of the circuit"};
+
+    first_indices_[circuit_index] = next_index;
+    num_uncheckpointed_instructions_[circuit_index] = 0;
+  }
+
+  // States in gate fusion cannot be saved, so the checkpoint is postponed until END FUSION
+  void interpreter::save_checkpoint_if_needed(::bra::state& state, int const circuit_index, int const next_index)
+  {
+    if (checkpoint_interval_ <= 0)
+      return;
+
+    auto& num_uncheckpointed_instructions = num_uncheckpointed_instructions_[circuit_index];
+    if (++num_uncheckpointed_instructions < checkpoint_interval_ or state.is_in_fusion())
+      return;
+
+    state.save_state(checkpoint_filename(circuit_index), next_index);
+    num_uncheckpointed_instructions = 0;
+  }
+
+  void interpreter::update_diagonal_accumulation(::bra::state& state, circuit_type const& circuit, int const index) const
+  {
+    if (not circuit[index]->is_diagonal())
+      state.end_diagonal_accumulation();
+    else if (not state.is_accumulating_diagonal_gates()
+             and index + 1 < static_cast<int>(circuit.size()) and circuit[index + 1]->is_diagonal())
+      state.begin_diagonal_accumulation();
+  }
+
+  void interpreter::update_diagonal_accumulation(
+    ::bra::state& state, std::vector< ::bra::instruction > const& bytecode, int const index) const
+  {
+    if (not bytecode[index].is_diagonal)
+      state.end_diagonal_accumulation();
+    else if (not state.is_accumulating_diagonal_gates()
+             and index + 1 < static_cast<int>(bytecode.size()) and bytecode[index + 1].is_diagonal)
+      state.begin_diagonal_accumulation();
+  }
+
+  // Lowered gates are applied without virtual calls, and they neither make the state wait nor jump
   void interpreter::apply_circuit(::bra::state& state, int const circuit_index)
   {
+    if (is_streaming_)
+    {
+      apply_streaming_circuit(state, circuit_index);
+      return;
+    }
+
+    auto const& circuit = circuits_[circuit_index];
+    auto const& bytecode = bytecodes_[circuit_index];
+    assert(bytecode.size() == circuit.size());
+    auto const count = static_cast<int>(bytecode.size());
+    for (auto index = first_indices_[circuit_index]; index < count; ++index)
+    {
+      auto const& instruction = bytecode[index];
+      {
+        // Accumulated diagonal gates are counted by the gate applying them
+        ::bra::gate_profile_guard const profile_guard{
+          profiler_ptr_, state, circuit_index,
+          [this, &state, circuit_index, index, &circuit]() { return profile_key(state, circuit_index, index, *(circuit[index])); }};
+        update_diagonal_accumulation(state, bytecode, index);
+
+        if (instruction.opcode != ::bra::opcode::gate)
+          ::bra::execute(state, instruction);
+        else
+          state << *(circuit[index]);
+      }
+
+      if (instruction.opcode != ::bra::opcode::gate)
+      {
+        save_checkpoint_if_needed(state, circuit_index, index + 1);
+        continue;
+      }
+
+      if (state.is_waiting())
+      {
+        first_indices_[circuit_index] = index + 1;
+        break;
+      }
+
+      if (state.maybe_label())
+      {
+        index = static_cast<int>(label_maps_[circuit_index].at(*(state.maybe_label())));
+        --index;
+        state.delete_label();
+      }
+
+      save_checkpoint_if_needed(state, circuit_index, index + 1);
+    }
+
+    state.end_diagonal_accumulation();
+  }
+
+  // The reader is stopped when the state is waiting, and it is resumed from the saved offset at the next call.
+  // JUMP restarts the reader at the offset of the label, so gates already read are discarded
+  void interpreter::apply_streaming_circuit(::bra::state& state, int const circuit_index)
+  {
+    auto& stream = *circuit_streams_[circuit_index];
+    auto const read
+      = [this, circuit_index](::bra::circuit_stream& stream) { read_streaming_circuit(stream, circuit_index); };
+    stream.start(read);
+
+    auto& chunk = streamed_chunks_[circuit_index];
+    auto index = first_indices_[circuit_index];
+    while (true)
+    {
+      if (index >= static_cast<int>(chunk.size()))
+      {
+        if (not stream.pop(chunk))
+          break;
+
+        index = 0;
+      }
+
+      {
+        ::bra::gate_profile_guard const profile_guard{
+          profiler_ptr_, state, circuit_index,
+          [this, &state, circuit_index, index, &chunk]() { return profile_key(state, circuit_index, index, *(chunk[index])); }};
+        update_diagonal_accumulation(state, chunk, index);
+        state << *(chunk[index]);
+      }
+      ++index;
+
+      if (state.is_waiting())
+        break;
+
+      if (state.maybe_label())
+      {
+        auto const& label_offset = label_offsets_[circuit_index].at(*(state.maybe_label()));
+        stream.restart_at(label_offset.first, label_offset.second);
+        stream.start(read);
+        chunk.clear();
+        index = 0;
+        state.delete_label();
+      }
+    }
+
+    first_indices_[circuit_index] = index;
+    stream.stop();
+    state.end_diagonal_accumulation();
+  }
+
+  // Qubits of gates are known only if gates are read in advance, so they are not classified in streaming mode.
+  // Gates in fusion have no operated qubits, and END FUSION has all of them
+  auto interpreter::profile_key(
+    ::bra::state const& state, int const circuit_index, int const index, ::bra::gate::gate const& gate) const
+  -> ::bra::profiler::key_type
+  {
+    auto const& operated_qubits = operated_qubits_[circuit_index];
+    if (is_streaming_ or index >= static_cast<int>(operated_qubits.size()))
+      return ::bra::profiler::key_type{gate.name(), ::bra::bit_integer_type{0u}, false};
+
+    auto const& qubits = operated_qubits[index];
+#ifndef BRA_NO_MPI
+    auto const& permutation = state.permutation();
+    using std::begin;
+    using std::end;
+    auto const is_global
+      = std::any_of(
+          begin(qubits), end(qubits),
+          [this, &permutation](::bra::bit_integer_type const qubit)
+          { return permutation[ket::make_qubit< ::bra::state_integer_type >(qubit)] >= ::bra::permutated_qubit_type{num_lqubits_}; });
+#else // BRA_NO_MPI
+    static_cast<void>(state);
+    auto const is_global = false;
+#endif // BRA_NO_MPI
+    return ::bra::profiler::key_type{gate.name(), static_cast< ::bra::bit_integer_type >(qubits.size()), is_global};
+  }
+
+#ifndef BRA_NO_MPI
+  void interpreter::apply_circuit(::bra::state& state, int const circuit_index, ::bra::remapping_plan& plan)
+  {
+    assert(not is_streaming_);
     auto const count = static_cast<int>(circuits_[circuit_index].size());
     for (auto index = first_indices_[circuit_index]; index < count; ++index)
     {
-      state << *(circuits_[circuit_index][index]);
+      if (plan.is_remapped_before(index))
+      {
+        {
+          ::bra::gate_profile_guard const profile_guard{
+            profiler_ptr_, state, circuit_index,
+            [&plan, index]()
+            {
+              return ::bra::profiler::key_type{
+                "REMAP", static_cast< ::bra::bit_integer_type >(plan.remapped_qubits(index).size()), true};
+            }};
+          state.remap_qubits(plan.remapped_qubits(index));
+        }
+        plan.observe_remapping(index, state.permutation());
+      }
+
+      {
+        ::bra::gate_profile_guard const profile_guard{
+          profiler_ptr_, state, circuit_index,
+          [this, &state, circuit_index, index]() { return profile_key(state, circuit_index, index, *(circuits_[circuit_index][index])); }};
+        update_diagonal_accumulation(state, circuits_[circuit_index], index);
+        state << *(circuits_[circuit_index][index]);
+      }
+      plan.observe(index, state.permutation());
 
       if (state.is_waiting())
       {
@@ -861,13 +1847,28 @@ namespace bra
         break;
       }
 
-      if (!state.maybe_label())
-        continue;
+      if (state.maybe_label())
+      {
+        index = static_cast<int>(label_maps_[circuit_index].at(*(state.maybe_label())));
+        --index;
+        state.delete_label();
+      }
 
-      index = static_cast<int>(label_maps_[circuit_index].at(*(state.maybe_label())));
-      --index;
-      state.delete_label();
+      save_checkpoint_if_needed(state, circuit_index, index + 1);
     }
+
+    state.end_diagonal_accumulation();
+  }
+#endif // BRA_NO_MPI
+
+  ::bra::qubit_type interpreter::make_operated_qubit(::bra::bit_integer_type const bit)
+  {
+    // The gate which operates the qubit is going to be pushed back into circuits_[circuit_index_]
+    auto& operated_qubits = operated_qubits_[circuit_index_];
+    operated_qubits.resize(circuits_[circuit_index_].size() + 1u);
+    operated_qubits.back().push_back(bit);
+
+    return ket::make_qubit< ::bra::state_integer_type >(bit);
   }
 
   ::bra::bit_integer_type interpreter::read_num_qubits(interpreter::columns_type const& columns) const
@@ -955,7 +1956,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   ::bra::control_qubit_type interpreter::read_control(interpreter::columns_type const& columns)
@@ -969,7 +1970,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_control(ket::make_qubit< ::bra::state_integer_type >(target));
+    return ket::make_control(make_operated_qubit(target));
   }
 
   std::tuple< ::bra::qubit_type, ::bra::qubit_type > interpreter::read_2targets(interpreter::columns_type const& columns)
@@ -984,7 +1985,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
-    return std::make_tuple(ket::make_qubit< ::bra::state_integer_type >(target1), ket::make_qubit< ::bra::state_integer_type >(target2));
+    return std::make_tuple(make_operated_qubit(target1), make_operated_qubit(target2));
   }
 
   std::tuple< ::bra::control_qubit_type, ::bra::control_qubit_type > interpreter::read_2controls(interpreter::columns_type const& columns)
@@ -999,7 +2000,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
-    return std::make_tuple(ket::make_control(ket::make_qubit< ::bra::state_integer_type >(target1)), ket::make_control(ket::make_qubit< ::bra::state_integer_type >(target2)));
+    return std::make_tuple(ket::make_control(make_operated_qubit(target1)), ket::make_control(make_operated_qubit(target2)));
   }
 
   void interpreter::read_multi_targets(interpreter::columns_type const& columns, std::vector< ::bra::qubit_type >& targets)
@@ -1015,7 +2016,7 @@ namespace bra
     for (auto targets_iter = begin(targets); targets_iter != targets_last; ++targets_iter, ++iter)
     {
       auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *targets_iter = ket::make_qubit< ::bra::state_integer_type >(target);
+      *targets_iter = make_operated_qubit(target);
     }
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(targets.size()), largest_num_operated_qubits_);
@@ -1034,7 +2035,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()), largest_num_operated_qubits_);
@@ -1058,7 +2059,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   ::bra::control_qubit_type interpreter::read_control_phase(
@@ -1079,7 +2080,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_control(ket::make_qubit< ::bra::state_integer_type >(target));
+    return ket::make_control(make_operated_qubit(target));
   }
 
   ::bra::qubit_type interpreter::read_target_2phases(
@@ -1106,7 +2107,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   ::bra::qubit_type interpreter::read_target_3phases(
@@ -1139,7 +2140,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   ::bra::qubit_type interpreter::read_target_phaseexp(
@@ -1160,7 +2161,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   ::bra::control_qubit_type interpreter::read_control_phaseexp(
@@ -1181,7 +2182,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_control(ket::make_qubit< ::bra::state_integer_type >(target));
+    return ket::make_control(make_operated_qubit(target));
   }
 
   std::tuple< ::bra::qubit_type, ::bra::qubit_type >
@@ -1204,7 +2205,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
-    return std::make_tuple(ket::make_qubit< ::bra::state_integer_type >(target1), ket::make_qubit< ::bra::state_integer_type >(target2));
+    return std::make_tuple(make_operated_qubit(target1), make_operated_qubit(target2));
   }
 
   void interpreter::read_multi_targets_phase(
@@ -1223,7 +2224,7 @@ namespace bra
     for (auto targets_iter = begin(targets); targets_iter != targets_last; ++targets_iter, ++iter)
     {
       auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *targets_iter = ket::make_qubit< ::bra::state_integer_type >(target);
+      *targets_iter = make_operated_qubit(target);
     }
     auto const phase_string = *iter;
     if (std::isdigit(static_cast<unsigned char>(phase_string.front())) or phase_string.front() == '+' or phase_string.front() == '-' or phase_string.front() == '.')
@@ -1247,8 +2248,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control)),
-      ket::make_qubit< ::bra::state_integer_type >(target));
+      ket::make_control(make_operated_qubit(control)),
+      make_operated_qubit(target));
   }
 
   std::tuple< ::bra::control_qubit_type, ::bra::qubit_type >
@@ -1272,8 +2273,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control)),
-      ket::make_qubit< ::bra::state_integer_type >(target));
+      ket::make_control(make_operated_qubit(control)),
+      make_operated_qubit(target));
   }
 
   std::tuple< ::bra::control_qubit_type, ::bra::control_qubit_type >
@@ -1297,8 +2298,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control1)),
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control2)));
+      ket::make_control(make_operated_qubit(control1)),
+      ket::make_control(make_operated_qubit(control2)));
   }
 
   std::tuple< ::bra::control_qubit_type, ::bra::control_qubit_type, ::bra::qubit_type >
@@ -1316,9 +2317,9 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{3u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control1)),
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control2)),
-      ket::make_qubit< ::bra::state_integer_type >(target));
+      ket::make_control(make_operated_qubit(control1)),
+      ket::make_control(make_operated_qubit(control2)),
+      make_operated_qubit(target));
   }
 
   void interpreter::read_multi_controls_phase(
@@ -1337,7 +2338,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const phase_string = *iter;
@@ -1363,14 +2364,14 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + ::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   std::tuple< ::bra::qubit_type, ::bra::qubit_type >
@@ -1388,7 +2389,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const target1 = boost::lexical_cast< ::bra::bit_integer_type >(*iter++);
@@ -1397,8 +2398,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + ::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-       ket::make_qubit< ::bra::state_integer_type >(target1),
-       ket::make_qubit< ::bra::state_integer_type >(target2));
+       make_operated_qubit(target1),
+       make_operated_qubit(target2));
   }
 
   void interpreter::read_multi_controls_multi_targets(
@@ -1415,14 +2416,14 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const targets_last = end(targets);
     for (auto targets_iter = begin(targets); targets_iter != targets_last; ++targets_iter, ++iter)
     {
       auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *targets_iter = ket::make_qubit< ::bra::state_integer_type >(target);
+      *targets_iter = make_operated_qubit(target);
     }
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + static_cast< ::bra::bit_integer_type >(targets.size()), largest_num_operated_qubits_);
@@ -1449,8 +2450,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control)),
-      ket::make_qubit< ::bra::state_integer_type >(target));
+      ket::make_control(make_operated_qubit(control)),
+      make_operated_qubit(target));
   }
 
   std::tuple< ::bra::control_qubit_type, ::bra::control_qubit_type >
@@ -1474,8 +2475,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control1)),
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control2)));
+      ket::make_control(make_operated_qubit(control1)),
+      ket::make_control(make_operated_qubit(control2)));
   }
 
   ::bra::qubit_type interpreter::read_multi_controls_target_phase(
@@ -1494,7 +2495,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter++);
@@ -1506,7 +2507,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + ::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   std::tuple< ::bra::control_qubit_type, ::bra::qubit_type >
@@ -1536,8 +2537,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control)),
-      ket::make_qubit< ::bra::state_integer_type >(target));
+      ket::make_control(make_operated_qubit(control)),
+      make_operated_qubit(target));
   }
 
   ::bra::qubit_type interpreter::read_multi_controls_target_2phases(
@@ -1557,7 +2558,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter++);
@@ -1574,7 +2575,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + ::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   std::tuple< ::bra::control_qubit_type, ::bra::qubit_type >
@@ -1610,8 +2611,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-      ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control)),
-      ket::make_qubit< ::bra::state_integer_type >(target));
+      ket::make_control(make_operated_qubit(control)),
+      make_operated_qubit(target));
   }
 
   ::bra::qubit_type interpreter::read_multi_controls_target_3phases(
@@ -1632,7 +2633,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter++);
@@ -1654,7 +2655,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + ::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   void interpreter::read_multi_controls_phaseexp(
@@ -1673,7 +2674,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const phase_exponent_string = *iter;
@@ -1701,7 +2702,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter++);
@@ -1713,7 +2714,7 @@ namespace bra
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + ::bra::bit_integer_type{1u}, largest_num_operated_qubits_);
 
-    return ket::make_qubit< ::bra::state_integer_type >(target);
+    return make_operated_qubit(target);
   }
 
   void interpreter::read_multi_controls_multi_targets_phase(
@@ -1733,14 +2734,14 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const targets_last = end(targets);
     for (auto targets_iter = begin(targets); targets_iter != targets_last; ++targets_iter, ++iter)
     {
       auto const target = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *targets_iter = ket::make_qubit< ::bra::state_integer_type >(target);
+      *targets_iter = make_operated_qubit(target);
     }
 
     auto const phase_string = *iter;
@@ -1769,7 +2770,7 @@ namespace bra
     for (auto controls_iter = begin(controls); controls_iter != controls_last; ++controls_iter, ++iter)
     {
       auto const control = boost::lexical_cast< ::bra::bit_integer_type >(*iter);
-      *controls_iter = ket::make_control(ket::make_qubit< ::bra::state_integer_type >(control));
+      *controls_iter = ket::make_control(make_operated_qubit(control));
     }
 
     auto const target1 = boost::lexical_cast< ::bra::bit_integer_type >(*iter++);
@@ -1783,8 +2784,8 @@ namespace bra
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(controls.size()) + ::bra::bit_integer_type{2u}, largest_num_operated_qubits_);
 
     return std::make_tuple(
-       ket::make_qubit< ::bra::state_integer_type >(target1),
-       ket::make_qubit< ::bra::state_integer_type >(target2));
+       make_operated_qubit(target1),
+       make_operated_qubit(target2));
   }
 
   ::bra::begin_statement interpreter::read_begin_statement(interpreter::columns_type const& columns) const
@@ -3233,7 +4234,7 @@ namespace bra
     auto operated_qubits = std::vector< ::bra::qubit_type >{};
     operated_qubits.reserve(last - iter);
     for (; iter != last; ++iter)
-      operated_qubits.push_back(ket::make_qubit< ::bra::state_integer_type >(boost::lexical_cast< ::bra::bit_integer_type >(*iter)));
+      operated_qubits.push_back(make_operated_qubit(boost::lexical_cast< ::bra::bit_integer_type >(*iter)));
 
     largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(operated_qubits.size()), largest_num_operated_qubits_);
 
@@ -3276,7 +4277,7 @@ namespace bra
       auto operated_qubits = std::vector< ::bra::qubit_type >{};
       operated_qubits.reserve(last - iter);
       for (; iter != last; ++iter)
-        operated_qubits.push_back(ket::make_qubit< ::bra::state_integer_type >(boost::lexical_cast< ::bra::bit_integer_type >(*iter)));
+        operated_qubits.push_back(make_operated_qubit(boost::lexical_cast< ::bra::bit_integer_type >(*iter)));
 
       largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(operated_qubits.size()), largest_num_operated_qubits_);
 
@@ -3322,7 +4323,7 @@ namespace bra
       auto operated_qubits = std::vector< ::bra::qubit_type >{};
       operated_qubits.reserve(last - iter);
       for (; iter != last; ++iter)
-        operated_qubits.push_back(ket::make_qubit< ::bra::state_integer_type >(boost::lexical_cast< ::bra::bit_integer_type >(*iter)));
+        operated_qubits.push_back(make_operated_qubit(boost::lexical_cast< ::bra::bit_integer_type >(*iter)));
 
       largest_num_operated_qubits_ = std::max(static_cast< ::bra::bit_integer_type >(operated_qubits.size()), largest_num_operated_qubits_);
 
@@ -3338,6 +4339,23 @@ namespace bra
   void interpreter::add_set(interpreter::columns_type const& columns)
   { circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::set >(read_target(columns))); }
 
+  void interpreter::add_save_state(interpreter::columns_type const& columns)
+  {
+    if (boost::size(columns) != 3u or boost::algorithm::to_upper_copy(columns[1u]) != "STATE")
+      throw wrong_mnemonics_error{columns};
+
+    auto const next_index = static_cast<int>(circuits_[circuit_index_].size()) + 1;
+    circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::save_state >(columns[2u], next_index));
+  }
+
+  void interpreter::add_load_state(interpreter::columns_type const& columns)
+  {
+    if (boost::size(columns) != 3u or boost::algorithm::to_upper_copy(columns[1u]) != "STATE")
+      throw wrong_mnemonics_error{columns};
+
+    circuits_[circuit_index_].push_back(std::make_unique< ::bra::gate::load_state >(columns[2u]));
+  }
+
   void interpreter::interpret_controlled_gates(interpreter::columns_type const& columns, std::string const& mnemonic)
   {
     using std::begin;
@@ -0,0 +1,34 @@
+#include <string>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+
+#include <bra/gate/gate.hpp>
+#include <bra/gate/load_state.hpp>
+#include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    std::string const load_state::name_ = "LOAD STATE";
+
+    load_state::load_state(std::string const& filename)
+      : ::bra::gate::gate{}, filename_{filename}
+    { }
+
+    ::bra::state& load_state::do_apply(::bra::state& state) const
+    { return state.load_state(filename_); }
+
+    std::string const& load_state::do_name() const { return name_; }
+    std::string load_state::do_representation(
+      std::ostringstream& repr_stream, int const parameter_width) const
+    {
+      repr_stream
+        << std::right
+        << std::setw(parameter_width) << filename_;
+      return repr_stream.str();
+    }
+  } // namespace gate
+} // namespace bra
@@ -1,15 +1,20 @@
 #ifdef BRA_NO_MPI
+# include <cassert>
 # include <cmath>
+# include <cstddef>
 # include <iostream>
 # include <sstream>
 # include <vector>
+# include <array>
 # include <iterator>
 # include <algorithm>
 # include <numeric>
 # include <utility>
+# include <memory>
 # include <type_traits>
 
 # include <boost/algorithm/string/case_conv.hpp>
+# include <boost/range/iterator_range.hpp>
 
 # include <ket/inner_product.hpp>
 # include <ket/fidelity.hpp>
@@ -34,25 +39,32 @@
 # include <ket/gate/toffoli.hpp>
 # include <ket/gate/projective_measurement.hpp>
 # include <ket/gate/clear.hpp>
+# include <ket/gate/diagonal.hpp>
 # include <ket/gate/set.hpp>
+# include <ket/gate/cache_blocking.hpp>
+# ifdef BRA_USE_SPLIT_LAYOUT
+#   include <ket/gate/split/layout.hpp>
+#   include <ket/gate/split/gate.hpp>
+# endif // BRA_USE_SPLIT_LAYOUT
 # if defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
 #   include <ket/gate/utility/cache_aware_iterator.hpp>
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
-# include <ket/gate/utility/pauli_index_coeff.hpp>
 # include <ket/all_spin_expectation_values.hpp>
 # include <ket/print_amplitudes.hpp>
 # include <ket/measure.hpp>
 # include <ket/generate_events.hpp>
 # include <ket/expectation_value.hpp>
 # include <ket/shor_box.hpp>
+# include <ket/utility/num_on_cache_qubits.hpp>
 # include <ket/utility/all_in_state_vector.hpp>
 # include <ket/utility/none_in_state_vector.hpp>
 
 # include <bra/nompi_state.hpp>
 # include <bra/state.hpp>
 # include <bra/types.hpp>
+# include <bra/compiled_pauli_string_space.hpp>
 # include <bra/fused_gate.hpp>
-# include <bra/utility/closest_floating_point_of.hpp>
+# include <bra/fused_gate/fused_unitary.hpp>
 
 namespace bra
 {
@@ -113,6 +125,13 @@ namespace bra
     : ::bra::state{total_num_qubits, seed, is_depolarizing_channel, depolarizing_px, depolarizing_py, depolarizing_pz, uses_depolarizing_seed, depolarizing_seed, circuit_index},
       parallel_policy_{num_threads},
       data_{make_initial_data(initial_integer, total_num_qubits)},
+#   ifdef BRA_USE_SPLIT_LAYOUT
+      is_data_in_split_layout_{false},
+#   endif // BRA_USE_SPLIT_LAYOUT
+      cache_block_layout_{
+        ket::gate::num_cache_block_qubits< ::bra::state_integer_type >(
+          parallel_policy_, static_cast< ::bra::bit_integer_type >(total_num_qubits), ::ket::utility::num_on_cache_qubits< ::bra::bit_integer_type >())},
+      cache_blocked_gates_{}, cache_block_buffer_{},
       fused_gates_{},
       is_waiting_{false}
   { }
@@ -131,14 +150,18 @@ namespace bra
     : ::bra::state{total_num_qubits, seed, is_depolarizing_channel, depolarizing_px, depolarizing_py, depolarizing_pz, uses_depolarizing_seed, depolarizing_seed, circuit_index},
       parallel_policy_{num_threads},
       data_{make_initial_data(initial_integer, total_num_qubits)},
+#   ifdef BRA_USE_SPLIT_LAYOUT
+      is_data_in_split_layout_{false},
+#   endif // BRA_USE_SPLIT_LAYOUT
+      cache_block_layout_{
+        ket::gate::num_cache_block_qubits< ::bra::state_integer_type >(
+          parallel_policy_, static_cast< ::bra::bit_integer_type >(total_num_qubits), ::ket::utility::num_on_cache_qubits< ::bra::bit_integer_type >())},
+      cache_blocked_gates_{}, cache_block_buffer_{},
       fused_gates_{},
       cache_aware_fused_gates_{},
       is_waiting_{false}
   { }
 # else
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
   nompi_state::nompi_state(
     ::bra::state::state_integer_type const initial_integer,
     unsigned int const total_num_qubits,
@@ -153,29 +176,181 @@ namespace bra
     : ::bra::state{total_num_qubits, seed, is_depolarizing_channel, depolarizing_px, depolarizing_py, depolarizing_pz, uses_depolarizing_seed, depolarizing_seed, circuit_index},
       parallel_policy_{num_threads},
       data_{make_initial_data(initial_integer, total_num_qubits)},
-      on_cache_data_{::ket::utility::integer_exp2< ::bra::state_integer_type >(KET_DEFAULT_NUM_ON_CACHE_QUBITS)},
+#   ifdef BRA_USE_SPLIT_LAYOUT
+      is_data_in_split_layout_{false},
+#   endif // BRA_USE_SPLIT_LAYOUT
+      cache_block_layout_{
+        ket::gate::num_cache_block_qubits< ::bra::state_integer_type >(
+          parallel_policy_, static_cast< ::bra::bit_integer_type >(total_num_qubits), ::ket::utility::num_on_cache_qubits< ::bra::bit_integer_type >())},
+      cache_blocked_gates_{}, cache_block_buffer_{},
+      on_cache_data_{::ket::utility::integer_exp2< ::bra::state_integer_type >(::ket::utility::num_on_cache_qubits< ::bra::bit_integer_type >())},
       fused_gates_{},
       is_waiting_{false}
   { }
 # endif
 
-  auto nompi_state::do_is_waiting() const -> bool
-  { return is_waiting_; }
+# ifdef BRA_USE_SPLIT_LAYOUT
+  namespace nompi_state_detail
+  {
+    inline auto to_local_qubit(::bra::qubit_type const, ::bra::bit_integer_type const index) -> ::bra::qubit_type
+    { return ket::make_qubit< ::bra::state_integer_type >(index); }
 
-  auto nompi_state::do_cancel_waiting() -> void
-  { is_waiting_ = false; }
+    inline auto to_local_qubit(::bra::control_qubit_type const, ::bra::bit_integer_type const index) -> ::bra::control_qubit_type
+    { return ket::make_control(ket::make_qubit< ::bra::state_integer_type >(index)); }
+
+    inline auto to_target_qubit(::bra::qubit_type const qubit) -> ::bra::qubit_type
+    { return qubit; }
+
+    inline auto to_target_qubit(::bra::control_qubit_type const control_qubit) -> ::bra::qubit_type
+    { return control_qubit.qubit(); }
+
+    // Row-major matrix of a gate on k qubits, where bit i of row/column indices corresponds to i-th qubit
+    template <typename Gate, typename... Qubits, std::size_t... indices>
+    auto make_gate_matrix(Gate const& gate, std::index_sequence<indices...> const, Qubits const... qubits)
+    -> std::array< ::bra::complex_type, (std::size_t{1u} << (2u * sizeof...(Qubits))) >
+    {
+      constexpr auto num_qubits = sizeof...(Qubits);
+      constexpr auto num_indices = std::size_t{1u} << num_qubits;
+
+      // columns[(j << k) bitor i] is the i-th element of the j-th column, and the gate is applied to all columns at once as in ::bra::fused_gate::fused_unitary
+      auto columns = ::bra::data_type(num_indices * num_indices, ::bra::complex_type{::bra::real_type{0}});
+      for (auto j = std::size_t{0u}; j < num_indices; ++j)
+        columns[(j << num_qubits) bitor j] = ::bra::complex_type{::bra::real_type{1}};
+
+      gate(
+        ket::utility::policy::make_sequential(), columns,
+        ::bra::nompi_state_detail::to_local_qubit(qubits, static_cast< ::bra::bit_integer_type >(indices))...);
+
+      auto result = std::array< ::bra::complex_type, num_indices * num_indices >{};
+      for (auto i = std::size_t{0u}; i < num_indices; ++i)
+        for (auto j = std::size_t{0u}; j < num_indices; ++j)
+          result[i * num_indices + j] = columns[(j << num_qubits) bitor i];
+      return result;
+    }
+  } // namespace nompi_state_detail
+
+# endif // BRA_USE_SPLIT_LAYOUT
+  namespace nompi_state_detail
+  {
+    inline auto to_mask() -> ::bra::state_integer_type
+    { return ::bra::state_integer_type{0u}; }
+
+    inline auto to_bit(::bra::qubit_type const qubit) -> ::bra::bit_integer_type
+    { return static_cast< ::bra::bit_integer_type >(qubit); }
+
+    inline auto to_bit(::bra::control_qubit_type const control_qubit) -> ::bra::bit_integer_type
+    { return static_cast< ::bra::bit_integer_type >(control_qubit.qubit()); }
+
+    template <typename Qubit, typename... Qubits>
+    inline auto to_mask(Qubit const qubit, Qubits const... qubits) -> ::bra::state_integer_type
+    {
+      return ket::utility::integer_exp2< ::bra::state_integer_type >(::bra::nompi_state_detail::to_bit(qubit))
+        bitor ::bra::nompi_state_detail::to_mask(qubits...);
+    }
+
+    template <typename Layout>
+    inline auto to_block_qubit(Layout const& layout, ::bra::qubit_type const qubit) -> ::bra::qubit_type
+    { return ket::make_qubit< ::bra::state_integer_type >(layout.block_qubit(::bra::nompi_state_detail::to_bit(qubit))); }
 
-  auto nompi_state::generate_probability() -> real_type
+    template <typename Layout>
+    inline auto to_block_qubit(Layout const& layout, ::bra::control_qubit_type const control_qubit) -> ::bra::control_qubit_type
+    { return ket::make_control(::bra::nompi_state_detail::to_block_qubit(layout, control_qubit.qubit())); }
+  } // namespace nompi_state_detail
+
+  template <typename Gate, typename... Qubits>
+  auto nompi_state::apply_gate(Gate const& gate, Qubits const... qubits) -> void
   {
-    using floating_point_type = typename ::bra::utility::closest_floating_point_of<real_type>::type;
-    auto distribution = std::uniform_real_distribution<floating_point_type>{0.0, 1.0};
+# ifdef BRA_USE_SPLIT_LAYOUT
+    static_assert(sizeof...(Qubits) == 1u or sizeof...(Qubits) == 2u, "split-layout kernels are available for one- and two-qubit gates");
+
+    using std::begin;
+    using std::end;
+    // Split-layout kernels sweep the whole state vector, so gates are not blocked on cache if the split layout is selected.
+    // Whether it is applicable depends only on the size of data_, so no gates are deferred in this case
+    if (ket::gate::split::is_split_layout_applicable(begin(data_), end(data_)))
+    {
+      assert(cache_blocked_gates_.empty());
+      auto const matrix
+        = ::bra::nompi_state_detail::make_gate_matrix(gate, std::make_index_sequence<sizeof...(Qubits)>{}, qubits...);
+
+      if (not is_data_in_split_layout_)
+      {
+        ket::gate::split::ranges::to_split_layout(parallel_policy_, data_);
+        is_data_in_split_layout_ = true;
+      }
+
+      ket::gate::split::ranges::gate(parallel_policy_, data_, matrix, ::bra::nompi_state_detail::to_target_qubit(qubits)...);
+      return;
+    }
+
+# endif // BRA_USE_SPLIT_LAYOUT
+    if (cache_block_layout_.num_block_qubits() > ::bra::bit_integer_type{0u})
+    {
+      auto const qubits_mask = ::bra::nompi_state_detail::to_mask(qubits...);
+      if (not cache_block_layout_.add(qubits_mask))
+      {
+        apply_cache_blocked_gates();
+        auto const is_added = cache_block_layout_.add(qubits_mask);
+        assert(is_added);
+        static_cast<void>(is_added);
+      }
 
-    return
-      uses_depolarizing_seed_
-      ? static_cast<real_type>(distribution(depolarizing_random_number_generator_))
-      : static_cast<real_type>(distribution(random_number_generator_));
+      // Gates in a block are applied sequentially, and blocks are distributed to threads
+      cache_blocked_gates_.push_back(
+        [gate, parallel_policy = parallel_policy_, qubits...](
+          data_type::iterator const first, data_type::iterator const last, cache_block_layout_type const* layout_ptr)
+        {
+          auto range = boost::make_iterator_range(first, last);
+          if (layout_ptr == nullptr)
+            gate(parallel_policy, range, qubits...);
+          else
+            gate(ket::utility::policy::make_sequential(), range, ::bra::nompi_state_detail::to_block_qubit(*layout_ptr, qubits)...);
+        });
+      return;
+    }
+
+    gate(parallel_policy_, interleaved_data(), qubits...);
+  }
+
+  auto nompi_state::apply_cache_blocked_gates() -> void
+  {
+    if (cache_blocked_gates_.empty())
+      return;
+
+    // A single gate does not reuse blocks on cache
+    if (cache_blocked_gates_.size() == 1u)
+    {
+      using std::begin;
+      using std::end;
+      cache_blocked_gates_.front()(begin(data_), end(data_), nullptr);
+    }
+    else
+    {
+      auto const buffer_size
+        = static_cast< ::bra::state_integer_type >(ket::utility::num_threads(parallel_policy_))
+          << cache_block_layout_.num_block_qubits();
+      if (not cache_block_layout_.is_contiguous() and cache_block_buffer_.size() < buffer_size)
+        cache_block_buffer_.resize(buffer_size);
+
+      ket::gate::ranges::for_each_cache_block(
+        parallel_policy_, data_, cache_block_layout_, cache_block_buffer_,
+        [this](data_type::iterator const first, data_type::iterator const last)
+        {
+          for (auto const& cache_blocked_gate: this->cache_blocked_gates_)
+            cache_blocked_gate(first, last, std::addressof(this->cache_block_layout_));
+        });
+    }
+
+    cache_blocked_gates_.clear();
+    cache_block_layout_.clear();
   }
 
+  auto nompi_state::do_is_waiting() const -> bool
+  { return is_waiting_; }
+
+  auto nompi_state::do_cancel_waiting() -> void
+  { is_waiting_ = false; }
+
   auto nompi_state::do_send_real_variable(int const destination_circuit_index, std::string const& variable_name, int const num_elements) const -> void
   {
     if (destination_circuit_index < 0 or destination_circuit_index == circuit_index_)
@@ -333,7 +508,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::hadamard(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::hadamard(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_not_(qubit_type const qubit)
@@ -346,7 +524,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::not_(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::not_(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_pauli_x(qubit_type const qubit)
@@ -359,7 +540,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_x(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_x(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_pauli_xx(qubit_type const qubit1, qubit_type const qubit2)
@@ -372,7 +556,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_x(parallel_policy_, data_, qubit1, qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_x(parallel_policy, data, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_pauli_xn(std::vector<qubit_type> const& qubits)
@@ -388,7 +575,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::pauli_x(parallel_policy_, data_, qubits);
+    ket::gate::runtime::ranges::pauli_x(parallel_policy_, interleaved_data(), qubits);
   }
 
   void nompi_state::do_pauli_y(qubit_type const qubit)
@@ -401,7 +588,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_y(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_y(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_pauli_yy(qubit_type const qubit1, qubit_type const qubit2)
@@ -414,7 +604,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_y(parallel_policy_, data_, qubit1, qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_y(parallel_policy, data, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_pauli_yn(std::vector<qubit_type> const& qubits)
@@ -430,7 +623,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::pauli_y(parallel_policy_, data_, qubits);
+    ket::gate::runtime::ranges::pauli_y(parallel_policy_, interleaved_data(), qubits);
   }
 
   void nompi_state::do_pauli_z(control_qubit_type const control_qubit)
@@ -443,7 +636,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_z(parallel_policy_, data_, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_z(parallel_policy, data, qubits...); },
+        control_qubit);
   }
 
   void nompi_state::do_pauli_zz(qubit_type const qubit1, qubit_type const qubit2)
@@ -456,7 +652,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_z(parallel_policy_, data_, qubit1, qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_z(parallel_policy, data, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_pauli_zn(std::vector<qubit_type> const& qubits)
@@ -472,7 +671,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::pauli_z(parallel_policy_, data_, qubits);
+    ket::gate::runtime::ranges::pauli_z(parallel_policy_, interleaved_data(), qubits);
   }
 
   void nompi_state::do_swap(qubit_type const qubit1, qubit_type const qubit2)
@@ -485,7 +684,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::swap(parallel_policy_, data_, qubit1, qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::swap(parallel_policy, data, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_sqrt_pauli_x(qubit_type const qubit)
@@ -498,7 +700,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::sqrt_pauli_x(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::sqrt_pauli_x(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_sqrt_pauli_x(qubit_type const qubit)
@@ -511,7 +716,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_sqrt_pauli_x(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_sqrt_pauli_x(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_sqrt_pauli_y(qubit_type const qubit)
@@ -524,7 +732,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::sqrt_pauli_y(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::sqrt_pauli_y(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_sqrt_pauli_y(qubit_type const qubit)
@@ -537,7 +748,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_sqrt_pauli_y(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_sqrt_pauli_y(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_sqrt_pauli_z(control_qubit_type const control_qubit)
@@ -550,7 +764,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::sqrt_pauli_z(parallel_policy_, data_, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::sqrt_pauli_z(parallel_policy, data, qubits...); },
+        control_qubit);
   }
 
   void nompi_state::do_adj_sqrt_pauli_z(control_qubit_type const control_qubit)
@@ -563,7 +780,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_sqrt_pauli_z(parallel_policy_, data_, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_sqrt_pauli_z(parallel_policy, data, qubits...); },
+        control_qubit);
   }
 
   void nompi_state::do_sqrt_pauli_zz(qubit_type const qubit1, qubit_type const qubit2)
@@ -576,7 +796,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::sqrt_pauli_z(parallel_policy_, data_, qubit1, qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::sqrt_pauli_z(parallel_policy, data, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_adj_sqrt_pauli_zz(qubit_type const qubit1, qubit_type const qubit2)
@@ -589,7 +812,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_sqrt_pauli_z(parallel_policy_, data_, qubit1, qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_sqrt_pauli_z(parallel_policy, data, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_sqrt_pauli_zn(std::vector<qubit_type> const& qubits)
@@ -605,7 +831,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::sqrt_pauli_z(parallel_policy_, data_, qubits);
+    ket::gate::runtime::ranges::sqrt_pauli_z(parallel_policy_, interleaved_data(), qubits);
   }
 
   void nompi_state::do_adj_sqrt_pauli_zn(std::vector<qubit_type> const& qubits)
@@ -621,7 +847,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::adj_sqrt_pauli_z(parallel_policy_, data_, qubits);
+    ket::gate::runtime::ranges::adj_sqrt_pauli_z(parallel_policy_, interleaved_data(), qubits);
   }
 
   void nompi_state::do_u1(real_type const phase, control_qubit_type const control_qubit)
@@ -634,7 +860,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift(parallel_policy_, data_, phase, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift(parallel_policy, data, phase, qubits...); },
+        control_qubit);
   }
 
   void nompi_state::do_adj_u1(real_type const phase, control_qubit_type const control_qubit)
@@ -647,7 +876,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift(parallel_policy_, data_, phase, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift(parallel_policy, data, phase, qubits...); },
+        control_qubit);
   }
 
   void nompi_state::do_u2(
@@ -661,7 +893,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift2(parallel_policy_, data_, phase1, phase2, qubit);
+      apply_gate(
+        [phase1, phase2](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift2(parallel_policy, data, phase1, phase2, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_u2(
@@ -675,7 +910,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift2(parallel_policy_, data_, phase1, phase2, qubit);
+      apply_gate(
+        [phase1, phase2](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift2(parallel_policy, data, phase1, phase2, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_u3(
@@ -690,7 +928,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift3(parallel_policy_, data_, phase1, phase2, phase3, qubit);
+      apply_gate(
+        [phase1, phase2, phase3](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift3(parallel_policy, data, phase1, phase2, phase3, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_u3(
@@ -705,7 +946,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift3(parallel_policy_, data_, phase1, phase2, phase3, qubit);
+      apply_gate(
+        [phase1, phase2, phase3](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift3(parallel_policy, data, phase1, phase2, phase3, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_phase_shift(
@@ -719,7 +963,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift_coeff(parallel_policy_, data_, phase_coefficient, control_qubit);
+      apply_gate(
+        [phase_coefficient](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift_coeff(parallel_policy, data, phase_coefficient, qubits...); },
+        control_qubit);
   }
 
   void nompi_state::do_adj_phase_shift(
@@ -733,7 +980,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift_coeff(parallel_policy_, data_, phase_coefficient, control_qubit);
+      apply_gate(
+        [phase_coefficient](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift_coeff(parallel_policy, data, phase_coefficient, qubits...); },
+        control_qubit);
   }
 
   void nompi_state::do_x_rotation_half_pi(qubit_type const qubit)
@@ -746,7 +996,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::x_rotation_half_pi(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::x_rotation_half_pi(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_x_rotation_half_pi(qubit_type const qubit)
@@ -759,7 +1012,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_x_rotation_half_pi(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_x_rotation_half_pi(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_y_rotation_half_pi(qubit_type const qubit)
@@ -772,7 +1028,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::y_rotation_half_pi(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::y_rotation_half_pi(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_y_rotation_half_pi(qubit_type const qubit)
@@ -785,7 +1044,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_y_rotation_half_pi(parallel_policy_, data_, qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_y_rotation_half_pi(parallel_policy, data, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_exponential_pauli_x(real_type const phase, qubit_type const qubit)
@@ -798,7 +1060,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_x(parallel_policy_, data_, phase, qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_x(parallel_policy, data, phase, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_exponential_pauli_x(real_type const phase, qubit_type const qubit)
@@ -811,7 +1076,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_x(parallel_policy_, data_, phase, qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_x(parallel_policy, data, phase, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_exponential_pauli_xx(
@@ -825,7 +1093,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_x(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_x(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_adj_exponential_pauli_xx(
@@ -839,7 +1110,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_x(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_x(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_exponential_pauli_xn(
@@ -856,7 +1130,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::exponential_pauli_x(parallel_policy_, data_, phase, qubits);
+    ket::gate::runtime::ranges::exponential_pauli_x(parallel_policy_, interleaved_data(), phase, qubits);
   }
 
   void nompi_state::do_adj_exponential_pauli_xn(
@@ -873,7 +1147,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::adj_exponential_pauli_x(parallel_policy_, data_, phase, qubits);
+    ket::gate::runtime::ranges::adj_exponential_pauli_x(parallel_policy_, interleaved_data(), phase, qubits);
   }
 
   void nompi_state::do_exponential_pauli_y(real_type const phase, qubit_type const qubit)
@@ -886,7 +1160,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_y(parallel_policy_, data_, phase, qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_y(parallel_policy, data, phase, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_exponential_pauli_y(real_type const phase, qubit_type const qubit)
@@ -899,7 +1176,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_y(parallel_policy_, data_, phase, qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_y(parallel_policy, data, phase, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_exponential_pauli_yy(
@@ -913,7 +1193,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_y(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_y(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_adj_exponential_pauli_yy(
@@ -927,7 +1210,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_y(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_y(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_exponential_pauli_yn(
@@ -944,7 +1230,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::exponential_pauli_y(parallel_policy_, data_, phase, qubits);
+    ket::gate::runtime::ranges::exponential_pauli_y(parallel_policy_, interleaved_data(), phase, qubits);
   }
 
   void nompi_state::do_adj_exponential_pauli_yn(
@@ -961,7 +1247,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::adj_exponential_pauli_y(parallel_policy_, data_, phase, qubits);
+    ket::gate::runtime::ranges::adj_exponential_pauli_y(parallel_policy_, interleaved_data(), phase, qubits);
   }
 
   void nompi_state::do_exponential_pauli_z(real_type const phase, qubit_type const qubit)
@@ -974,7 +1260,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_z(parallel_policy_, data_, phase, qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_z(parallel_policy, data, phase, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_adj_exponential_pauli_z(real_type const phase, qubit_type const qubit)
@@ -987,7 +1276,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_z(parallel_policy_, data_, phase, qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_z(parallel_policy, data, phase, qubits...); },
+        qubit);
   }
 
   void nompi_state::do_exponential_pauli_zz(
@@ -1001,7 +1293,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_z(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_z(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_adj_exponential_pauli_zz(
@@ -1015,7 +1310,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_z(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_z(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_exponential_pauli_zn(
@@ -1032,7 +1330,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::exponential_pauli_z(parallel_policy_, data_, phase, qubits);
+    ket::gate::runtime::ranges::exponential_pauli_z(parallel_policy_, interleaved_data(), phase, qubits);
   }
 
   void nompi_state::do_adj_exponential_pauli_zn(
@@ -1049,7 +1347,7 @@ namespace bra
 
     assert(qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::adj_exponential_pauli_z(parallel_policy_, data_, phase, qubits);
+    ket::gate::runtime::ranges::adj_exponential_pauli_z(parallel_policy_, interleaved_data(), phase, qubits);
   }
 
   void nompi_state::do_exponential_swap(
@@ -1063,7 +1361,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_swap(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_swap(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_adj_exponential_swap(
@@ -1077,7 +1378,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_swap(parallel_policy_, data_, phase, qubit1, qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_swap(parallel_policy, data, phase, qubits...); },
+        qubit1, qubit2);
   }
 
   void nompi_state::do_toffoli(
@@ -1096,14 +1400,14 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::toffoli(parallel_policy_, data_, target_qubit, control_qubit1, control_qubit2);
+      ket::gate::ranges::toffoli(parallel_policy_, interleaved_data(), target_qubit, control_qubit1, control_qubit2);
   }
 
   ::ket::gate::outcome nompi_state::do_projective_measurement(qubit_type const qubit)
-  { return ket::gate::ranges::projective_measurement(parallel_policy_, data_, random_number_generator_, qubit); }
+  { return ket::gate::ranges::projective_measurement(parallel_policy_, interleaved_data(), random_number_generator_, qubit); }
 
   void nompi_state::do_expectation_values()
-  { maybe_expectation_values_ = ket::ranges::all_spin_expectation_values<qubit_type>(parallel_policy_, data_); }
+  { maybe_expectation_values_ = ket::ranges::all_spin_expectation_values<qubit_type>(parallel_policy_, interleaved_data()); }
 
   void nompi_state::do_amplitudes(std::vector< ::bra::state_integer_type > const& amplitude_indices)
   {
@@ -1111,7 +1415,7 @@ namespace bra
 
     if (amplitude_indices.empty())
       ket::println_amplitudes(
-        oss, data_,
+        oss, interleaved_data(),
         [this](::bra::state_integer_type const qubit_value, ::bra::complex_type const& amplitude)
         {
           std::ostringstream oss;
@@ -1123,7 +1427,7 @@ namespace bra
     else
       for (auto const amplitude_index: amplitude_indices)
       {
-        auto const& amplitude = data_[amplitude_index];
+        auto const& amplitude = interleaved_data()[amplitude_index];
         using std::real;
         using std::imag;
         oss << ::bra::state_detail::integer_to_bits_string(amplitude_index, total_num_qubits_) << " => " << real(amplitude) << " + " << imag(amplitude) << " i\n";
@@ -1137,19 +1441,19 @@ namespace bra
     measured_value_
       = ket::ranges::measure(
           ket::utility::policy::make_sequential(), // parallel_policy_,
-          data_, random_number_generator_);
+          interleaved_data(), random_number_generator_);
   }
 
   void nompi_state::do_generate_events(int const num_events, int const seed)
   {
     if (seed < 0)
       ket::ranges::generate_events(
-        ket::utility::policy::make_sequential(), // parallel_policy_,
-        generated_events_, data_, num_events, random_number_generator_);
+        parallel_policy_,
+        generated_events_, interleaved_data(), num_events, random_number_generator_);
     else
       ket::ranges::generate_events(
-        ket::utility::policy::make_sequential(), // parallel_policy_,
-        generated_events_, data_, num_events, random_number_generator_, static_cast<seed_type>(seed));
+        parallel_policy_,
+        generated_events_, interleaved_data(), num_events, random_number_generator_, static_cast<seed_type>(seed));
   }
 
   void nompi_state::do_expectation_value(std::string const& operator_literal_or_variable_name, std::vector<qubit_type> const& operated_qubits)
@@ -1160,44 +1464,12 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     result_
       = ket::runtime::ranges::expectation_value(
-          parallel_policy_, data_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto index = ::bra::state_integer_type{0u}; index < last_index; ++index)
-            {
-              using std::begin;
-              using std::end;
-              auto const iter
-                = first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const other_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, index);
-                auto const other_iter
-                  = first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, other_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*iter) * (other_index_coeff.second * *other_iter));
-              }
-            }
-
-            return result;
-          },
+          parallel_policy_, interleaved_data(),
+          compiled_pauli_string_space_element,
           operated_qubits);
   }
 
@@ -1277,7 +1549,7 @@ namespace bra
     state_integer_type const divisor, state_integer_type const base,
     std::vector<qubit_type> const& exponent_qubits,
     std::vector<qubit_type> const& modular_exponentiation_qubits)
-  { ket::ranges::shor_box(parallel_policy_, data_, base, divisor, exponent_qubits, modular_exponentiation_qubits); }
+  { ket::ranges::shor_box(parallel_policy_, interleaved_data(), base, divisor, exponent_qubits, modular_exponentiation_qubits); }
 
   void nompi_state::do_begin_fusion()
   { }
@@ -1348,7 +1620,17 @@ namespace bra
           fused_gates_, cache_aware_fused_gates_, to_qubit_index_in_fused_gates};
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
 
-    ket::gate::runtime::ranges::gate(parallel_policy_, data_, call_fused_gates, operated_qubits);
+    auto const num_operated_qubits = static_cast< ::bra::bit_integer_type >(operated_qubits.size());
+    if (::bra::fused_gate::is_fused_unitary_preferable(num_operated_qubits, fused_gates_.size()))
+    {
+      auto const fused_unitary
+        = ::bra::fused_gate::fused_unitary{
+            fused_gates_, num_operated_qubits, to_qubit_index_in_fused_gates, ket::utility::num_threads(parallel_policy_)};
+      ket::gate::runtime::ranges::gate(
+        parallel_policy_, interleaved_data(), ::bra::fused_gate::make_fused_unitary_caller(fused_unitary, call_fused_gates), operated_qubits);
+    }
+    else
+      ket::gate::runtime::ranges::gate(parallel_policy_, interleaved_data(), call_fused_gates, operated_qubits);
 
     fused_gates_.clear();
 # if defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
@@ -1356,11 +1638,20 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
   }
 
+  void nompi_state::do_diagonal(::ket::gate::diagonal_accumulator<complex_type, state_integer_type> const& accumulator)
+  { ket::gate::ranges::diagonal(parallel_policy_, interleaved_data(), accumulator); }
+
   void nompi_state::do_clear(qubit_type const qubit)
-  { ket::gate::ranges::clear(parallel_policy_, data_, qubit); }
+  { ket::gate::ranges::clear(parallel_policy_, interleaved_data(), qubit); }
 
   void nompi_state::do_set(qubit_type const qubit)
-  { ket::gate::ranges::set(parallel_policy_, data_, qubit); }
+  { ket::gate::ranges::set(parallel_policy_, interleaved_data(), qubit); }
+
+  auto nompi_state::do_local_amplitude_ranges() -> std::vector<std::pair<complex_type*, std::size_t>>
+  {
+    auto& data = interleaved_data();
+    return {std::make_pair(data.data(), data.size())};
+  }
 
   void nompi_state::do_controlled_i_gate(
     qubit_type const target_qubit, control_qubit_type const control_qubit)
@@ -1392,7 +1683,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::hadamard(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::hadamard(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_hadamard(
@@ -1409,7 +1703,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::hadamard(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::hadamard(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_not(
@@ -1427,7 +1721,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::not_(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::not_(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_not(
@@ -1444,7 +1741,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::not_(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::not_(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_pauli_x(
@@ -1462,7 +1759,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_x(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_x(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_pauli_xn(
@@ -1481,7 +1781,7 @@ namespace bra
     assert(control_qubits.size() > 0u);
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::pauli_x(parallel_policy_, data_, target_qubits, control_qubits);
+    ket::gate::runtime::ranges::pauli_x(parallel_policy_, interleaved_data(), target_qubits, control_qubits);
   }
 
   void nompi_state::do_controlled_pauli_y(
@@ -1499,7 +1799,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_y(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_y(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_pauli_yn(
@@ -1518,7 +1821,7 @@ namespace bra
     assert(control_qubits.size() > 0u);
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::pauli_y(parallel_policy_, data_, target_qubits, control_qubits);
+    ket::gate::runtime::ranges::pauli_y(parallel_policy_, interleaved_data(), target_qubits, control_qubits);
   }
 
   void nompi_state::do_controlled_pauli_z(
@@ -1536,7 +1839,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::pauli_z(parallel_policy_, data_, control_qubit1, control_qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::pauli_z(parallel_policy, data, qubits...); },
+        control_qubit1, control_qubit2);
   }
 
   void nompi_state::do_multi_controlled_pauli_z(std::vector<control_qubit_type> const& control_qubits)
@@ -1552,7 +1858,7 @@ namespace bra
 
     assert(control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::pauli_z(parallel_policy_, data_, control_qubits);
+    ket::gate::runtime::ranges::pauli_z(parallel_policy_, interleaved_data(), control_qubits);
   }
 
   void nompi_state::do_multi_controlled_pauli_zn(
@@ -1571,7 +1877,7 @@ namespace bra
     assert(control_qubits.size() > 0u);
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::pauli_z(parallel_policy_, data_, target_qubits, control_qubits);
+    ket::gate::runtime::ranges::pauli_z(parallel_policy_, interleaved_data(), target_qubits, control_qubits);
   }
 
   void nompi_state::do_multi_controlled_swap(
@@ -1589,7 +1895,7 @@ namespace bra
 
     assert(control_qubits.size() > 0u);
 
-    ket::gate::runtime::ranges::swap(parallel_policy_, data_, target_qubit1, target_qubit2, control_qubits);
+    ket::gate::runtime::ranges::swap(parallel_policy_, interleaved_data(), target_qubit1, target_qubit2, control_qubits);
   }
 
   void nompi_state::do_controlled_sqrt_pauli_x(
@@ -1607,7 +1913,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::sqrt_pauli_x(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::sqrt_pauli_x(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_sqrt_pauli_x(
@@ -1625,7 +1934,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_sqrt_pauli_x(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_sqrt_pauli_x(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_sqrt_pauli_x(
@@ -1642,7 +1954,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::sqrt_pauli_x(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::sqrt_pauli_x(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_sqrt_pauli_x(
@@ -1659,7 +1971,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::adj_sqrt_pauli_x(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::adj_sqrt_pauli_x(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_sqrt_pauli_y(
@@ -1677,7 +1989,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::sqrt_pauli_y(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::sqrt_pauli_y(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_sqrt_pauli_y(
@@ -1695,7 +2010,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_sqrt_pauli_y(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_sqrt_pauli_y(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_sqrt_pauli_y(
@@ -1712,7 +2030,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::sqrt_pauli_y(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::sqrt_pauli_y(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_sqrt_pauli_y(
@@ -1729,7 +2047,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::adj_sqrt_pauli_y(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::adj_sqrt_pauli_y(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_sqrt_pauli_z(
@@ -1747,7 +2065,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::sqrt_pauli_z(parallel_policy_, data_, control_qubit1, control_qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::sqrt_pauli_z(parallel_policy, data, qubits...); },
+        control_qubit1, control_qubit2);
   }
 
   void nompi_state::do_adj_controlled_sqrt_pauli_z(
@@ -1765,7 +2086,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_sqrt_pauli_z(parallel_policy_, data_, control_qubit1, control_qubit2);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_sqrt_pauli_z(parallel_policy, data, qubits...); },
+        control_qubit1, control_qubit2);
   }
 
   void nompi_state::do_multi_controlled_sqrt_pauli_z(std::vector<control_qubit_type> const& control_qubits)
@@ -1781,7 +2105,7 @@ namespace bra
 
     assert(control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::sqrt_pauli_z(parallel_policy_, data_, control_qubits);
+    ket::gate::runtime::ranges::sqrt_pauli_z(parallel_policy_, interleaved_data(), control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_sqrt_pauli_z(std::vector<control_qubit_type> const& control_qubits)
@@ -1797,7 +2121,7 @@ namespace bra
 
     assert(control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::adj_sqrt_pauli_z(parallel_policy_, data_, control_qubits);
+    ket::gate::runtime::ranges::adj_sqrt_pauli_z(parallel_policy_, interleaved_data(), control_qubits);
   }
 
   void nompi_state::do_multi_controlled_sqrt_pauli_zn(
@@ -1816,7 +2140,7 @@ namespace bra
     assert(control_qubits.size() > 0u);
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::sqrt_pauli_z(parallel_policy_, data_, target_qubits, control_qubits);
+    ket::gate::runtime::ranges::sqrt_pauli_z(parallel_policy_, interleaved_data(), target_qubits, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_sqrt_pauli_zn(
@@ -1835,7 +2159,7 @@ namespace bra
     assert(control_qubits.size() > 0u);
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
-    ket::gate::runtime::ranges::adj_sqrt_pauli_z(parallel_policy_, data_, target_qubits, control_qubits);
+    ket::gate::runtime::ranges::adj_sqrt_pauli_z(parallel_policy_, interleaved_data(), target_qubits, control_qubits);
   }
 
   void nompi_state::do_controlled_phase_shift(
@@ -1854,7 +2178,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift_coeff(parallel_policy_, data_, phase_coefficient, control_qubit1, control_qubit2);
+      apply_gate(
+        [phase_coefficient](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift_coeff(parallel_policy, data, phase_coefficient, qubits...); },
+        control_qubit1, control_qubit2);
   }
 
   void nompi_state::do_adj_controlled_phase_shift(
@@ -1873,7 +2200,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift_coeff(parallel_policy_, data_, phase_coefficient, control_qubit1, control_qubit2);
+      apply_gate(
+        [phase_coefficient](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift_coeff(parallel_policy, data, phase_coefficient, qubits...); },
+        control_qubit1, control_qubit2);
   }
 
   void nompi_state::do_multi_controlled_phase_shift(
@@ -1892,7 +2222,7 @@ namespace bra
     assert(control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::phase_shift_coeff(
-      parallel_policy_, data_, phase_coefficient, control_qubits);
+      parallel_policy_, interleaved_data(), phase_coefficient, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_phase_shift(
@@ -1911,7 +2241,7 @@ namespace bra
     assert(control_qubits.size() > 1u);
 
     ket::gate::runtime::ranges::adj_phase_shift_coeff(
-      parallel_policy_, data_, phase_coefficient, control_qubits);
+      parallel_policy_, interleaved_data(), phase_coefficient, control_qubits);
   }
 
   void nompi_state::do_controlled_u1(
@@ -1929,7 +2259,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift(parallel_policy_, data_, phase, control_qubit1, control_qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift(parallel_policy, data, phase, qubits...); },
+        control_qubit1, control_qubit2);
   }
 
   void nompi_state::do_adj_controlled_u1(
@@ -1947,7 +2280,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift(parallel_policy_, data_, phase, control_qubit1, control_qubit2);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift(parallel_policy, data, phase, qubits...); },
+        control_qubit1, control_qubit2);
   }
 
   void nompi_state::do_multi_controlled_u1(
@@ -1965,7 +2301,7 @@ namespace bra
     assert(control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::phase_shift(
-      parallel_policy_, data_, phase, control_qubits);
+      parallel_policy_, interleaved_data(), phase, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_u1(
@@ -1983,7 +2319,7 @@ namespace bra
     assert(control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::adj_phase_shift(
-      parallel_policy_, data_, phase, control_qubits);
+      parallel_policy_, interleaved_data(), phase, control_qubits);
   }
 
   void nompi_state::do_controlled_u2(
@@ -2001,7 +2337,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift2(parallel_policy_, data_, phase1, phase2, target_qubit, control_qubit);
+      apply_gate(
+        [phase1, phase2](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift2(parallel_policy, data, phase1, phase2, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_u2(
@@ -2019,7 +2358,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift2(parallel_policy_, data_, phase1, phase2, target_qubit, control_qubit);
+      apply_gate(
+        [phase1, phase2](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift2(parallel_policy, data, phase1, phase2, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_u2(
@@ -2037,7 +2379,7 @@ namespace bra
     assert(control_qubits.size() > 1u);
 
     ket::gate::runtime::ranges::phase_shift2(
-      parallel_policy_, data_, phase1, phase2, target_qubit, control_qubits);
+      parallel_policy_, interleaved_data(), phase1, phase2, target_qubit, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_u2(
@@ -2055,7 +2397,7 @@ namespace bra
     assert(control_qubits.size() > 1u);
 
     ket::gate::runtime::ranges::adj_phase_shift2(
-      parallel_policy_, data_, phase1, phase2, target_qubit, control_qubits);
+      parallel_policy_, interleaved_data(), phase1, phase2, target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_u3(
@@ -2074,7 +2416,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::phase_shift3(parallel_policy_, data_, phase1, phase2, phase3, target_qubit, control_qubit);
+      apply_gate(
+        [phase1, phase2, phase3](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::phase_shift3(parallel_policy, data, phase1, phase2, phase3, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_u3(
@@ -2093,7 +2438,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_phase_shift3(parallel_policy_, data_, phase1, phase2, phase3, target_qubit, control_qubit);
+      apply_gate(
+        [phase1, phase2, phase3](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_phase_shift3(parallel_policy, data, phase1, phase2, phase3, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_u3(
@@ -2112,7 +2460,7 @@ namespace bra
     assert(control_qubits.size() > 1u);
 
     ket::gate::runtime::ranges::phase_shift3(
-      parallel_policy_, data_, phase1, phase2, phase3, target_qubit, control_qubits);
+      parallel_policy_, interleaved_data(), phase1, phase2, phase3, target_qubit, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_u3(
@@ -2131,7 +2479,7 @@ namespace bra
     assert(control_qubits.size() > 1u);
 
     ket::gate::runtime::ranges::adj_phase_shift3(
-      parallel_policy_, data_, phase1, phase2, phase3, target_qubit, control_qubits);
+      parallel_policy_, interleaved_data(), phase1, phase2, phase3, target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_x_rotation_half_pi(
@@ -2149,7 +2497,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::x_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::x_rotation_half_pi(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_x_rotation_half_pi(
@@ -2167,7 +2518,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_x_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_x_rotation_half_pi(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_x_rotation_half_pi(
@@ -2184,7 +2538,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::x_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::x_rotation_half_pi(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_x_rotation_half_pi(
@@ -2201,7 +2555,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::adj_x_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::adj_x_rotation_half_pi(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_y_rotation_half_pi(
@@ -2219,7 +2573,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::y_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::y_rotation_half_pi(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_y_rotation_half_pi(
@@ -2237,7 +2594,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_y_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubit);
+      apply_gate(
+        [](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_y_rotation_half_pi(parallel_policy, data, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_y_rotation_half_pi(
@@ -2254,7 +2614,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::y_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::y_rotation_half_pi(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_y_rotation_half_pi(
@@ -2271,7 +2631,7 @@ namespace bra
 
     assert(control_qubits.size() > 1u);
 
-    ket::gate::runtime::ranges::adj_y_rotation_half_pi(parallel_policy_, data_, target_qubit, control_qubits);
+    ket::gate::runtime::ranges::adj_y_rotation_half_pi(parallel_policy_, interleaved_data(), target_qubit, control_qubits);
   }
 
   void nompi_state::do_controlled_exponential_pauli_x(
@@ -2289,7 +2649,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_x(parallel_policy_, data_, phase, target_qubit, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_x(parallel_policy, data, phase, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_exponential_pauli_x(
@@ -2307,7 +2670,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_x(parallel_policy_, data_, phase, target_qubit, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_x(parallel_policy, data, phase, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_exponential_pauli_xn(
@@ -2327,7 +2693,7 @@ namespace bra
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::exponential_pauli_x(
-      parallel_policy_, data_, phase, target_qubits, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubits, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_exponential_pauli_xn(
@@ -2347,7 +2713,7 @@ namespace bra
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::adj_exponential_pauli_x(
-      parallel_policy_, data_, phase, target_qubits, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubits, control_qubits);
   }
 
   void nompi_state::do_controlled_exponential_pauli_y(
@@ -2365,7 +2731,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_y(parallel_policy_, data_, phase, target_qubit, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_y(parallel_policy, data, phase, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_exponential_pauli_y(
@@ -2383,7 +2752,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_y(parallel_policy_, data_, phase, target_qubit, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_y(parallel_policy, data, phase, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_exponential_pauli_yn(
@@ -2403,7 +2775,7 @@ namespace bra
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::exponential_pauli_y(
-      parallel_policy_, data_, phase, target_qubits, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubits, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_exponential_pauli_yn(
@@ -2423,7 +2795,7 @@ namespace bra
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::adj_exponential_pauli_y(
-      parallel_policy_, data_, phase, target_qubits, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubits, control_qubits);
   }
 
   void nompi_state::do_controlled_exponential_pauli_z(
@@ -2441,7 +2813,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::exponential_pauli_z(parallel_policy_, data_, phase, target_qubit, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::exponential_pauli_z(parallel_policy, data, phase, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_adj_controlled_exponential_pauli_z(
@@ -2459,7 +2834,10 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
     }
     else
-      ket::gate::ranges::adj_exponential_pauli_z(parallel_policy_, data_, phase, target_qubit, control_qubit);
+      apply_gate(
+        [phase](auto const parallel_policy, auto& data, auto const... qubits)
+        { ket::gate::ranges::adj_exponential_pauli_z(parallel_policy, data, phase, qubits...); },
+        target_qubit, control_qubit);
   }
 
   void nompi_state::do_multi_controlled_exponential_pauli_z(
@@ -2477,7 +2855,7 @@ namespace bra
     assert(1u + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::exponential_pauli_z(
-      parallel_policy_, data_, phase,
+      parallel_policy_, interleaved_data(), phase,
       boost::make_iterator_range(&target_qubit, &target_qubit + 1), control_qubits);
   }
 
@@ -2496,7 +2874,7 @@ namespace bra
     assert(1u + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::adj_exponential_pauli_z(
-      parallel_policy_, data_, phase,
+      parallel_policy_, interleaved_data(), phase,
       boost::make_iterator_range(&target_qubit, &target_qubit + 1), control_qubits);
   }
 
@@ -2517,7 +2895,7 @@ namespace bra
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::exponential_pauli_z(
-      parallel_policy_, data_, phase, target_qubits, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubits, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_exponential_pauli_zn(
@@ -2537,7 +2915,7 @@ namespace bra
     assert(target_qubits.size() + control_qubits.size() > 2u);
 
     ket::gate::runtime::ranges::adj_exponential_pauli_z(
-      parallel_policy_, data_, phase, target_qubits, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubits, control_qubits);
   }
 
   void nompi_state::do_multi_controlled_exponential_swap(
@@ -2556,7 +2934,7 @@ namespace bra
     assert(control_qubits.size() > 0u);
 
     ket::gate::runtime::ranges::exponential_swap(
-      parallel_policy_, data_, phase, target_qubit1, target_qubit2, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubit1, target_qubit2, control_qubits);
   }
 
   void nompi_state::do_adj_multi_controlled_exponential_swap(
@@ -2575,13 +2953,13 @@ namespace bra
     assert(control_qubits.size() > 0u);
 
     ket::gate::runtime::ranges::adj_exponential_swap(
-      parallel_policy_, data_, phase, target_qubit1, target_qubit2, control_qubits);
+      parallel_policy_, interleaved_data(), phase, target_qubit1, target_qubit2, control_qubits);
   }
 
   void inner_product(::bra::nompi_state& state1, ::bra::nompi_state& state2)
   {
     auto const result
-      = ket::ranges::inner_product(state1.parallel_policy_, state1.data_, state2.data_);
+      = ket::ranges::inner_product(state1.parallel_policy_, state1.interleaved_data(), state2.interleaved_data());
     state1.result_ = result;
     using std::conj;
     state2.result_ = conj(result);
@@ -2595,7 +2973,7 @@ namespace bra
     auto const state_last = end(states);
     for (auto iter = state_first; iter != state_last; ++iter)
       iter->result_
-        = ket::ranges::inner_product(state_first->parallel_policy_, state_first->data_, iter->data_);
+        = ket::ranges::inner_product(state_first->parallel_policy_, state_first->interleaved_data(), iter->interleaved_data());
   }
 
   void inner_product_op(
@@ -2612,44 +2990,12 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     auto const result
       = ket::runtime::ranges::inner_product(
-          state1.parallel_policy_, state1.data_, state2.data_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          state1.parallel_policy_, state1.interleaved_data(), state2.interleaved_data(),
+          compiled_pauli_string_space_element,
           operated_qubits);
     state1.result_ = result;
     using std::conj;
@@ -2675,52 +3021,20 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     for (auto iter = state_first; iter != state_last; ++iter)
       iter->result_
         = ket::runtime::ranges::inner_product(
-            state_first->parallel_policy_, state_first->data_, iter->data_,
-            [&pauli_string_space_element, num_operated_qubits](
-              auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-              auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-            {
-              auto result = ::bra::complex_type{};
-
-              auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-              for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-              {
-                using std::begin;
-                using std::end;
-                auto const bra_iter
-                  = bra_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, bra_index,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                for (auto const& basis_scalar: pauli_string_space_element)
-                {
-                  auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                  auto const ket_iter
-                    = ket_first
-                      + ket::gate::utility::index_with_qubits(
-                          index_wo_qubits, ket_index_coeff.first,
-                          begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                          begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                  using std::conj;
-                  result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-                }
-              }
-
-              return result;
-            },
+            state_first->parallel_policy_, state_first->interleaved_data(), iter->interleaved_data(),
+            compiled_pauli_string_space_element,
             operated_qubits);
   }
 
   void fidelity(::bra::nompi_state& state1, ::bra::nompi_state& state2)
   {
     auto const result
-      = ket::ranges::fidelity(state1.parallel_policy_, state1.data_, state2.data_);
+      = ket::ranges::fidelity(state1.parallel_policy_, state1.interleaved_data(), state2.interleaved_data());
     state1.result_ = result;
     using std::conj;
     state2.result_ = conj(result);
@@ -2734,7 +3048,7 @@ namespace bra
     auto const state_last = end(states);
     for (auto iter = state_first; iter != state_last; ++iter)
       iter->result_
-        = ket::ranges::fidelity(state_first->parallel_policy_, state_first->data_, iter->data_);
+        = ket::ranges::fidelity(state_first->parallel_policy_, state_first->interleaved_data(), iter->interleaved_data());
   }
 
   void fidelity_op(
@@ -2751,44 +3065,12 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     auto const result
       = ket::runtime::ranges::fidelity(
-          state1.parallel_policy_, state1.data_, state2.data_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          state1.parallel_policy_, state1.interleaved_data(), state2.interleaved_data(),
+          compiled_pauli_string_space_element,
           operated_qubits);
     state1.result_ = result;
     using std::conj;
@@ -2814,45 +3096,13 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     for (auto iter = state_first; iter != state_last; ++iter)
       iter->result_
         = ket::runtime::ranges::fidelity(
-            state_first->parallel_policy_, state_first->data_, iter->data_,
-            [&pauli_string_space_element, num_operated_qubits](
-              auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-              auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-            {
-              auto result = ::bra::complex_type{};
-
-              auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-              for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-              {
-                using std::begin;
-                using std::end;
-                auto const bra_iter
-                  = bra_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, bra_index,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                for (auto const& basis_scalar: pauli_string_space_element)
-                {
-                  auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                  auto const ket_iter
-                    = ket_first
-                      + ket::gate::utility::index_with_qubits(
-                          index_wo_qubits, ket_index_coeff.first,
-                          begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                          begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                  using std::conj;
-                  result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-                }
-              }
-
-              return result;
-            },
+            state_first->parallel_policy_, state_first->interleaved_data(), iter->interleaved_data(),
+            compiled_pauli_string_space_element,
             operated_qubits);
   }
 
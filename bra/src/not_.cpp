@@ -8,6 +8,7 @@
 #include <bra/gate/gate.hpp>
 #include <bra/gate/not_.hpp>
 #include <bra/state.hpp>
+#include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -32,5 +33,15 @@ namespace bra
         << std::setw(parameter_width) << qubit_;
       return repr_stream.str();
     }
+
+    bool not_::do_lower(::bra::instruction& instruction) const
+    {
+      instruction
+        = ::bra::instruction{
+            ::bra::opcode::not_, do_is_diagonal(),
+            {static_cast< ::bra::bit_integer_type >(qubit_), 0u},
+            ::bra::real_type{}};
+      return true;
+    }
   } // namespace gate
 } // namespace bra
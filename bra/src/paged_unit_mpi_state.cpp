@@ -32,7 +32,6 @@
 # if defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
 #   include <ket/gate/utility/cache_aware_iterator.hpp>
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
-# include <ket/gate/utility/pauli_index_coeff.hpp>
 # include <ket/mpi/gate/gate.hpp>
 # include <ket/mpi/gate/identity.hpp>
 # include <ket/mpi/gate/hadamard.hpp>
@@ -54,6 +53,7 @@
 # include <ket/mpi/gate/toffoli.hpp>
 # include <ket/mpi/gate/projective_measurement.hpp>
 # include <ket/mpi/gate/clear.hpp>
+# include <ket/mpi/gate/diagonal.hpp>
 # include <ket/mpi/gate/set.hpp>
 # include <ket/mpi/all_spin_expectation_values.hpp>
 # include <ket/mpi/print_amplitudes.hpp>
@@ -69,8 +69,9 @@
 # include <bra/paged_unit_mpi_state.hpp>
 # include <bra/state.hpp>
 # include <bra/types.hpp>
+# include <bra/compiled_pauli_string_space.hpp>
 # include <bra/fused_gate.hpp>
-# include <bra/utility/closest_floating_point_of.hpp>
+# include <bra/fused_gate/fused_unitary.hpp>
 
 namespace bra
 {
@@ -254,7 +255,7 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{num_unit_qubits, num_processes_per_unit},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        parallel_policy_, mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, circuit_communicator, environment},
       fused_gates_{},
       paged_fused_gates_{},
@@ -286,7 +287,7 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{num_unit_qubits, num_processes_per_unit},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        parallel_policy_, mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, circuit_communicator, environment},
       fused_gates_{},
       paged_fused_gates_{},
@@ -318,7 +319,7 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{num_unit_qubits, num_processes_per_unit},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        parallel_policy_, mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, circuit_communicator, environment},
       fused_gates_{},
       paged_fused_gates_{}
@@ -348,7 +349,7 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{num_unit_qubits, num_processes_per_unit},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        parallel_policy_, mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, circuit_communicator, environment},
       fused_gates_{},
       paged_fused_gates_{}
@@ -378,7 +379,7 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{num_unit_qubits, num_processes_per_unit},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        parallel_policy_, mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, circuit_communicator, environment},
       fused_gates_{}
   { }
@@ -407,33 +408,12 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{num_unit_qubits, num_processes_per_unit},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        parallel_policy_, mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, circuit_communicator, environment},
       fused_gates_{}
   { }
 # endif
 
-  auto paged_unit_mpi_state::generate_probability() -> real_type
-  {
-    auto result = real_type{0};
-
-    using namespace yampi::literals::rank_literals;
-    if (circuit_communicator_.rank(environment_) == 0_r)
-    {
-      using floating_point_type = typename ::bra::utility::closest_floating_point_of<real_type>::type;
-      auto distribution = std::uniform_real_distribution<floating_point_type>{0.0, 1.0};
-
-      result
-        = uses_depolarizing_seed_
-          ? static_cast<real_type>(distribution(depolarizing_random_number_generator_))
-          : static_cast<real_type>(distribution(random_number_generator_));
-    }
-
-    yampi::broadcast(yampi::make_buffer(result), 0_r, circuit_communicator_, environment_);
-
-    return result;
-  }
-
   auto paged_unit_mpi_state::do_send_real_variable(int const destination_circuit_index, std::string const& variable_name, int const num_elements) const -> void
   {
     if (destination_circuit_index == circuit_index_)
@@ -2031,12 +2011,12 @@ namespace bra
   {
     if (seed < 0)
       ket::mpi::generate_events(
-        mpi_policy_, ket::utility::policy::make_sequential(), // parallel_policy_,
+        mpi_policy_, parallel_policy_,
         generated_events_, data_, num_events, random_number_generator_, permutation_,
         circuit_communicator_, environment_);
     else
       ket::mpi::generate_events(
-        mpi_policy_, ket::utility::policy::make_sequential(), // parallel_policy_,
+        mpi_policy_, parallel_policy_,
         generated_events_, data_, num_events, random_number_generator_, static_cast<seed_type>(seed), permutation_,
         circuit_communicator_, environment_);
   }
@@ -2049,45 +2029,13 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     result_
       = ket::mpi::runtime::ranges::expectation_value(
           mpi_policy_, parallel_policy_,
           data_, permutation_, buffer_, circuit_communicator_, environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto index = ::bra::state_integer_type{0u}; index < last_index; ++index)
-            {
-              using std::begin;
-              using std::end;
-              auto const iter
-                = first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const other_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, index);
-                auto const other_iter
-                  = first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, other_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*iter) * (other_index_coeff.second * *other_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
   }
 
@@ -2136,6 +2084,8 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     if (std::isdigit(static_cast<unsigned char>(remote_circuit_index_or_all.front())))
     {
       remote_circuit_index = boost::lexical_cast<int>(remote_circuit_index_or_all);
@@ -2154,41 +2104,7 @@ namespace bra
         = ket::mpi::runtime::ranges::inner_product(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, 0_r, intercircuit_communicator_, environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
     else
@@ -2198,41 +2114,7 @@ namespace bra
         = ket::mpi::runtime::ranges::inner_product(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, intercommunicators_[index], environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
   }
@@ -2282,6 +2164,8 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     if (std::isdigit(static_cast<unsigned char>(remote_circuit_index_or_all.front())))
     {
       remote_circuit_index = boost::lexical_cast<int>(remote_circuit_index_or_all);
@@ -2300,41 +2184,7 @@ namespace bra
         = ket::mpi::runtime::ranges::fidelity(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, 0_r, intercircuit_communicator_, environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
     else
@@ -2344,41 +2194,7 @@ namespace bra
         = ket::mpi::runtime::ranges::fidelity(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, intercommunicators_[index], environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
   }
@@ -2608,10 +2424,22 @@ namespace bra
           fused_gates_, to_qubit_index_in_fused_gates};
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && defined(KET_USE_ON_CACHE_STATE_VECTOR)
 
-    ket::mpi::gate::runtime::ranges::gate(
-      mpi_policy_, parallel_policy_,
-      data_, permutation_, buffer_, circuit_communicator_, environment_,
-      call_fused_gates, fused_qubits, fused_control_qubits);
+    auto const num_operated_qubits = static_cast< ::bra::bit_integer_type >(fused_qubits.size() + fused_control_qubits.size());
+    if (::bra::fused_gate::is_fused_unitary_preferable(num_operated_qubits, fused_gates_.size()))
+    {
+      auto const fused_unitary
+        = ::bra::fused_gate::fused_unitary{
+            fused_gates_, num_operated_qubits, to_qubit_index_in_fused_gates, ket::utility::num_threads(parallel_policy_)};
+      ket::mpi::gate::runtime::ranges::gate(
+        mpi_policy_, parallel_policy_,
+        data_, permutation_, buffer_, circuit_communicator_, environment_,
+        ::bra::fused_gate::make_fused_unitary_caller(fused_unitary, call_fused_gates), fused_qubits, fused_control_qubits);
+    }
+    else
+      ket::mpi::gate::runtime::ranges::gate(
+        mpi_policy_, parallel_policy_,
+        data_, permutation_, buffer_, circuit_communicator_, environment_,
+        call_fused_gates, fused_qubits, fused_control_qubits);
 
     fused_gates_.clear();
 # if !defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) || (defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR))
@@ -2623,6 +2451,13 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
   }
 
+  void paged_unit_mpi_state::do_diagonal(::ket::gate::diagonal_accumulator<complex_type, state_integer_type> const& accumulator)
+  {
+    ket::mpi::gate::diagonal(
+      mpi_policy_, parallel_policy_,
+      data_, permutation_, circuit_communicator_, environment_, accumulator);
+  }
+
   void paged_unit_mpi_state::do_clear(qubit_type const qubit)
   {
     ket::mpi::gate::clear(
@@ -2637,6 +2472,25 @@ namespace bra
       data_, permutation_, buffer_, circuit_communicator_, environment_, qubit);
   }
 
+  auto paged_unit_mpi_state::do_local_amplitude_ranges() -> std::vector<std::pair<complex_type*, std::size_t>>
+  {
+    auto const num_data_blocks = data_.num_data_blocks();
+    auto const num_pages = data_.num_pages();
+    auto result = std::vector<std::pair<complex_type*, std::size_t>>{};
+    result.reserve(num_data_blocks * num_pages);
+
+    using std::begin;
+    using std::end;
+    for (auto data_block_index = std::size_t{0u}; data_block_index < num_data_blocks; ++data_block_index)
+      for (auto page_index = std::size_t{0u}; page_index < num_pages; ++page_index)
+      {
+        auto const& page_range = data_.page_range(std::make_pair(data_block_index, page_index));
+        result.emplace_back(std::addressof(*begin(page_range)), static_cast<std::size_t>(end(page_range) - begin(page_range)));
+      }
+
+    return result;
+  }
+
   void paged_unit_mpi_state::do_controlled_i_gate(
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
@@ -9,6 +9,7 @@
 #include <bra/gate/gate.hpp>
 #include <bra/gate/pauli_z.hpp>
 #include <bra/state.hpp>
+#include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -33,5 +34,15 @@ namespace bra
         << std::setw(parameter_width) << control_qubit_;
       return repr_stream.str();
     }
+
+    bool pauli_z::do_lower(::bra::instruction& instruction) const
+    {
+      instruction
+        = ::bra::instruction{
+            ::bra::opcode::pauli_z, do_is_diagonal(),
+            {static_cast< ::bra::bit_integer_type >(control_qubit_.qubit()), 0u},
+            ::bra::real_type{}};
+      return true;
+    }
   } // namespace gate
 } // namespace bra
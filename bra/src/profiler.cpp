@@ -0,0 +1,275 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <string>
+#include <tuple>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <ios>
+#include <iomanip>
+#include <stdexcept>
+
+#ifndef BRA_NO_MPI
+# include <yampi/communicator.hpp>
+# include <yampi/environment.hpp>
+# include <yampi/rank.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/gather.hpp>
+#endif // BRA_NO_MPI
+
+#include <ket/utility/profiler.hpp>
+
+#include <bra/profiler.hpp>
+
+
+namespace bra
+{
+  namespace profiler_detail
+  {
+    // values of a record, which are gathered from MPI processes as doubles
+    constexpr auto num_values = std::size_t{5u};
+    enum value_index : std::size_t { count = 0u, compute_time, interchange_time, barrier_time, num_moved_bytes };
+
+    inline auto to_values(::bra::profiler::record_type const& record, std::vector<double>& values) -> void
+    {
+      values.push_back(static_cast<double>(record.count));
+      values.push_back(record.compute_time);
+      values.push_back(record.interchange_time);
+      values.push_back(record.barrier_time);
+      values.push_back(static_cast<double>(record.num_moved_bytes));
+    }
+
+    // times are maxima over processes and moved bytes are summed up
+    inline auto reduce(std::vector<std::vector<double>> const& rank_values, std::size_t const record_index) -> std::vector<double>
+    {
+      auto result = std::vector<double>(num_values, 0.0);
+      for (auto const& values: rank_values)
+      {
+        auto const first = values.begin() + record_index * num_values;
+        result[count] = std::max(result[count], first[count]);
+        result[compute_time] = std::max(result[compute_time], first[compute_time]);
+        result[interchange_time] = std::max(result[interchange_time], first[interchange_time]);
+        result[barrier_time] = std::max(result[barrier_time], first[barrier_time]);
+        result[num_moved_bytes] += first[num_moved_bytes];
+      }
+      return result;
+    }
+
+    inline auto ends_with(std::string const& string, std::string const& suffix) -> bool
+    { return string.size() >= suffix.size() and std::equal(suffix.rbegin(), suffix.rend(), string.rbegin()); }
+
+    inline auto class_name(::bra::profiler::key_type const& key) -> char const*
+    { return std::get<2u>(key) ? "global" : "local"; }
+
+    // rank_values[rank][record_index * num_values + value_index]
+    struct circuit_profile
+    {
+      int circuit_index;
+      std::vector< ::bra::profiler::key_type > keys;
+      std::vector<std::vector<double>> rank_values;
+      ::bra::profiler::fusion_record_type fusion_record;
+    }; // struct circuit_profile
+
+    inline auto write_values(std::ostream& output_stream, std::vector<double>::const_iterator const first) -> void
+    {
+      output_stream
+        << static_cast<std::uint64_t>(first[count]) << ',' << first[compute_time] << ','
+        << first[interchange_time] << ',' << first[barrier_time] << ',' << static_cast<std::uint64_t>(first[num_moved_bytes]);
+    }
+
+    // Records of processes are followed by reduced ones if there are two or more processes, and fusion records are in a separate table
+    inline auto write_csv(std::ostream& output_stream, std::vector<circuit_profile> const& profiles) -> void
+    {
+      output_stream << "circuit,rank,mnemonic,num_qubits,class,count,compute_seconds,interchange_seconds,barrier_seconds,moved_bytes\n";
+      for (auto const& profile: profiles)
+      {
+        auto const num_ranks = profile.rank_values.size();
+        for (auto record_index = std::size_t{0u}; record_index < profile.keys.size(); ++record_index)
+        {
+          auto const& key = profile.keys[record_index];
+          for (auto rank = std::size_t{0u}; rank < num_ranks; ++rank)
+          {
+            output_stream << profile.circuit_index << ',' << rank << ',' << std::get<0u>(key) << ',' << std::get<1u>(key) << ',' << class_name(key) << ',';
+            write_values(output_stream, profile.rank_values[rank].begin() + record_index * num_values);
+            output_stream << '\n';
+          }
+
+          if (num_ranks <= 1u)
+            continue;
+
+          auto const reduced_values = reduce(profile.rank_values, record_index);
+          output_stream << profile.circuit_index << ",reduced," << std::get<0u>(key) << ',' << std::get<1u>(key) << ',' << class_name(key) << ',';
+          write_values(output_stream, reduced_values.begin());
+          output_stream << '\n';
+        }
+      }
+
+      output_stream << "\ncircuit,fusion_blocks,fused_gates,max_fused_gates\n";
+      for (auto const& profile: profiles)
+        output_stream
+          << profile.circuit_index << ',' << profile.fusion_record.num_blocks << ','
+          << profile.fusion_record.num_fused_gates << ',' << profile.fusion_record.max_num_fused_gates << '\n';
+    }
+
+    inline auto write_json_values(std::ostream& output_stream, std::vector<double>::const_iterator const first) -> void
+    {
+      output_stream
+        << "\"count\": " << static_cast<std::uint64_t>(first[count])
+        << ", \"compute_seconds\": " << first[compute_time]
+        << ", \"interchange_seconds\": " << first[interchange_time]
+        << ", \"barrier_seconds\": " << first[barrier_time]
+        << ", \"moved_bytes\": " << static_cast<std::uint64_t>(first[num_moved_bytes]);
+    }
+
+    inline auto write_json(std::ostream& output_stream, std::vector<circuit_profile> const& profiles) -> void
+    {
+      output_stream << "{\n  \"circuits\": [";
+      auto is_first_profile = true;
+      for (auto const& profile: profiles)
+      {
+        output_stream << (is_first_profile ? "\n" : ",\n");
+        is_first_profile = false;
+
+        auto const num_ranks = profile.rank_values.size();
+        output_stream
+          << "    {\n      \"circuit\": " << profile.circuit_index << ",\n      \"num_processes\": " << num_ranks << ",\n      \"gates\": [";
+        for (auto record_index = std::size_t{0u}; record_index < profile.keys.size(); ++record_index)
+        {
+          auto const& key = profile.keys[record_index];
+          output_stream
+            << (record_index == 0u ? "\n" : ",\n")
+            << "        {\"mnemonic\": \"" << std::get<0u>(key) << "\", \"num_qubits\": " << std::get<1u>(key)
+            << ", \"class\": \"" << class_name(key) << "\", ";
+          write_json_values(output_stream, reduce(profile.rank_values, record_index).begin());
+          output_stream << ",\n         \"ranks\": [";
+          for (auto rank = std::size_t{0u}; rank < num_ranks; ++rank)
+          {
+            output_stream << (rank == 0u ? "{" : ", {");
+            write_json_values(output_stream, profile.rank_values[rank].begin() + record_index * num_values);
+            output_stream << '}';
+          }
+          output_stream << "]}";
+        }
+
+        output_stream
+          << "\n      ],\n      \"fusion\": {\"blocks\": " << profile.fusion_record.num_blocks
+          << ", \"fused_gates\": " << profile.fusion_record.num_fused_gates
+          << ", \"max_fused_gates\": " << profile.fusion_record.max_num_fused_gates << "}\n    }";
+      }
+      output_stream << "\n  ]\n}\n";
+    }
+
+    inline auto write(std::string const& filename, std::vector<circuit_profile> const& profiles) -> void
+    {
+      std::ofstream output_stream{filename};
+      if (not output_stream)
+        throw std::runtime_error{(filename + " cannot be opened").c_str()};
+
+      output_stream << std::setprecision(9);
+      if (ends_with(filename, ".json"))
+        write_json(output_stream, profiles);
+      else
+        write_csv(output_stream, profiles);
+    }
+
+    inline auto make_circuit_profile(
+      int const circuit_index, std::map< ::bra::profiler::key_type, ::bra::profiler::record_type > const& records,
+      ::bra::profiler::fusion_record_type const& fusion_record)
+    -> circuit_profile
+    {
+      auto result = circuit_profile{circuit_index, {}, std::vector<std::vector<double>>(1u), fusion_record};
+      result.keys.reserve(records.size());
+      result.rank_values.front().reserve(records.size() * num_values);
+      for (auto const& key_record: records)
+      {
+        result.keys.push_back(key_record.first);
+        to_values(key_record.second, result.rank_values.front());
+      }
+
+      return result;
+    }
+  } // namespace profiler_detail
+
+  profiler::profiler(std::size_t const num_circuits)
+    : records_(num_circuits), fusion_records_(num_circuits, fusion_record_type{0u, 0u, 0u}), num_gates_in_fusion_(num_circuits, 0u)
+  { ket::utility::profiler::instance().enable(); }
+
+  auto profiler::add(int const circuit_index, key_type const& key, double const seconds) -> void
+  {
+    auto const counters = ket::utility::profiler::instance().take();
+    auto const interchange_time = counters.seconds[static_cast<int>(ket::utility::profile_phase::interchange)];
+    auto const barrier_time = counters.seconds[static_cast<int>(ket::utility::profile_phase::barrier)];
+
+    auto& record = records_[circuit_index].emplace(key, record_type{0u, 0.0, 0.0, 0.0, 0u}).first->second;
+    ++record.count;
+    record.compute_time += std::max(0.0, seconds - interchange_time - barrier_time);
+    record.interchange_time += interchange_time;
+    record.barrier_time += barrier_time;
+    record.num_moved_bytes += counters.num_moved_bytes;
+  }
+
+  auto profiler::observe_fusion(int const circuit_index, bool const was_in_fusion, bool const is_in_fusion) -> void
+  {
+    auto& num_gates_in_fusion = num_gates_in_fusion_[circuit_index];
+    if (not was_in_fusion)
+    {
+      // BEGIN FUSION
+      if (is_in_fusion)
+        num_gates_in_fusion = 0u;
+      return;
+    }
+
+    if (is_in_fusion)
+    {
+      ++num_gates_in_fusion;
+      return;
+    }
+
+    // END FUSION
+    auto& fusion_record = fusion_records_[circuit_index];
+    ++fusion_record.num_blocks;
+    fusion_record.num_fused_gates += num_gates_in_fusion;
+    fusion_record.max_num_fused_gates = std::max(fusion_record.max_num_fused_gates, num_gates_in_fusion);
+  }
+
+#ifndef BRA_NO_MPI
+  auto profiler::write(
+    std::string const& filename, int const circuit_index,
+    yampi::communicator const& circuit_communicator, yampi::environment const& environment) const -> void
+  {
+    auto profile = ::bra::profiler_detail::make_circuit_profile(circuit_index, records_[circuit_index], fusion_records_[circuit_index]);
+    auto const& values = profile.rank_values.front();
+
+    auto const root = yampi::rank{0};
+    if (circuit_communicator.rank(environment) != root)
+    {
+      yampi::gather(yampi::range_to_buffer(values), root, circuit_communicator, environment);
+      return;
+    }
+
+    auto const num_ranks = static_cast<std::size_t>(circuit_communicator.size(environment));
+    auto gathered_values = std::vector<double>(values.size() * num_ranks);
+    yampi::gather(yampi::range_to_buffer(values), gathered_values.data(), root, circuit_communicator, environment);
+
+    profile.rank_values.clear();
+    profile.rank_values.reserve(num_ranks);
+    for (auto rank = std::size_t{0u}; rank < num_ranks; ++rank)
+      profile.rank_values.emplace_back(gathered_values.begin() + rank * values.size(), gathered_values.begin() + (rank + 1u) * values.size());
+
+    ::bra::profiler_detail::write(filename, std::vector< ::bra::profiler_detail::circuit_profile >{profile});
+  }
+#else // BRA_NO_MPI
+  auto profiler::write(std::string const& filename) const -> void
+  {
+    auto profiles = std::vector< ::bra::profiler_detail::circuit_profile >{};
+    profiles.reserve(records_.size());
+    for (auto circuit_index = 0; circuit_index < static_cast<int>(records_.size()); ++circuit_index)
+      profiles.push_back(::bra::profiler_detail::make_circuit_profile(circuit_index, records_[circuit_index], fusion_records_[circuit_index]));
+
+    ::bra::profiler_detail::write(filename, profiles);
+  }
+#endif // BRA_NO_MPI
+} // namespace bra
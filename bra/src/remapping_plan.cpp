@@ -0,0 +1,189 @@
+#ifndef BRA_NO_MPI
+# include <cassert>
+# include <cstddef>
+# include <vector>
+# include <algorithm>
+# include <iterator>
+# include <limits>
+# include <utility>
+
+# include <ket/qubit.hpp>
+
+# include <bra/types.hpp>
+# include <bra/state.hpp>
+# include <bra/remapping_plan.hpp>
+
+
+namespace bra
+{
+  namespace remapping_plan_detail
+  {
+    constexpr auto never_used = std::numeric_limits<std::size_t>::max();
+
+    // Indices of the next gates operating qubits. Gate indices of queries must not decrease
+    class next_use_table
+    {
+      std::vector<std::vector<std::size_t>> gate_indices_;
+      std::vector<std::size_t> cursors_;
+
+     public:
+      next_use_table(
+        ::bra::remapping_plan::operated_qubits_type const& operated_qubits,
+        ::bra::bit_integer_type const num_qubits)
+        : gate_indices_(num_qubits), cursors_(num_qubits, std::size_t{0u})
+      {
+        for (auto gate_index = std::size_t{0u}; gate_index < operated_qubits.size(); ++gate_index)
+          for (auto const qubit: operated_qubits[gate_index])
+            if (gate_indices_[qubit].empty() or gate_indices_[qubit].back() != gate_index)
+              gate_indices_[qubit].push_back(gate_index);
+      }
+
+      auto operator()(::bra::bit_integer_type const qubit, std::size_t const gate_index) -> std::size_t
+      {
+        auto const& gate_indices = gate_indices_[qubit];
+        auto& cursor = cursors_[qubit];
+        while (cursor < gate_indices.size() and gate_indices[cursor] <= gate_index)
+          ++cursor;
+
+        return cursor < gate_indices.size() ? gate_indices[cursor] : never_used;
+      }
+    }; // class next_use_table
+  } // namespace remapping_plan_detail
+
+  remapping_plan::remapping_plan(
+    remapping_plan::operated_qubits_type const& operated_qubits,
+    ::bra::bit_integer_type const num_qubits, ::bra::bit_integer_type const num_local_qubits,
+    std::vector< ::bra::permutated_qubit_type > const& initial_permutation)
+    : operated_qubits_{operated_qubits}, num_qubits_{num_qubits}, num_local_qubits_{num_local_qubits},
+      remapped_qubits_(operated_qubits.size()),
+      num_greedy_interchanges_{0u}, num_planned_interchanges_{0u}, num_actual_interchanges_{0u},
+      num_greedy_local_swaps_{0u}, num_planned_local_swaps_{0u},
+      actual_layout_{initial_permutation, num_local_qubits}, is_global_qubit_(num_qubits)
+  {
+    assert(initial_permutation.size() == num_qubits);
+
+    auto greedy_layout = ::bra::remapping_plan_detail::layout{initial_permutation, num_local_qubits};
+    auto planned_layout = ::bra::remapping_plan_detail::layout{initial_permutation, num_local_qubits};
+    auto next_use = ::bra::remapping_plan_detail::next_use_table{operated_qubits, num_qubits};
+
+    for (auto qubit = ::bra::bit_integer_type{0u}; qubit < num_qubits; ++qubit)
+      is_global_qubit_[qubit] = greedy_layout.is_global(qubit);
+
+    using std::begin;
+    using std::end;
+    auto local_candidates = std::vector<std::pair<std::size_t, ::bra::bit_integer_type>>{}; // (next use, qubit)
+    auto global_candidates = std::vector<std::pair<std::size_t, ::bra::bit_integer_type>>{}; // (next use, qubit)
+    for (auto gate_index = std::size_t{0u}; gate_index < operated_qubits.size(); ++gate_index)
+    {
+      auto const& qubits = operated_qubits[gate_index];
+      if (greedy_layout.interchange(qubits))
+        ++num_greedy_interchanges_;
+
+      auto const num_global_operated_qubits
+        = static_cast<std::size_t>(std::count_if(
+            begin(qubits), end(qubits),
+            [&planned_layout](::bra::bit_integer_type const qubit) { return planned_layout.is_global(qubit); }));
+      if (num_global_operated_qubits == 0u)
+        continue;
+
+      auto const is_operated
+        = [&qubits](::bra::bit_integer_type const qubit)
+          { using std::begin; using std::end; return std::find(begin(qubits), end(qubits), qubit) != end(qubits); };
+
+      // Local qubits to be global are sorted in order of their next uses from the furthest one
+      local_candidates.clear();
+      global_candidates.clear();
+      for (auto position = ::bra::bit_integer_type{0u}; position < num_qubits; ++position)
+      {
+        auto const qubit = planned_layout.qubit(position);
+        if (is_operated(qubit))
+          continue;
+
+        if (position < num_local_qubits)
+          local_candidates.emplace_back(next_use(qubit, gate_index), qubit);
+        else if (next_use(qubit, gate_index) != ::bra::remapping_plan_detail::never_used)
+          global_candidates.emplace_back(next_use(qubit, gate_index), qubit);
+      }
+      std::stable_sort(
+        begin(local_candidates), end(local_candidates),
+        [](std::pair<std::size_t, ::bra::bit_integer_type> const& lhs, std::pair<std::size_t, ::bra::bit_integer_type> const& rhs)
+        { return lhs.first > rhs.first; });
+      std::stable_sort(
+        begin(global_candidates), end(global_candidates),
+        [](std::pair<std::size_t, ::bra::bit_integer_type> const& lhs, std::pair<std::size_t, ::bra::bit_integer_type> const& rhs)
+        { return lhs.first < rhs.first; });
+
+      auto remapped_qubits = qubits;
+      if (local_candidates.size() >= num_global_operated_qubits)
+      {
+        // A global qubit is prefetched if it is used before the local qubit which would be global instead of it
+        auto num_interchanged_qubits = num_global_operated_qubits;
+        for (auto const& global_candidate: global_candidates)
+        {
+          if (num_interchanged_qubits >= BRA_MAX_NUM_INTERCHANGED_QUBITS
+              or num_interchanged_qubits >= local_candidates.size()
+              or global_candidate.first >= local_candidates[num_interchanged_qubits].first)
+            break;
+
+          remapped_qubits.push_back(global_candidate.second);
+          ++num_interchanged_qubits;
+        }
+
+        // Local qubits except for chosen ones are unswappable in ket::mpi::utility::runtime::maybe_interchange_qubits
+        std::transform(
+          std::next(begin(local_candidates), num_interchanged_qubits), end(local_candidates),
+          std::back_inserter(remapped_qubits),
+          [](std::pair<std::size_t, ::bra::bit_integer_type> const& local_candidate) { return local_candidate.second; });
+      }
+
+      planned_layout.interchange(remapped_qubits);
+      ++num_planned_interchanges_;
+
+      remapped_qubits_[gate_index].reserve(remapped_qubits.size());
+      std::transform(
+        begin(remapped_qubits), end(remapped_qubits), std::back_inserter(remapped_qubits_[gate_index]),
+        [](::bra::bit_integer_type const qubit) { return ket::make_qubit< ::bra::state_integer_type >(qubit); });
+    }
+
+    num_greedy_local_swaps_ = greedy_layout.num_local_swaps();
+    num_planned_local_swaps_ = planned_layout.num_local_swaps();
+  }
+
+  auto remapping_plan::observe_remapping(int const gate_index, ::bra::state::permutation_type const& permutation) -> void
+  {
+    auto unswappable_qubits = std::vector< ::bra::bit_integer_type >{};
+    unswappable_qubits.reserve(remapped_qubits_[gate_index].size());
+    using std::begin;
+    using std::end;
+    std::transform(
+      begin(remapped_qubits_[gate_index]), end(remapped_qubits_[gate_index]), std::back_inserter(unswappable_qubits),
+      [](::bra::qubit_type const qubit) { return static_cast< ::bra::bit_integer_type >(qubit); });
+    do_observe(unswappable_qubits, permutation);
+  }
+
+  auto remapping_plan::observe(int const gate_index, ::bra::state::permutation_type const& permutation) -> void
+  { do_observe(operated_qubits_[gate_index], permutation); }
+
+  // ket chooses local qubits to be global in the same way as the layout, so local swaps are counted by following the choice
+  auto remapping_plan::do_observe(
+    std::vector< ::bra::bit_integer_type > const& unswappable_qubits, ::bra::state::permutation_type const& permutation)
+  -> void
+  {
+    actual_layout_.interchange(unswappable_qubits);
+    actual_layout_.assign(permutation);
+
+    auto is_changed = false;
+    for (auto qubit = ::bra::bit_integer_type{0u}; qubit < num_qubits_; ++qubit)
+    {
+      auto const is_global = actual_layout_.is_global(qubit);
+      is_changed = is_changed or is_global != is_global_qubit_[qubit];
+      is_global_qubit_[qubit] = is_global;
+    }
+
+    if (is_changed)
+      ++num_actual_interchanges_;
+  }
+} // namespace bra
+
+
+#endif // BRA_NO_MPI
@@ -0,0 +1,34 @@
+#include <string>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+
+#include <bra/gate/gate.hpp>
+#include <bra/gate/save_state.hpp>
+#include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    std::string const save_state::name_ = "SAVE STATE";
+
+    save_state::save_state(std::string const& filename, int const next_instruction_index)
+      : ::bra::gate::gate{}, filename_{filename}, next_instruction_index_{next_instruction_index}
+    { }
+
+    ::bra::state& save_state::do_apply(::bra::state& state) const
+    { return state.save_state(filename_, next_instruction_index_); }
+
+    std::string const& save_state::do_name() const { return name_; }
+    std::string save_state::do_representation(
+      std::ostringstream& repr_stream, int const parameter_width) const
+    {
+      repr_stream
+        << std::right
+        << std::setw(parameter_width) << filename_;
+      return repr_stream.str();
+    }
+  } // namespace gate
+} // namespace bra
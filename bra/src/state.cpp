@@ -1,14 +1,20 @@
+#include <cassert>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <algorithm>
 #include <iterator>
 #include <utility>
+#include <memory>
 #ifdef BRA_NO_MPI
 # include <chrono>
-# include <memory>
 #endif
 #include <stdexcept>
 
@@ -19,19 +25,28 @@
 #include <boost/variant/apply_visitor.hpp>
 
 #ifndef BRA_NO_MPI
+# include <mpi.h>
+
 # include <yampi/rank.hpp>
 # include <yampi/communicator.hpp>
 # include <yampi/intercommunicator.hpp>
 # include <yampi/environment.hpp>
 # include <yampi/wall_clock.hpp>
+# include <yampi/barrier.hpp>
 #endif // BRA_NO_MPI
 
 #include <ket/qubit.hpp>
 #include <ket/control.hpp>
 #include <ket/utility/imaginary_unit.hpp>
+#include <ket/utility/exp_i.hpp>
+#include <ket/utility/integer_exp2.hpp>
+#include <ket/gate/diagonal.hpp>
 
 #include <bra/types.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/closest_floating_point_of.hpp>
+#include <bra/utility/philox.hpp>
+#include <bra/utility/binary_io.hpp>
 
 #ifndef BRA_NO_MPI
 # define BRA_clock yampi::wall_clock
@@ -96,6 +111,28 @@ namespace bra
     : std::runtime_error{std::string{"the number of operated qubits ("}.append(std::to_string(num_operated_qubits)).append(") is not equal to the length of Pauli string (").append(std::to_string(pauli_string_length)).append(")").c_str()}
   { }
 
+  wrong_state_file_error::wrong_state_file_error(std::string const& filename, std::string const& reason)
+    : std::runtime_error{(std::string{"wrong state file \""} + filename + "\": " + reason).c_str()}
+  { }
+
+  namespace diagonal_accumulation_detail
+  {
+    inline auto to_mask(::bra::qubit_type const qubit) -> ::bra::state_integer_type
+    { return ::ket::utility::integer_exp2< ::bra::state_integer_type >(qubit); }
+
+    inline auto to_mask(::bra::control_qubit_type const control_qubit) -> ::bra::state_integer_type
+    { return ::bra::diagonal_accumulation_detail::to_mask(control_qubit.qubit()); }
+
+    template <typename Qubit>
+    inline auto to_mask(std::vector<Qubit> const& qubits) -> ::bra::state_integer_type
+    {
+      auto result = ::bra::state_integer_type{0u};
+      for (auto const qubit: qubits)
+        result |= ::bra::diagonal_accumulation_detail::to_mask(qubit);
+      return result;
+    }
+  } // namespace diagonal_accumulation_detail
+
 #ifndef BRA_NO_MPI
   state::state(
     bit_integer_type const total_num_qubits,
@@ -120,6 +157,8 @@ namespace bra
       result_{},
       is_in_fusion_{false},
       found_qubits_{},
+      is_accumulating_diagonal_gates_{false},
+      diagonal_accumulator_{},
       circuit_index_{circuit_index},
       wait_reason_{::bra::wait_reason::no_wait_t{}},
       random_number_generator_{seed},
@@ -128,7 +167,12 @@ namespace bra
       depolarizing_py_{is_depolarizing_channel ? depolarizing_py : ::bra::real_type{}},
       depolarizing_pz_{is_depolarizing_channel ? depolarizing_pz : ::bra::real_type{}},
       uses_depolarizing_seed_{uses_depolarizing_seed},
-      depolarizing_random_number_generator_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed_type{}},
+      noise_key_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed},
+      noise_gate_index_{0u},
+      is_tracking_pauli_frame_{false},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
+      pauli_frame_phase_{real_type{1}},
       permutation_{static_cast<permutation_type::size_type>(total_num_qubits)},
       buffer_{},
       circuit_communicator_{circuit_communicator},
@@ -172,6 +216,8 @@ namespace bra
       result_{},
       is_in_fusion_{false},
       found_qubits_{},
+      is_accumulating_diagonal_gates_{false},
+      diagonal_accumulator_{},
       circuit_index_{circuit_index},
       wait_reason_{::bra::wait_reason::no_wait_t{}},
       random_number_generator_{seed},
@@ -180,7 +226,12 @@ namespace bra
       depolarizing_py_{is_depolarizing_channel ? depolarizing_py : ::bra::real_type{}},
       depolarizing_pz_{is_depolarizing_channel ? depolarizing_pz : ::bra::real_type{}},
       uses_depolarizing_seed_{uses_depolarizing_seed},
-      depolarizing_random_number_generator_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed_type{}},
+      noise_key_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed},
+      noise_gate_index_{0u},
+      is_tracking_pauli_frame_{false},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
+      pauli_frame_phase_{real_type{1}},
       permutation_{static_cast<permutation_type::size_type>(total_num_qubits)},
       buffer_(num_elements_in_buffer),
       circuit_communicator_{circuit_communicator},
@@ -223,6 +274,8 @@ namespace bra
       result_{},
       is_in_fusion_{false},
       found_qubits_{},
+      is_accumulating_diagonal_gates_{false},
+      diagonal_accumulator_{},
       circuit_index_{circuit_index},
       wait_reason_{::bra::wait_reason::no_wait_t{}},
       random_number_generator_{seed},
@@ -231,7 +284,12 @@ namespace bra
       depolarizing_py_{is_depolarizing_channel ? depolarizing_py : ::bra::real_type{}},
       depolarizing_pz_{is_depolarizing_channel ? depolarizing_pz : ::bra::real_type{}},
       uses_depolarizing_seed_{uses_depolarizing_seed},
-      depolarizing_random_number_generator_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed_type{}},
+      noise_key_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed},
+      noise_gate_index_{0u},
+      is_tracking_pauli_frame_{false},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
+      pauli_frame_phase_{real_type{1}},
       permutation_{
         std::begin(initial_permutation), std::end(initial_permutation)},
       buffer_{},
@@ -276,6 +334,8 @@ namespace bra
       result_{},
       is_in_fusion_{false},
       found_qubits_{},
+      is_accumulating_diagonal_gates_{false},
+      diagonal_accumulator_{},
       circuit_index_{circuit_index},
       wait_reason_{::bra::wait_reason::no_wait_t{}},
       random_number_generator_{seed},
@@ -284,7 +344,12 @@ namespace bra
       depolarizing_py_{is_depolarizing_channel ? depolarizing_py : ::bra::real_type{}},
       depolarizing_pz_{is_depolarizing_channel ? depolarizing_pz : ::bra::real_type{}},
       uses_depolarizing_seed_{uses_depolarizing_seed},
-      depolarizing_random_number_generator_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed_type{}},
+      noise_key_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed},
+      noise_gate_index_{0u},
+      is_tracking_pauli_frame_{false},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
+      pauli_frame_phase_{real_type{1}},
       permutation_{
         std::begin(initial_permutation), std::end(initial_permutation)},
       buffer_(num_elements_in_buffer),
@@ -323,6 +388,8 @@ namespace bra
       result_{},
       is_in_fusion_{false},
       found_qubits_{},
+      is_accumulating_diagonal_gates_{false},
+      diagonal_accumulator_{},
       circuit_index_{circuit_index},
       wait_reason_{::bra::wait_reason::no_wait_t{}},
       random_number_generator_{seed},
@@ -331,7 +398,13 @@ namespace bra
       depolarizing_py_{is_depolarizing_channel ? depolarizing_py : ::bra::real_type{}},
       depolarizing_pz_{is_depolarizing_channel ? depolarizing_pz : ::bra::real_type{}},
       uses_depolarizing_seed_{uses_depolarizing_seed},
-      depolarizing_random_number_generator_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed_type{}},
+      noise_key_{is_depolarizing_channel_ and uses_depolarizing_seed ? depolarizing_seed : seed},
+      noise_gate_index_{0u},
+      is_tracking_pauli_frame_{false},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
+      pauli_frame_phase_{real_type{1}},
+      physical_qubits_(total_num_qubits),
       start_time_{BRA_clock::now()},
       last_processed_time_{start_time_},
       phase_coefficients_{},
@@ -341,6 +414,9 @@ namespace bra
       int_variables_{},
       pauli_string_space_variables_{}
   {
+    std::iota(
+      std::begin(physical_qubits_), std::end(physical_qubits_),
+      qubit_type{0u});
     found_qubits_.reserve(total_num_qubits_);
     ket::utility::generate_phase_coefficients(phase_coefficients_, total_num_qubits_);
   }
@@ -1000,9 +1076,9 @@ namespace bra
   state& state::i_gate(qubit_type const qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_i_gate(qubit);
+    do_i_gate(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1011,9 +1087,9 @@ namespace bra
   state& state::ic_gate(control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    do_ic_gate(control_qubit);
+    do_ic_gate(physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1023,11 +1099,11 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_ii_gate(qubit1, qubit2);
+    do_ii_gate(physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1036,9 +1112,9 @@ namespace bra
   state& state::in_gate(std::vector<qubit_type> const& qubits)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_in_gate(qubits);
+    do_in_gate(physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1047,9 +1123,10 @@ namespace bra
   state& state::hadamard(qubit_type const qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_hadamard(qubit);
+    conjugate_pauli_frame_by_hadamard(qubit);
+    do_hadamard(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1058,9 +1135,12 @@ namespace bra
   state& state::not_(qubit_type const qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_not_(qubit);
+    if (is_absorbing_paulis())
+      absorb_pauli_x(qubit);
+    else
+      do_not_(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1069,9 +1149,12 @@ namespace bra
   state& state::pauli_x(qubit_type const qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_pauli_x(qubit);
+    if (is_absorbing_paulis())
+      absorb_pauli_x(qubit);
+    else
+      do_pauli_x(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1081,11 +1164,17 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_pauli_xx(qubit1, qubit2);
+    if (is_absorbing_paulis())
+    {
+      absorb_pauli_x(qubit1);
+      absorb_pauli_x(qubit2);
+    }
+    else
+      do_pauli_xx(physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1094,9 +1183,13 @@ namespace bra
   state& state::pauli_xn(std::vector<qubit_type> const& qubits)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_pauli_xn(qubits);
+    if (is_absorbing_paulis())
+      for (auto const qubit: qubits)
+        absorb_pauli_x(qubit);
+    else
+      do_pauli_xn(physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1105,9 +1198,12 @@ namespace bra
   state& state::pauli_y(qubit_type const qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_pauli_y(qubit);
+    if (is_absorbing_paulis())
+      absorb_pauli_y(qubit);
+    else
+      do_pauli_y(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1117,11 +1213,17 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_pauli_yy(qubit1, qubit2);
+    if (is_absorbing_paulis())
+    {
+      absorb_pauli_y(qubit1);
+      absorb_pauli_y(qubit2);
+    }
+    else
+      do_pauli_yy(physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1130,9 +1232,13 @@ namespace bra
   state& state::pauli_yn(std::vector<qubit_type> const& qubits)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_pauli_yn(qubits);
+    if (is_absorbing_paulis())
+      for (auto const qubit: qubits)
+        absorb_pauli_y(qubit);
+    else
+      do_pauli_yn(physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1141,9 +1247,14 @@ namespace bra
   state& state::pauli_z(control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    do_pauli_z(control_qubit);
+    if (is_absorbing_paulis())
+      absorb_pauli_z(control_qubit.qubit());
+    else if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(complex_type{real_type{-1}}, ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit)));
+    else
+      do_pauli_z(physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1153,11 +1264,19 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_pauli_zz(qubit1, qubit2);
+    if (is_absorbing_paulis())
+    {
+      absorb_pauli_z(qubit1);
+      absorb_pauli_z(qubit2);
+    }
+    else if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(complex_type{real_type{1}}, complex_type{real_type{-1}}, ::bra::diagonal_accumulation_detail::to_mask(physical(qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(qubit2)));
+    else
+      do_pauli_zz(physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1166,34 +1285,75 @@ namespace bra
   state& state::pauli_zn(std::vector<qubit_type> const& qubits)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_pauli_zn(qubits);
+    if (is_absorbing_paulis())
+      for (auto const qubit: qubits)
+        absorb_pauli_z(qubit);
+    else if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(complex_type{real_type{1}}, complex_type{real_type{-1}}, ::bra::diagonal_accumulation_detail::to_mask(physical(qubits)));
+    else
+      do_pauli_zn(physical(qubits));
     apply_noises(qubits);
 
     return *this;
   }
 
+  // Outside gate fusion, SWAP exchanges the positions of the qubits in the state vector instead of moving amplitudes
   state& state::swap(qubit_type const qubit1, qubit_type const qubit2)
   {
+    conjugate_pauli_frame_by_swap(qubit1, qubit2);
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
+      do_swap(physical(qubit1), physical(qubit2));
+    }
+    else if (qubit1 != qubit2)
+    {
+#ifndef BRA_NO_MPI
+      permutation_.permutate(qubit1, qubit2);
+#else // BRA_NO_MPI
+      using std::swap;
+      swap(physical_qubits_[static_cast<bit_integer_type>(qubit1)], physical_qubits_[static_cast<bit_integer_type>(qubit2)]);
+#endif // BRA_NO_MPI
     }
-
-    do_swap(qubit1, qubit2);
     apply_noises(qubit1, qubit2);
 
     return *this;
   }
 
+#ifdef BRA_NO_MPI
+  // Each qubit is moved to its own position by at most total_num_qubits_ - 1 swaps of amplitudes
+  auto state::resolve_physical_qubits() -> void
+  {
+    using std::begin;
+    using std::end;
+    for (auto bit = bit_integer_type{0u}; bit < total_num_qubits_; ++bit)
+    {
+      auto const qubit = ket::make_qubit<state_integer_type>(bit);
+      auto const physical_qubit = physical_qubits_[bit];
+      if (physical_qubit == qubit)
+        continue;
+
+      // the qubit at the position "qubit" is not resolved yet, and it is moved to the position "physical_qubit"
+      auto const found = std::find(begin(physical_qubits_) + (bit + 1u), end(physical_qubits_), qubit);
+      assert(found != end(physical_qubits_));
+      do_swap(qubit, physical_qubit);
+      *found = physical_qubit;
+      physical_qubits_[bit] = qubit;
+    }
+  }
+#endif // BRA_NO_MPI
+
   state& state::sqrt_pauli_x(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_sqrt_pauli_x(qubit);
+    do_sqrt_pauli_x(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1201,10 +1361,12 @@ namespace bra
 
   state& state::adj_sqrt_pauli_x(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_adj_sqrt_pauli_x(qubit);
+    do_adj_sqrt_pauli_x(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1212,10 +1374,12 @@ namespace bra
 
   state& state::sqrt_pauli_y(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_sqrt_pauli_y(qubit);
+    do_sqrt_pauli_y(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1223,10 +1387,12 @@ namespace bra
 
   state& state::adj_sqrt_pauli_y(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_adj_sqrt_pauli_y(qubit);
+    do_adj_sqrt_pauli_y(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1235,9 +1401,13 @@ namespace bra
   state& state::sqrt_pauli_z(control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    do_sqrt_pauli_z(control_qubit);
+    conjugate_pauli_frame_by_sqrt_pauli_z(control_qubit.qubit(), ::ket::utility::imaginary_unit<complex_type>());
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::imaginary_unit<complex_type>(), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit)));
+    else
+      do_sqrt_pauli_z(physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1246,9 +1416,13 @@ namespace bra
   state& state::adj_sqrt_pauli_z(control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    do_adj_sqrt_pauli_z(control_qubit);
+    conjugate_pauli_frame_by_sqrt_pauli_z(control_qubit.qubit(), ::ket::utility::minus_imaginary_unit<complex_type>());
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::minus_imaginary_unit<complex_type>(), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit)));
+    else
+      do_adj_sqrt_pauli_z(physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1256,13 +1430,15 @@ namespace bra
 
   state& state::sqrt_pauli_zz(qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_sqrt_pauli_zz(qubit1, qubit2);
+    do_sqrt_pauli_zz(physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1270,13 +1446,15 @@ namespace bra
 
   state& state::adj_sqrt_pauli_zz(qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_adj_sqrt_pauli_zz(qubit1, qubit2);
+    do_adj_sqrt_pauli_zz(physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1284,10 +1462,12 @@ namespace bra
 
   state& state::sqrt_pauli_zn(std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_sqrt_pauli_zn(qubits);
+    do_sqrt_pauli_zn(physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1295,10 +1475,12 @@ namespace bra
 
   state& state::adj_sqrt_pauli_zn(std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_adj_sqrt_pauli_zn(qubits);
+    do_adj_sqrt_pauli_zn(physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1307,11 +1489,23 @@ namespace bra
   state& state::u1(
     boost::variant<real_type, std::string> const& phase,
     control_qubit_type const control_qubit)
+  { return u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit); }
+
+  state& state::u1(real_type const phase, control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    do_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit);
+    // X U1(phase) X = exp(i phase) U1(-phase)
+    auto const is_flipped = is_flipped_by_pauli_frame(control_qubit.qubit());
+    if (is_flipped)
+      pauli_frame_phase_ *= ::ket::utility::exp_i<complex_type>(phase);
+    auto const operated_phase = is_flipped ? -phase : phase;
+
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::exp_i<complex_type>(operated_phase), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit)));
+    else
+      do_u1(operated_phase, physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1320,11 +1514,23 @@ namespace bra
   state& state::adj_u1(
     boost::variant<real_type, std::string> const& phase,
     control_qubit_type const control_qubit)
+  { return adj_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit); }
+
+  state& state::adj_u1(real_type const phase, control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    do_adj_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit);
+    // X U1(phase) X = exp(i phase) U1(-phase)
+    auto const is_flipped = is_flipped_by_pauli_frame(control_qubit.qubit());
+    if (is_flipped)
+      pauli_frame_phase_ *= ::ket::utility::exp_i<complex_type>(-phase);
+    auto const operated_phase = is_flipped ? -phase : phase;
+
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::exp_i<complex_type>(-operated_phase), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit)));
+    else
+      do_adj_u1(operated_phase, physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1335,13 +1541,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase2,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
     do_u2(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
-      qubit);
+      physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1352,13 +1560,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase2,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
     do_adj_u2(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
-      qubit);
+      physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1370,14 +1580,16 @@ namespace bra
     boost::variant<real_type, std::string> const& phase3,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
     do_u3(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
       boost::apply_visitor(real_visitor{*this}, phase3),
-      qubit);
+      physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1389,14 +1601,16 @@ namespace bra
     boost::variant<real_type, std::string> const& phase3,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
     do_adj_u3(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
       boost::apply_visitor(real_visitor{*this}, phase3),
-      qubit);
+      physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1407,14 +1621,24 @@ namespace bra
     control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    auto const phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
+    auto phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
+    // X T(k) X = (coefficient of T(k)) T(-k)
+    if (is_flipped_by_pauli_frame(control_qubit.qubit()))
+    {
+      pauli_frame_phase_ *= phase_exponent_value >= 0 ? phase_coefficients_[phase_exponent_value] : std::conj(phase_coefficients_[-phase_exponent_value]);
+      phase_exponent_value = -phase_exponent_value;
+    }
 
-    if (phase_exponent_value >= 0)
-      do_phase_shift(phase_coefficients_[phase_exponent_value], control_qubit);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(
+        phase_exponent_value >= 0 ? phase_coefficients_[phase_exponent_value] : std::conj(phase_coefficients_[-phase_exponent_value]),
+        ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit)));
+    else if (phase_exponent_value >= 0)
+      do_phase_shift(phase_coefficients_[phase_exponent_value], physical(control_qubit));
     else
-      do_adj_phase_shift(phase_coefficients_[-phase_exponent_value], control_qubit);
+      do_adj_phase_shift(phase_coefficients_[-phase_exponent_value], physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1425,14 +1649,24 @@ namespace bra
     control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
 
-    auto const phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
+    auto phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
+    // X T(k) X = (coefficient of T(k)) T(-k)
+    if (is_flipped_by_pauli_frame(control_qubit.qubit()))
+    {
+      pauli_frame_phase_ *= phase_exponent_value >= 0 ? std::conj(phase_coefficients_[phase_exponent_value]) : phase_coefficients_[-phase_exponent_value];
+      phase_exponent_value = -phase_exponent_value;
+    }
 
-    if (phase_exponent_value >= 0)
-      do_adj_phase_shift(phase_coefficients_[phase_exponent_value], control_qubit);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(
+        phase_exponent_value >= 0 ? std::conj(phase_coefficients_[phase_exponent_value]) : phase_coefficients_[-phase_exponent_value],
+        ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit)));
+    else if (phase_exponent_value >= 0)
+      do_adj_phase_shift(phase_coefficients_[phase_exponent_value], physical(control_qubit));
     else
-      do_phase_shift(phase_coefficients_[-phase_exponent_value], control_qubit);
+      do_phase_shift(phase_coefficients_[-phase_exponent_value], physical(control_qubit));
     apply_noise(control_qubit);
 
     return *this;
@@ -1440,10 +1674,12 @@ namespace bra
 
   state& state::x_rotation_half_pi(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_x_rotation_half_pi(qubit);
+    do_x_rotation_half_pi(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1451,10 +1687,12 @@ namespace bra
 
   state& state::adj_x_rotation_half_pi(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_adj_x_rotation_half_pi(qubit);
+    do_adj_x_rotation_half_pi(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1462,10 +1700,12 @@ namespace bra
 
   state& state::y_rotation_half_pi(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_y_rotation_half_pi(qubit);
+    do_y_rotation_half_pi(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1473,10 +1713,12 @@ namespace bra
 
   state& state::adj_y_rotation_half_pi(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_adj_y_rotation_half_pi(qubit);
+    do_adj_y_rotation_half_pi(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1486,10 +1728,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), qubit);
+    do_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1499,10 +1743,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_adj_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), qubit);
+    do_adj_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1512,13 +1758,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_exponential_pauli_xx(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    do_exponential_pauli_xx(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1528,13 +1776,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_adj_exponential_pauli_xx(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    do_adj_exponential_pauli_xx(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1544,10 +1794,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), qubits);
+    do_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1557,10 +1809,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_adj_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), qubits);
+    do_adj_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1570,10 +1824,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), qubit);
+    do_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1583,10 +1839,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-    do_adj_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), qubit);
+    do_adj_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1596,13 +1854,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_exponential_pauli_yy(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    do_exponential_pauli_yy(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1612,13 +1872,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_adj_exponential_pauli_yy(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    do_adj_exponential_pauli_yy(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1628,10 +1890,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), qubits);
+    do_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1641,10 +1905,12 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_adj_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), qubits);
+    do_adj_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1653,12 +1919,22 @@ namespace bra
   state& state::exponential_pauli_z(
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit)
+  { return exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), qubit); }
+
+  state& state::exponential_pauli_z(real_type const phase, qubit_type const qubit)
   {
     if (is_in_fusion_)
-      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(qubit)], ::bra::found_qubit::ez_qubit))
-        found_qubits_[static_cast< ::bra::bit_integer_type >(qubit)] = ::bra::found_qubit::ez_qubit;
+      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(physical(qubit))], ::bra::found_qubit::ez_qubit))
+        found_qubits_[static_cast< ::bra::bit_integer_type >(physical(qubit))] = ::bra::found_qubit::ez_qubit;
+
+    // X exp(i phase Z) X = exp(-i phase Z)
+    auto const operated_phase = is_flipped_by_pauli_frame(qubit) ? -phase : phase;
 
-    do_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), qubit);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(
+        ::ket::utility::exp_i<complex_type>(operated_phase), ::ket::utility::exp_i<complex_type>(-operated_phase), ::bra::diagonal_accumulation_detail::to_mask(physical(qubit)));
+    else
+      do_exponential_pauli_z(operated_phase, physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1667,12 +1943,22 @@ namespace bra
   state& state::adj_exponential_pauli_z(
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit)
+  { return adj_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), qubit); }
+
+  state& state::adj_exponential_pauli_z(real_type const phase, qubit_type const qubit)
   {
     if (is_in_fusion_)
-      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(qubit)], ::bra::found_qubit::ez_qubit))
-        found_qubits_[static_cast< ::bra::bit_integer_type >(qubit)] = ::bra::found_qubit::ez_qubit;
+      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(physical(qubit))], ::bra::found_qubit::ez_qubit))
+        found_qubits_[static_cast< ::bra::bit_integer_type >(physical(qubit))] = ::bra::found_qubit::ez_qubit;
+
+    // X exp(i phase Z) X = exp(-i phase Z)
+    auto const operated_phase = is_flipped_by_pauli_frame(qubit) ? -phase : phase;
 
-    do_adj_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), qubit);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(
+        ::ket::utility::exp_i<complex_type>(-operated_phase), ::ket::utility::exp_i<complex_type>(operated_phase), ::bra::diagonal_accumulation_detail::to_mask(physical(qubit)));
+    else
+      do_adj_exponential_pauli_z(operated_phase, physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -1682,13 +1968,20 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_exponential_pauli_zz(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    auto const phase_value = boost::apply_visitor(real_visitor{*this}, phase);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(
+        ::ket::utility::exp_i<complex_type>(phase_value), ::ket::utility::exp_i<complex_type>(-phase_value), ::bra::diagonal_accumulation_detail::to_mask(physical(qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(qubit2)));
+    else
+      do_exponential_pauli_zz(phase_value, physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1698,13 +1991,20 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_adj_exponential_pauli_zz(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    auto const phase_value = boost::apply_visitor(real_visitor{*this}, phase);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(
+        ::ket::utility::exp_i<complex_type>(-phase_value), ::ket::utility::exp_i<complex_type>(phase_value), ::bra::diagonal_accumulation_detail::to_mask(physical(qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(qubit2)));
+    else
+      do_adj_exponential_pauli_zz(phase_value, physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1714,10 +2014,17 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_exponential_pauli_zn(boost::apply_visitor(real_visitor{*this}, phase), qubits);
+    auto const phase_value = boost::apply_visitor(real_visitor{*this}, phase);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(
+        ::ket::utility::exp_i<complex_type>(phase_value), ::ket::utility::exp_i<complex_type>(-phase_value), ::bra::diagonal_accumulation_detail::to_mask(physical(qubits)));
+    else
+      do_exponential_pauli_zn(phase_value, physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1727,10 +2034,17 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& qubits)
   {
+    materialize_pauli_frame_on(qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(qubits));
 
-    do_adj_exponential_pauli_zn(boost::apply_visitor(real_visitor{*this}, phase), qubits);
+    auto const phase_value = boost::apply_visitor(real_visitor{*this}, phase);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_parity_phase(
+        ::ket::utility::exp_i<complex_type>(-phase_value), ::ket::utility::exp_i<complex_type>(phase_value), ::bra::diagonal_accumulation_detail::to_mask(physical(qubits)));
+    else
+      do_adj_exponential_pauli_zn(phase_value, physical(qubits));
     apply_noises(qubits);
 
     return *this;
@@ -1740,13 +2054,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    do_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1756,13 +2072,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const qubit1, qubit_type const qubit2)
   {
+    materialize_pauli_frame_on(qubit1, qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, qubit1);
-      ::bra::set_found_qubits(found_qubits_, qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(qubit2));
     }
 
-    do_adj_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), qubit1, qubit2);
+    do_adj_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), physical(qubit1), physical(qubit2));
     apply_noises(qubit1, qubit2);
 
     return *this;
@@ -1772,14 +2090,16 @@ namespace bra
     qubit_type const target_qubit,
     control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit1, control_qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
-    do_toffoli(target_qubit, control_qubit1, control_qubit2);
+    do_toffoli(physical(target_qubit), physical(control_qubit1), physical(control_qubit2));
     apply_noises(target_qubit, control_qubit1, control_qubit2);
 
     return *this;
@@ -1788,11 +2108,13 @@ namespace bra
 #ifndef BRA_NO_MPI
   state& state::projective_measurement(qubit_type const qubit, yampi::rank const root)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"M"};
 
     last_outcomes_[static_cast<bit_integer_type>(qubit)]
-      = do_projective_measurement(qubit, root);
+      = do_projective_measurement(physical(qubit), root);
     last_measured_qubit_ = qubit;
     return *this;
   }
@@ -1814,6 +2136,7 @@ namespace bra
     }
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
     do_expectation_values(root);
 
     if (circuit_communicator_.rank(environment_) == root)
@@ -1879,6 +2202,7 @@ namespace bra
     }
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
     do_amplitudes(root, amplitude_indices);
 
     auto const amplitudes_finish_time = BRA_clock::now(environment_);
@@ -1909,6 +2233,7 @@ namespace bra
     }
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
     do_generate_events(root, num_events, seed);
 
     if (circuit_communicator_.rank(environment_) == root)
@@ -1948,6 +2273,7 @@ namespace bra
     }
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
     do_measure(root);
 
     if (circuit_communicator_.rank(environment_) == root)
@@ -1972,11 +2298,13 @@ namespace bra
 #else // BRA_NO_MPI
   state& state::projective_measurement(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"M"};
 
     last_outcomes_[static_cast<bit_integer_type>(qubit)]
-      = do_projective_measurement(qubit);
+      = do_projective_measurement(physical(qubit));
     last_measured_qubit_ = qubit;
     return *this;
   }
@@ -1993,6 +2321,8 @@ namespace bra
     std::cout << oss.str() << std::flush;
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_expectation_values();
 
     if (precision > 0)
@@ -2049,6 +2379,8 @@ namespace bra
     std::cout << oss.str() << std::flush;
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_amplitudes(amplitude_indices);
 
     auto const amplitudes_finish_time = BRA_clock::now();
@@ -2073,6 +2405,8 @@ namespace bra
     std::cout << oss.str() << std::flush;
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_generate_events(num_events, seed);
 
     oss.str("");
@@ -2103,6 +2437,8 @@ namespace bra
     std::cout << oss.str() << std::flush;
     last_processed_time_ = operation_finish_time;
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_measure();
 
     oss.str("");
@@ -2125,6 +2461,8 @@ namespace bra
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"EXPECTATION VALUE"};
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_expectation_value(operator_literal_or_variable_name, operated_qubits);
 
     return *this;
@@ -2135,6 +2473,8 @@ namespace bra
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"INNER PRODUCT"};
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_inner_product(remote_circuit_index_or_all);
 
     return *this;
@@ -2145,6 +2485,8 @@ namespace bra
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"INNER PRODUCT"};
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_inner_product(remote_circuit_index_or_all, operator_literal_or_variable_name, operated_qubits);
 
     return *this;
@@ -2155,6 +2497,8 @@ namespace bra
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"INNER PRODUCT"};
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_fidelity(remote_circuit_index_or_all);
 
     return *this;
@@ -2165,6 +2509,8 @@ namespace bra
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"INNER PRODUCT"};
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_fidelity(remote_circuit_index_or_all, operator_literal_or_variable_name, operated_qubits);
 
     return *this;
@@ -2185,6 +2531,8 @@ namespace bra
       std::begin(modular_exponentiation_qubits), std::end(modular_exponentiation_qubits),
       qubit_type{0u});
 
+    materialize_pauli_frame();
+    resolve_physical_qubits();
     do_shor_box(divisor, base, exponent_qubits, modular_exponentiation_qubits);
 
     return *this;
@@ -2195,6 +2543,7 @@ namespace bra
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"BEGIN FUSION"};
 
+    materialize_pauli_frame();
     is_in_fusion_ = true;
     found_qubits_.assign(total_num_qubits_, ::bra::found_qubit::not_found);
 
@@ -2216,12 +2565,37 @@ namespace bra
     return *this;
   }
 
+  state& state::begin_diagonal_accumulation()
+  {
+    if (is_in_fusion_ or is_depolarizing_channel_ or is_accumulating_diagonal_gates_)
+      return *this;
+
+    is_accumulating_diagonal_gates_ = true;
+    diagonal_accumulator_.clear();
+
+    return *this;
+  }
+
+  state& state::end_diagonal_accumulation()
+  {
+    if (not is_accumulating_diagonal_gates_)
+      return *this;
+
+    is_accumulating_diagonal_gates_ = false;
+    do_diagonal(diagonal_accumulator_);
+    diagonal_accumulator_.clear();
+
+    return *this;
+  }
+
   state& state::clear(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"CLEAR"};
 
-    do_clear(qubit);
+    do_clear(physical(qubit));
     apply_noise(qubit);
 
     return *this;
@@ -2229,24 +2603,500 @@ namespace bra
 
   state& state::set(qubit_type const qubit)
   {
+    materialize_pauli_frame_on(qubit);
+
     if (is_in_fusion_)
       throw ::bra::unsupported_fused_gate_error{"SET"};
 
-    do_set(qubit);
+    do_set(physical(qubit));
     apply_noise(qubit);
 
     return *this;
   }
 
+  namespace state_file_detail
+  {
+    // A state file consists of the header, the metadata of each process in slots of the same size, and local amplitudes of each process.
+    // The amplitudes of the i-th process start at data_offset + i * num_local_amplitudes * sizeof(complex_type)
+    constexpr char magic[8u] = {'B', 'R', 'A', 'S', 'T', 'A', 'T', 'E'};
+    constexpr std::uint64_t version = 1u;
+    constexpr std::uint64_t header_size = 64u;
+    constexpr std::uint64_t alignment = 4096u;
+    // counts of MPI-IO functions are int
+    constexpr std::uint64_t max_chunk_size = std::uint64_t{1u} << 30u;
+
+    struct header
+    {
+      std::uint64_t version;
+      std::uint64_t real_size;
+      std::uint64_t total_num_qubits;
+      std::uint64_t num_processes;
+      std::uint64_t num_local_amplitudes;
+      std::uint64_t slot_size;
+      std::uint64_t data_offset;
+    }; // struct header
+
+    inline auto round_up(std::uint64_t const value, std::uint64_t const unit) -> std::uint64_t
+    { return (value + unit - std::uint64_t{1u}) / unit * unit; }
+
+    inline auto make_header(
+      std::uint64_t const total_num_qubits, std::uint64_t const num_processes,
+      std::uint64_t const num_local_amplitudes, std::uint64_t const slot_size)
+    -> header
+    {
+      return header{
+        version, sizeof(::bra::real_type), total_num_qubits, num_processes, num_local_amplitudes, slot_size,
+        round_up(header_size + num_processes * slot_size, alignment)};
+    }
+
+    using ::bra::utility::binary_io::write;
+    using ::bra::utility::binary_io::write_string;
+    using ::bra::utility::binary_io::write_array;
+
+    template <typename Value>
+    inline auto write_variables(std::string& bytes, std::unordered_map<std::string, std::vector<Value>> const& variables) -> void
+    {
+      write(bytes, static_cast<std::uint64_t>(variables.size()));
+      for (auto const& variable: variables)
+      {
+        write_string(bytes, variable.first);
+        write_array(bytes, variable.second.data(), variable.second.size());
+      }
+    }
+
+    inline auto header_to_bytes(header const& file_header) -> std::string
+    {
+      auto result = std::string(magic, sizeof(magic));
+      write(result, file_header.version);
+      write(result, file_header.real_size);
+      write(result, file_header.total_num_qubits);
+      write(result, file_header.num_processes);
+      write(result, file_header.num_local_amplitudes);
+      write(result, file_header.slot_size);
+      write(result, file_header.data_offset);
+      assert(result.size() == header_size);
+      return result;
+    }
+
+    // metadata is stored with its size in a slot
+    inline auto metadata_to_slot(std::string const& metadata, std::uint64_t const slot_size) -> std::string
+    {
+      auto result = std::string{};
+      write_string(result, metadata);
+      assert(result.size() <= slot_size);
+      result.resize(slot_size, '\0');
+      return result;
+    }
+
+    using reader = ::bra::utility::binary_io::reader< ::bra::wrong_state_file_error >;
+
+    template <typename Value>
+    inline auto read_variables(reader& variables_reader, std::unordered_map<std::string, std::vector<Value>>& variables) -> void
+    {
+      variables.clear();
+      auto const num_variables = variables_reader.read<std::uint64_t>();
+      for (auto count = std::uint64_t{0u}; count < num_variables; ++count)
+      {
+        auto variable_name = variables_reader.read_string();
+        auto values = std::vector<Value>{};
+        variables_reader.read_array(values);
+        variables.emplace(std::move(variable_name), std::move(values));
+      }
+    }
+
+    inline auto bytes_to_header(
+      std::string const& filename, std::string const& bytes,
+      std::uint64_t const total_num_qubits, std::uint64_t const num_processes, std::uint64_t const num_local_amplitudes)
+    -> header
+    {
+      if (bytes.size() < header_size or not std::equal(magic, magic + sizeof(magic), bytes.data()))
+        throw ::bra::wrong_state_file_error{filename, "not a state file"};
+
+      auto file_reader = reader{filename, bytes.data(), bytes.size()};
+      char read_magic[sizeof(magic)];
+      file_reader.read_bytes(read_magic, sizeof(magic));
+
+      auto result = header{};
+      result.version = file_reader.read<std::uint64_t>();
+      result.real_size = file_reader.read<std::uint64_t>();
+      result.total_num_qubits = file_reader.read<std::uint64_t>();
+      result.num_processes = file_reader.read<std::uint64_t>();
+      result.num_local_amplitudes = file_reader.read<std::uint64_t>();
+      result.slot_size = file_reader.read<std::uint64_t>();
+      result.data_offset = file_reader.read<std::uint64_t>();
+
+      if (result.version != version)
+        throw ::bra::wrong_state_file_error{filename, "unsupported version " + std::to_string(result.version)};
+      if (result.real_size != sizeof(::bra::real_type))
+        throw ::bra::wrong_state_file_error{filename, "precision of amplitudes is different"};
+      if (result.total_num_qubits != total_num_qubits)
+        throw ::bra::wrong_state_file_error{filename, "the number of qubits is " + std::to_string(result.total_num_qubits)};
+      if (result.num_processes != num_processes)
+        throw ::bra::wrong_state_file_error{filename, "the number of processes is " + std::to_string(result.num_processes)};
+      if (result.num_local_amplitudes != num_local_amplitudes)
+        throw ::bra::wrong_state_file_error{filename, "the number of local amplitudes is " + std::to_string(result.num_local_amplitudes)};
+      if (result.data_offset != make_header(total_num_qubits, num_processes, num_local_amplitudes, result.slot_size).data_offset)
+        throw ::bra::wrong_state_file_error{filename, "broken header"};
+
+      return result;
+    }
+
+    inline auto slot_to_metadata(std::string const& filename, std::string const& slot) -> std::string
+    {
+      auto slot_reader = reader{filename, slot.data(), slot.size()};
+      return slot_reader.read_string();
+    }
+
+    template <typename Ranges>
+    inline auto count_amplitudes(Ranges const& ranges) -> std::uint64_t
+    {
+      auto result = std::uint64_t{0u};
+      for (auto const& range: ranges)
+        result += static_cast<std::uint64_t>(range.second);
+      return result;
+    }
+
+    struct chunk
+    {
+      std::uint64_t offset;
+      char* data;
+      std::uint64_t size;
+    }; // struct chunk
+
+    // splits local amplitudes into chunks of at most max_chunk_size bytes
+    template <typename Ranges>
+    inline auto make_chunks(Ranges const& ranges, std::uint64_t offset) -> std::vector<chunk>
+    {
+      auto result = std::vector<chunk>{};
+      for (auto const& range: ranges)
+      {
+        auto const data = reinterpret_cast<char*>(range.first);
+        auto const size = static_cast<std::uint64_t>(range.second) * sizeof(::bra::complex_type);
+        for (auto position = std::uint64_t{0u}; position < size; position += max_chunk_size)
+          result.push_back(chunk{offset + position, data + position, std::min(max_chunk_size, size - position)});
+        offset += size;
+      }
+      return result;
+    }
+
+#ifndef BRA_NO_MPI
+    inline auto check_mpi_result(int const result, std::string const& filename, char const* const function_name) -> void
+    {
+      if (result != MPI_SUCCESS)
+        throw ::bra::wrong_state_file_error{filename, std::string{function_name} + " failed"};
+    }
+
+    inline auto all_reduce_max(std::uint64_t const value, MPI_Comm const communicator) -> std::uint64_t
+    {
+      auto result = std::uint64_t{};
+      MPI_Allreduce(std::addressof(value), std::addressof(result), 1, MPI_UINT64_T, MPI_MAX, communicator);
+      return result;
+    }
+#endif // BRA_NO_MPI
+  } // namespace state_file_detail
+
+  auto state::generate_state_metadata(int const next_instruction_index) const -> std::string
+  {
+    auto result = std::string{};
+    ::bra::state_file_detail::write(result, static_cast<std::int64_t>(next_instruction_index));
+
+    std::ostringstream random_number_generator_stream;
+    random_number_generator_stream << random_number_generator_;
+    ::bra::state_file_detail::write_string(result, random_number_generator_stream.str());
+    ::bra::state_file_detail::write(result, static_cast<std::uint64_t>(noise_key_));
+    ::bra::state_file_detail::write(result, static_cast<std::uint64_t>(noise_gate_index_));
+
+#ifndef BRA_NO_MPI
+    ::bra::state_file_detail::write(result, static_cast<std::uint64_t>(permutation_.size()));
+    for (auto const& permutated_qubit: permutation_)
+      ::bra::state_file_detail::write(result, static_cast<std::uint64_t>(static_cast<bit_integer_type>(permutated_qubit.qubit())));
+#else // BRA_NO_MPI
+    ::bra::state_file_detail::write(result, std::uint64_t{0u});
+#endif // BRA_NO_MPI
+
+    ::bra::state_file_detail::write_variables(result, real_variables_);
+    ::bra::state_file_detail::write_variables(result, complex_variables_);
+    ::bra::state_file_detail::write_variables(result, int_variables_);
+    return result;
+  }
+
+  auto state::restore_state_metadata(std::string const& filename, std::string const& metadata) -> int
+  {
+    auto metadata_reader = ::bra::state_file_detail::reader{filename, metadata.data(), metadata.size()};
+    auto const next_instruction_index = static_cast<int>(metadata_reader.read<std::int64_t>());
+
+    std::istringstream random_number_generator_stream{metadata_reader.read_string()};
+    random_number_generator_stream >> random_number_generator_;
+    if (not random_number_generator_stream)
+      throw ::bra::wrong_state_file_error{filename, "broken state of the random number generator"};
+    noise_key_ = static_cast<seed_type>(metadata_reader.read<std::uint64_t>());
+    noise_gate_index_ = metadata_reader.read<std::uint64_t>();
+    // Pauli frames are materialized before states are saved
+    pauli_frame_x_mask_ = state_integer_type{0u};
+    pauli_frame_z_mask_ = state_integer_type{0u};
+    pauli_frame_phase_ = complex_type{real_type{1}};
+
+    auto const permutation_size = metadata_reader.read<std::uint64_t>();
+#ifndef BRA_NO_MPI
+    if (permutation_size != static_cast<std::uint64_t>(total_num_qubits_))
+      throw ::bra::wrong_state_file_error{filename, "broken qubit permutation"};
+
+    auto permutated_qubits = std::vector<permutated_qubit_type>{};
+    permutated_qubits.reserve(total_num_qubits_);
+    for (auto count = std::uint64_t{0u}; count < permutation_size; ++count)
+    {
+      auto const bit = metadata_reader.read<std::uint64_t>();
+      if (bit >= static_cast<std::uint64_t>(total_num_qubits_))
+        throw ::bra::wrong_state_file_error{filename, "broken qubit permutation"};
+      permutated_qubits.push_back(permutated_qubit_type{static_cast<bit_integer_type>(bit)});
+    }
+    using std::begin;
+    using std::end;
+    permutation_.assign(begin(permutated_qubits), end(permutated_qubits));
+#else // BRA_NO_MPI
+    if (permutation_size != std::uint64_t{0u})
+      throw ::bra::wrong_state_file_error{filename, "the state file was saved by MPI processes"};
+    std::iota(
+      std::begin(physical_qubits_), std::end(physical_qubits_),
+      qubit_type{0u});
+#endif // BRA_NO_MPI
+
+    ::bra::state_file_detail::read_variables(metadata_reader, real_variables_);
+    ::bra::state_file_detail::read_variables(metadata_reader, complex_variables_);
+    ::bra::state_file_detail::read_variables(metadata_reader, int_variables_);
+    return next_instruction_index;
+  }
+
+  // The file is written as filename.tmp and renamed to filename, so that the last snapshot survives failures while writing
+  state& state::save_state(std::string const& filename, int const next_instruction_index)
+  {
+    if (is_in_fusion_)
+      throw ::bra::unsupported_fused_gate_error{"SAVE STATE"};
+
+    end_diagonal_accumulation();
+    materialize_pauli_frame();
+    resolve_physical_qubits();
+
+    auto const local_amplitude_ranges = do_local_amplitude_ranges();
+    auto const num_local_amplitudes = ::bra::state_file_detail::count_amplitudes(local_amplitude_ranges);
+    auto const metadata = generate_state_metadata(next_instruction_index);
+    auto const temporary_filename = filename + ".tmp";
+
+#ifndef BRA_NO_MPI
+    auto const communicator = circuit_communicator_.mpi_comm();
+    auto const rank = circuit_communicator_.rank(environment_);
+    auto const num_processes = static_cast<std::uint64_t>(circuit_communicator_.size(environment_));
+
+    auto const slot_size
+      = ::bra::state_file_detail::all_reduce_max(
+          ::bra::state_file_detail::round_up(sizeof(std::uint64_t) + metadata.size(), sizeof(std::uint64_t)), communicator);
+    auto const file_header = ::bra::state_file_detail::make_header(total_num_qubits_, num_processes, num_local_amplitudes, slot_size);
+    auto const local_offset
+      = file_header.data_offset + static_cast<std::uint64_t>(rank.mpi_rank()) * num_local_amplitudes * sizeof(complex_type);
+    auto const chunks = ::bra::state_file_detail::make_chunks(local_amplitude_ranges, local_offset);
+    auto const num_chunks = ::bra::state_file_detail::all_reduce_max(chunks.size(), communicator);
+
+    auto file = MPI_File{};
+    ::bra::state_file_detail::check_mpi_result(
+      MPI_File_open(communicator, const_cast<char*>(temporary_filename.c_str()), MPI_MODE_CREATE bitor MPI_MODE_WRONLY, MPI_INFO_NULL, std::addressof(file)),
+      temporary_filename, "MPI_File_open");
+    ::bra::state_file_detail::check_mpi_result(
+      MPI_File_set_size(file, static_cast<MPI_Offset>(file_header.data_offset + num_processes * num_local_amplitudes * sizeof(complex_type))),
+      temporary_filename, "MPI_File_set_size");
+
+    if (rank == yampi::rank{0})
+    {
+      auto const header_bytes = ::bra::state_file_detail::header_to_bytes(file_header);
+      ::bra::state_file_detail::check_mpi_result(
+        MPI_File_write_at(file, MPI_Offset{0}, header_bytes.data(), static_cast<int>(header_bytes.size()), MPI_BYTE, MPI_STATUS_IGNORE),
+        temporary_filename, "MPI_File_write_at");
+    }
+
+    auto const slot = ::bra::state_file_detail::metadata_to_slot(metadata, slot_size);
+    ::bra::state_file_detail::check_mpi_result(
+      MPI_File_write_at_all(
+        file, static_cast<MPI_Offset>(::bra::state_file_detail::header_size + static_cast<std::uint64_t>(rank.mpi_rank()) * slot_size),
+        slot.data(), static_cast<int>(slot.size()), MPI_BYTE, MPI_STATUS_IGNORE),
+      temporary_filename, "MPI_File_write_at_all");
+
+    // every process should call MPI_File_write_at_all the same number of times
+    for (auto chunk_index = std::uint64_t{0u}; chunk_index < num_chunks; ++chunk_index)
+    {
+      auto const chunk
+        = chunk_index < chunks.size()
+          ? chunks[chunk_index]
+          : ::bra::state_file_detail::chunk{local_offset, nullptr, std::uint64_t{0u}};
+      ::bra::state_file_detail::check_mpi_result(
+        MPI_File_write_at_all(
+          file, static_cast<MPI_Offset>(chunk.offset), chunk.data, static_cast<int>(chunk.size), MPI_BYTE, MPI_STATUS_IGNORE),
+        temporary_filename, "MPI_File_write_at_all");
+    }
+
+    ::bra::state_file_detail::check_mpi_result(MPI_File_close(std::addressof(file)), temporary_filename, "MPI_File_close");
+
+    if (rank == yampi::rank{0} and std::rename(temporary_filename.c_str(), filename.c_str()) != 0)
+      throw ::bra::wrong_state_file_error{filename, "cannot rename " + temporary_filename};
+    yampi::barrier(circuit_communicator_, environment_);
+
+    auto const save_finish_time = BRA_clock::now(environment_);
+    if (rank == yampi::rank{0})
+    {
+      std::ostringstream oss;
+      oss << "State saved to " << filename << ": " << ::bra::state_detail::duration_to_second(start_time_, save_finish_time)
+          << " (" << ::bra::state_detail::duration_to_second(last_processed_time_, save_finish_time) << ")\n";
+      std::cout << oss.str() << std::flush;
+    }
+    last_processed_time_ = save_finish_time;
+#else // BRA_NO_MPI
+    auto const slot_size = ::bra::state_file_detail::round_up(sizeof(std::uint64_t) + metadata.size(), sizeof(std::uint64_t));
+    auto const file_header = ::bra::state_file_detail::make_header(total_num_qubits_, std::uint64_t{1u}, num_local_amplitudes, slot_size);
+
+    {
+      std::ofstream file{temporary_filename, std::ios::binary bitor std::ios::trunc};
+      if (not file)
+        throw ::bra::wrong_state_file_error{temporary_filename, "cannot open"};
+
+      auto const header_bytes = ::bra::state_file_detail::header_to_bytes(file_header);
+      auto const slot = ::bra::state_file_detail::metadata_to_slot(metadata, slot_size);
+      auto const padding = std::string(file_header.data_offset - header_bytes.size() - slot.size(), '\0');
+      file.write(header_bytes.data(), header_bytes.size());
+      file.write(slot.data(), slot.size());
+      file.write(padding.data(), padding.size());
+      for (auto const& chunk: ::bra::state_file_detail::make_chunks(local_amplitude_ranges, file_header.data_offset))
+        file.write(chunk.data, static_cast<std::streamsize>(chunk.size));
+
+      file.close();
+      if (not file)
+        throw ::bra::wrong_state_file_error{temporary_filename, "cannot write"};
+    }
+
+    if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0)
+      throw ::bra::wrong_state_file_error{filename, "cannot rename " + temporary_filename};
+
+    auto const save_finish_time = BRA_clock::now();
+    std::ostringstream oss;
+    oss << "State saved to " << filename << ": " << ::bra::state_detail::duration_to_second(start_time_, save_finish_time)
+        << " (" << ::bra::state_detail::duration_to_second(last_processed_time_, save_finish_time) << ")\n";
+    std::cout << oss.str() << std::flush;
+    last_processed_time_ = save_finish_time;
+#endif // BRA_NO_MPI
+
+    return *this;
+  }
+
+  state& state::load_state(std::string const& filename)
+  {
+    auto next_instruction_index = int{};
+    return load_state(filename, next_instruction_index);
+  }
+
+  // The state file should be saved by the same number of processes with the same number of qubits and pages
+  state& state::load_state(std::string const& filename, int& next_instruction_index)
+  {
+    if (is_in_fusion_)
+      throw ::bra::unsupported_fused_gate_error{"LOAD STATE"};
+
+    auto const local_amplitude_ranges = do_local_amplitude_ranges();
+    auto const num_local_amplitudes = ::bra::state_file_detail::count_amplitudes(local_amplitude_ranges);
+    auto header_bytes = std::string(::bra::state_file_detail::header_size, '\0');
+
+#ifndef BRA_NO_MPI
+    auto const communicator = circuit_communicator_.mpi_comm();
+    auto const rank = circuit_communicator_.rank(environment_);
+    auto const num_processes = static_cast<std::uint64_t>(circuit_communicator_.size(environment_));
+
+    auto file = MPI_File{};
+    ::bra::state_file_detail::check_mpi_result(
+      MPI_File_open(communicator, const_cast<char*>(filename.c_str()), MPI_MODE_RDONLY, MPI_INFO_NULL, std::addressof(file)),
+      filename, "MPI_File_open");
+
+    // all processes validate the header by themselves, so that all of them throw the same exception
+    auto num_read_bytes = int{};
+    auto status = MPI_Status{};
+    ::bra::state_file_detail::check_mpi_result(
+      MPI_File_read_at_all(file, MPI_Offset{0}, std::addressof(header_bytes[0u]), static_cast<int>(header_bytes.size()), MPI_BYTE, std::addressof(status)),
+      filename, "MPI_File_read_at_all");
+    MPI_Get_count(std::addressof(status), MPI_BYTE, std::addressof(num_read_bytes));
+    header_bytes.resize(static_cast<std::size_t>(num_read_bytes));
+    auto const file_header
+      = ::bra::state_file_detail::bytes_to_header(filename, header_bytes, total_num_qubits_, num_processes, num_local_amplitudes);
+
+    auto slot = std::string(static_cast<std::size_t>(file_header.slot_size), '\0');
+    ::bra::state_file_detail::check_mpi_result(
+      MPI_File_read_at_all(
+        file, static_cast<MPI_Offset>(::bra::state_file_detail::header_size + static_cast<std::uint64_t>(rank.mpi_rank()) * file_header.slot_size),
+        std::addressof(slot[0u]), static_cast<int>(slot.size()), MPI_BYTE, MPI_STATUS_IGNORE),
+      filename, "MPI_File_read_at_all");
+
+    auto const local_offset
+      = file_header.data_offset + static_cast<std::uint64_t>(rank.mpi_rank()) * num_local_amplitudes * sizeof(complex_type);
+    auto const chunks = ::bra::state_file_detail::make_chunks(local_amplitude_ranges, local_offset);
+    auto const num_chunks = ::bra::state_file_detail::all_reduce_max(chunks.size(), communicator);
+    for (auto chunk_index = std::uint64_t{0u}; chunk_index < num_chunks; ++chunk_index)
+    {
+      auto const chunk
+        = chunk_index < chunks.size()
+          ? chunks[chunk_index]
+          : ::bra::state_file_detail::chunk{local_offset, nullptr, std::uint64_t{0u}};
+      ::bra::state_file_detail::check_mpi_result(
+        MPI_File_read_at_all(
+          file, static_cast<MPI_Offset>(chunk.offset), chunk.data, static_cast<int>(chunk.size), MPI_BYTE, MPI_STATUS_IGNORE),
+        filename, "MPI_File_read_at_all");
+    }
+
+    ::bra::state_file_detail::check_mpi_result(MPI_File_close(std::addressof(file)), filename, "MPI_File_close");
+
+    next_instruction_index = restore_state_metadata(filename, ::bra::state_file_detail::slot_to_metadata(filename, slot));
+
+    auto const load_finish_time = BRA_clock::now(environment_);
+    if (rank == yampi::rank{0})
+    {
+      std::ostringstream oss;
+      oss << "State loaded from " << filename << ": " << ::bra::state_detail::duration_to_second(start_time_, load_finish_time)
+          << " (" << ::bra::state_detail::duration_to_second(last_processed_time_, load_finish_time) << ")\n";
+      std::cout << oss.str() << std::flush;
+    }
+    last_processed_time_ = load_finish_time;
+#else // BRA_NO_MPI
+    std::ifstream file{filename, std::ios::binary};
+    if (not file)
+      throw ::bra::wrong_state_file_error{filename, "cannot open"};
+
+    file.read(std::addressof(header_bytes[0u]), static_cast<std::streamsize>(header_bytes.size()));
+    header_bytes.resize(static_cast<std::size_t>(file.gcount()));
+    auto const file_header
+      = ::bra::state_file_detail::bytes_to_header(filename, header_bytes, total_num_qubits_, std::uint64_t{1u}, num_local_amplitudes);
+
+    auto slot = std::string(static_cast<std::size_t>(file_header.slot_size), '\0');
+    file.read(std::addressof(slot[0u]), static_cast<std::streamsize>(slot.size()));
+    file.seekg(static_cast<std::streamoff>(file_header.data_offset));
+    for (auto const& chunk: ::bra::state_file_detail::make_chunks(local_amplitude_ranges, file_header.data_offset))
+      file.read(chunk.data, static_cast<std::streamsize>(chunk.size));
+    if (not file)
+      throw ::bra::wrong_state_file_error{filename, "unexpected end of file"};
+
+    next_instruction_index = restore_state_metadata(filename, ::bra::state_file_detail::slot_to_metadata(filename, slot));
+
+    auto const load_finish_time = BRA_clock::now();
+    std::ostringstream oss;
+    oss << "State loaded from " << filename << ": " << ::bra::state_detail::duration_to_second(start_time_, load_finish_time)
+        << " (" << ::bra::state_detail::duration_to_second(last_processed_time_, load_finish_time) << ")\n";
+    std::cout << oss.str() << std::flush;
+    last_processed_time_ = load_finish_time;
+#endif // BRA_NO_MPI
+
+    return *this;
+  }
+
   state& state::controlled_i_gate(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_i_gate(target_qubit, control_qubit);
+    do_controlled_i_gate(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2256,11 +3106,11 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
-    do_controlled_ic_gate(control_qubit1, control_qubit2);
+    do_controlled_ic_gate(physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2270,11 +3120,11 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_in_gate(target_qubits, control_qubits);
+    do_multi_controlled_in_gate(physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -2283,9 +3133,9 @@ namespace bra
   state& state::multi_controlled_ic_gate(std::vector<control_qubit_type> const& control_qubits)
   {
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
-    do_multi_controlled_ic_gate(control_qubits);
+    do_multi_controlled_ic_gate(physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2293,13 +3143,15 @@ namespace bra
 
   state& state::controlled_hadamard(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_hadamard(target_qubit, control_qubit);
+    do_controlled_hadamard(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2307,13 +3159,15 @@ namespace bra
 
   state& state::multi_controlled_hadamard(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_hadamard(target_qubit, control_qubits);
+    do_multi_controlled_hadamard(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2323,11 +3177,12 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_not(target_qubit, control_qubit);
+    conjugate_pauli_frame_by_controlled_not(target_qubit, control_qubit.qubit());
+    do_controlled_not(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2335,13 +3190,15 @@ namespace bra
 
   state& state::multi_controlled_not(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_not(target_qubit, control_qubits);
+    do_multi_controlled_not(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2349,13 +3206,15 @@ namespace bra
 
   state& state::controlled_pauli_x(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_pauli_x(target_qubit, control_qubit);
+    do_controlled_pauli_x(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2363,13 +3222,15 @@ namespace bra
 
   state& state::multi_controlled_pauli_xn(std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_pauli_xn(target_qubits, control_qubits);
+    do_multi_controlled_pauli_xn(physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -2377,13 +3238,15 @@ namespace bra
 
   state& state::controlled_pauli_y(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_pauli_y(target_qubit, control_qubit);
+    do_controlled_pauli_y(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2391,13 +3254,15 @@ namespace bra
 
   state& state::multi_controlled_pauli_yn(std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_pauli_yn(target_qubits, control_qubits);
+    do_multi_controlled_pauli_yn(physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -2407,11 +3272,15 @@ namespace bra
   {
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
-    do_controlled_pauli_z(control_qubit1, control_qubit2);
+    conjugate_pauli_frame_by_controlled_pauli_z(control_qubit1.qubit(), control_qubit2.qubit());
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(complex_type{real_type{-1}}, ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit2)));
+    else
+      do_controlled_pauli_z(physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2419,10 +3288,15 @@ namespace bra
 
   state& state::multi_controlled_pauli_z(std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(control_qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
-    do_multi_controlled_pauli_z(control_qubits);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(complex_type{real_type{-1}}, ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubits)));
+    else
+      do_multi_controlled_pauli_z(physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2430,13 +3304,15 @@ namespace bra
 
   state& state::multi_controlled_pauli_zn(std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_pauli_zn(target_qubits, control_qubits);
+    do_multi_controlled_pauli_zn(physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -2444,14 +3320,16 @@ namespace bra
 
   state& state::multi_controlled_swap(qubit_type const target_qubit1, qubit_type const target_qubit2, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit1, target_qubit2, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit1);
-      ::bra::set_found_qubits(found_qubits_, target_qubit2);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit2));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_swap(target_qubit1, target_qubit2, control_qubits);
+    do_multi_controlled_swap(physical(target_qubit1), physical(target_qubit2), physical(control_qubits));
     apply_noises(target_qubit1, target_qubit2, control_qubits);
 
     return *this;
@@ -2459,13 +3337,15 @@ namespace bra
 
   state& state::controlled_sqrt_pauli_x(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_sqrt_pauli_x(target_qubit, control_qubit);
+    do_controlled_sqrt_pauli_x(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2473,13 +3353,15 @@ namespace bra
 
   state& state::adj_controlled_sqrt_pauli_x(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_adj_controlled_sqrt_pauli_x(target_qubit, control_qubit);
+    do_adj_controlled_sqrt_pauli_x(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2487,13 +3369,15 @@ namespace bra
 
   state& state::multi_controlled_sqrt_pauli_x(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_sqrt_pauli_x(target_qubit, control_qubits);
+    do_multi_controlled_sqrt_pauli_x(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2501,13 +3385,15 @@ namespace bra
 
   state& state::adj_multi_controlled_sqrt_pauli_x(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_sqrt_pauli_x(target_qubit, control_qubits);
+    do_adj_multi_controlled_sqrt_pauli_x(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2515,13 +3401,15 @@ namespace bra
 
   state& state::controlled_sqrt_pauli_y(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_sqrt_pauli_y(target_qubit, control_qubit);
+    do_controlled_sqrt_pauli_y(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2529,13 +3417,15 @@ namespace bra
 
   state& state::adj_controlled_sqrt_pauli_y(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_adj_controlled_sqrt_pauli_y(target_qubit, control_qubit);
+    do_adj_controlled_sqrt_pauli_y(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2543,13 +3433,15 @@ namespace bra
 
   state& state::multi_controlled_sqrt_pauli_y(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_sqrt_pauli_y(target_qubit, control_qubits);
+    do_multi_controlled_sqrt_pauli_y(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2557,13 +3449,15 @@ namespace bra
 
   state& state::adj_multi_controlled_sqrt_pauli_y(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_sqrt_pauli_y(target_qubit, control_qubits);
+    do_adj_multi_controlled_sqrt_pauli_y(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2571,13 +3465,18 @@ namespace bra
 
   state& state::controlled_sqrt_pauli_z(control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
   {
+    materialize_pauli_frame_on(control_qubit1, control_qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
-    do_controlled_sqrt_pauli_z(control_qubit1, control_qubit2);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::imaginary_unit<complex_type>(), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit2)));
+    else
+      do_controlled_sqrt_pauli_z(physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2585,13 +3484,18 @@ namespace bra
 
   state& state::adj_controlled_sqrt_pauli_z(control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
   {
+    materialize_pauli_frame_on(control_qubit1, control_qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
-    do_adj_controlled_sqrt_pauli_z(control_qubit1, control_qubit2);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::minus_imaginary_unit<complex_type>(), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit2)));
+    else
+      do_adj_controlled_sqrt_pauli_z(physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2599,10 +3503,15 @@ namespace bra
 
   state& state::multi_controlled_sqrt_pauli_z(std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(control_qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
-    do_multi_controlled_sqrt_pauli_z(control_qubits);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::imaginary_unit<complex_type>(), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubits)));
+    else
+      do_multi_controlled_sqrt_pauli_z(physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2610,10 +3519,15 @@ namespace bra
 
   state& state::adj_multi_controlled_sqrt_pauli_z(std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(control_qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
-    do_adj_multi_controlled_sqrt_pauli_z(control_qubits);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::minus_imaginary_unit<complex_type>(), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubits)));
+    else
+      do_adj_multi_controlled_sqrt_pauli_z(physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2621,13 +3535,15 @@ namespace bra
 
   state& state::multi_controlled_sqrt_pauli_zn(std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_sqrt_pauli_zn(target_qubits, control_qubits);
+    do_multi_controlled_sqrt_pauli_zn(physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -2635,13 +3551,15 @@ namespace bra
 
   state& state::adj_multi_controlled_sqrt_pauli_zn(std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_sqrt_pauli_zn(target_qubits, control_qubits);
+    do_adj_multi_controlled_sqrt_pauli_zn(physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -2651,18 +3569,24 @@ namespace bra
     boost::variant<int_type, std::string> const& phase_exponent,
     control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
   {
+    materialize_pauli_frame_on(control_qubit1, control_qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
     auto const phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
 
-    if (phase_exponent_value >= 0)
-      do_controlled_phase_shift(phase_coefficients_[phase_exponent_value], control_qubit1, control_qubit2);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(
+        phase_exponent_value >= 0 ? phase_coefficients_[phase_exponent_value] : std::conj(phase_coefficients_[-phase_exponent_value]),
+        ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit2)));
+    else if (phase_exponent_value >= 0)
+      do_controlled_phase_shift(phase_coefficients_[phase_exponent_value], physical(control_qubit1), physical(control_qubit2));
     else
-      do_adj_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], control_qubit1, control_qubit2);
+      do_adj_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2672,18 +3596,24 @@ namespace bra
     boost::variant<int_type, std::string> const& phase_exponent,
     control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
   {
+    materialize_pauli_frame_on(control_qubit1, control_qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
     auto const phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
 
-    if (phase_exponent_value >= 0)
-      do_adj_controlled_phase_shift(phase_coefficients_[phase_exponent_value], control_qubit1, control_qubit2);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(
+        phase_exponent_value >= 0 ? std::conj(phase_coefficients_[phase_exponent_value]) : phase_coefficients_[-phase_exponent_value],
+        ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit2)));
+    else if (phase_exponent_value >= 0)
+      do_adj_controlled_phase_shift(phase_coefficients_[phase_exponent_value], physical(control_qubit1), physical(control_qubit2));
     else
-      do_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], control_qubit1, control_qubit2);
+      do_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2693,15 +3623,21 @@ namespace bra
     boost::variant<int_type, std::string> const& phase_exponent,
     std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(control_qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
     auto const phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
 
-    if (phase_exponent_value >= 0)
-      do_multi_controlled_phase_shift(phase_coefficients_[phase_exponent_value], control_qubits);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(
+        phase_exponent_value >= 0 ? phase_coefficients_[phase_exponent_value] : std::conj(phase_coefficients_[-phase_exponent_value]),
+        ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubits)));
+    else if (phase_exponent_value >= 0)
+      do_multi_controlled_phase_shift(phase_coefficients_[phase_exponent_value], physical(control_qubits));
     else
-      do_adj_multi_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], control_qubits);
+      do_adj_multi_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2711,15 +3647,21 @@ namespace bra
     boost::variant<int_type, std::string> const& phase_exponent,
     std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(control_qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
     auto const phase_exponent_value = boost::apply_visitor(int_visitor{*this}, phase_exponent);
 
-    if (phase_exponent_value >= 0)
-      do_adj_multi_controlled_phase_shift(phase_coefficients_[phase_exponent_value], control_qubits);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(
+        phase_exponent_value >= 0 ? std::conj(phase_coefficients_[phase_exponent_value]) : phase_coefficients_[-phase_exponent_value],
+        ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubits)));
+    else if (phase_exponent_value >= 0)
+      do_adj_multi_controlled_phase_shift(phase_coefficients_[phase_exponent_value], physical(control_qubits));
     else
-      do_multi_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], control_qubits);
+      do_multi_controlled_phase_shift(phase_coefficients_[-phase_exponent_value], physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2728,14 +3670,22 @@ namespace bra
   state& state::controlled_u1(
     boost::variant<real_type, std::string> const& phase,
     control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
+  { return controlled_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit1, control_qubit2); }
+
+  state& state::controlled_u1(real_type const phase, control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
   {
+    materialize_pauli_frame_on(control_qubit1, control_qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
-    do_controlled_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit1, control_qubit2);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::exp_i<complex_type>(phase), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit2)));
+    else
+      do_controlled_u1(phase, physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2744,14 +3694,22 @@ namespace bra
   state& state::adj_controlled_u1(
     boost::variant<real_type, std::string> const& phase,
     control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
+  { return adj_controlled_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit1, control_qubit2); }
+
+  state& state::adj_controlled_u1(real_type const phase, control_qubit_type const control_qubit1, control_qubit_type const control_qubit2)
   {
+    materialize_pauli_frame_on(control_qubit1, control_qubit2);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, control_qubit1);
-      ::bra::set_found_qubits(found_qubits_, control_qubit2);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit2));
     }
 
-    do_adj_controlled_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubit1, control_qubit2);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::exp_i<complex_type>(-phase), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit1)) bitor ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubit2)));
+    else
+      do_adj_controlled_u1(phase, physical(control_qubit1), physical(control_qubit2));
     apply_noises(control_qubit1, control_qubit2);
 
     return *this;
@@ -2761,10 +3719,16 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(control_qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
-    do_multi_controlled_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubits);
+    auto const phase_value = boost::apply_visitor(real_visitor{*this}, phase);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::exp_i<complex_type>(phase_value), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubits)));
+    else
+      do_multi_controlled_u1(phase_value, physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2774,10 +3738,16 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(control_qubits);
+
     if (is_in_fusion_)
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
 
-    do_adj_multi_controlled_u1(boost::apply_visitor(real_visitor{*this}, phase), control_qubits);
+    auto const phase_value = boost::apply_visitor(real_visitor{*this}, phase);
+    if (is_accumulating_diagonal_gates_)
+      diagonal_accumulator_.add_phase(::ket::utility::exp_i<complex_type>(-phase_value), ::bra::diagonal_accumulation_detail::to_mask(physical(control_qubits)));
+    else
+      do_adj_multi_controlled_u1(phase_value, physical(control_qubits));
     apply_noises(control_qubits);
 
     return *this;
@@ -2788,16 +3758,18 @@ namespace bra
     boost::variant<real_type, std::string> const& phase2,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
     do_controlled_u2(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
-      target_qubit, control_qubit);
+      physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2808,16 +3780,18 @@ namespace bra
     boost::variant<real_type, std::string> const& phase2,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
     do_adj_controlled_u2(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
-      target_qubit, control_qubit);
+      physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2828,16 +3802,18 @@ namespace bra
     boost::variant<real_type, std::string> const& phase2,
     qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
     do_multi_controlled_u2(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
-      target_qubit, control_qubits);
+      physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2848,16 +3824,18 @@ namespace bra
     boost::variant<real_type, std::string> const& phase2,
     qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
     do_adj_multi_controlled_u2(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
-      target_qubit, control_qubits);
+      physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2869,17 +3847,19 @@ namespace bra
     boost::variant<real_type, std::string> const& phase3,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
     do_controlled_u3(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
       boost::apply_visitor(real_visitor{*this}, phase3),
-      target_qubit, control_qubit);
+      physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2891,17 +3871,19 @@ namespace bra
     boost::variant<real_type, std::string> const& phase3,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
     do_adj_controlled_u3(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
       boost::apply_visitor(real_visitor{*this}, phase3),
-      target_qubit, control_qubit);
+      physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2913,17 +3895,19 @@ namespace bra
     boost::variant<real_type, std::string> const& phase3,
     qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
     do_multi_controlled_u3(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
       boost::apply_visitor(real_visitor{*this}, phase3),
-      target_qubit, control_qubits);
+      physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2935,17 +3919,19 @@ namespace bra
     boost::variant<real_type, std::string> const& phase3,
     qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
     do_adj_multi_controlled_u3(
       boost::apply_visitor(real_visitor{*this}, phase1),
       boost::apply_visitor(real_visitor{*this}, phase2),
       boost::apply_visitor(real_visitor{*this}, phase3),
-      target_qubit, control_qubits);
+      physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2953,13 +3939,15 @@ namespace bra
 
   state& state::controlled_x_rotation_half_pi(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_x_rotation_half_pi(target_qubit, control_qubit);
+    do_controlled_x_rotation_half_pi(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2967,13 +3955,15 @@ namespace bra
 
   state& state::adj_controlled_x_rotation_half_pi(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_adj_controlled_x_rotation_half_pi(target_qubit, control_qubit);
+    do_adj_controlled_x_rotation_half_pi(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -2981,13 +3971,15 @@ namespace bra
 
   state& state::multi_controlled_x_rotation_half_pi(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_x_rotation_half_pi(target_qubit, control_qubits);
+    do_multi_controlled_x_rotation_half_pi(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -2995,13 +3987,15 @@ namespace bra
 
   state& state::adj_multi_controlled_x_rotation_half_pi(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_x_rotation_half_pi(target_qubit, control_qubits);
+    do_adj_multi_controlled_x_rotation_half_pi(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -3009,13 +4003,15 @@ namespace bra
 
   state& state::controlled_y_rotation_half_pi(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_y_rotation_half_pi(target_qubit, control_qubit);
+    do_controlled_y_rotation_half_pi(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3023,13 +4019,15 @@ namespace bra
 
   state& state::adj_controlled_y_rotation_half_pi(qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_adj_controlled_y_rotation_half_pi(target_qubit, control_qubit);
+    do_adj_controlled_y_rotation_half_pi(physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3037,13 +4035,15 @@ namespace bra
 
   state& state::multi_controlled_y_rotation_half_pi(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_y_rotation_half_pi(target_qubit, control_qubits);
+    do_multi_controlled_y_rotation_half_pi(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -3051,13 +4051,15 @@ namespace bra
 
   state& state::adj_multi_controlled_y_rotation_half_pi(qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_y_rotation_half_pi(target_qubit, control_qubits);
+    do_adj_multi_controlled_y_rotation_half_pi(physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -3067,13 +4069,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubit);
+    do_controlled_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3083,13 +4087,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_adj_controlled_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubit);
+    do_adj_controlled_exponential_pauli_x(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3099,13 +4105,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), target_qubits, control_qubits);
+    do_multi_controlled_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -3115,13 +4123,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), target_qubits, control_qubits);
+    do_adj_multi_controlled_exponential_pauli_xn(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -3131,13 +4141,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubit);
+    do_controlled_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3147,13 +4159,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit);
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_adj_controlled_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubit);
+    do_adj_controlled_exponential_pauli_y(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3163,13 +4177,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), target_qubits, control_qubits);
+    do_multi_controlled_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -3179,13 +4195,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), target_qubits, control_qubits);
+    do_adj_multi_controlled_exponential_pauli_yn(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -3195,15 +4213,17 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)], ::bra::found_qubit::cez_qubit))
-        found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)] = ::bra::found_qubit::cez_qubit;
+      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))], ::bra::found_qubit::cez_qubit))
+        found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))] = ::bra::found_qubit::cez_qubit;
 
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubit);
+    do_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3213,15 +4233,17 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubit);
+
     if (is_in_fusion_)
     {
-      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)], ::bra::found_qubit::cez_qubit))
-        found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)] = ::bra::found_qubit::cez_qubit;
+      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))], ::bra::found_qubit::cez_qubit))
+        found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))] = ::bra::found_qubit::cez_qubit;
 
-      ::bra::set_found_qubits(found_qubits_, control_qubit);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubit));
     }
 
-    do_adj_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubit);
+    do_adj_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubit));
     apply_noises(target_qubit, control_qubit);
 
     return *this;
@@ -3231,15 +4253,17 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)], ::bra::found_qubit::cez_qubit))
-        found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)] = ::bra::found_qubit::cez_qubit;
+      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))], ::bra::found_qubit::cez_qubit))
+        found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))] = ::bra::found_qubit::cez_qubit;
 
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubits);
+    do_multi_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -3249,15 +4273,17 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit, control_qubits);
+
     if (is_in_fusion_)
     {
-      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)], ::bra::found_qubit::cez_qubit))
-        found_qubits_[static_cast< ::bra::bit_integer_type >(target_qubit)] = ::bra::found_qubit::cez_qubit;
+      if (::bra::is_weaker(found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))], ::bra::found_qubit::cez_qubit))
+        found_qubits_[static_cast< ::bra::bit_integer_type >(physical(target_qubit))] = ::bra::found_qubit::cez_qubit;
 
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), target_qubit, control_qubits);
+    do_adj_multi_controlled_exponential_pauli_z(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit), physical(control_qubits));
     apply_noises(target_qubit, control_qubits);
 
     return *this;
@@ -3267,13 +4293,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_exponential_pauli_zn(boost::apply_visitor(real_visitor{*this}, phase), target_qubits, control_qubits);
+    do_multi_controlled_exponential_pauli_zn(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -3283,13 +4311,15 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     std::vector<qubit_type> const& target_qubits, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubits, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubits);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubits));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_exponential_pauli_zn(boost::apply_visitor(real_visitor{*this}, phase), target_qubits, control_qubits);
+    do_adj_multi_controlled_exponential_pauli_zn(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubits), physical(control_qubits));
     apply_noises(target_qubits, control_qubits);
 
     return *this;
@@ -3299,14 +4329,16 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit1, qubit_type const target_qubit2, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit1, target_qubit2, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit1);
-      ::bra::set_found_qubits(found_qubits_, target_qubit2);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit2));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_multi_controlled_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), target_qubit1, target_qubit2, control_qubits);
+    do_multi_controlled_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit1), physical(target_qubit2), physical(control_qubits));
     apply_noises(target_qubit1, target_qubit2, control_qubits);
 
     return *this;
@@ -3316,32 +4348,190 @@ namespace bra
     boost::variant<real_type, std::string> const& phase,
     qubit_type const target_qubit1, qubit_type const target_qubit2, std::vector<control_qubit_type> const& control_qubits)
   {
+    materialize_pauli_frame_on(target_qubit1, target_qubit2, control_qubits);
+
     if (is_in_fusion_)
     {
-      ::bra::set_found_qubits(found_qubits_, target_qubit1);
-      ::bra::set_found_qubits(found_qubits_, target_qubit2);
-      ::bra::set_found_qubits(found_qubits_, control_qubits);
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit1));
+      ::bra::set_found_qubits(found_qubits_, physical(target_qubit2));
+      ::bra::set_found_qubits(found_qubits_, physical(control_qubits));
     }
 
-    do_adj_multi_controlled_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), target_qubit1, target_qubit2, control_qubits);
+    do_adj_multi_controlled_exponential_swap(boost::apply_visitor(real_visitor{*this}, phase), physical(target_qubit1), physical(target_qubit2), physical(control_qubits));
     apply_noises(target_qubit1, target_qubit2, control_qubits);
 
     return *this;
   }
 
-  auto state::apply_noise(qubit_type const qubit) -> void
+  void state::track_pauli_frame(bool const is_tracking)
+  {
+    if (not is_tracking)
+      materialize_pauli_frame();
+
+    is_tracking_pauli_frame_ = is_tracking;
+  }
+
+  // P X^x Z^z = phase X^x' Z^z' for a Pauli gate P
+  auto state::absorb_pauli_x(qubit_type const qubit) -> void
+  { pauli_frame_x_mask_ ^= ::bra::diagonal_accumulation_detail::to_mask(qubit); }
+
+  auto state::absorb_pauli_y(qubit_type const qubit) -> void
+  {
+    // Y = i X Z
+    pauli_frame_phase_
+      *= is_flipped_by_pauli_frame(qubit)
+         ? ::ket::utility::minus_imaginary_unit<complex_type>()
+         : ::ket::utility::imaginary_unit<complex_type>();
+
+    auto const mask = ::bra::diagonal_accumulation_detail::to_mask(qubit);
+    pauli_frame_x_mask_ ^= mask;
+    pauli_frame_z_mask_ ^= mask;
+  }
+
+  auto state::absorb_pauli_z(qubit_type const qubit) -> void
+  {
+    if (is_flipped_by_pauli_frame(qubit))
+      pauli_frame_phase_ = -pauli_frame_phase_;
+
+    pauli_frame_z_mask_ ^= ::bra::diagonal_accumulation_detail::to_mask(qubit);
+  }
+
+  // U X^x Z^z U+ = phase X^x' Z^z' for a Clifford gate U
+  auto state::conjugate_pauli_frame_by_hadamard(qubit_type const qubit) -> void
+  {
+    auto const mask = ::bra::diagonal_accumulation_detail::to_mask(qubit);
+    auto const x_bit = pauli_frame_x_mask_ bitand mask;
+    auto const z_bit = pauli_frame_z_mask_ bitand mask;
+    // H X Z H = Z X = -X Z
+    if (x_bit != state_integer_type{0u} and z_bit != state_integer_type{0u})
+      pauli_frame_phase_ = -pauli_frame_phase_;
+
+    pauli_frame_x_mask_ = (pauli_frame_x_mask_ bitand compl mask) bitor z_bit;
+    pauli_frame_z_mask_ = (pauli_frame_z_mask_ bitand compl mask) bitor x_bit;
+  }
+
+  auto state::conjugate_pauli_frame_by_sqrt_pauli_z(qubit_type const qubit, complex_type const& phase_if_flipped) -> void
+  {
+    // S X S+ = i X Z, S+ X S = -i X Z
+    if (not is_flipped_by_pauli_frame(qubit))
+      return;
+
+    pauli_frame_phase_ *= phase_if_flipped;
+    pauli_frame_z_mask_ ^= ::bra::diagonal_accumulation_detail::to_mask(qubit);
+  }
+
+  auto state::conjugate_pauli_frame_by_controlled_not(qubit_type const target_qubit, qubit_type const control_qubit) -> void
   {
-    if (not is_depolarizing_channel_)
+    // X on the control qubit spreads to the target qubit, and Z on the target qubit spreads to the control qubit
+    if (is_flipped_by_pauli_frame(control_qubit))
+      pauli_frame_x_mask_ ^= ::bra::diagonal_accumulation_detail::to_mask(target_qubit);
+    if ((pauli_frame_z_mask_ bitand ::bra::diagonal_accumulation_detail::to_mask(target_qubit)) != state_integer_type{0u})
+      pauli_frame_z_mask_ ^= ::bra::diagonal_accumulation_detail::to_mask(control_qubit);
+  }
+
+  auto state::conjugate_pauli_frame_by_controlled_pauli_z(qubit_type const qubit1, qubit_type const qubit2) -> void
+  {
+    // X on one qubit brings Z to the other qubit
+    auto const is_flipped1 = is_flipped_by_pauli_frame(qubit1);
+    auto const is_flipped2 = is_flipped_by_pauli_frame(qubit2);
+    if (is_flipped1 and is_flipped2)
+      pauli_frame_phase_ = -pauli_frame_phase_;
+    if (is_flipped1)
+      pauli_frame_z_mask_ ^= ::bra::diagonal_accumulation_detail::to_mask(qubit2);
+    if (is_flipped2)
+      pauli_frame_z_mask_ ^= ::bra::diagonal_accumulation_detail::to_mask(qubit1);
+  }
+
+  auto state::conjugate_pauli_frame_by_swap(qubit_type const qubit1, qubit_type const qubit2) -> void
+  {
+    auto const mask1 = ::bra::diagonal_accumulation_detail::to_mask(qubit1);
+    auto const mask2 = ::bra::diagonal_accumulation_detail::to_mask(qubit2);
+    for (auto* mask_ptr: {&pauli_frame_x_mask_, &pauli_frame_z_mask_})
+      if (((*mask_ptr bitand mask1) == state_integer_type{0u}) != ((*mask_ptr bitand mask2) == state_integer_type{0u}))
+        *mask_ptr ^= mask1 bitor mask2;
+  }
+
+  // Z factors and the phase are applied by one diagonal gate, and then X factors are applied by one gate
+  auto state::materialize_pauli_frame() -> void
+  {
+    if (pauli_frame_x_mask_ == state_integer_type{0u} and pauli_frame_z_mask_ == state_integer_type{0u}
+        and pauli_frame_phase_ == complex_type{real_type{1}})
       return;
 
-    auto const probability = generate_probability();
+    if (is_accumulating_diagonal_gates_)
+      end_diagonal_accumulation();
+
+    auto accumulator = ::ket::gate::diagonal_accumulator<complex_type, state_integer_type>{};
+    auto flipped_qubits = std::vector<qubit_type>{};
+    for (auto bit = bit_integer_type{0u}; bit < total_num_qubits_; ++bit)
+    {
+      auto const qubit = ket::make_qubit<state_integer_type>(bit);
+      auto const mask = ::bra::diagonal_accumulation_detail::to_mask(qubit);
+      if ((pauli_frame_z_mask_ bitand mask) != state_integer_type{0u})
+        accumulator.add_phase(complex_type{real_type{-1}}, ::bra::diagonal_accumulation_detail::to_mask(physical(qubit)));
+      if ((pauli_frame_x_mask_ bitand mask) != state_integer_type{0u})
+        flipped_qubits.push_back(physical(qubit));
+    }
+
+    if (pauli_frame_phase_ != complex_type{real_type{1}})
+      accumulator.add_parity_phase(
+        pauli_frame_phase_, pauli_frame_phase_,
+        ::bra::diagonal_accumulation_detail::to_mask(physical(ket::make_qubit<state_integer_type>(bit_integer_type{0u}))));
+
+    if (not accumulator.empty())
+      do_diagonal(accumulator);
+
+    if (flipped_qubits.size() == std::size_t{1u})
+      do_pauli_x(flipped_qubits.front());
+    else if (flipped_qubits.size() == std::size_t{2u})
+      do_pauli_xx(flipped_qubits.front(), flipped_qubits.back());
+    else if (flipped_qubits.size() > std::size_t{2u})
+      do_pauli_xn(flipped_qubits);
+
+    pauli_frame_x_mask_ = state_integer_type{0u};
+    pauli_frame_z_mask_ = state_integer_type{0u};
+    pauli_frame_phase_ = complex_type{real_type{1}};
+  }
+
+  auto state::materialize_pauli_frame_on_qubit(qubit_type const qubit) -> void
+  {
+    auto const mask = ::bra::diagonal_accumulation_detail::to_mask(qubit);
+    auto const is_flipped = (pauli_frame_x_mask_ bitand mask) != state_integer_type{0u};
+    auto const is_phase_flipped = (pauli_frame_z_mask_ bitand mask) != state_integer_type{0u};
+    if (not is_flipped and not is_phase_flipped)
+      return;
+
+    if (is_flipped and is_accumulating_diagonal_gates_)
+      end_diagonal_accumulation();
+
+    if (is_flipped and is_phase_flipped)
+    {
+      // X Z = -i Y
+      pauli_frame_phase_ *= ::ket::utility::minus_imaginary_unit<complex_type>();
+      do_pauli_y(physical(qubit));
+    }
+    else if (is_flipped)
+      do_pauli_x(physical(qubit));
+    else
+      do_pauli_z(ket::make_control(physical(qubit)));
+
+    pauli_frame_x_mask_ &= compl mask;
+    pauli_frame_z_mask_ &= compl mask;
+  }
+
+  auto state::apply_noise_to_qubit(qubit_type const qubit) -> void
+  {
+    auto const probability = generate_probability(qubit);
 
     if (probability < depolarizing_px_)
     {
       if (is_in_fusion_)
-        ::bra::set_found_qubits(found_qubits_, qubit);
+        ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-      do_pauli_x(qubit);
+      if (is_absorbing_paulis())
+        absorb_pauli_x(qubit);
+      else
+        do_pauli_x(physical(qubit));
       return;
     }
 
@@ -3349,18 +4539,32 @@ namespace bra
     if (probability < px_py)
     {
       if (is_in_fusion_)
-        ::bra::set_found_qubits(found_qubits_, qubit);
+        ::bra::set_found_qubits(found_qubits_, physical(qubit));
 
-      do_pauli_y(qubit);
+      if (is_absorbing_paulis())
+        absorb_pauli_y(qubit);
+      else
+        do_pauli_y(physical(qubit));
     }
     else if (probability < px_py + depolarizing_pz_)
     {
       if (is_in_fusion_)
-        ::bra::set_found_qubits(found_qubits_, ket::make_control(qubit));
+        ::bra::set_found_qubits(found_qubits_, ket::make_control(physical(qubit)));
 
-      do_pauli_z(ket::make_control(qubit));
+      if (is_absorbing_paulis())
+        absorb_pauli_z(qubit);
+      else
+        do_pauli_z(ket::make_control(physical(qubit)));
     }
   }
+
+  auto state::generate_probability(qubit_type const qubit) const -> real_type
+  {
+    using floating_point_type = typename ::bra::utility::closest_floating_point_of<real_type>::type;
+    return static_cast<real_type>(
+      ::bra::utility::philox_canonical<floating_point_type>(
+        static_cast<std::uint64_t>(static_cast<bit_integer_type>(qubit)), noise_gate_index_, static_cast<std::uint64_t>(noise_key_)));
+  }
 } // namespace bra
 
 
@@ -8,6 +8,7 @@
 #include <bra/gate/gate.hpp>
 #include <bra/gate/swap.hpp>
 #include <bra/state.hpp>
+#include <bra/bytecode.hpp>
 
 
 namespace bra
@@ -33,5 +34,15 @@ namespace bra
         << std::setw(parameter_width) << qubit2_;
       return repr_stream.str();
     }
+
+    bool swap::do_lower(::bra::instruction& instruction) const
+    {
+      instruction
+        = ::bra::instruction{
+            ::bra::opcode::swap, do_is_diagonal(),
+            {static_cast< ::bra::bit_integer_type >(qubit1_), static_cast< ::bra::bit_integer_type >(qubit2_)},
+            ::bra::real_type{}};
+      return true;
+    }
   } // namespace gate
 } // namespace bra
@@ -32,7 +32,6 @@
 # if defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
 #   include <ket/gate/utility/cache_aware_iterator.hpp>
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
-# include <ket/gate/utility/pauli_index_coeff.hpp>
 # include <ket/mpi/gate/gate.hpp>
 # include <ket/mpi/gate/identity.hpp>
 # include <ket/mpi/gate/hadamard.hpp>
@@ -54,6 +53,7 @@
 # include <ket/mpi/gate/toffoli.hpp>
 # include <ket/mpi/gate/projective_measurement.hpp>
 # include <ket/mpi/gate/clear.hpp>
+# include <ket/mpi/gate/diagonal.hpp>
 # include <ket/mpi/gate/set.hpp>
 # include <ket/mpi/all_spin_expectation_values.hpp>
 # include <ket/mpi/print_amplitudes.hpp>
@@ -70,8 +70,9 @@
 # include <bra/unit_mpi_state.hpp>
 # include <bra/state.hpp>
 # include <bra/types.hpp>
+# include <bra/compiled_pauli_string_space.hpp>
 # include <bra/fused_gate.hpp>
-# include <bra/utility/closest_floating_point_of.hpp>
+# include <bra/fused_gate/fused_unitary.hpp>
 
 namespace bra
 {
@@ -362,15 +363,16 @@ namespace bra
     ::bra::state::state_integer_type const initial_integer,
     yampi::communicator const& circuit_communicator, yampi::environment const& environment) const
   {
+    // Amplitudes are zero-filled in parallel so that pages are first touched by the threads applying gates to them
     auto result
       = data_type(
           ket::utility::integer_exp2<std::size_t>(num_local_qubits)
-            * ket::mpi::utility::policy::num_data_blocks(mpi_policy_, circuit_communicator, environment),
-          complex_type{0});
+            * ket::mpi::utility::policy::num_data_blocks(mpi_policy_, circuit_communicator, environment));
+    ket::utility::ranges::fill(parallel_policy_, result, complex_type{0});
 
     auto const rank_index
       = ket::mpi::utility::qubit_value_to_rank_index(
-          mpi_policy_, data_, ket::mpi::permutate_bits(permutation_, initial_integer),
+          mpi_policy_, result, ket::mpi::permutate_bits(permutation_, initial_integer),
           circuit_communicator, environment);
     if (circuit_communicator.rank(environment) == rank_index.first)
       result[rank_index.second] = complex_type{1};
@@ -378,27 +380,6 @@ namespace bra
     return result;
   }
 
-  auto unit_mpi_state::generate_probability() -> real_type
-  {
-    auto result = real_type{0};
-
-    using namespace yampi::literals::rank_literals;
-    if (circuit_communicator_.rank(environment_) == 0_r)
-    {
-      using floating_point_type = typename ::bra::utility::closest_floating_point_of<real_type>::type;
-      auto distribution = std::uniform_real_distribution<floating_point_type>{0.0, 1.0};
-
-      result
-        = uses_depolarizing_seed_
-          ? static_cast<real_type>(distribution(depolarizing_random_number_generator_))
-          : static_cast<real_type>(distribution(random_number_generator_));
-    }
-
-    yampi::broadcast(yampi::make_buffer(result), 0_r, circuit_communicator_, environment_);
-
-    return result;
-  }
-
   auto unit_mpi_state::do_send_real_variable(int const destination_circuit_index, std::string const& variable_name, int const num_elements) const -> void
   {
     if (destination_circuit_index == circuit_index_)
@@ -1780,12 +1761,12 @@ namespace bra
   {
     if (seed < 0)
       ket::mpi::generate_events(
-        mpi_policy_, ket::utility::policy::make_sequential(), // parallel_policy_,
+        mpi_policy_, parallel_policy_,
         generated_events_, data_, num_events, random_number_generator_, permutation_,
         circuit_communicator_, environment_);
     else
       ket::mpi::generate_events(
-        mpi_policy_, ket::utility::policy::make_sequential(), // parallel_policy_,
+        mpi_policy_, parallel_policy_,
         generated_events_, data_, num_events, random_number_generator_, static_cast<seed_type>(seed), permutation_,
         circuit_communicator_, environment_);
   }
@@ -1798,45 +1779,13 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     result_
       = ket::mpi::runtime::ranges::expectation_value(
           mpi_policy_, parallel_policy_,
           data_, permutation_, buffer_, circuit_communicator_, environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto index = ::bra::state_integer_type{0u}; index < last_index; ++index)
-            {
-              using std::begin;
-              using std::end;
-              auto const iter
-                = first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const other_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, index);
-                auto const other_iter
-                  = first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, other_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*iter) * (other_index_coeff.second * *other_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
   }
 
@@ -1885,6 +1834,8 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     if (std::isdigit(static_cast<unsigned char>(remote_circuit_index_or_all.front())))
     {
       remote_circuit_index = boost::lexical_cast<int>(remote_circuit_index_or_all);
@@ -1903,41 +1854,7 @@ namespace bra
         = ket::mpi::runtime::ranges::inner_product(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, 0_r, intercircuit_communicator_, environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
     else
@@ -1947,41 +1864,7 @@ namespace bra
         = ket::mpi::runtime::ranges::inner_product(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, intercommunicators_[index], environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
   }
@@ -2031,6 +1914,8 @@ namespace bra
     if (num_operated_qubits != pauli_string_space_element.num_qubits())
       throw ::bra::wrong_pauli_string_length_error{num_operated_qubits, pauli_string_space_element.num_qubits()};
 
+    auto const compiled_pauli_string_space_element = ::bra::compiled_pauli_string_space{pauli_string_space_element};
+
     if (std::isdigit(static_cast<unsigned char>(remote_circuit_index_or_all.front())))
     {
       remote_circuit_index = boost::lexical_cast<int>(remote_circuit_index_or_all);
@@ -2049,41 +1934,7 @@ namespace bra
         = ket::mpi::runtime::ranges::fidelity(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, 0_r, intercircuit_communicator_, environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
     else
@@ -2093,41 +1944,7 @@ namespace bra
         = ket::mpi::runtime::ranges::fidelity(
             mpi_policy_, parallel_policy_,
             data_, permutation_, buffer_, circuit_communicator_, intercommunicators_[index], environment_,
-          [&pauli_string_space_element, num_operated_qubits](
-            auto const ket_first, auto const bra_first, auto const index_wo_qubits,
-            auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_or_index_masks)
-          {
-            auto result = ::bra::complex_type{};
-
-            auto const last_index = (::bra::state_integer_type{1u} << num_operated_qubits);
-            for (auto bra_index = ::bra::state_integer_type{0u}; bra_index < last_index; ++bra_index)
-            {
-              using std::begin;
-              using std::end;
-              auto const bra_iter
-                = bra_first
-                  + ket::gate::utility::index_with_qubits(
-                      index_wo_qubits, bra_index,
-                      begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                      begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-              for (auto const& basis_scalar: pauli_string_space_element)
-              {
-                auto const ket_index_coeff = ket::gate::utility::pauli_index_coeff< ::bra::complex_type >(basis_scalar.first, bra_index);
-                auto const ket_iter
-                  = ket_first
-                    + ket::gate::utility::index_with_qubits(
-                        index_wo_qubits, ket_index_coeff.first,
-                        begin(unsorted_qubits_or_masks), end(unsorted_qubits_or_masks),
-                        begin(sorted_qubits_or_index_masks), end(sorted_qubits_or_index_masks));
-
-                using std::conj;
-                result += basis_scalar.second * (conj(*bra_iter) * (ket_index_coeff.second * *ket_iter));
-              }
-            }
-
-            return result;
-          },
+          compiled_pauli_string_space_element,
           operated_qubits);
     }
   }
@@ -2332,10 +2149,22 @@ namespace bra
           fused_gates_, cache_aware_fused_gates_, to_qubit_index_in_fused_gates};
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
 
-    ket::mpi::gate::runtime::ranges::gate(
-      mpi_policy_, parallel_policy_,
-      data_, permutation_, buffer_, circuit_communicator_, environment_,
-      call_fused_gates, fused_qubits, fused_control_qubits);
+    auto const num_operated_qubits = static_cast< ::bra::bit_integer_type >(fused_qubits.size() + fused_control_qubits.size());
+    if (::bra::fused_gate::is_fused_unitary_preferable(num_operated_qubits, fused_gates_.size()))
+    {
+      auto const fused_unitary
+        = ::bra::fused_gate::fused_unitary{
+            fused_gates_, num_operated_qubits, to_qubit_index_in_fused_gates, ket::utility::num_threads(parallel_policy_)};
+      ket::mpi::gate::runtime::ranges::gate(
+        mpi_policy_, parallel_policy_,
+        data_, permutation_, buffer_, circuit_communicator_, environment_,
+        ::bra::fused_gate::make_fused_unitary_caller(fused_unitary, call_fused_gates), fused_qubits, fused_control_qubits);
+    }
+    else
+      ket::mpi::gate::runtime::ranges::gate(
+        mpi_policy_, parallel_policy_,
+        data_, permutation_, buffer_, circuit_communicator_, environment_,
+        call_fused_gates, fused_qubits, fused_control_qubits);
 
     fused_gates_.clear();
 # if defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
@@ -2343,6 +2172,13 @@ namespace bra
 # endif // defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION) && !defined(KET_USE_ON_CACHE_STATE_VECTOR)
   }
 
+  void unit_mpi_state::do_diagonal(::ket::gate::diagonal_accumulator<complex_type, state_integer_type> const& accumulator)
+  {
+    ket::mpi::gate::diagonal(
+      mpi_policy_, parallel_policy_,
+      data_, permutation_, circuit_communicator_, environment_, accumulator);
+  }
+
   void unit_mpi_state::do_clear(qubit_type const qubit)
   {
     ket::mpi::gate::clear(
@@ -2357,6 +2193,9 @@ namespace bra
       data_, permutation_, buffer_, circuit_communicator_, environment_, qubit);
   }
 
+  auto unit_mpi_state::do_local_amplitude_ranges() -> std::vector<std::pair<complex_type*, std::size_t>>
+  { return {std::make_pair(data_.data(), data_.size())}; }
+
   void unit_mpi_state::do_controlled_i_gate(
     qubit_type const target_qubit, control_qubit_type const control_qubit)
   {
@@ -0,0 +1,166 @@
+// Tests bra::fused_gate::fused_unitary: a dense unitary of fused gates gives the same state as the gates applied one by one,
+// for a fusion of diagonal gates and a fusion including non-diagonal gates.
+// It is linked with src/fused_unitary.cpp, src/fused_gate.cpp and src/fused_<gate>.cpp of the fused gates below (BRA_NO_MPI is required)
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/control.hpp>
+#include <ket/gate/gate.hpp>
+#include <ket/gate/hadamard.hpp>
+#include <ket/gate/pauli_x.hpp>
+#include <ket/gate/pauli_z.hpp>
+#include <ket/gate/exponential_pauli_z.hpp>
+#include <ket/gate/phase_shift.hpp>
+#include <ket/utility/exp_i.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+#include <bra/types.hpp>
+#include <bra/fused_gate/fused_gate.hpp>
+#include <bra/fused_gate/fused_hadamard.hpp>
+#include <bra/fused_gate/fused_controlled_not.hpp>
+#include <bra/fused_gate/fused_controlled_phase_shift.hpp>
+#include <bra/fused_gate/fused_pauli_zz.hpp>
+#include <bra/fused_gate/fused_exponential_pauli_z.hpp>
+#include <bra/fused_gate/fused_unitary.hpp>
+
+namespace
+{
+  using fused_gate_type = bra::fused_gate::fused_gate<bra::data_type::iterator>;
+  using fused_gates_type = std::vector<std::unique_ptr<fused_gate_type>>;
+
+  constexpr auto num_qubits = bra::bit_integer_type{6u};
+
+  auto initial_state() -> bra::data_type
+  {
+    auto result = bra::data_type(bra::state_integer_type{1u} << num_qubits);
+    for (auto index = std::size_t{0u}; index < result.size(); ++index)
+      result[index] = bra::complex_type{
+        0.125 * static_cast<bra::real_type>(index % 11u + 1u),
+        -0.0625 * static_cast<bra::real_type>((index * 3u + 1u) % 7u)};
+    return result;
+  }
+
+  auto max_error(bra::data_type const& lhs, bra::data_type const& rhs) -> bra::real_type
+  {
+    auto result = bra::real_type{0};
+    for (auto index = std::size_t{0u}; index < lhs.size(); ++index)
+      result = std::max(result, std::abs(lhs[index] - rhs[index]));
+    return result;
+  }
+
+  // operated_qubits are given in the order of fused qubits, and they need not be sorted
+  template <typename ParallelPolicy, typename ReferenceOperation>
+  auto run_case(
+    std::string const& name, ParallelPolicy const parallel_policy,
+    fused_gates_type const& fused_gates, std::vector<bra::qubit_type> const& operated_qubits,
+    ReferenceOperation const& reference_operation)
+  -> bool
+  {
+    auto to_qubit_index_in_fused_gates = std::vector<bra::bit_integer_type>(num_qubits);
+    std::iota(to_qubit_index_in_fused_gates.begin(), to_qubit_index_in_fused_gates.end(), bra::bit_integer_type{0u});
+    for (auto index = bra::bit_integer_type{0u}; index < operated_qubits.size(); ++index)
+      to_qubit_index_in_fused_gates[static_cast<bra::bit_integer_type>(operated_qubits[index])] = index;
+
+    auto const fused_unitary
+      = bra::fused_gate::fused_unitary{
+          fused_gates, static_cast<bra::bit_integer_type>(operated_qubits.size()), to_qubit_index_in_fused_gates,
+          ket::utility::num_threads(parallel_policy)};
+
+    auto state = initial_state();
+    ket::gate::runtime::ranges::gate(
+      parallel_policy, state,
+      [&fused_unitary](
+        bra::data_type::iterator const first, bra::state_integer_type const index_wo_qubits,
+        auto const& unsorted_fused_qubits_or_masks, auto const& sorted_fused_qubits_with_sentinel_or_index_masks,
+        int const thread_index)
+      {
+        fused_unitary.call(
+          first, index_wo_qubits, unsorted_fused_qubits_or_masks, sorted_fused_qubits_with_sentinel_or_index_masks, thread_index);
+      },
+      operated_qubits);
+
+    auto reference_state = initial_state();
+    reference_operation(reference_state);
+
+    auto const error = max_error(state, reference_state);
+    if (error < bra::real_type{1e-12})
+      return true;
+
+    std::cerr << name << " failed: max error = " << error << '\n';
+    return false;
+  }
+
+  template <typename ParallelPolicy>
+  auto run_diagonal_case(std::string const& name, ParallelPolicy const parallel_policy) -> bool
+  {
+    using namespace ket::literals::qubit_literals;
+    using namespace ket::literals::control_literals;
+
+    auto const phase_coefficient = ket::utility::exp_i<bra::complex_type>(bra::real_type{0.375});
+    auto fused_gates = fused_gates_type{};
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_exponential_pauli_z<bra::data_type::iterator>>(bra::real_type{0.25}, 4_q));
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_controlled_phase_shift<bra::data_type::iterator>>(phase_coefficient, 1_cq, 3_cq));
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_pauli_zz<bra::data_type::iterator>>(4_q, 1_q));
+
+    return run_case(
+      name, parallel_policy, fused_gates, std::vector<bra::qubit_type>{4_q, 1_q, 3_q},
+      [parallel_policy, phase_coefficient](bra::data_type& state)
+      {
+        ket::gate::ranges::exponential_pauli_z(parallel_policy, state, bra::real_type{0.25}, 4_q);
+        ket::gate::ranges::phase_shift_coeff(parallel_policy, state, phase_coefficient, 1_cq, 3_cq);
+        ket::gate::ranges::pauli_z(parallel_policy, state, 4_q, 1_q);
+      });
+  }
+
+  template <typename ParallelPolicy>
+  auto run_nondiagonal_case(std::string const& name, ParallelPolicy const parallel_policy) -> bool
+  {
+    using namespace ket::literals::qubit_literals;
+    using namespace ket::literals::control_literals;
+
+    auto fused_gates = fused_gates_type{};
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_hadamard<bra::data_type::iterator>>(5_q));
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_controlled_not<bra::data_type::iterator>>(0_q, 5_cq));
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_exponential_pauli_z<bra::data_type::iterator>>(bra::real_type{0.5}, 0_q));
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_hadamard<bra::data_type::iterator>>(2_q));
+    fused_gates.push_back(std::make_unique<bra::fused_gate::fused_controlled_not<bra::data_type::iterator>>(5_q, 2_cq));
+
+    return run_case(
+      name, parallel_policy, fused_gates, std::vector<bra::qubit_type>{5_q, 0_q, 2_q},
+      [parallel_policy](bra::data_type& state)
+      {
+        ket::gate::ranges::hadamard(parallel_policy, state, 5_q);
+        ket::gate::ranges::pauli_x(parallel_policy, state, 0_q, 5_cq);
+        ket::gate::ranges::exponential_pauli_z(parallel_policy, state, bra::real_type{0.5}, 0_q);
+        ket::gate::ranges::hadamard(parallel_policy, state, 2_q);
+        ket::gate::ranges::pauli_x(parallel_policy, state, 5_q, 2_cq);
+      });
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  run(run_diagonal_case("sequential, diagonal", sequential));
+  run(run_diagonal_case("parallel, diagonal", parallel));
+  run(run_nondiagonal_case("sequential, non-diagonal", sequential));
+  run(run_nondiagonal_case("parallel, non-diagonal", parallel));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "fused unitary tests passed\n";
+  return EXIT_SUCCESS;
+}
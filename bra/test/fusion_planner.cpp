@@ -0,0 +1,71 @@
+// Tests bra::interpreter::plan_fusion: a realistic run of gates on a few qubits is put into a gate fusion block,
+// and a run too short to pay for the fused unitary is left as it is.
+// It is linked with src/*.cpp except for src/bra.cpp and the MPI versions (BRA_NO_MPI is required)
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <bra/types.hpp>
+#include <bra/interpreter.hpp>
+#include <bra/fused_gate/fused_unitary.hpp>
+
+namespace
+{
+  auto check(bool const condition, std::string const& message, bool& failed) -> void
+  {
+    if (condition)
+      return;
+
+    std::cerr << "failed: " << message << '\n';
+    failed = true;
+  }
+
+  auto gate_names(bra::interpreter const& interpreter) -> std::vector<std::string>
+  {
+    auto result = std::vector<std::string>{};
+    for (auto const& gate: interpreter.circuit(0))
+      result.push_back(gate->name());
+    return result;
+  }
+
+  // two layers of a hardware-efficient ansatz on qubits 0, 1 and 2 (12 gates), followed by three gates on qubits 3, 4 and 5
+  auto const circuit =
+    "QUBITS 6\n"
+    "H 0\nH 1\nH 2\n"
+    "CNOT 1 0\nCNOT 2 1\n"
+    "EZ 0 0.25\nEZ 1 0.5\nEZ 2 0.75\n"
+    "CZ 0 2\n"
+    "H 0\nH 1\nH 2\n"
+    "H 3\nCNOT 4 3\nCZ 5 4\n";
+}
+
+int main()
+{
+  auto failed = false;
+
+  check(bra::fused_gate::is_fusion_preferable(3u, 12u), "the cost model prefers fusion of 12 gates on 3 qubits", failed);
+  check(not bra::fused_gate::is_fusion_preferable(3u, 3u), "the cost model does not prefer fusion of 3 gates on 3 qubits", failed);
+
+  auto input_stream = std::istringstream{circuit};
+  auto interpreter = bra::interpreter{input_stream};
+  interpreter.plan_fusion(3u);
+
+  auto const names = gate_names(interpreter);
+  check(names.size() == 17u, "BEGIN FUSION and END FUSION are added", failed);
+  check(names.size() > 13u and names[0u] == "BEGIN FUSION" and names[13u] == "END FUSION", "the 12 gates are fused", failed);
+  check(
+    names.size() == 17u and names[14u] == "H" and names[15u] != "END FUSION" and names[16u] != "END FUSION",
+    "the last 3 gates are not fused", failed);
+
+  auto const& operated_qubits = interpreter.operated_qubits(0);
+  check(operated_qubits.size() > 13u and operated_qubits[13u].size() == 3u, "the fused block operates 3 qubits", failed);
+  check(interpreter.largest_num_operated_qubits() == 3u, "the largest number of operated qubits is that of the block", failed);
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "fusion planner tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+// Measures the time per gate (the fastest of num_repetitions sweeps over all qubits) of ket::gate::* kernels running on ket::utility::loop_n with OpenMP.
+// Compare the fast paths of loop_n with the exception-catching loop:
+//   g++ -std=c++14 -O3 -march=native -fopenmp -DNDEBUG -DKET_USE_OPENMP -Iket/include ket/benchmark/loop_n_gates.cpp -o loop_n_gates
+//   g++ -std=c++14 -O3 -march=native -fopenmp -DNDEBUG -DKET_USE_OPENMP -DKET_CATCH_EXCEPTIONS_IN_LOOP_N -Iket/include ket/benchmark/loop_n_gates.cpp -o loop_n_gates_catch
+// Usage: loop_n_gates [num_qubits=22] [num_repetitions=20]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/control.hpp>
+#include <ket/gate/hadamard.hpp>
+#include <ket/gate/pauli_x.hpp>
+#include <ket/gate/pauli_z.hpp>
+#include <ket/gate/phase_shift.hpp>
+#include <ket/gate/controlled_phase_shift.hpp>
+#include <ket/gate/exponential_pauli_x.hpp>
+#include <ket/gate/controlled_not.hpp>
+#include <ket/gate/swap.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+
+  template <typename Gate>
+  auto measure(
+    std::string const& name, bit_integer_type const num_qubits, int const num_repetitions, Gate&& gate)
+  -> void
+  {
+    // warm up
+    gate(ket::make_qubit<state_integer_type>(bit_integer_type{0u}), ket::make_qubit<state_integer_type>(bit_integer_type{1u}));
+
+    // the fastest sweep over all qubits is taken to suppress noise
+    auto time_per_gate = std::numeric_limits<double>::max();
+    for (auto repetition = 0; repetition < num_repetitions; ++repetition)
+    {
+      auto const first_time = std::chrono::steady_clock::now();
+      for (auto bit = bit_integer_type{0u}; bit < num_qubits; ++bit)
+        gate(
+          ket::make_qubit<state_integer_type>(bit),
+          ket::make_qubit<state_integer_type>((bit + bit_integer_type{1u}) % num_qubits));
+      auto const last_time = std::chrono::steady_clock::now();
+
+      time_per_gate
+        = std::min(
+            time_per_gate,
+            std::chrono::duration<double, std::micro>(last_time - first_time).count() / static_cast<double>(num_qubits));
+    }
+
+    std::cout << std::setw(24) << std::left << name << std::fixed << std::setprecision(3) << time_per_gate << " us/gate\n";
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  auto const num_qubits = argc > 1 ? static_cast<bit_integer_type>(std::atoi(argv[1])) : bit_integer_type{22u};
+  auto const num_repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  auto const parallel_policy = ket::utility::policy::make_parallel<int>();
+  auto state = std::vector<complex_type>(state_integer_type{1u} << num_qubits, complex_type{1.0 / std::sqrt(static_cast<double>(state_integer_type{1u} << num_qubits))});
+
+#ifdef KET_CATCH_EXCEPTIONS_IN_LOOP_N
+  std::cout << "loop_n: catching exceptions in each iteration\n";
+#else
+  std::cout << "loop_n: fast paths\n";
+#endif
+  std::cout << num_qubits << " qubits, " << ket::utility::num_threads(parallel_policy) << " threads\n";
+
+  measure(
+    "hadamard", num_qubits, num_repetitions,
+    [&](qubit_type const qubit, qubit_type const) { ket::gate::ranges::hadamard(parallel_policy, state, qubit); });
+  measure(
+    "pauli_x", num_qubits, num_repetitions,
+    [&](qubit_type const qubit, qubit_type const) { ket::gate::ranges::pauli_x(parallel_policy, state, qubit); });
+  measure(
+    "pauli_z", num_qubits, num_repetitions,
+    [&](qubit_type const qubit, qubit_type const) { ket::gate::ranges::pauli_z(parallel_policy, state, qubit); });
+  measure(
+    "exponential_pauli_x", num_qubits, num_repetitions,
+    [&](qubit_type const qubit, qubit_type const) { ket::gate::ranges::exponential_pauli_x(parallel_policy, state, 0.1, qubit); });
+  measure(
+    "controlled_phase_shift", num_qubits, num_repetitions,
+    [&](qubit_type const target_qubit, qubit_type const control_qubit)
+    { ket::gate::ranges::controlled_phase_shift(parallel_policy, state, 0.1, target_qubit, ket::make_control(control_qubit)); });
+  measure(
+    "controlled_not", num_qubits, num_repetitions,
+    [&](qubit_type const target_qubit, qubit_type const control_qubit)
+    { ket::gate::ranges::controlled_not(parallel_policy, state, target_qubit, ket::make_control(control_qubit)); });
+  measure(
+    "swap", num_qubits, num_repetitions,
+    [&](qubit_type const qubit1, qubit_type const qubit2) { ket::gate::ranges::swap(parallel_policy, state, qubit1, qubit2); });
+
+  return EXIT_SUCCESS;
+}
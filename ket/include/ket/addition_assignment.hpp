@@ -3,15 +3,18 @@
 
 # include <cassert>
 # include <cstddef>
+# include <complex>
 # include <vector>
 # include <iterator>
+# include <algorithm>
 # include <type_traits>
 
 # include <ket/control.hpp>
 # include <ket/swapped_fourier_transform.hpp>
-# include <ket/gate/controlled_phase_shift.hpp>
+# include <ket/gate/diagonal.hpp>
 # include <ket/meta/state_integer_of.hpp>
 # include <ket/meta/bit_integer_of.hpp>
+# include <ket/utility/integer_exp2.hpp>
 # include <ket/utility/generate_phase_coefficients.hpp>
 # include <ket/utility/meta/ranges.hpp>
 
@@ -21,36 +24,56 @@ namespace ket
   // lhs += rhs
   namespace addition_assignment_detail
   {
+    // Controlled phase shifts of the adder in the Fourier space: CU1(2 pi / 2^k) with targets lhs[c + k - 1] and controls rhs[c],
+    // which are added to accumulator with conjugated coefficients if is_adjoint
     template <
-      typename ParallelPolicy,
-      typename RandomAccessIterator, typename Iterator1, typename Iterator2,
+      typename Complex, typename StateInteger, typename Iterator1, typename Iterator2,
       typename BitInteger, typename PhaseCoefficientsAllocator>
-    inline auto addition_assignment(
-      ParallelPolicy const parallel_policy,
-      RandomAccessIterator const first, RandomAccessIterator const last,
+    inline auto accumulate_phases(
+      ::ket::gate::diagonal_accumulator<Complex, StateInteger>& accumulator,
       Iterator1 const& lhs_qubits_first, Iterator2 const& rhs_qubits_first, BitInteger const register_size,
-      std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type, PhaseCoefficientsAllocator> const& phase_coefficients)
+      std::vector<Complex, PhaseCoefficientsAllocator> const& phase_coefficients, bool const is_adjoint)
     -> void
     {
-      static_assert(std::is_unsigned<BitInteger>::value, "BitInteger should be unsigned");
-
+      using std::conj;
       for (auto phase_exponent = BitInteger{1u}; phase_exponent <= register_size; ++phase_exponent)
       {
-        auto const phase_coefficient = phase_coefficients[phase_exponent];
+        auto const phase_coefficient = is_adjoint ? conj(phase_coefficients[phase_exponent]) : phase_coefficients[phase_exponent];
 
         for (auto control_bit_index = BitInteger{0u};
              control_bit_index <= register_size - phase_exponent; ++control_bit_index)
         {
           auto const target_bit_index = control_bit_index + (phase_exponent - BitInteger{1u});
 
-          ::ket::gate::controlled_phase_shift_coeff(
-            parallel_policy,
-            first, last, phase_coefficient,
-            lhs_qubits_first[target_bit_index],
-            ::ket::make_control(rhs_qubits_first[control_bit_index]));
+          accumulator.add_phase(
+            phase_coefficient,
+            ::ket::utility::integer_exp2<StateInteger>(lhs_qubits_first[target_bit_index])
+            bitor ::ket::utility::integer_exp2<StateInteger>(rhs_qubits_first[control_bit_index]));
         }
       }
     }
+
+    template <
+      typename ParallelPolicy,
+      typename RandomAccessIterator, typename Iterator1, typename Iterator2,
+      typename BitInteger, typename PhaseCoefficientsAllocator>
+    inline auto addition_assignment(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Iterator1 const& lhs_qubits_first, Iterator2 const& rhs_qubits_first, BitInteger const register_size,
+      std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type, PhaseCoefficientsAllocator> const& phase_coefficients)
+    -> void
+    {
+      static_assert(std::is_unsigned<BitInteger>::value, "BitInteger should be unsigned");
+      using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+      using state_integer_type = ::ket::meta::state_integer_t<std::remove_cv_t<std::remove_reference_t<decltype(*lhs_qubits_first)>>>;
+
+      // All controlled phase shifts are applied in one sweep
+      auto accumulator = ::ket::gate::diagonal_accumulator<complex_type, state_integer_type>{};
+      ::ket::addition_assignment_detail::accumulate_phases(
+        accumulator, lhs_qubits_first, rhs_qubits_first, register_size, phase_coefficients, false);
+      ::ket::gate::diagonal(parallel_policy, first, last, accumulator);
+    }
   } // namespace addition_assignment_detail
 
 
@@ -200,26 +223,17 @@ namespace ket
       RandomAccessIterator const first, RandomAccessIterator const last,
       Iterator1 const& lhs_qubits_first, Iterator2 const& rhs_qubits_first,
       BitInteger const register_size,
-      std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator > const& phase_coefficients)
+      std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type, PhaseCoefficientsAllocator> const& phase_coefficients)
     -> void
     {
-      for (auto index = BitInteger{0u}; index < register_size; ++index)
-      {
-        auto const phase_exponent = register_size - index;
-        auto const phase_coefficient = phase_coefficients[phase_exponent];
-
-        for (auto control_bit_index = BitInteger{0u};
-             control_bit_index <= register_size - phase_exponent; ++control_bit_index)
-        {
-          auto const target_bit_index = control_bit_index + (phase_exponent - BitInteger{1u});
+      static_assert(std::is_unsigned<BitInteger>::value, "BitInteger should be unsigned");
+      using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+      using state_integer_type = ::ket::meta::state_integer_t<std::remove_cv_t<std::remove_reference_t<decltype(*lhs_qubits_first)>>>;
 
-          ::ket::gate::adj_controlled_phase_shift_coeff(
-            parallel_policy,
-            first, last, phase_coefficient,
-            lhs_qubits_first[target_bit_index],
-            ::ket::make_control(rhs_qubits_first[control_bit_index]));
-        }
-      }
+      auto accumulator = ::ket::gate::diagonal_accumulator<complex_type, state_integer_type>{};
+      ::ket::addition_assignment_detail::accumulate_phases(
+        accumulator, lhs_qubits_first, rhs_qubits_first, register_size, phase_coefficients, true);
+      ::ket::gate::diagonal(parallel_policy, first, last, accumulator);
     }
   } // namespace addition_assignment_detail
 
@@ -231,7 +245,7 @@ namespace ket
   inline void adj_addition_assignment(
     ParallelPolicy const parallel_policy, RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
-    std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator>& phase_coefficients)
+    std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type, PhaseCoefficientsAllocator>& phase_coefficients)
   {
     using bit_integer_type = ::ket::meta::bit_integer_t< ::ket::utility::meta::range_value_t<Qubits> >;
     static_assert(std::is_unsigned< ::ket::meta::state_integer_t< ::ket::utility::meta::range_value_t<Qubits> > >::value, "StateInteger should be unsigned");
@@ -265,7 +279,7 @@ namespace ket
   adj_addition_assignment(
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
-    std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator>& phase_coefficients)
+    std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type, PhaseCoefficientsAllocator>& phase_coefficients)
   {
     ::ket::adj_addition_assignment(
       ::ket::utility::policy::make_sequential(),
@@ -318,7 +332,7 @@ namespace ket
       return state;
     }
 
-    template <typename RandomAccessRange, typename Qubits, typename QubitsRange>
+    template <typename RandomAccessRange, typename Qubits, typename QubitsRange, typename PhaseCoefficientsAllocator>
     inline std::enable_if_t<not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value, RandomAccessRange&>
     adj_addition_assignment(
       RandomAccessRange& state, Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
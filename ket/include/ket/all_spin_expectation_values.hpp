@@ -2,41 +2,225 @@
 # define KET_ALL_EXPECTATION_VALUES_HPP
 
 # include <cassert>
+# include <cstddef>
 # include <vector>
 # include <array>
+# include <algorithm>
 # include <iterator>
 
-# include <ket/spin_expectation_value.hpp>
+# include <boost/math/constants/constants.hpp>
+
 # include <ket/meta/bit_integer_of.hpp>
+# include <ket/meta/state_integer_of.hpp>
+# include <ket/utility/loop_n.hpp>
 # include <ket/utility/integer_log2.hpp>
-# ifndef NDEBUG
-#   include <ket/utility/integer_exp2.hpp>
-# endif
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/num_on_cache_qubits.hpp>
 # include <ket/utility/meta/real_of.hpp>
 # include <ket/utility/meta/ranges.hpp>
 
 
 namespace ket
 {
+  namespace all_spin_expectation_values_detail
+  {
+    using hd_spin_type = std::array<long double, 3u>;
+
+    // Number of qubits of contiguous amplitudes which are copied into a tile at once
+    constexpr auto num_chunk_qubits = 3u;
+
+    // conj(zero_value) * one_value and |zero_value|^2 - |one_value|^2 are written by hand to let compilers vectorize loops
+    template <typename Complex, typename Real>
+    inline auto accumulate_pair(
+      Complex const& zero_value, Complex const& one_value,
+      Real& real_sum, Real& imag_sum, Real& norm_difference_sum)
+    -> void
+    {
+      using std::real;
+      using std::imag;
+      auto const zero_real = real(zero_value);
+      auto const zero_imag = imag(zero_value);
+      auto const one_real = real(one_value);
+      auto const one_imag = imag(one_value);
+      real_sum += zero_real * one_real + zero_imag * one_imag;
+      imag_sum += zero_real * one_imag - zero_imag * one_real;
+      norm_difference_sum += (zero_real * zero_real + zero_imag * zero_imag) - (one_real * one_real + one_imag * one_imag);
+    }
+
+    // Spins of tile qubits first_tile_qubit, ..., num_tile_qubits - 1 are added to spins_first[first_tile_qubit], ..., spins_first[num_tile_qubits - 1].
+    // Because all amplitudes in a tile are on cache, the number of tile qubits does not change memory traffic.
+    template <typename RandomAccessIterator, typename BitInteger, typename HdSpinIterator>
+    inline auto accumulate_tile_spins(
+      RandomAccessIterator const tile_first, BitInteger const num_tile_qubits, BitInteger const first_tile_qubit,
+      HdSpinIterator const spins_first)
+    -> void
+    {
+      using real_type = ::ket::utility::meta::real_t<typename std::iterator_traits<RandomAccessIterator>::value_type>;
+      auto const tile_size = std::size_t{1u} << num_tile_qubits;
+
+      for (auto tile_qubit = first_tile_qubit; tile_qubit < num_tile_qubits; ++tile_qubit)
+      {
+        auto const qubit_mask = std::size_t{1u} << tile_qubit;
+
+        // Independent partial sums are used in lanes to hide latencies of additions
+        constexpr auto num_lanes = std::size_t{4u};
+        auto real_sums = std::array<real_type, num_lanes>{};
+        auto imag_sums = std::array<real_type, num_lanes>{};
+        auto norm_difference_sums = std::array<real_type, num_lanes>{};
+        if (qubit_mask >= num_lanes)
+        {
+          for (auto upper_index = std::size_t{0u}; upper_index < tile_size; upper_index += qubit_mask << 1u)
+            for (auto zero_index = upper_index, last_zero_index = upper_index + qubit_mask; zero_index < last_zero_index; zero_index += num_lanes)
+              for (auto lane = std::size_t{0u}; lane < num_lanes; ++lane)
+                ::ket::all_spin_expectation_values_detail::accumulate_pair(
+                  tile_first[zero_index + lane], tile_first[zero_index + lane + qubit_mask],
+                  real_sums[lane], imag_sums[lane], norm_difference_sums[lane]);
+        }
+        else
+        {
+          for (auto upper_index = std::size_t{0u}; upper_index < tile_size; upper_index += qubit_mask << 1u)
+            for (auto zero_index = upper_index, last_zero_index = upper_index + qubit_mask; zero_index < last_zero_index; ++zero_index)
+              ::ket::all_spin_expectation_values_detail::accumulate_pair(
+                tile_first[zero_index], tile_first[zero_index + qubit_mask],
+                real_sums[0u], imag_sums[0u], norm_difference_sums[0u]);
+        }
+
+        auto& spin = spins_first[tile_qubit];
+        for (auto lane = std::size_t{0u}; lane < num_lanes; ++lane)
+        {
+          spin[0u] += static_cast<long double>(real_sums[lane]);
+          spin[1u] += static_cast<long double>(imag_sums[lane]);
+          spin[2u] += static_cast<long double>(norm_difference_sums[lane]);
+        }
+      }
+    }
+
+    // Spins (whose Z components are not halved) of all qubits are added to spins_in_threads.
+    // locate(index) returns an iterator pointing the amplitude of index, and amplitudes of
+    // index, index + 1, ..., index + 2^num_contiguous_qubits - 1 must be contiguous if index is a multiple of 2^num_contiguous_qubits.
+    // The first sweep deals with qubits in contiguous tiles, and each of later sweeps gathers chunks of amplitudes into a tile to deal with upper qubits.
+    // Therefore the number of sweeps is about num_qubits / ::ket::utility::num_on_cache_qubits() instead of num_qubits.
+    template <typename StateInteger, typename ParallelPolicy, typename BitInteger, typename Locate>
+    inline auto accumulate_spins(
+      ParallelPolicy const parallel_policy, BitInteger const num_qubits, BitInteger const num_contiguous_qubits,
+      Locate locate, std::vector<std::vector<hd_spin_type>>& spins_in_threads)
+    -> void
+    {
+      assert(num_contiguous_qubits <= num_qubits);
+      assert(spins_in_threads.size() == static_cast<std::size_t>(::ket::utility::num_threads(parallel_policy)));
+
+      auto num_tile_qubits = std::min(::ket::utility::num_on_cache_qubits<BitInteger>(), num_contiguous_qubits);
+      // Keep enough tiles to make all threads busy
+      auto const min_num_tiles = StateInteger{4u} * static_cast<StateInteger>(::ket::utility::num_threads(parallel_policy));
+      while (num_tile_qubits > BitInteger{num_chunk_qubits + 1u}
+             and ::ket::utility::integer_exp2<StateInteger>(num_qubits - num_tile_qubits) < min_num_tiles)
+        --num_tile_qubits;
+
+      ::ket::utility::loop_n(
+        parallel_policy, ::ket::utility::integer_exp2<StateInteger>(num_qubits - num_tile_qubits),
+        [&locate, &spins_in_threads, num_tile_qubits](StateInteger const tile_index, int const thread_index)
+        {
+          using std::begin;
+          ::ket::all_spin_expectation_values_detail::accumulate_tile_spins(
+            locate(tile_index << num_tile_qubits), num_tile_qubits, BitInteger{0u}, begin(spins_in_threads[thread_index]));
+        });
+
+      if (num_tile_qubits == num_qubits)
+        return;
+
+      using complex_type = typename std::iterator_traits<decltype(locate(StateInteger{0u}))>::value_type;
+      auto tiles = std::vector<complex_type>(spins_in_threads.size() << num_tile_qubits);
+
+      auto const chunk_qubits = std::min(BitInteger{num_chunk_qubits}, static_cast<BitInteger>(num_tile_qubits - BitInteger{1u}));
+      auto const chunk_size = ::ket::utility::integer_exp2<StateInteger>(chunk_qubits);
+      auto const max_num_new_qubits = static_cast<BitInteger>(num_tile_qubits - chunk_qubits);
+      for (auto first_new_qubit = num_tile_qubits; first_new_qubit < num_qubits; first_new_qubit += max_num_new_qubits)
+      {
+        // Tile qubits are chunk qubits (0, ..., chunk_qubits - 1) and new qubits (first_new_qubit, ..., first_new_qubit + num_new_qubits - 1)
+        auto const num_new_qubits = std::min(max_num_new_qubits, static_cast<BitInteger>(num_qubits - first_new_qubit));
+        auto const num_pass_tile_qubits = static_cast<BitInteger>(chunk_qubits + num_new_qubits);
+        auto const lower_tile_index_mask = ::ket::utility::integer_exp2<StateInteger>(first_new_qubit - chunk_qubits) - StateInteger{1u};
+        auto const upper_tile_index_mask = compl lower_tile_index_mask;
+        auto const num_chunks = ::ket::utility::integer_exp2<StateInteger>(num_new_qubits);
+
+        ::ket::utility::loop_n(
+          parallel_policy, ::ket::utility::integer_exp2<StateInteger>(num_qubits - num_pass_tile_qubits),
+          [&locate, &spins_in_threads, &tiles, num_tile_qubits, chunk_qubits, chunk_size, first_new_qubit,
+           num_pass_tile_qubits, lower_tile_index_mask, upper_tile_index_mask, num_chunks](
+            StateInteger const tile_index, int const thread_index)
+          {
+            auto const first_index
+              = ((tile_index bitand lower_tile_index_mask) << chunk_qubits)
+                bitor ((tile_index bitand upper_tile_index_mask) << num_pass_tile_qubits);
+
+            using std::begin;
+            auto const tile_first = begin(tiles) + (static_cast<StateInteger>(thread_index) << num_tile_qubits);
+            for (auto chunk_index = StateInteger{0u}; chunk_index < num_chunks; ++chunk_index)
+              std::copy_n(
+                locate(first_index bitor (chunk_index << first_new_qubit)), chunk_size,
+                tile_first + (chunk_index << chunk_qubits));
+
+            ::ket::all_spin_expectation_values_detail::accumulate_tile_spins(
+              tile_first, num_pass_tile_qubits, chunk_qubits,
+              begin(spins_in_threads[thread_index]) + (first_new_qubit - chunk_qubits));
+          });
+      }
+    }
+
+    template <typename Real, typename SpinsAllocator>
+    inline auto reduce_spins_in_threads(
+      std::vector<std::vector<hd_spin_type>> const& spins_in_threads,
+      std::vector<std::array<Real, 3u>, SpinsAllocator>& result)
+    -> void
+    {
+      assert(not spins_in_threads.empty());
+      auto const num_qubits = spins_in_threads.front().size();
+
+      result.clear();
+      result.reserve(num_qubits);
+      for (auto qubit = std::size_t{0u}; qubit < num_qubits; ++qubit)
+      {
+        auto hd_spin = hd_spin_type{};
+        for (auto const& spins: spins_in_threads)
+        {
+          hd_spin[0u] += spins[qubit][0u];
+          hd_spin[1u] += spins[qubit][1u];
+          hd_spin[2u] += spins[qubit][2u];
+        }
+
+        using boost::math::constants::half;
+        result.push_back(
+          std::array<Real, 3u>{
+            static_cast<Real>(hd_spin[0u]), static_cast<Real>(hd_spin[1u]),
+            static_cast<Real>(hd_spin[2u]) * half<Real>()});
+      }
+    }
+  } // namespace all_spin_expectation_values_detail
+
   template <typename Qubit, typename ParallelPolicy, typename RandomAccessIterator>
   inline auto all_spin_expectation_values(ParallelPolicy const parallel_policy, RandomAccessIterator const first, RandomAccessIterator const last)
   -> std::vector<std::array< ::ket::utility::meta::real_t<typename std::iterator_traits<RandomAccessIterator>::value_type>, 3u >>
   {
     using bit_integer_type = ::ket::meta::bit_integer_t<Qubit>;
+    using state_integer_type = ::ket::meta::state_integer_t<Qubit>;
     auto const num_qubits = ::ket::utility::integer_log2<bit_integer_type>(last - first);
     assert(
-      ::ket::utility::integer_exp2<bit_integer_type>(num_qubits)
-        == static_cast<bit_integer_type>(last - first));
+      ::ket::utility::integer_exp2<state_integer_type>(num_qubits)
+        == static_cast<state_integer_type>(last - first));
+
+    using hd_spin_type = ::ket::all_spin_expectation_values_detail::hd_spin_type;
+    auto spins_in_threads
+      = std::vector<std::vector<hd_spin_type>>(
+          ::ket::utility::num_threads(parallel_policy), std::vector<hd_spin_type>(num_qubits, hd_spin_type{}));
+    ::ket::all_spin_expectation_values_detail::accumulate_spins<state_integer_type>(
+      parallel_policy, num_qubits, num_qubits,
+      [first](state_integer_type const index) { return first + index; }, spins_in_threads);
 
     using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
     using real_type = ::ket::utility::meta::real_t<complex_type>;
     using spin_type = std::array<real_type, 3u>;
     auto result = std::vector<spin_type>{};
-    result.reserve(num_qubits);
-
-    auto const last_qubit = Qubit{num_qubits};
-    for (auto qubit = Qubit{bit_integer_type{0u}}; qubit < last_qubit; ++qubit)
-      result.push_back(::ket::spin_expectation_value(parallel_policy, first, last, qubit));
+    ::ket::all_spin_expectation_values_detail::reduce_spins_in_threads(spins_in_threads, result);
 
     return result;
   }
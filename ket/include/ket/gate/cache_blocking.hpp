@@ -0,0 +1,207 @@
+#ifndef KET_GATE_CACHE_BLOCKING_HPP
+# define KET_GATE_CACHE_BLOCKING_HPP
+
+# include <cassert>
+# include <vector>
+# include <iterator>
+# include <algorithm>
+
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/num_on_cache_qubits.hpp>
+
+
+namespace ket
+{
+  namespace gate
+  {
+    namespace cache_blocking_detail
+    {
+      // Number of qubits of contiguous amplitudes which are copied into a block at once
+      constexpr auto min_num_low_qubits = 3u;
+    } // namespace cache_blocking_detail
+
+    // Qubits of a cache block which is shared by a run of gates. A block has 2^num_block_qubits amplitudes, and block qubits are
+    // low qubits 0, ..., num_low_qubits - 1 and high qubits, which are brought to block qubits num_low_qubits, num_low_qubits + 1, ...
+    // Gates on block qubits never mix amplitudes of different blocks, so that the run is applied block by block while each block is on cache.
+    // If there are no high qubits, blocks are contiguous in the state vector. Otherwise amplitudes of each block are gathered into a buffer
+    template <typename StateInteger, typename BitInteger>
+    class cache_block_layout
+    {
+      BitInteger num_block_qubits_;
+      StateInteger operated_qubits_mask_;
+      BitInteger num_low_qubits_;
+      std::vector<BitInteger> high_qubits_; // in ascending order
+
+     public:
+      cache_block_layout() : num_block_qubits_{0u}, operated_qubits_mask_{0u}, num_low_qubits_{0u}, high_qubits_{} { }
+
+      explicit cache_block_layout(BitInteger const num_block_qubits)
+        : num_block_qubits_{num_block_qubits}, operated_qubits_mask_{0u}, num_low_qubits_{num_block_qubits}, high_qubits_{}
+      { high_qubits_.reserve(num_block_qubits); }
+
+      auto num_block_qubits() const noexcept -> BitInteger { return num_block_qubits_; }
+      auto num_low_qubits() const noexcept -> BitInteger { return num_low_qubits_; }
+      auto high_qubits() const noexcept -> std::vector<BitInteger> const& { return high_qubits_; }
+      auto is_contiguous() const noexcept -> bool { return high_qubits_.empty(); }
+      auto empty() const noexcept -> bool { return operated_qubits_mask_ == StateInteger{0u}; }
+
+      auto clear() -> void
+      {
+        operated_qubits_mask_ = StateInteger{0u};
+        num_low_qubits_ = num_block_qubits_;
+        high_qubits_.clear();
+      }
+
+      // Adds qubits operated by a gate and returns true if all operated qubits of the run still fit in a block, otherwise returns false without any change.
+      // The number of low qubits is taken as large as possible to copy longer chunks of contiguous amplitudes
+      auto add(StateInteger const qubits_mask) -> bool
+      {
+        auto const operated_qubits_mask = operated_qubits_mask_ bitor qubits_mask;
+        for (auto num_low_qubits = num_block_qubits_;
+             num_low_qubits >= BitInteger{::ket::gate::cache_blocking_detail::min_num_low_qubits}; --num_low_qubits)
+        {
+          auto num_high_qubits = BitInteger{0u};
+          for (auto high_mask = operated_qubits_mask >> num_low_qubits; high_mask != StateInteger{0u}; high_mask >>= 1u)
+            num_high_qubits += static_cast<BitInteger>(high_mask bitand StateInteger{1u});
+
+          if (num_low_qubits + num_high_qubits > num_block_qubits_)
+            continue;
+
+          operated_qubits_mask_ = operated_qubits_mask;
+          num_low_qubits_ = num_low_qubits;
+          high_qubits_.clear();
+          for (auto qubit = num_low_qubits; (operated_qubits_mask >> qubit) != StateInteger{0u}; ++qubit)
+            if (((operated_qubits_mask >> qubit) bitand StateInteger{1u}) != StateInteger{0u})
+              high_qubits_.push_back(qubit);
+          return true;
+        }
+
+        return false;
+      }
+
+      // The position of the operated qubit in a block
+      auto block_qubit(BitInteger const qubit) const -> BitInteger
+      {
+        if (qubit < num_low_qubits_)
+          return qubit;
+
+        using std::begin;
+        using std::end;
+        auto const found = std::lower_bound(begin(high_qubits_), end(high_qubits_), qubit);
+        assert(found != end(high_qubits_) and *found == qubit);
+        return num_low_qubits_ + static_cast<BitInteger>(found - begin(high_qubits_));
+      }
+    }; // class cache_block_layout<StateInteger, BitInteger>
+
+    // The number of block qubits which is not more than max_num_block_qubits and keeps enough blocks to make all threads busy.
+    // Zero means that cache blocking does not pay, e.g. the whole state vector is on cache
+    template <typename StateInteger, typename ParallelPolicy, typename BitInteger>
+    inline auto num_cache_block_qubits(
+      ParallelPolicy const parallel_policy, BitInteger const num_qubits, BitInteger const max_num_block_qubits)
+    -> BitInteger
+    {
+      if (num_qubits <= max_num_block_qubits)
+        return BitInteger{0u};
+
+      auto result = max_num_block_qubits;
+      auto const min_num_blocks = StateInteger{4u} * static_cast<StateInteger>(::ket::utility::num_threads(parallel_policy));
+      while (result > BitInteger{0u} and ::ket::utility::integer_exp2<StateInteger>(num_qubits - result) < min_num_blocks)
+        --result;
+
+      // Gates on two qubits should fit in a block with at least min_num_low_qubits low qubits
+      if (result < BitInteger{::ket::gate::cache_blocking_detail::min_num_low_qubits + 2u})
+        return BitInteger{0u};
+
+      return result;
+    }
+
+    // Calls function(block_first, block_last) for each block in parallel. Each thread gathers amplitudes of a block into
+    // [buffer_first + thread_index * 2^num_block_qubits, buffer_first + (thread_index + 1) * 2^num_block_qubits) and scatters them back
+    // after the call unless the blocks are contiguous
+    template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger, typename BitInteger, typename Function>
+    inline auto for_each_cache_block(
+      ParallelPolicy const parallel_policy, RandomAccessIterator const first, RandomAccessIterator const last,
+      ::ket::gate::cache_block_layout<StateInteger, BitInteger> const& layout,
+      RandomAccessIterator const buffer_first, RandomAccessIterator const buffer_last, Function&& function)
+    -> void
+    {
+      auto const num_qubits = ::ket::utility::integer_log2<BitInteger>(static_cast<StateInteger>(last - first));
+      auto const num_block_qubits = layout.num_block_qubits();
+      assert(::ket::utility::integer_exp2<StateInteger>(num_qubits) == static_cast<StateInteger>(last - first));
+      assert(num_block_qubits <= num_qubits);
+      auto const block_size = ::ket::utility::integer_exp2<StateInteger>(num_block_qubits);
+      auto const num_blocks = ::ket::utility::integer_exp2<StateInteger>(num_qubits - num_block_qubits);
+
+      if (layout.is_contiguous())
+      {
+        ::ket::utility::loop_n(
+          parallel_policy, num_blocks,
+          [first, num_block_qubits, block_size, &function](StateInteger const block_index, int const)
+          {
+            auto const block_first = first + (block_index << num_block_qubits);
+            function(block_first, block_first + block_size);
+          });
+        return;
+      }
+
+      assert(
+        static_cast<StateInteger>(buffer_last - buffer_first)
+        >= static_cast<StateInteger>(::ket::utility::num_threads(parallel_policy)) * block_size);
+      static_cast<void>(buffer_last);
+
+      // offsets of chunks of 2^num_low_qubits contiguous amplitudes from the first amplitude of a block
+      auto const num_low_qubits = layout.num_low_qubits();
+      auto const& high_qubits = layout.high_qubits();
+      auto const chunk_size = ::ket::utility::integer_exp2<StateInteger>(num_low_qubits);
+      auto const num_chunks = ::ket::utility::integer_exp2<StateInteger>(static_cast<BitInteger>(high_qubits.size()));
+      auto chunk_offsets = std::vector<StateInteger>(num_chunks, StateInteger{0u});
+      for (auto chunk_index = StateInteger{0u}; chunk_index < num_chunks; ++chunk_index)
+        for (auto index = decltype(high_qubits.size()){0u}; index < high_qubits.size(); ++index)
+          if (((chunk_index >> index) bitand StateInteger{1u}) != StateInteger{0u})
+            chunk_offsets[chunk_index] |= ::ket::utility::integer_exp2<StateInteger>(high_qubits[index]);
+
+      ::ket::utility::loop_n(
+        parallel_policy, num_blocks,
+        [first, buffer_first, num_block_qubits, block_size, num_low_qubits, &high_qubits, chunk_size, num_chunks, &chunk_offsets, &function](
+          StateInteger const block_index, int const thread_index)
+        {
+          // high qubits are inserted as zero bits into the block index
+          auto first_index = block_index << num_low_qubits;
+          for (auto const high_qubit: high_qubits)
+            first_index
+              = ((first_index >> high_qubit) << (high_qubit + BitInteger{1u}))
+                bitor (first_index bitand (::ket::utility::integer_exp2<StateInteger>(high_qubit) - StateInteger{1u}));
+
+          auto const block_first = buffer_first + (static_cast<StateInteger>(thread_index) << num_block_qubits);
+          for (auto chunk_index = StateInteger{0u}; chunk_index < num_chunks; ++chunk_index)
+            std::copy_n(first + (first_index bitor chunk_offsets[chunk_index]), chunk_size, block_first + (chunk_index << num_low_qubits));
+
+          function(block_first, block_first + block_size);
+
+          for (auto chunk_index = StateInteger{0u}; chunk_index < num_chunks; ++chunk_index)
+            std::copy_n(block_first + (chunk_index << num_low_qubits), chunk_size, first + (first_index bitor chunk_offsets[chunk_index]));
+        });
+    }
+
+    namespace ranges
+    {
+      template <typename ParallelPolicy, typename RandomAccessRange, typename StateInteger, typename BitInteger, typename Function>
+      inline auto for_each_cache_block(
+        ParallelPolicy const parallel_policy, RandomAccessRange& state,
+        ::ket::gate::cache_block_layout<StateInteger, BitInteger> const& layout,
+        RandomAccessRange& buffer, Function&& function)
+      -> RandomAccessRange&
+      {
+        using std::begin;
+        using std::end;
+        ::ket::gate::for_each_cache_block(parallel_policy, begin(state), end(state), layout, begin(buffer), end(buffer), function);
+        return state;
+      }
+    } // namespace ranges
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_CACHE_BLOCKING_HPP
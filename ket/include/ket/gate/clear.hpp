@@ -83,7 +83,7 @@ namespace ket
         using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
         ::ket::utility::loop_n(
           parallel_policy, static_cast<StateInteger>(last - first)/2u,
-          [first, multiplier, qubit_mask, lower_bits_mask, upper_bits_mask](StateInteger const value_wo_qubit, int const)
+          [first, multiplier, qubit_mask, lower_bits_mask, upper_bits_mask](StateInteger const value_wo_qubit, int const) noexcept
           {
             // xxxxx0xxxxxx
             auto const zero_index = ((value_wo_qubit bitand upper_bits_mask) << 1u) bitor (value_wo_qubit bitand lower_bits_mask);
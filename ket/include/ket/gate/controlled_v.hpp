@@ -76,7 +76,7 @@ namespace ket
         parallel_policy, static_cast<StateInteger>(last - first) >> 2u,
         [first, &one_plus_phase_coefficient, &one_minus_phase_coefficient,
          target_qubit_mask, control_qubit_mask, lower_bits_mask, middle_bits_mask, upper_bits_mask](
-          StateInteger const value_wo_qubits, int const)
+          StateInteger const value_wo_qubits, int const) noexcept
         {
           // xxx0_txxx0_cxxx
           auto const base_index
@@ -26,6 +26,7 @@
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/integer_exp2.hpp>
 # include <ket/utility/integer_log2.hpp>
+# include <ket/utility/num_on_cache_qubits.hpp>
 # if !defined(NDEBUG) || defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION)
 #   include <ket/utility/all_in_state_vector.hpp>
 # endif // !defined(NDEBUG) || defined(KET_ENABLE_CACHE_AWARE_GATE_FUNCTION)
@@ -342,11 +343,8 @@ namespace ket
           auto const num_qubits = ::ket::utility::integer_log2<bit_integer_type>(state_size);
           assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
 
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-          constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-          constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+          auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+          auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
           assert(num_on_cache_qubits < num_qubits);
 
           // xxxx|yyyy|zzzzzz: (local) qubits
@@ -407,11 +405,8 @@ namespace ket
           assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
           assert(::ket::utility::all_in_state_vector(num_qubits, qubit, qubits...));
 
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-          constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-          constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+          auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+          auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
           assert(num_on_cache_qubits < num_qubits);
           // It is required to be confirmed to satisfy Case 1)
           assert(::ket::utility::all_in_state_vector(num_on_cache_qubits, qubit, qubits...));
@@ -461,11 +456,8 @@ namespace ket
           auto const num_qubits = ::ket::utility::integer_log2<bit_integer_type>(state_size);
           assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-          constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-          constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+          auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+          auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
           assert(num_on_cache_qubits < num_qubits);
           auto const num_off_cache_qubits = num_qubits - num_on_cache_qubits;
 
@@ -548,11 +540,8 @@ namespace ket
             assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
             assert(::ket::utility::all_in_state_vector(num_qubits, qubit, qubits...));
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-            constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+            auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
             assert(num_on_cache_qubits < num_qubits);
             auto const num_off_cache_qubits = num_qubits - num_on_cache_qubits;
             // It is required to be confirmed not to satisfy Case 1)
@@ -639,11 +628,8 @@ namespace ket
           auto const num_qubits = ::ket::utility::integer_log2<bit_integer_type>(state_size);
           assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-          constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-          constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+          auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+          auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
           assert(num_on_cache_qubits < num_qubits);
           auto const num_off_cache_qubits = num_qubits - num_on_cache_qubits;
 
@@ -726,11 +712,8 @@ namespace ket
             assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
             assert(::ket::utility::all_in_state_vector(num_qubits, qubit, qubits...));
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-            constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+            auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
             assert(num_on_cache_qubits < num_qubits);
             auto const num_off_cache_qubits = num_qubits - num_on_cache_qubits;
             // It is required to be confirmed not to satisfy Case 1)
@@ -1663,11 +1646,8 @@ namespace ket
 #   endif // NDEBUG
       assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
 
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-      constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-      constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+      auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+      auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
       if (state_size <= cache_size)
       {
         ::ket::gate::nocache::gate(parallel_policy, first, last, std::forward<Function>(function));
@@ -1735,11 +1715,8 @@ namespace ket
       assert(::ket::utility::integer_exp2<state_integer_type>(num_qubits) == state_size);
       assert(::ket::utility::all_in_state_vector(num_qubits, qubit, qubits...));
 
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-      constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-      constexpr auto cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
+      auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+      auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
       if (state_size <= cache_size)
       {
         ::ket::gate::nocache::gate(parallel_policy, first, last, std::forward<Function>(function), std::forward<Qubit>(qubit), std::forward<Qubits>(qubits)...);
@@ -2204,7 +2181,7 @@ namespace ket
 
               auto const cache_size = ::ket::utility::integer_exp2<state_integer_type>(num_on_cache_qubits);
               // It is required to be confirmed not to satisfy Case 1)
-              assert(::ket::utility::runtime::ranges::all_in_state_vector(num_on_cache_qubits, qubits));
+              assert(not ::ket::utility::runtime::ranges::all_in_state_vector(num_on_cache_qubits, qubits));
 
               // xxxx|yyyy|zzzzzz: (local) qubits
               // * xxxx: off-cache qubits
@@ -2404,7 +2381,7 @@ namespace ket
               sorted_on_cache_qubits_with_sentinel.push_back(qubit_type{num_on_cache_qubits});
               std::sort(begin(sorted_on_cache_qubits_with_sentinel), std::prev(end(sorted_on_cache_qubits_with_sentinel)));
 
-              auto const tag_loop_size = ::ket::utility::integer_exp2<state_integer_type>(num_tag_qubits - num_operated_qubits);
+              auto const tag_loop_size = ::ket::utility::integer_exp2<state_integer_type>(num_tag_qubits - num_chunk_qubits); // num_chunk_qubits == unsorted_tag_qubits.size()
               for (auto tag_index_wo_qubits = state_integer_type{0u}; tag_index_wo_qubits < tag_loop_size; ++tag_index_wo_qubits)
                 ::ket::gate::runtime::gate_detail::ranges::gate_n(
                   parallel_policy,
@@ -3027,10 +3004,7 @@ namespace ket
         {
           using qubit_type = ::ket::utility::meta::range_value_t<QubitsRange>;
           using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-          constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+          auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
           ::ket::gate::runtime::qubit_ranges::gate(
             parallel_policy, first, last, std::forward<Function>(function), num_on_cache_qubits, qubits);
@@ -0,0 +1,277 @@
+#ifndef KET_GATE_DIAGONAL_HPP
+# define KET_GATE_DIAGONAL_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+# include <iterator>
+# include <type_traits>
+
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+
+// Terms of a diagonal accumulator are tabulated in groups whose supports have at most this number of qubits
+# ifndef KET_DIAGONAL_TABLE_QUBITS
+#   define KET_DIAGONAL_TABLE_QUBITS 10
+# endif // KET_DIAGONAL_TABLE_QUBITS
+
+
+namespace ket
+{
+  namespace gate
+  {
+    // D(n) = (c_{f(n & p)} if n & m == m, otherwise 1), where f(n): the parity of the number of "1" bits in n
+    //   m: control_mask, p: parity_mask, c_0: even_coefficient, c_1: odd_coefficient
+    // e.g. CnZ: m = (bits of all qubits), p = 0, c_0 = -1; eZZ_{ij}(theta): m = 0, p = 2^i + 2^j, c_0 = e^{i theta}, c_1 = e^{-i theta}
+    template <typename Complex, typename StateInteger>
+    struct diagonal_term
+    {
+      StateInteger control_mask;
+      StateInteger parity_mask;
+      Complex even_coefficient;
+      Complex odd_coefficient;
+    }; // struct diagonal_term<Complex, StateInteger>
+
+    namespace diagonal_detail
+    {
+      template <typename StateInteger>
+      inline auto parity(StateInteger value) -> bool
+      {
+        auto result = false;
+        for (; value != StateInteger{0u}; value &= value - StateInteger{1u})
+          result = not result;
+        return result;
+      }
+
+      template <typename StateInteger>
+      inline auto popcount(StateInteger value) -> std::size_t
+      {
+        auto result = std::size_t{0u};
+        for (; value != StateInteger{0u}; value &= value - StateInteger{1u})
+          ++result;
+        return result;
+      }
+
+      template <typename Complex, typename StateInteger>
+      inline auto coefficient(::ket::gate::diagonal_term<Complex, StateInteger> const& term, StateInteger const index) -> Complex
+      {
+        if ((index bitand term.control_mask) != term.control_mask)
+          return Complex{1};
+
+        return ::ket::gate::diagonal_detail::parity(index bitand term.parity_mask) ? term.odd_coefficient : term.even_coefficient;
+      }
+    } // namespace diagonal_detail
+
+    // Product of diagonal gates, which are gathered by add_phase/add_parity_phase and applied by ket::gate::diagonal in one sweep.
+    // All diagonal gates commute, so the order of added terms does not matter
+    template <typename Complex, typename StateInteger = std::uint64_t>
+    class diagonal_accumulator
+    {
+     public:
+      using complex_type = Complex;
+      using state_integer_type = StateInteger;
+      using term_type = ::ket::gate::diagonal_term<Complex, StateInteger>;
+
+     private:
+      std::vector<term_type> terms_;
+
+     public:
+      diagonal_accumulator() = default;
+
+      // multiplies coefficient to amplitudes whose bits in control_mask are all 1, e.g. U1, CnZ, CnU1
+      auto add_phase(Complex const& coefficient, StateInteger const control_mask) -> void
+      { terms_.push_back(term_type{control_mask, StateInteger{0u}, coefficient, coefficient}); }
+
+      // multiplies even_coefficient (odd_coefficient) to amplitudes whose bits in control_mask are all 1 and the number of "1" bits in parity_mask is even (odd),
+      // e.g. Z...Z, eZ...Z, CneZ...Z
+      auto add_parity_phase(
+        Complex const& even_coefficient, Complex const& odd_coefficient,
+        StateInteger const parity_mask, StateInteger const control_mask = StateInteger{0u})
+      -> void
+      {
+        assert((parity_mask bitand control_mask) == StateInteger{0u});
+        terms_.push_back(term_type{control_mask, parity_mask, even_coefficient, odd_coefficient});
+      }
+
+      auto empty() const noexcept -> bool { return terms_.empty(); }
+      auto size() const noexcept -> std::size_t { return terms_.size(); }
+      auto clear() noexcept -> void { terms_.clear(); }
+      auto terms() const noexcept -> std::vector<term_type> const& { return terms_; }
+
+      auto operated_mask() const -> StateInteger
+      {
+        auto result = StateInteger{0u};
+        for (auto const& term: terms_)
+          result |= term.control_mask bitor term.parity_mask;
+        return result;
+      }
+
+      // transform_mask(mask) should return the mask whose bits are moved in the same way as each bit of mask, e.g. by ket::mpi::permutate_bits
+      template <typename Function>
+      auto transform_masks(Function&& transform_mask) const -> diagonal_accumulator
+      {
+        auto result = diagonal_accumulator{};
+        result.terms_.reserve(terms_.size());
+        for (auto const& term: terms_)
+          result.terms_.push_back(
+            term_type{transform_mask(term.control_mask), transform_mask(term.parity_mask), term.even_coefficient, term.odd_coefficient});
+        return result;
+      }
+    }; // class diagonal_accumulator<Complex, StateInteger>
+
+    namespace diagonal_detail
+    {
+      // values[i] is the product of coefficients of terms for an index whose bits[j] is the j-th bit of i
+      template <typename Complex, typename StateInteger>
+      struct phase_table
+      {
+        StateInteger mask;
+        std::vector<unsigned int> bits;
+        std::vector< ::ket::gate::diagonal_term<Complex, StateInteger> > terms;
+        std::vector<Complex> values;
+      }; // struct phase_table<Complex, StateInteger>
+
+      // Terms are put into tables by first fit, and terms on more than KET_DIAGONAL_TABLE_QUBITS qubits are evaluated for each index
+      template <typename Complex, typename StateInteger>
+      inline auto make_phase_tables(
+        ::ket::gate::diagonal_accumulator<Complex, StateInteger> const& accumulator,
+        std::vector< ::ket::gate::diagonal_term<Complex, StateInteger> >& large_terms)
+      -> std::vector< ::ket::gate::diagonal_detail::phase_table<Complex, StateInteger> >
+      {
+        constexpr auto max_num_table_qubits = std::size_t{KET_DIAGONAL_TABLE_QUBITS};
+
+        auto result = std::vector< ::ket::gate::diagonal_detail::phase_table<Complex, StateInteger> >{};
+        for (auto const& term: accumulator.terms())
+        {
+          auto const term_mask = term.control_mask bitor term.parity_mask;
+          if (::ket::gate::diagonal_detail::popcount(term_mask) > max_num_table_qubits)
+          {
+            large_terms.push_back(term);
+            continue;
+          }
+
+          auto is_found = false;
+          for (auto& table: result)
+            if (::ket::gate::diagonal_detail::popcount(table.mask bitor term_mask) <= max_num_table_qubits)
+            {
+              table.mask |= term_mask;
+              table.terms.push_back(term);
+              is_found = true;
+              break;
+            }
+
+          if (not is_found)
+            result.push_back(::ket::gate::diagonal_detail::phase_table<Complex, StateInteger>{term_mask, {}, {term}, {}});
+        }
+
+        for (auto& table: result)
+        {
+          for (auto bit = 0u; (table.mask >> bit) != StateInteger{0u}; ++bit)
+            if (((table.mask >> bit) bitand StateInteger{1u}) == StateInteger{1u})
+              table.bits.push_back(bit);
+
+          auto const num_values = ::ket::utility::integer_exp2<std::size_t>(table.bits.size());
+          table.values.assign(num_values, Complex{1});
+          for (auto value_index = std::size_t{0u}; value_index < num_values; ++value_index)
+          {
+            auto index = StateInteger{0u};
+            for (auto bit_index = std::size_t{0u}; bit_index < table.bits.size(); ++bit_index)
+              index |= static_cast<StateInteger>((value_index >> bit_index) bitand std::size_t{1u}) << table.bits[bit_index];
+
+            for (auto const& term: table.terms)
+              table.values[value_index] *= ::ket::gate::diagonal_detail::coefficient(term, index);
+          }
+        }
+
+        return result;
+      }
+
+      // first_index is the index of *first in the whole state vector, which is not zero if [first, last) is a part of it
+      template <typename ParallelPolicy, typename RandomAccessIterator, typename Complex, typename StateInteger>
+      inline auto apply_phase_tables(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        std::vector< ::ket::gate::diagonal_detail::phase_table<Complex, StateInteger> > const& tables,
+        std::vector< ::ket::gate::diagonal_term<Complex, StateInteger> > const& large_terms,
+        StateInteger const first_index)
+      -> void
+      {
+        ::ket::utility::loop_n(
+          parallel_policy, static_cast<StateInteger>(last - first),
+          ::ket::utility::make_independent_loop_function(
+            [first, first_index, &tables, &large_terms](StateInteger const count, int const)
+            {
+              auto const index = first_index + count;
+              auto coefficient = Complex{1};
+
+              for (auto const& table: tables)
+              {
+                auto value_index = std::size_t{0u};
+                auto const num_bits = table.bits.size();
+                for (auto bit_index = std::size_t{0u}; bit_index < num_bits; ++bit_index)
+                  value_index |= static_cast<std::size_t>((index >> table.bits[bit_index]) bitand StateInteger{1u}) << bit_index;
+                coefficient *= table.values[value_index];
+              }
+
+              for (auto const& term: large_terms)
+                coefficient *= ::ket::gate::diagonal_detail::coefficient(term, index);
+
+              *(first + count) *= coefficient;
+            }));
+      }
+    } // namespace diagonal_detail
+
+    template <typename ParallelPolicy, typename RandomAccessIterator, typename Complex, typename StateInteger>
+    inline auto diagonal(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      ::ket::gate::diagonal_accumulator<Complex, StateInteger> const& accumulator)
+    -> void
+    {
+      static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
+      static_assert(
+        std::is_same<Complex, typename std::iterator_traits<RandomAccessIterator>::value_type>::value,
+        "Complex must be the same to value_type of RandomAccessIterator");
+      assert(accumulator.operated_mask() < static_cast<StateInteger>(last - first));
+
+      if (accumulator.empty())
+        return;
+
+      auto large_terms = std::vector< ::ket::gate::diagonal_term<Complex, StateInteger> >{};
+      auto const tables = ::ket::gate::diagonal_detail::make_phase_tables(accumulator, large_terms);
+      ::ket::gate::diagonal_detail::apply_phase_tables(parallel_policy, first, last, tables, large_terms, StateInteger{0u});
+    }
+
+    template <typename RandomAccessIterator, typename Complex, typename StateInteger>
+    inline auto diagonal(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      ::ket::gate::diagonal_accumulator<Complex, StateInteger> const& accumulator)
+    -> void
+    { ::ket::gate::diagonal(::ket::utility::policy::make_sequential(), first, last, accumulator); }
+
+    namespace ranges
+    {
+      template <typename ParallelPolicy, typename RandomAccessRange, typename Complex, typename StateInteger>
+      inline auto diagonal(
+        ParallelPolicy const parallel_policy, RandomAccessRange& state,
+        ::ket::gate::diagonal_accumulator<Complex, StateInteger> const& accumulator)
+      -> std::enable_if_t< ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange& >
+      {
+        using std::begin;
+        using std::end;
+        ::ket::gate::diagonal(parallel_policy, begin(state), end(state), accumulator);
+        return state;
+      }
+
+      template <typename RandomAccessRange, typename Complex, typename StateInteger>
+      inline auto diagonal(
+        RandomAccessRange& state, ::ket::gate::diagonal_accumulator<Complex, StateInteger> const& accumulator)
+      -> RandomAccessRange&
+      { return ::ket::gate::ranges::diagonal(::ket::utility::policy::make_sequential(), state, accumulator); }
+    } // namespace ranges
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_DIAGONAL_HPP
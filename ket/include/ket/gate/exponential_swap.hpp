@@ -73,7 +73,7 @@ namespace ket
       ::ket::utility::loop_n(
         parallel_policy, static_cast<StateInteger>(last - first) >> 2u,
         [first, &phase_coefficient, &i_sin_theta, qubit1_mask, qubit2_mask, lower_bits_mask, middle_bits_mask, upper_bits_mask](
-          StateInteger const value_wo_qubits, int const)
+          StateInteger const value_wo_qubits, int const) noexcept
         {
           // xxx0_1xxx0_2xxx
           auto const base_index
@@ -51,7 +51,7 @@ namespace ket
 
       ::ket::utility::loop_n(
         parallel_policy, static_cast<StateInteger>(last - first) >> 1u,
-        [first, qubit_mask, lower_bits_mask, upper_bits_mask](StateInteger const value_wo_qubit, int const)
+        [first, qubit_mask, lower_bits_mask, upper_bits_mask](StateInteger const value_wo_qubit, int const) noexcept
         {
           // xxxxx0xxxxxx
           auto const zero_index = ((value_wo_qubit bitand upper_bits_mask) << 1u) bitor (value_wo_qubit bitand lower_bits_mask);
@@ -104,7 +104,7 @@ namespace ket
       ::ket::utility::loop_n(
         parallel_policy, static_cast<StateInteger>(last - first) >> 2u,
         [first, target_qubit_mask, control_qubit_mask, lower_bits_mask, middle_bits_mask, upper_bits_mask](
-          StateInteger const value_wo_qubits, int const)
+          StateInteger const value_wo_qubits, int const) noexcept
         {
           // xxx0_txxx0_cxxx
           auto const base_index
@@ -98,7 +98,7 @@ namespace ket
 
         ::ket::utility::loop_n(
           parallel_policy, static_cast<StateInteger>(last - first) / 2u,
-          [first, qubit_mask, lower_bits_mask, upper_bits_mask, multiplier](StateInteger const value_wo_qubit, int const)
+          [first, qubit_mask, lower_bits_mask, upper_bits_mask, multiplier](StateInteger const value_wo_qubit, int const) noexcept
           {
             // xxxxx0xxxxxx
             auto const zero_index = ((value_wo_qubit bitand upper_bits_mask) << 1u) bitor (value_wo_qubit bitand lower_bits_mask);
@@ -136,7 +136,7 @@ namespace ket
 
         ::ket::utility::loop_n(
           parallel_policy, static_cast<StateInteger>(last - first) / 2u,
-          [first, qubit_mask, lower_bits_mask, upper_bits_mask, multiplier](StateInteger const value_wo_qubit, int const)
+          [first, qubit_mask, lower_bits_mask, upper_bits_mask, multiplier](StateInteger const value_wo_qubit, int const) noexcept
           {
             // xxxxx0xxxxxx
             auto const zero_index = ((value_wo_qubit bitand upper_bits_mask) << 1u) bitor (value_wo_qubit bitand lower_bits_mask);
@@ -0,0 +1,359 @@
+#ifndef KET_GATE_SPLIT_GATE_HPP
+# define KET_GATE_SPLIT_GATE_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <complex>
+# include <array>
+# include <iterator>
+# include <algorithm>
+# include <utility>
+# include <type_traits>
+
+# include <boost/range/value_type.hpp>
+
+# include <ket/qubit.hpp>
+# include <ket/gate/split/layout.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# ifndef NDEBUG
+#   include <ket/utility/integer_log2.hpp>
+# endif
+# include <ket/utility/meta/real_of.hpp>
+
+
+namespace ket
+{
+  namespace gate
+  {
+    namespace split
+    {
+      namespace gate_detail
+      {
+        // LaneMasks... has one element for each operated qubit: (1 << qubit) for a lane qubit and 0 for a block qubit
+        template <std::size_t... LaneMasks>
+        inline constexpr auto num_block_qubits() -> std::size_t
+        {
+          constexpr std::size_t lane_masks[] = {LaneMasks...};
+          auto result = std::size_t{0u};
+          for (auto const lane_mask: lane_masks)
+            if (lane_mask == std::size_t{0u})
+              ++result;
+          return result;
+        }
+
+        // An amplitude is updated with the amplitudes whose indices differ in operated qubits by "pattern".
+        // partner_lanes gives the lane XOR mask, and partner_group_block the XOR mask of the block position in a group, for pattern
+        template <std::size_t... LaneMasks>
+        inline constexpr auto partner_lanes(std::size_t const pattern) -> std::size_t
+        {
+          constexpr std::size_t lane_masks[] = {LaneMasks...};
+          auto result = std::size_t{0u};
+          for (auto index = std::size_t{0u}; index < sizeof...(LaneMasks); ++index)
+            if (((pattern >> index) bitand std::size_t{1u}) == std::size_t{1u})
+              result xor_eq lane_masks[index];
+          return result;
+        }
+
+        template <std::size_t... LaneMasks>
+        inline constexpr auto partner_group_block(std::size_t const pattern) -> std::size_t
+        {
+          constexpr std::size_t lane_masks[] = {LaneMasks...};
+          auto result = std::size_t{0u};
+          auto block_qubit_index = std::size_t{0u};
+          for (auto index = std::size_t{0u}; index < sizeof...(LaneMasks); ++index)
+            if (lane_masks[index] == std::size_t{0u})
+            {
+              if (((pattern >> index) bitand std::size_t{1u}) == std::size_t{1u})
+                result xor_eq std::size_t{1u} << block_qubit_index;
+              ++block_qubit_index;
+            }
+          return result;
+        }
+
+        // Blocks whose indices differ only in block qubits form a group, and a group is processed in registers at once.
+        // new_amplitude(row) = sum_{pattern} matrix[row][row xor pattern] * amplitude(row xor pattern)
+        template <typename ParallelPolicy, typename Real, typename StateInteger, std::size_t num_qubits>
+        class dense_kernel
+        {
+          static constexpr auto num_indices = std::size_t{1u} << num_qubits;
+
+          ParallelPolicy parallel_policy_;
+          Real* reals_;
+          StateInteger num_blocks_;
+          std::complex<Real> const* matrix_; // row-major, bit i of row/column indices corresponds to i-th qubit
+          std::array<StateInteger, num_qubits> block_masks_; // (1 << (qubit - vector_width_bits)) for a block qubit and 0 for a lane qubit
+
+         public:
+          dense_kernel(
+            ParallelPolicy const parallel_policy, Real* const reals, StateInteger const num_blocks,
+            std::complex<Real> const* const matrix, std::array<StateInteger, num_qubits> const& block_masks)
+            : parallel_policy_{parallel_policy}, reals_{reals}, num_blocks_{num_blocks}, matrix_{matrix}, block_masks_(block_masks)
+          { }
+
+          template <std::size_t... LaneMasks>
+          auto call() const -> void
+          {
+            static_assert(sizeof...(LaneMasks) == num_qubits, "the number of lane masks should be equal to the number of qubits");
+            constexpr auto num_block_qubits = ::ket::gate::split::gate_detail::num_block_qubits<LaneMasks...>();
+            constexpr auto num_group_blocks = std::size_t{1u} << num_block_qubits;
+            constexpr std::size_t lane_masks[] = {LaneMasks...};
+
+            // coefficients[group_block][pattern][lane]
+            using coefficients_type = std::array<std::array<std::array<Real, vector_width>, num_indices>, num_group_blocks>;
+            auto real_coefficients = coefficients_type{};
+            auto imag_coefficients = coefficients_type{};
+            for (auto group_block = std::size_t{0u}; group_block < num_group_blocks; ++group_block)
+              for (auto lane = std::size_t{0u}; lane < vector_width; ++lane)
+              {
+                auto row = std::size_t{0u};
+                auto block_qubit_index = std::size_t{0u};
+                for (auto index = std::size_t{0u}; index < num_qubits; ++index)
+                  if (lane_masks[index] == std::size_t{0u})
+                    row or_eq ((group_block >> block_qubit_index++) bitand std::size_t{1u}) << index;
+                  else if ((lane bitand lane_masks[index]) != std::size_t{0u})
+                    row or_eq std::size_t{1u} << index;
+
+                for (auto pattern = std::size_t{0u}; pattern < num_indices; ++pattern)
+                {
+                  auto const coefficient = matrix_[row * num_indices + (row xor pattern)];
+                  using std::real;
+                  using std::imag;
+                  real_coefficients[group_block][pattern][lane] = real(coefficient);
+                  imag_coefficients[group_block][pattern][lane] = imag(coefficient);
+                }
+              }
+
+            // block offsets in a group, and block masks sorted in ascending order to make the first block index of a group
+            auto group_block_offsets = std::array<StateInteger, num_group_blocks>{};
+            auto sorted_block_masks = std::array<StateInteger, num_block_qubits>{};
+            {
+              auto block_qubit_index = std::size_t{0u};
+              for (auto index = std::size_t{0u}; index < num_qubits; ++index)
+                if (lane_masks[index] == std::size_t{0u})
+                  sorted_block_masks[block_qubit_index++] = block_masks_[index];
+
+              for (auto group_block = std::size_t{0u}; group_block < num_group_blocks; ++group_block)
+                for (auto block_qubit_index = std::size_t{0u}; block_qubit_index < num_block_qubits; ++block_qubit_index)
+                  if (((group_block >> block_qubit_index) bitand std::size_t{1u}) == std::size_t{1u})
+                    group_block_offsets[group_block] or_eq sorted_block_masks[block_qubit_index];
+
+              using std::begin;
+              using std::end;
+              std::sort(begin(sorted_block_masks), end(sorted_block_masks));
+            }
+
+            auto const reals = reals_;
+            ::ket::utility::loop_n(
+              parallel_policy_, num_blocks_ >> num_block_qubits,
+              [reals, real_coefficients, imag_coefficients, group_block_offsets, sorted_block_masks](
+                StateInteger const group_index, int const)
+              {
+                auto first_block_index = group_index;
+                for (auto const block_mask: sorted_block_masks)
+                  first_block_index
+                    = ((first_block_index bitand compl (block_mask - StateInteger{1u})) << 1u)
+                      bitor (first_block_index bitand (block_mask - StateInteger{1u}));
+
+                Real* blocks[num_group_blocks];
+                Real real_parts[num_group_blocks][vector_width];
+                Real imag_parts[num_group_blocks][vector_width];
+                for (auto group_block = std::size_t{0u}; group_block < num_group_blocks; ++group_block)
+                {
+                  blocks[group_block]
+                    = reals + static_cast<std::size_t>(first_block_index bitor group_block_offsets[group_block]) * (std::size_t{2u} * vector_width);
+                  for (auto lane = std::size_t{0u}; lane < vector_width; ++lane)
+                  {
+                    real_parts[group_block][lane] = blocks[group_block][lane];
+                    imag_parts[group_block][lane] = blocks[group_block][vector_width + lane];
+                  }
+                }
+
+                for (auto group_block = std::size_t{0u}; group_block < num_group_blocks; ++group_block)
+                {
+                  Real new_real_parts[vector_width] = {};
+                  Real new_imag_parts[vector_width] = {};
+
+                  for (auto pattern = std::size_t{0u}; pattern < num_indices; ++pattern)
+                  {
+                    // Both partners are compile-time constants once the loop over patterns is unrolled,
+                    // so the lane permutation becomes an in-register shuffle (or nothing for block qubits)
+                    auto const partner_block = group_block xor ::ket::gate::split::gate_detail::partner_group_block<LaneMasks...>(pattern);
+                    auto const partner_lanes = ::ket::gate::split::gate_detail::partner_lanes<LaneMasks...>(pattern);
+                    auto const& real_coefficient = real_coefficients[group_block][pattern];
+                    auto const& imag_coefficient = imag_coefficients[group_block][pattern];
+
+                    for (auto lane = std::size_t{0u}; lane < vector_width; ++lane)
+                    {
+                      auto const real_part = real_parts[partner_block][lane xor partner_lanes];
+                      auto const imag_part = imag_parts[partner_block][lane xor partner_lanes];
+                      new_real_parts[lane] += real_coefficient[lane] * real_part - imag_coefficient[lane] * imag_part;
+                      new_imag_parts[lane] += real_coefficient[lane] * imag_part + imag_coefficient[lane] * real_part;
+                    }
+                  }
+
+                  for (auto lane = std::size_t{0u}; lane < vector_width; ++lane)
+                  {
+                    blocks[group_block][lane] = new_real_parts[lane];
+                    blocks[group_block][vector_width + lane] = new_imag_parts[lane];
+                  }
+                }
+              });
+          }
+        }; // class dense_kernel<ParallelPolicy, Real, StateInteger, num_qubits>
+
+        // Runtime lane masks are turned into template arguments one by one: candidates are vector_width/2, ..., 2, 1, and 0 (block qubit)
+        template <std::size_t... LaneMasks>
+        struct call_with_lane_masks;
+
+        template <std::size_t candidate, std::size_t... LaneMasks>
+        struct select_lane_mask
+        {
+          template <typename Kernel, typename... RuntimeLaneMasks>
+          static auto call(Kernel const& kernel, std::size_t const lane_mask, RuntimeLaneMasks const... lane_masks) -> void
+          {
+            if (lane_mask == candidate)
+              ::ket::gate::split::gate_detail::call_with_lane_masks<LaneMasks..., candidate>::call(kernel, lane_masks...);
+            else
+              ::ket::gate::split::gate_detail::select_lane_mask<candidate / 2u, LaneMasks...>::call(kernel, lane_mask, lane_masks...);
+          }
+        }; // struct select_lane_mask<candidate, LaneMasks...>
+
+        template <std::size_t... LaneMasks>
+        struct select_lane_mask<0u, LaneMasks...>
+        {
+          template <typename Kernel, typename... RuntimeLaneMasks>
+          static auto call(Kernel const& kernel, std::size_t const lane_mask, RuntimeLaneMasks const... lane_masks) -> void
+          {
+            assert(lane_mask == std::size_t{0u});
+            ::ket::gate::split::gate_detail::call_with_lane_masks<LaneMasks..., 0u>::call(kernel, lane_masks...);
+          }
+        }; // struct select_lane_mask<0u, LaneMasks...>
+
+        template <std::size_t... LaneMasks>
+        struct call_with_lane_masks
+        {
+          template <typename Kernel>
+          static auto call(Kernel const& kernel) -> void
+          { kernel.template call<LaneMasks...>(); }
+
+          template <typename Kernel, typename... RuntimeLaneMasks>
+          static auto call(Kernel const& kernel, std::size_t const lane_mask, RuntimeLaneMasks const... lane_masks) -> void
+          { ::ket::gate::split::gate_detail::select_lane_mask<vector_width / 2u, LaneMasks...>::call(kernel, lane_mask, lane_masks...); }
+        }; // struct call_with_lane_masks<LaneMasks...>
+
+        template <typename Kernel, std::size_t num_qubits, std::size_t... indices>
+        inline auto call_kernel(
+          Kernel const& kernel, std::array<std::size_t, num_qubits> const& lane_masks, std::index_sequence<indices...> const)
+        -> void
+        { ::ket::gate::split::gate_detail::call_with_lane_masks<>::call(kernel, lane_masks[indices]...); }
+
+        template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger, typename BitInteger, typename... Qubits>
+        inline auto gate(
+          ParallelPolicy const parallel_policy,
+          RandomAccessIterator const first, RandomAccessIterator const last,
+          typename std::iterator_traits<RandomAccessIterator>::value_type const* const matrix,
+          ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+        -> void
+        {
+          static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
+          static_assert(std::is_unsigned<BitInteger>::value, "BitInteger should be unsigned");
+          assert(::ket::gate::split::is_split_layout_applicable(first, last));
+          assert(
+            ::ket::utility::integer_exp2<StateInteger>(::ket::utility::integer_log2<BitInteger>(last - first))
+            == static_cast<StateInteger>(last - first));
+
+          constexpr auto num_qubits = sizeof...(Qubits) + 1u;
+          using real_type = ::ket::utility::meta::real_t<typename std::iterator_traits<RandomAccessIterator>::value_type>;
+
+          auto const operated_qubits = std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits >{qubit, qubits...};
+          auto block_masks = std::array<StateInteger, num_qubits>{};
+          auto lane_masks = std::array<std::size_t, num_qubits>{};
+          for (auto index = std::size_t{0u}; index < num_qubits; ++index)
+          {
+            auto const bit = static_cast<BitInteger>(operated_qubits[index]);
+            assert(::ket::utility::integer_exp2<StateInteger>(bit) < static_cast<StateInteger>(last - first));
+            if (bit < static_cast<BitInteger>(vector_width_bits))
+              lane_masks[index] = std::size_t{1u} << bit;
+            else
+              block_masks[index] = StateInteger{1u} << (bit - static_cast<BitInteger>(vector_width_bits));
+          }
+
+          auto const num_blocks = static_cast<StateInteger>(last - first) >> vector_width_bits;
+          auto const kernel
+            = ::ket::gate::split::gate_detail::dense_kernel<ParallelPolicy, real_type, StateInteger, num_qubits>{
+                parallel_policy, ::ket::gate::split::layout_detail::real_pointer(first), num_blocks,
+                matrix, block_masks};
+          ::ket::gate::split::gate_detail::call_kernel(kernel, lane_masks, std::make_index_sequence<num_qubits>{});
+        }
+      } // namespace gate_detail
+
+      // U_i on a state vector in split layout
+      // U_1 (a_0 |0> + a_1 |1>) = (u_{00} a_0 + u_{01} a_1) |0> + (u_{10} a_0 + u_{11} a_1) |1>, where matrix = {u_{00}, u_{01}, u_{10}, u_{11}}
+      template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger, typename BitInteger>
+      inline auto gate(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        std::array<typename std::iterator_traits<RandomAccessIterator>::value_type, 4u> const& matrix,
+        ::ket::qubit<StateInteger, BitInteger> const qubit)
+      -> void
+      {
+        ::ket::gate::split::gate_detail::gate(
+          parallel_policy, first, last, matrix.data(),
+          qubit);
+      }
+
+      // U_{ij} on a state vector in split layout
+      // matrix is row-major, and bit 0 (bit 1) of row and column indices corresponds to qubit1 (qubit2):
+      // U_{12} a_{x_2 x_1} |x_2 x_1> = sum_{y_2 y_1} u_{(y_2 y_1),(x_2 x_1)} a_{x_2 x_1} |y_2 y_1>
+      template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger, typename BitInteger>
+      inline auto gate(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        std::array<typename std::iterator_traits<RandomAccessIterator>::value_type, 16u> const& matrix,
+        ::ket::qubit<StateInteger, BitInteger> const qubit1, ::ket::qubit<StateInteger, BitInteger> const qubit2)
+      -> void
+      {
+        assert(qubit1 != qubit2);
+        ::ket::gate::split::gate_detail::gate(
+          parallel_policy, first, last, matrix.data(),
+          qubit1, qubit2);
+      }
+
+      template <typename RandomAccessIterator, std::size_t num_elements, typename StateInteger, typename BitInteger, typename... Qubits>
+      inline auto gate(
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        std::array<typename std::iterator_traits<RandomAccessIterator>::value_type, num_elements> const& matrix,
+        ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+      -> void
+      { ::ket::gate::split::gate(::ket::utility::policy::make_sequential(), first, last, matrix, qubit, qubits...); }
+
+      namespace ranges
+      {
+        template <typename ParallelPolicy, typename RandomAccessRange, std::size_t num_elements, typename StateInteger, typename BitInteger, typename... Qubits>
+        inline auto gate(
+          ParallelPolicy const parallel_policy, RandomAccessRange& state,
+          std::array<typename boost::range_value<RandomAccessRange>::type, num_elements> const& matrix,
+          ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+        -> std::enable_if_t< ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange& >
+        {
+          using std::begin;
+          using std::end;
+          ::ket::gate::split::gate(parallel_policy, begin(state), end(state), matrix, qubit, qubits...);
+          return state;
+        }
+
+        template <typename RandomAccessRange, std::size_t num_elements, typename StateInteger, typename BitInteger, typename... Qubits>
+        inline auto gate(
+          RandomAccessRange& state,
+          std::array<typename boost::range_value<RandomAccessRange>::type, num_elements> const& matrix,
+          ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+        -> RandomAccessRange&
+        { return ::ket::gate::split::ranges::gate(::ket::utility::policy::make_sequential(), state, matrix, qubit, qubits...); }
+      } // namespace ranges
+    } // namespace split
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_SPLIT_GATE_HPP
@@ -0,0 +1,186 @@
+#ifndef KET_GATE_SPLIT_LAYOUT_HPP
+# define KET_GATE_SPLIT_LAYOUT_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <complex>
+# include <array>
+# include <iterator>
+# include <memory>
+# include <algorithm>
+# include <type_traits>
+
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/meta/real_of.hpp>
+
+# ifndef KET_SPLIT_VECTOR_WIDTH
+#   define KET_SPLIT_VECTOR_WIDTH 8
+# endif // KET_SPLIT_VECTOR_WIDTH
+
+
+namespace ket
+{
+  namespace gate
+  {
+    // Split layout: amplitudes are grouped into blocks of vector_width consecutive amplitudes,
+    // and each block stores the vector_width real parts followed by the vector_width imaginary parts.
+    // A block has the same size as vector_width std::complex values, so the layout is changed in place.
+    // Qubits below vector_width_bits ("lane qubits") select lanes in a block, and the others ("block qubits") select blocks.
+    namespace split
+    {
+      constexpr auto vector_width = std::size_t{KET_SPLIT_VECTOR_WIDTH};
+      static_assert(
+        vector_width >= std::size_t{2u} and (vector_width bitand (vector_width - std::size_t{1u})) == std::size_t{0u},
+        "KET_SPLIT_VECTOR_WIDTH should be a power of two");
+
+      namespace layout_detail
+      {
+        inline constexpr auto log2(std::size_t const value) -> std::size_t
+        { return value <= std::size_t{1u} ? std::size_t{0u} : std::size_t{1u} + ::ket::gate::split::layout_detail::log2(value >> 1u); }
+      } // namespace layout_detail
+
+      constexpr auto vector_width_bits = ::ket::gate::split::layout_detail::log2(vector_width);
+
+      template <typename RandomAccessIterator>
+      inline auto is_split_layout_applicable(RandomAccessIterator const first, RandomAccessIterator const last) -> bool
+      {
+        auto const num_amplitudes = static_cast<std::size_t>(last - first);
+        return num_amplitudes >= vector_width and num_amplitudes % vector_width == std::size_t{0u};
+      }
+
+      namespace layout_detail
+      {
+        template <typename RandomAccessIterator>
+        inline auto real_pointer(RandomAccessIterator const first)
+        -> ::ket::utility::meta::real_t<typename std::iterator_traits<RandomAccessIterator>::value_type>*
+        {
+          using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+          using real_type = ::ket::utility::meta::real_t<complex_type>;
+          static_assert(
+            std::is_same<complex_type, std::complex<real_type>>::value,
+            "value_type of RandomAccessIterator should be std::complex");
+
+          // std::complex<T> is guaranteed to be array-like, T[2]
+          return reinterpret_cast<real_type*>(std::addressof(*first));
+        }
+      } // namespace layout_detail
+
+      // [re_0, im_0, re_1, im_1, ...] => [re_0, re_1, ..., re_{w-1}, im_0, im_1, ..., im_{w-1}, re_w, ...]
+      template <typename ParallelPolicy, typename RandomAccessIterator>
+      inline auto to_split_layout(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last)
+      -> void
+      {
+        assert(::ket::gate::split::is_split_layout_applicable(first, last));
+
+        auto const reals = ::ket::gate::split::layout_detail::real_pointer(first);
+        using real_type = std::remove_pointer_t<decltype(reals)>;
+
+        ::ket::utility::loop_n(
+          parallel_policy, static_cast<std::size_t>(last - first) / vector_width,
+          [reals](std::size_t const block_index, int const)
+          {
+            auto const block = reals + block_index * (std::size_t{2u} * vector_width);
+
+            auto buffer = std::array<real_type, 2u * vector_width>{};
+            for (auto lane = std::size_t{0u}; lane < vector_width; ++lane)
+            {
+              buffer[lane] = block[2u * lane];
+              buffer[vector_width + lane] = block[2u * lane + 1u];
+            }
+
+            using std::begin;
+            using std::end;
+            std::copy(begin(buffer), end(buffer), block);
+          });
+      }
+
+      template <typename RandomAccessIterator>
+      inline auto to_split_layout(RandomAccessIterator const first, RandomAccessIterator const last) -> void
+      { ::ket::gate::split::to_split_layout(::ket::utility::policy::make_sequential(), first, last); }
+
+      // [re_0, re_1, ..., re_{w-1}, im_0, im_1, ..., im_{w-1}, re_w, ...] => [re_0, im_0, re_1, im_1, ...]
+      template <typename ParallelPolicy, typename RandomAccessIterator>
+      inline auto to_interleaved_layout(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last)
+      -> void
+      {
+        assert(::ket::gate::split::is_split_layout_applicable(first, last));
+
+        auto const reals = ::ket::gate::split::layout_detail::real_pointer(first);
+        using real_type = std::remove_pointer_t<decltype(reals)>;
+
+        ::ket::utility::loop_n(
+          parallel_policy, static_cast<std::size_t>(last - first) / vector_width,
+          [reals](std::size_t const block_index, int const)
+          {
+            auto const block = reals + block_index * (std::size_t{2u} * vector_width);
+
+            auto buffer = std::array<real_type, 2u * vector_width>{};
+            for (auto lane = std::size_t{0u}; lane < vector_width; ++lane)
+            {
+              buffer[2u * lane] = block[lane];
+              buffer[2u * lane + 1u] = block[vector_width + lane];
+            }
+
+            using std::begin;
+            using std::end;
+            std::copy(begin(buffer), end(buffer), block);
+          });
+      }
+
+      template <typename RandomAccessIterator>
+      inline auto to_interleaved_layout(RandomAccessIterator const first, RandomAccessIterator const last) -> void
+      { ::ket::gate::split::to_interleaved_layout(::ket::utility::policy::make_sequential(), first, last); }
+
+      // index-th amplitude of a state vector in split layout
+      template <typename RandomAccessIterator, typename StateInteger>
+      inline auto amplitude(RandomAccessIterator const first, StateInteger const index)
+      -> typename std::iterator_traits<RandomAccessIterator>::value_type
+      {
+        using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        using real_type = ::ket::utility::meta::real_t<complex_type>;
+        auto const reals = reinterpret_cast<real_type const*>(std::addressof(*first));
+        auto const block = reals + static_cast<std::size_t>(index >> vector_width_bits) * (std::size_t{2u} * vector_width);
+        auto const lane = static_cast<std::size_t>(index) bitand (vector_width - std::size_t{1u});
+        return {block[lane], block[vector_width + lane]};
+      }
+
+      namespace ranges
+      {
+        template <typename ParallelPolicy, typename RandomAccessRange>
+        inline auto to_split_layout(ParallelPolicy const parallel_policy, RandomAccessRange& state)
+        -> std::enable_if_t< ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange& >
+        {
+          using std::begin;
+          using std::end;
+          ::ket::gate::split::to_split_layout(parallel_policy, begin(state), end(state));
+          return state;
+        }
+
+        template <typename RandomAccessRange>
+        inline auto to_split_layout(RandomAccessRange& state) -> RandomAccessRange&
+        { return ::ket::gate::split::ranges::to_split_layout(::ket::utility::policy::make_sequential(), state); }
+
+        template <typename ParallelPolicy, typename RandomAccessRange>
+        inline auto to_interleaved_layout(ParallelPolicy const parallel_policy, RandomAccessRange& state)
+        -> std::enable_if_t< ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange& >
+        {
+          using std::begin;
+          using std::end;
+          ::ket::gate::split::to_interleaved_layout(parallel_policy, begin(state), end(state));
+          return state;
+        }
+
+        template <typename RandomAccessRange>
+        inline auto to_interleaved_layout(RandomAccessRange& state) -> RandomAccessRange&
+        { return ::ket::gate::split::ranges::to_interleaved_layout(::ket::utility::policy::make_sequential(), state); }
+      } // namespace ranges
+    } // namespace split
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_SPLIT_LAYOUT_HPP
@@ -67,7 +67,7 @@ namespace ket
 
       ::ket::utility::loop_n(
         parallel_policy, static_cast<StateInteger>(last - first) >> 3u,
-        [first, target_qubit_mask, control_qubits_mask, &bits_mask](StateInteger const value_wo_qubits, int const)
+        [first, target_qubit_mask, control_qubits_mask, &bits_mask](StateInteger const value_wo_qubits, int const) noexcept
         {
           // xxx0_cxxx0_txxxx0_cxxx
           auto const base_index
@@ -3,6 +3,7 @@
 
 # include <string>
 # include <utility>
+# include <type_traits>
 
 # include <ket/utility/imaginary_unit.hpp>
 # include <ket/utility/meta/real_of.hpp>
@@ -57,6 +58,66 @@ namespace ket
 
         return {result_index, result_coeff};
       }
+
+      // pauli_masks: compiled form of a Pauli string
+      //   a'(n) = coefficient (-1)^{popcount(n & z_mask)} a(n ^ x_mask)
+      //   x_mask: bits of X and Y, z_mask: bits of Z and Y, coefficient: (-i)^{number of Y} times the given scalar
+      template <typename StateInteger, typename Complex>
+      struct pauli_masks
+      {
+        StateInteger x_mask;
+        StateInteger z_mask;
+        Complex coefficient;
+      }; // struct pauli_masks<StateInteger, Complex>
+
+      template <typename StateInteger, typename Complex>
+      inline auto make_pauli_masks(std::string const& pauli_string, Complex const& scalar)
+      -> ::ket::gate::utility::pauli_masks<StateInteger, Complex>
+      {
+        static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
+
+        auto result = ::ket::gate::utility::pauli_masks<StateInteger, Complex>{StateInteger{0u}, StateInteger{0u}, scalar};
+
+        auto const pauli_string_length = pauli_string.size();
+        for (auto n = decltype(pauli_string_length){0}; n < pauli_string_length; ++n)
+        {
+          if (pauli_string[n] == 'X')
+            result.x_mask |= StateInteger{1u} << n;
+          else if (pauli_string[n] == 'Y')
+          {
+            result.x_mask |= StateInteger{1u} << n;
+            result.z_mask |= StateInteger{1u} << n;
+            result.coefficient *= ::ket::utility::minus_imaginary_unit<Complex>();
+          }
+          else if (pauli_string[n] == 'Z')
+            result.z_mask |= StateInteger{1u} << n;
+        }
+
+        return result;
+      }
+
+      template <typename StateInteger>
+      inline auto has_odd_parity(StateInteger value) noexcept -> bool
+      {
+        static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
+# if defined(__GNUC__) || defined(__clang__)
+        return __builtin_parityll(static_cast<unsigned long long>(value)) != 0;
+# else // defined(__GNUC__) || defined(__clang__)
+        auto result = false;
+        for (; value != StateInteger{0u}; value &= value - StateInteger{1u})
+          result = not result;
+        return result;
+# endif // defined(__GNUC__) || defined(__clang__)
+      }
+
+      template <typename Complex, typename StateInteger>
+      inline auto pauli_index_coeff(::ket::gate::utility::pauli_masks<StateInteger, Complex> const& masks, StateInteger const index)
+      -> std::pair<StateInteger, Complex>
+      {
+        return {
+          index xor masks.x_mask,
+          ::ket::gate::utility::has_odd_parity(index bitand masks.z_mask) ? -masks.coefficient : masks.coefficient};
+      }
     } // namespace utility
   } // namespace gate
 } // namespace ket
@@ -2,15 +2,116 @@
 # define KET_GENERATE_EVENTS_HPP
 
 # include <cmath>
+# include <cstddef>
+# include <complex>
 # include <vector>
 # include <iterator>
 # include <algorithm>
+# include <numeric>
+# include <utility>
 
+# include <ket/utility/loop_n.hpp>
 # include <ket/utility/positive_random_value_upto.hpp>
+# include <ket/utility/meta/real_of.hpp>
 
 
 namespace ket
 {
+  namespace generate_events_detail
+  {
+    // The state vector is divided into blocks of num_elements_in_block elements, and sums of probabilities in blocks are used as a side structure
+    constexpr auto num_elements_in_block = std::size_t{1024u};
+
+    // returns the inclusive scan of probabilities of blocks in [first, last)
+    template <typename ParallelPolicy, typename RandomAccessIterator>
+    inline auto cumulative_block_probabilities(
+      ParallelPolicy const parallel_policy, RandomAccessIterator const first, RandomAccessIterator const last)
+    -> std::vector< ::ket::utility::meta::real_t<typename std::iterator_traits<RandomAccessIterator>::value_type> >
+    {
+      using real_type = ::ket::utility::meta::real_t<typename std::iterator_traits<RandomAccessIterator>::value_type>;
+      auto const num_elements = static_cast<std::size_t>(last - first);
+      auto const num_blocks = (num_elements + num_elements_in_block - std::size_t{1u}) / num_elements_in_block;
+
+      auto result = std::vector<real_type>(num_blocks);
+      ::ket::utility::loop_n(
+        parallel_policy, num_blocks,
+        [first, num_elements, &result](std::size_t const block_index, int const)
+        {
+          auto const block_first = first + block_index * num_elements_in_block;
+          auto const block_last = first + std::min(num_elements, (block_index + std::size_t{1u}) * num_elements_in_block);
+          using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+          result[block_index]
+            = std::accumulate(
+                block_first, block_last, real_type{0},
+                [](real_type const partial_sum, complex_type const& value) { using std::norm; return partial_sum + norm(value); });
+        });
+
+      using std::begin;
+      using std::end;
+      std::partial_sum(begin(result), end(result), begin(result));
+      return result;
+    }
+
+    // [random_value_first, random_value_last) is a sorted range of (random value, event index) pairs, and base_probability is the total probability before *first.
+    // function(event_index, index) is called for each random value, where index is the first index in [first, last) such that base_probability + (sum of probabilities in [first, first + index]) > random value.
+    // If such an index does not exist because of rounding errors, the index of the last element with nonzero probability is used.
+    template <typename RandomAccessIterator, typename Real, typename RandomValueIterator, typename Function>
+    inline auto find_events(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      std::vector<Real> const& cumulative_block_probabilities, Real const base_probability,
+      RandomValueIterator const random_value_first, RandomValueIterator const random_value_last,
+      Function&& function)
+    -> void
+    {
+      auto const num_elements = static_cast<std::size_t>(last - first);
+      auto const num_blocks = cumulative_block_probabilities.size();
+
+      auto block_index = std::size_t{0u};
+      auto index = std::size_t{0u};
+      auto partial_sum = base_probability;
+      for (auto iter = random_value_first; iter != random_value_last; ++iter)
+      {
+        auto const random_value = iter->first;
+
+        // skip blocks whose probabilities are not needed
+        while (block_index + std::size_t{1u} < num_blocks
+               and base_probability + cumulative_block_probabilities[block_index] <= random_value)
+        {
+          partial_sum = base_probability + cumulative_block_probabilities[block_index];
+          ++block_index;
+          index = block_index * num_elements_in_block;
+        }
+
+        while (index < num_elements)
+        {
+          using std::norm;
+          auto const probability = norm(*(first + index));
+          if (partial_sum + probability > random_value)
+            break;
+
+          partial_sum += probability;
+          ++index;
+          block_index = index / num_elements_in_block;
+        }
+
+        if (index < num_elements)
+        {
+          function(iter->second, index);
+          continue;
+        }
+
+        auto last_nonzero_index = num_elements - std::size_t{1u};
+        using std::norm;
+        while (last_nonzero_index > std::size_t{0u} and norm(*(first + last_nonzero_index)) == Real{0})
+          --last_nonzero_index;
+        for (; iter != random_value_last; ++iter)
+          function(iter->second, last_nonzero_index);
+        return;
+      }
+    }
+  } // namespace generate_events_detail
+
+  // Events are generated without modifying the state: all random values are sorted and found by one scan of the state
   template <
     typename ParallelPolicy,
     typename StateInteger, typename Allocator,
@@ -22,32 +123,28 @@ namespace ket
     int const num_events, RandomNumberGenerator& random_number_generator)
   -> void
   {
-    result.clear();
-    result.reserve(num_events);
+    result.assign(num_events, StateInteger{0u});
 
-    using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
-    ::ket::utility::transform_inclusive_scan(
-      parallel_policy, first, last, first,
-      [](complex_type const& lhs, complex_type const& rhs)
-      { using std::real; return static_cast<complex_type>(real(lhs) + real(rhs)); },
-      [](complex_type const& value)
-      { using std::norm; return static_cast<complex_type>(norm(value)); });
-
-    using std::real;
-    auto const total_probability = real(*std::prev(last));
+    auto const cumulative_block_probabilities
+      = ::ket::generate_events_detail::cumulative_block_probabilities(parallel_policy, first, last);
+    using real_type = typename decltype(cumulative_block_probabilities)::value_type;
+    auto const total_probability = cumulative_block_probabilities.back();
 
+    auto random_values = std::vector<std::pair<real_type, int>>{};
+    random_values.reserve(num_events);
     for (auto event_index = int{0}; event_index < num_events; ++event_index)
-    {
-      RandomAccessIterator const found
-        = std::upper_bound(
-            first, last,
-            static_cast<complex_type>(
-              ::ket::utility::positive_random_value_upto(total_probability, random_number_generator)),
-            [](complex_type const& lhs, complex_type const& rhs)
-            { return real(lhs) < real(rhs); });
-
-      result.push_back(found - first);
-    }
+      random_values.emplace_back(
+        ::ket::utility::positive_random_value_upto(total_probability, random_number_generator), event_index);
+
+    using std::begin;
+    using std::end;
+    std::sort(begin(random_values), end(random_values));
+
+    ::ket::generate_events_detail::find_events(
+      first, last, cumulative_block_probabilities, real_type{0},
+      begin(random_values), end(random_values),
+      [&result](int const event_index, std::size_t const index)
+      { result[event_index] = static_cast<StateInteger>(index); });
   }
 
   template <
@@ -4,6 +4,7 @@
 # include <cassert>
 # include <cstddef>
 # include <iterator>
+# include <algorithm>
 # include <type_traits>
 # include <vector>
 
@@ -12,12 +13,14 @@
 # include <yampi/datatype_base.hpp>
 
 # include <ket/control.hpp>
+# include <ket/addition_assignment.hpp>
+# include <ket/gate/diagonal.hpp>
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/generate_phase_coefficients.hpp>
 # include <ket/utility/meta/ranges.hpp>
 # include <ket/mpi/swapped_fourier_transform.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
-# include <ket/mpi/gate/controlled_phase_shift.hpp>
+# include <ket/mpi/gate/diagonal.hpp>
 # include <ket/mpi/utility/simple_mpi.hpp>
 # include <ket/mpi/utility/logger.hpp>
 
@@ -29,69 +32,28 @@ namespace ket
     // lhs += rhs
     namespace addition_assignment_detail
     {
+      // The controlled phase shifts for all rhs registers are diagonal, so they are applied in one sweep without any communication
       template <
         typename MpiPolicy, typename ParallelPolicy,
-        typename RandomAccessRange, typename StateInteger, typename BitInteger,
-        typename Allocator, typename BufferAllocator,
-        typename Iterator1, typename Iterator2, typename PhaseCoefficientsAllocator>
+        typename RandomAccessRange, typename StateInteger, typename BitInteger, typename Allocator,
+        typename Iterator, typename QubitsRange, typename PhaseCoefficientsAllocator>
       inline auto do_addition_assignment(
         MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
         RandomAccessRange& local_state,
-        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, BufferAllocator >& buffer,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
         yampi::communicator const& communicator, yampi::environment const& environment,
-        Iterator1 const lhs_qubits_first, Iterator2 const rhs_qubits_first, BitInteger const register_size,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator >& phase_coefficients)
+        Iterator const lhs_qubits_first, QubitsRange const& rhs_qubits_range, BitInteger const register_size,
+        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator > const& phase_coefficients,
+        bool const is_adjoint)
       -> void
       {
-        for (auto phase_exponent = BitInteger{1u}; phase_exponent <= register_size; ++phase_exponent)
-        {
-          auto const phase_coefficient = phase_coefficients[phase_exponent];
-
-          for (auto control_bit_index = BitInteger{0u};
-               control_bit_index <= register_size - phase_exponent; ++control_bit_index)
-          {
-            auto const target_bit_index = control_bit_index + (phase_exponent - BitInteger{1u});
-
-            ::ket::mpi::gate::controlled_phase_shift_coeff(
-              mpi_policy, parallel_policy,
-              local_state, permutation, buffer, communicator, environment,
-              phase_coefficient, lhs_qubits_first[target_bit_index], ::ket::make_control(rhs_qubits_first[control_bit_index]));
-          }
-        }
-      }
+        using std::begin;
+        auto accumulator = ::ket::gate::diagonal_accumulator< ::ket::utility::meta::range_value_t<RandomAccessRange>, StateInteger >{};
+        for (auto const& rhs_qubits: rhs_qubits_range)
+          ::ket::addition_assignment_detail::accumulate_phases(
+            accumulator, lhs_qubits_first, begin(rhs_qubits), register_size, phase_coefficients, is_adjoint);
 
-      template <
-        typename MpiPolicy, typename ParallelPolicy,
-        typename RandomAccessRange, typename StateInteger, typename BitInteger,
-        typename Allocator, typename BufferAllocator, typename DerivedDatatype,
-        typename Iterator1, typename Iterator2, typename PhaseCoefficientsAllocator>
-      inline auto do_addition_assignment(
-        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
-        RandomAccessRange& local_state,
-        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, BufferAllocator >& buffer,
-        yampi::datatype_base<DerivedDatatype> const& datatype,
-        yampi::communicator const& communicator, yampi::environment const& environment,
-        Iterator1 const lhs_qubits_first, Iterator2 const rhs_qubits_first, BitInteger const register_size,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator >& phase_coefficients)
-      -> void
-      {
-        for (auto phase_exponent = BitInteger{1u}; phase_exponent <= register_size; ++phase_exponent)
-        {
-          auto const phase_coefficient = phase_coefficients[phase_exponent];
-
-          for (auto control_bit_index = BitInteger{0u};
-               control_bit_index <= register_size - phase_exponent; ++control_bit_index)
-          {
-            auto const target_bit_index = control_bit_index + (phase_exponent - BitInteger{1u});
-
-            ::ket::mpi::gate::controlled_phase_shift_coeff(
-              mpi_policy, parallel_policy,
-              local_state, permutation, buffer, datatype, communicator, environment,
-              phase_coefficient, lhs_qubits_first[target_bit_index], ::ket::make_control(rhs_qubits_first[control_bit_index]));
-          }
-        }
+        ::ket::mpi::gate::diagonal(mpi_policy, parallel_policy, local_state, permutation, communicator, environment, accumulator);
       }
     } // namespace addition_assignment_detail
 
@@ -136,15 +98,13 @@ namespace ket
         local_state, permutation, buffer, communicator, environment,
         lhs_qubits, phase_coefficients);
 
-      for (auto const& rhs_qubits: rhs_qubits_range)
-        ::ket::mpi::addition_assignment_detail::do_addition_assignment(
-          mpi_policy, parallel_policy,
-          local_state, permutation, buffer, communicator, environment,
-          begin(lhs_qubits), begin(rhs_qubits), register_size, phase_coefficients);
+      ::ket::mpi::addition_assignment_detail::do_addition_assignment(
+        mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
+        begin(lhs_qubits), rhs_qubits_range, register_size, phase_coefficients, false);
 
       ::ket::mpi::adj_swapped_fourier_transform(
         mpi_policy, parallel_policy,
-        local_state, permutation, buffer, communicator, environment
+        local_state, permutation, buffer, communicator, environment,
         lhs_qubits, phase_coefficients);
 
       return local_state;
@@ -213,11 +173,9 @@ namespace ket
         local_state, permutation, buffer, datatype, communicator, environment,
         lhs_qubits, phase_coefficients);
 
-      for (auto const& rhs_qubits: rhs_qubits_range)
-        ::ket::mpi::addition_assignment_detail::do_addition_assignment(
-          mpi_policy, parallel_policy,
-          local_state, permutation, buffer, datatype, communicator, environment,
-          begin(lhs_qubits), begin(rhs_qubits), register_size, phase_coefficients,
+      ::ket::mpi::addition_assignment_detail::do_addition_assignment(
+        mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
+        begin(lhs_qubits), rhs_qubits_range, register_size, phase_coefficients, false);
 
       ::ket::mpi::adj_swapped_fourier_transform(
         mpi_policy, parallel_policy,
@@ -736,80 +694,6 @@ namespace ket
     }
 
 
-    namespace addition_assignment_detail
-    {
-      template <
-        typename MpiPolicy, typename ParallelPolicy,
-        typename RandomAccessRange, typename StateInteger, typename BitInteger,
-        typename Allocator, typename BufferAllocator,
-        typename Iterator1, typename Iterator2, typename PhaseCoefficientsAllocator>
-      inline auto do_adj_addition_assignment(
-        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
-        RandomAccessRange& local_state,
-        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, BufferAllocator >& buffer,
-        yampi::communicator const& communicator, yampi::environment const& environment,
-        Iterator1 const lhs_qubits_first, Iterator2 const rhs_qubits_first, BitInteger const register_size,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator >& phase_coefficients)
-      -> void
-      {
-        for (auto index = BitInteger{0u}; index < register_size; ++index)
-        {
-          auto const phase_exponent = register_size - index;
-
-          auto const phase_coefficient = phase_coefficients[phase_exponent];
-
-          for (auto control_bit_index = BitInteger{0u};
-               control_bit_index <= register_size - phase_exponent; ++control_bit_index)
-          {
-            auto const target_bit_index
-              = control_bit_index + (phase_exponent - BitInteger{1u});
-
-            ::ket::mpi::gate::adj_controlled_phase_shift_coeff(
-              mpi_policy, parallel_policy,
-              local_state, permutation, buffer, communicator, environment);
-              phase_coefficient, lhs_qubits_first[target_bit_index], ::ket::make_control(rhs_qubits_first[control_bit_index]));
-          }
-        }
-      }
-
-      template <
-        typename MpiPolicy, typename ParallelPolicy,
-        typename RandomAccessRange, typename StateInteger, typename BitInteger,
-        typename Allocator, typename BufferAllocator, typename DerivedDatatype,
-        typename Iterator1, typename Iterator2, typename PhaseCoefficientsAllocator>
-      inline auto do_adj_addition_assignment(
-        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
-        RandomAccessRange& local_state,
-        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, BufferAllocator >& buffer,
-        yampi::datatype_base<DerivedDatatype> const& datatype,
-        yampi::communicator const& communicator, yampi::environment const& environment,
-        Iterator1 const lhs_qubits_first, Iterator2 const rhs_qubits_first, BitInteger const register_size,
-        std::vector< ::ket::utility::meta::range_value_t<RandomAccessRange>, PhaseCoefficientsAllocator >& phase_coefficients)
-      -> void
-      {
-        for (auto index = BitInteger{0u}; index < register_size; ++index)
-        {
-          auto const phase_exponent = register_size - index;
-
-          auto const phase_coefficient = phase_coefficients[phase_exponent];
-
-          for (auto control_bit_index = BitInteger{0u};
-               control_bit_index <= register_size - phase_exponent; ++control_bit_index)
-          {
-            auto const target_bit_index
-              = control_bit_index + (phase_exponent - BitInteger{1u});
-
-            ::ket::mpi::gate::adj_controlled_phase_shift_coeff(
-              mpi_policy, parallel_policy,
-              local_state, permutation, buffer, datatype, communicator, environment);
-              phase_coefficient, lhs_qubits_first[target_bit_index], ::ket::make_control(rhs_qubits_first[control_bit_index]));
-          }
-        }
-      }
-    } // namespace addition_assignment_detail
-
     template <
       typename MpiPolicy, typename ParallelPolicy,
       typename RandomAccessRange,
@@ -851,11 +735,9 @@ namespace ket
         local_state, permutation, buffer, communicator, environment,
         lhs_qubits, phase_coefficients);
 
-      for (auto const& rhs_qubits: rhs_qubits_range)
-        ::ket::mpi::addition_assignment_detail::do_adj_addition_assignment(
-          mpi_policy, parallel_policy,
-          local_state, permutation, buffer, communicator, environment,
-          begin(lhs_qubits), begin(rhs_qubits), register_size, phase_coefficients);
+      ::ket::mpi::addition_assignment_detail::do_addition_assignment(
+        mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
+        begin(lhs_qubits), rhs_qubits_range, register_size, phase_coefficients, true);
 
       ::ket::mpi::adj_swapped_fourier_transform(
         mpi_policy, parallel_policy,
@@ -931,11 +813,9 @@ namespace ket
         local_state, permutation, buffer, datatype, communicator, environment,
         lhs_qubits, phase_coefficients);
 
-      for (auto const& rhs_qubits: rhs_qubits_range)
-        ::ket::mpi::addition_assignment_detail::do_adj_addition_assignment(
-          mpi_policy, parallel_policy,
-          local_state, permutation, buffer, datatype, communicator, environment,
-          begin(lhs_qubits), begin(rhs_qubits), register_size, phase_coefficients);
+      ::ket::mpi::addition_assignment_detail::do_addition_assignment(
+        mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
+        begin(lhs_qubits), rhs_qubits_range, register_size, phase_coefficients, true);
 
       ::ket::mpi::adj_swapped_fourier_transform(
         mpi_policy, parallel_policy,
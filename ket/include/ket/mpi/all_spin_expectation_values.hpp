@@ -1,7 +1,10 @@
 #ifndef KET_MPI_ALL_EXPECTATION_VALUES_HPP
 # define KET_MPI_ALL_EXPECTATION_VALUES_HPP
 
+# include <cstddef>
+# include <vector>
 # include <array>
+# include <iterator>
 # include <type_traits>
 
 # include <boost/optional.hpp>
@@ -9,20 +12,85 @@
 # include <yampi/environment.hpp>
 # include <yampi/datatype_base.hpp>
 # include <yampi/communicator.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/all_reduce.hpp>
+# include <yampi/reduce.hpp>
+# include <yampi/binary_operation.hpp>
 
 # include <ket/qubit.hpp>
+# include <ket/all_spin_expectation_values.hpp>
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/real_of.hpp>
 # include <ket/utility/meta/ranges.hpp>
+# include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/spin_expectation_value.hpp>
+# include <ket/mpi/page/is_on_page.hpp>
+# include <ket/mpi/page/spin_expectation_value.hpp>
 # include <ket/mpi/utility/simple_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/logger.hpp>
 
 
 namespace ket
 {
   namespace mpi
   {
+    namespace all_spin_expectation_values_detail
+    {
+      // permutated_bits[bit] is the permutated bit of qubit "bit"
+      template <typename StateInteger, typename BitInteger, typename Allocator>
+      inline auto permutated_bits(
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation, BitInteger const num_qubits)
+      -> std::vector<BitInteger>
+      {
+        auto result = std::vector<BitInteger>{};
+        result.reserve(num_qubits);
+        for (auto bit = BitInteger{0u}; bit < num_qubits; ++bit)
+          result.push_back(static_cast<BitInteger>(permutation[::ket::make_qubit<StateInteger>(bit)].qubit()));
+        return result;
+      }
+
+      // Spins (x0, y0, z0, x1, y1, z1, ...) of local qubits (including page qubits) in this process, which are indexed by permutated bits and are not reduced yet.
+      // All local qubits are dealt with by a few sweeps of local_state
+      template <typename StateInteger, typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename BitInteger>
+      inline auto local_spin_values(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy, LocalState& local_state, BitInteger const num_local_qubits,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      -> std::vector< ::ket::utility::meta::real_t< ::ket::utility::meta::range_value_t<LocalState> > >
+      {
+        using real_type = ::ket::utility::meta::real_t< ::ket::utility::meta::range_value_t<LocalState> >;
+        auto result = std::vector<real_type>(std::size_t{3u} * num_local_qubits, real_type{0});
+
+        auto const add_spins
+          = [&result](auto const& spins)
+            {
+              for (auto index = std::size_t{0u}; index < spins.size(); ++index)
+              {
+                result[std::size_t{3u} * index] += spins[index][0u];
+                result[std::size_t{3u} * index + 1u] += spins[index][1u];
+                result[std::size_t{3u} * index + 2u] += spins[index][2u];
+              }
+            };
+
+        if (num_local_qubits > BitInteger{0u}
+            and ::ket::mpi::page::is_on_page(
+                  ::ket::mpi::make_permutated(::ket::make_qubit<StateInteger>(static_cast<BitInteger>(num_local_qubits - BitInteger{1u}))),
+                  local_state))
+        {
+          add_spins(::ket::mpi::page::all_spin_expectation_values(parallel_policy, local_state));
+          return result;
+        }
+
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [parallel_policy, &add_spins](auto const first, auto const last)
+          { add_spins(::ket::all_spin_expectation_values< ::ket::qubit<StateInteger, BitInteger> >(parallel_policy, first, last)); });
+
+        return result;
+      }
+    } // namespace all_spin_expectation_values_detail
+
     // all_reduce version
     template <
       typename SpinsAllocator,
@@ -42,19 +110,40 @@ namespace ket
       std::vector< ::ket::utility::meta::range_value_t<LocalState>, BufferAllocator >& buffer,
       yampi::communicator const& communicator, yampi::environment const& environment)
     {
+      ::ket::mpi::utility::log_with_time_guard<char> print{"All Spins", environment};
+
+      // Spins of qubits which are local at first are computed at once, and then the others are computed one by one
+      auto const num_local_qubits
+        = static_cast<BitInteger>(::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+      auto const permutated_bits = ::ket::mpi::all_spin_expectation_values_detail::permutated_bits(permutation, num_qubits);
+      auto local_spin_values
+        = ::ket::mpi::all_spin_expectation_values_detail::local_spin_values<StateInteger>(
+            mpi_policy, parallel_policy, local_state, num_local_qubits, communicator, environment);
+      yampi::all_reduce(
+        yampi::in_place, yampi::range_to_buffer(local_spin_values), yampi::binary_operation{::yampi::tags::plus},
+        communicator, environment);
+
       using complex_type = ::ket::utility::meta::range_value_t<LocalState>;
       using real_type = ::ket::utility::meta::real_t<complex_type>;
       using spin_type = std::array<real_type, 3u>;
       auto result = std::vector<spin_type, SpinsAllocator>{};
       result.reserve(num_qubits);
 
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
-        result.push_back(
-          ::ket::mpi::spin_expectation_value(
-            mpi_policy, parallel_policy,
-            local_state, permutation, buffer, communicator, environment, qubit));
+      for (auto bit = BitInteger{0u}; bit < num_qubits; ++bit)
+      {
+        auto const permutated_bit = static_cast<std::size_t>(permutated_bits[bit]);
+        if (permutated_bits[bit] < num_local_qubits)
+          result.push_back(
+            spin_type{
+              local_spin_values[3u * permutated_bit], local_spin_values[3u * permutated_bit + 1u],
+              local_spin_values[3u * permutated_bit + 2u]});
+        else
+          result.push_back(
+            ::ket::mpi::spin_expectation_value(
+              mpi_policy, parallel_policy,
+              local_state, permutation, buffer, communicator, environment,
+              ::ket::make_qubit<StateInteger>(bit)));
+      }
 
       return result;
     }
@@ -80,19 +169,40 @@ namespace ket
       yampi::datatype_base<DerivedDatatype2> const& complex_datatype,
       yampi::communicator const& communicator, yampi::environment const& environment)
     {
+      ::ket::mpi::utility::log_with_time_guard<char> print{"All Spins", environment};
+
+      // Spins of qubits which are local at first are computed at once, and then the others are computed one by one
+      auto const num_local_qubits
+        = static_cast<BitInteger>(::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+      auto const permutated_bits = ::ket::mpi::all_spin_expectation_values_detail::permutated_bits(permutation, num_qubits);
+      auto local_spin_values
+        = ::ket::mpi::all_spin_expectation_values_detail::local_spin_values<StateInteger>(
+            mpi_policy, parallel_policy, local_state, num_local_qubits, communicator, environment);
+      yampi::all_reduce(
+        yampi::in_place, yampi::range_to_buffer(local_spin_values, real_datatype), yampi::binary_operation{::yampi::tags::plus},
+        communicator, environment);
+
       using complex_type = ::ket::utility::meta::range_value_t<LocalState>;
       using real_type = ::ket::utility::meta::real_t<complex_type>;
       using spin_type = std::array<real_type, 3u>;
       auto result = std::vector<spin_type, SpinsAllocator>{};
       result.reserve(num_qubits);
 
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
-        result.push_back(
-          ::ket::mpi::spin_expectation_value(
-            mpi_policy, parallel_policy,
-            local_state, permutation, buffer, real_datatype, complex_datatype, communicator, environment, qubit));
+      for (auto bit = BitInteger{0u}; bit < num_qubits; ++bit)
+      {
+        auto const permutated_bit = static_cast<std::size_t>(permutated_bits[bit]);
+        if (permutated_bits[bit] < num_local_qubits)
+          result.push_back(
+            spin_type{
+              local_spin_values[3u * permutated_bit], local_spin_values[3u * permutated_bit + 1u],
+              local_spin_values[3u * permutated_bit + 2u]});
+        else
+          result.push_back(
+            ::ket::mpi::spin_expectation_value(
+              mpi_policy, parallel_policy,
+              local_state, permutation, buffer, real_datatype, complex_datatype, communicator, environment,
+              ::ket::make_qubit<StateInteger>(bit)));
+      }
 
       return result;
     }
@@ -359,8 +469,23 @@ namespace ket
       std::vector< ::ket::utility::meta::range_value_t<LocalState>, BufferAllocator >& buffer,
       yampi::rank const root, yampi::communicator const& communicator, yampi::environment const& environment)
     {
+      ::ket::mpi::utility::log_with_time_guard<char> print{"All Spins", environment};
+
       auto const is_root = communicator.rank(environment) == root;
 
+      // Spins of qubits which are local at first are computed at once, and then the others are computed one by one
+      auto const num_local_qubits
+        = static_cast<BitInteger>(::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+      auto const permutated_bits = ::ket::mpi::all_spin_expectation_values_detail::permutated_bits(permutation, num_qubits);
+      auto local_spin_values
+        = ::ket::mpi::all_spin_expectation_values_detail::local_spin_values<StateInteger>(
+            mpi_policy, parallel_policy, local_state, num_local_qubits, communicator, environment);
+      auto reduced_spin_values = local_spin_values;
+      using std::begin;
+      yampi::reduce(
+        yampi::range_to_buffer(local_spin_values), begin(reduced_spin_values), yampi::binary_operation{::yampi::tags::plus},
+        root, communicator, environment);
+
       using complex_type = ::ket::utility::meta::range_value_t<LocalState>;
       using real_type = ::ket::utility::meta::real_t<complex_type>;
       using spin_type = std::array<real_type, 3u>;
@@ -368,14 +493,24 @@ namespace ket
       if (is_root)
         result.reserve(num_qubits);
 
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
+      for (auto bit = BitInteger{0u}; bit < num_qubits; ++bit)
       {
+        auto const permutated_bit = static_cast<std::size_t>(permutated_bits[bit]);
+        if (permutated_bits[bit] < num_local_qubits)
+        {
+          if (is_root)
+            result.push_back(
+              spin_type{
+                reduced_spin_values[3u * permutated_bit], reduced_spin_values[3u * permutated_bit + 1u],
+                reduced_spin_values[3u * permutated_bit + 2u]});
+          continue;
+        }
+
         auto const maybe_expectation_value
           = ::ket::mpi::spin_expectation_value(
               mpi_policy, parallel_policy,
-              local_state, permutation, buffer, root, communicator, environment, qubit);
+              local_state, permutation, buffer, root, communicator, environment,
+              ::ket::make_qubit<StateInteger>(bit));
 
         if (is_root and maybe_expectation_value)
           result.push_back(*maybe_expectation_value);
@@ -409,8 +544,23 @@ namespace ket
       yampi::datatype_base<DerivedDatatype2> const& complex_datatype,
       yampi::rank const root, yampi::communicator const& communicator, yampi::environment const& environment)
     {
+      ::ket::mpi::utility::log_with_time_guard<char> print{"All Spins", environment};
+
       auto const is_root = communicator.rank(environment) == root;
 
+      // Spins of qubits which are local at first are computed at once, and then the others are computed one by one
+      auto const num_local_qubits
+        = static_cast<BitInteger>(::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+      auto const permutated_bits = ::ket::mpi::all_spin_expectation_values_detail::permutated_bits(permutation, num_qubits);
+      auto local_spin_values
+        = ::ket::mpi::all_spin_expectation_values_detail::local_spin_values<StateInteger>(
+            mpi_policy, parallel_policy, local_state, num_local_qubits, communicator, environment);
+      auto reduced_spin_values = local_spin_values;
+      using std::begin;
+      yampi::reduce(
+        yampi::range_to_buffer(local_spin_values, real_datatype), begin(reduced_spin_values), yampi::binary_operation{::yampi::tags::plus},
+        root, communicator, environment);
+
       using complex_type = ::ket::utility::meta::range_value_t<LocalState>;
       using real_type = ::ket::utility::meta::real_t<complex_type>;
       using spin_type = std::array<real_type, 3u>;
@@ -418,14 +568,24 @@ namespace ket
       if (is_root)
         result.reserve(num_qubits);
 
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
+      for (auto bit = BitInteger{0u}; bit < num_qubits; ++bit)
       {
+        auto const permutated_bit = static_cast<std::size_t>(permutated_bits[bit]);
+        if (permutated_bits[bit] < num_local_qubits)
+        {
+          if (is_root)
+            result.push_back(
+              spin_type{
+                reduced_spin_values[3u * permutated_bit], reduced_spin_values[3u * permutated_bit + 1u],
+                reduced_spin_values[3u * permutated_bit + 2u]});
+          continue;
+        }
+
         auto const maybe_expectation_value
           = ::ket::mpi::spin_expectation_value(
               mpi_policy, parallel_policy,
-              local_state, permutation, buffer, real_datatype, complex_datatype, root, communicator, environment, qubit);
+              local_state, permutation, buffer, real_datatype, complex_datatype, root, communicator, environment,
+              ::ket::make_qubit<StateInteger>(bit));
 
         if (is_root and maybe_expectation_value)
           result.push_back(*maybe_expectation_value);
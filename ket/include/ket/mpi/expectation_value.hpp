@@ -23,6 +23,7 @@
 
 # include <ket/qubit.hpp>
 # include <ket/utility/loop_n.hpp>
+# include <ket/utility/num_on_cache_qubits.hpp>
 # include <ket/utility/meta/ranges.hpp>
 # include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
@@ -110,10 +111,7 @@ namespace ket
 
             using permutated_qubit_type = ::ket::utility::meta::range_value_t<PermutatedQubitsRange>;
             using bit_integer_type = ::ket::meta::bit_integer_t<permutated_qubit_type>;
-# ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#   define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-# endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
 # ifndef KET_USE_BIT_MASKS_EXPLICITLY
             ::ket::mpi::gate::local::runtime::gate(
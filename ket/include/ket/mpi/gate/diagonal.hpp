@@ -0,0 +1,73 @@
+#ifndef KET_MPI_GATE_DIAGONAL_HPP
+# define KET_MPI_GATE_DIAGONAL_HPP
+
+# include <string>
+# include <vector>
+# include <iterator>
+# include <type_traits>
+
+# include <yampi/environment.hpp>
+# include <yampi/communicator.hpp>
+
+# include <ket/gate/diagonal.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+# include <ket/mpi/utility/simple_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/logger.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace gate
+    {
+      // Diagonal gates need no communication: masks of terms are permutated, and each local amplitude is multiplied by
+      // the coefficient for its permutated qubit value, which is determined by the rank and its local index
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename Complex>
+      inline auto diagonal(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator, yampi::environment const& environment,
+        ::ket::gate::diagonal_accumulator<Complex, StateInteger> const& accumulator)
+      -> RandomAccessRange&
+      {
+        static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
+        static_assert(std::is_unsigned<BitInteger>::value, "BitInteger should be unsigned");
+
+        ::ket::mpi::utility::log_with_time_guard<char> print{
+          ::ket::mpi::utility::generate_logger_string(std::string{"Diagonal "}, accumulator.size()), environment};
+
+        if (accumulator.empty())
+          return local_state;
+
+        auto const permutated_accumulator
+          = accumulator.transform_masks(
+              [&permutation](StateInteger const mask) { return ::ket::mpi::permutate_bits(permutation, mask); });
+        auto large_terms = std::vector< ::ket::gate::diagonal_term<Complex, StateInteger> >{};
+        auto const tables = ::ket::gate::diagonal_detail::make_phase_tables(permutated_accumulator, large_terms);
+
+        auto const present_rank = communicator.rank(environment);
+        auto local_index = StateInteger{0u};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [&mpi_policy, parallel_policy, &local_state, &tables, &large_terms, present_rank, &local_index](
+            auto const first, auto const last)
+          {
+            ::ket::gate::diagonal_detail::apply_phase_tables(
+              parallel_policy, first, last, tables, large_terms,
+              ::ket::mpi::utility::rank_index_to_qubit_value(mpi_policy, local_state, present_rank, local_index));
+            local_index += static_cast<StateInteger>(last - first);
+          });
+
+        return local_state;
+      }
+    } // namespace gate
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_GATE_DIAGONAL_HPP
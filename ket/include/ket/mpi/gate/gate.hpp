@@ -28,6 +28,7 @@
 # include <ket/utility/integer_exp2.hpp>
 # include <ket/utility/all_in_state_vector.hpp>
 # include <ket/utility/none_in_state_vector.hpp>
+# include <ket/utility/num_on_cache_qubits.hpp>
 # include <ket/utility/meta/ranges.hpp>
 # include <ket/meta/bit_integer_of.hpp>
 # include <ket/meta/state_integer_of.hpp>
@@ -383,10 +384,7 @@ namespace ket
                 std::array<qubit_type, num_operated_qubits> unsorted_qubits{
                   ::ket::remove_control(permutated_qubit.qubit()), ::ket::remove_control(permutated_qubits.qubit())...};
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-                constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+                auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
                 std::array<qubit_type, num_operated_qubits + bit_integer_type{1u}> sorted_qubits_with_sentinel{
                   ::ket::remove_control(permutated_qubit.qubit()), ::ket::remove_control(permutated_qubits.qubit())...,
@@ -430,10 +428,7 @@ namespace ket
 #   ifndef KET_USE_BIT_MASKS_EXPLICITLY
                 std::array<qubit_type, bit_integer_type{0u}> unsorted_qubits{};
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-                constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+                auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
                 std::array<qubit_type, bit_integer_type{1u}> sorted_qubits_with_sentinel{::ket::make_qubit<StateInteger>(num_on_cache_qubits)};
 
@@ -479,10 +474,7 @@ namespace ket
               std::array<qubit_type, num_operated_qubits> unsorted_qubits{
                 ::ket::remove_control(permutated_qubit.qubit()), ::ket::remove_control(permutated_qubits.qubit())...};
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-              constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+              auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
               std::array<qubit_type, num_operated_qubits + bit_integer_type{1u}> sorted_qubits_with_sentinel{
                 ::ket::remove_control(permutated_qubit.qubit()), ::ket::remove_control(permutated_qubits.qubit())...,
@@ -493,9 +485,9 @@ namespace ket
 
               return ::ket::mpi::utility::for_each_local_range(
                 mpi_policy, local_state, communicator, environment, unit_control_qubit_mask,
-                [parallel_policy, &unsorted_qubits, &sorted_qubits_with_sentinel, &function](auto const first, auto const last)
+                [parallel_policy, &unsorted_qubits, &sorted_qubits_with_sentinel, &function, num_on_cache_qubits](auto const first, auto const last)
                 {
-                  constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+                  auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
 
                   for (auto iter = first; iter < last; iter += cache_size)
                     ::ket::gate::gate_detail::gate_n(parallel_policy, iter, cache_size, unsorted_qubits, sorted_qubits_with_sentinel, function);
@@ -510,11 +502,8 @@ namespace ket
                 mpi_policy, local_state, communicator, environment, unit_control_qubit_mask,
                 [parallel_policy, &qubit_masks, &index_masks, &function](auto const first, auto const last)
                 {
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-                  constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-                  constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+                  auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+                  auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
 
                   for (auto iter = first; iter < last; iter += cache_size)
                     ::ket::gate::gate_detail::gate_n(parallel_policy, iter, cache_size, qubit_masks, index_masks, function);
@@ -540,19 +529,16 @@ namespace ket
 #   ifndef KET_USE_BIT_MASKS_EXPLICITLY
               std::array<qubit_type, bit_integer_type{0u}> unsorted_qubits{};
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-              constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+              auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
               std::array<qubit_type, bit_integer_type{1u}> sorted_qubits_with_sentinel{
                 ::ket::make_qubit<StateInteger>(num_on_cache_qubits)};
 
               return ::ket::mpi::utility::for_each_local_range(
                 mpi_policy, local_state, communicator, environment, unit_control_qubit_mask,
-                [parallel_policy, &unsorted_qubits, &sorted_qubits_with_sentinel, &function](auto const first, auto const last)
+                [parallel_policy, &unsorted_qubits, &sorted_qubits_with_sentinel, &function, num_on_cache_qubits](auto const first, auto const last)
                 {
-                  constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+                  auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
 
                   for (auto iter = first; iter < last; iter += cache_size)
                     ::ket::gate::gate_detail::gate_n(parallel_policy, iter, cache_size, unsorted_qubits, sorted_qubits_with_sentinel, function);
@@ -565,11 +551,8 @@ namespace ket
                 mpi_policy, local_state, communicator, environment, unit_control_qubit_mask,
                 [parallel_policy, &qubit_masks, &index_masks, &function](auto const first, auto const last)
                 {
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-                  constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-                  constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+                  auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+                  auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
 
                   for (auto iter = first; iter < last; iter += cache_size)
                     ::ket::gate::gate_detail::gate_n(parallel_policy, iter, cache_size, qubit_masks, index_masks, function);
@@ -658,11 +641,8 @@ namespace ket
               using qubit_type = ket::qubit<StateInteger>;
               using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-              constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-              constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+              auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+              auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
               assert(::ket::utility::none_in_state_vector(num_on_cache_qubits, permutated_qubits.qubit()...));
 
               // Case 1-2-1) Buffer size is large enough
@@ -673,7 +653,7 @@ namespace ket
 
                 return ::ket::mpi::utility::for_each_local_range(
                   mpi_policy, local_state, communicator, environment, unit_control_qubit_mask,
-                  [parallel_policy, &function, permutated_qubits..., buffer_first](auto const first, auto const last)
+                  [parallel_policy, &function, permutated_qubits..., buffer_first, cache_size](auto const first, auto const last)
                   {
                     ::ket::gate::cache::none_on_cache::gate(
                       parallel_policy,
@@ -722,11 +702,8 @@ namespace ket
               using qubit_type = ::ket::qubit<StateInteger>;
               using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-              constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-              constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+              auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+              auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
               assert(not ::ket::utility::all_in_state_vector(num_on_cache_qubits, permutated_qubits.qubit()...));
               assert(not ::ket::utility::none_in_state_vector(num_on_cache_qubits, permutated_qubits.qubit()...));
 
@@ -738,7 +715,7 @@ namespace ket
 
                 return ::ket::mpi::utility::for_each_local_range(
                   mpi_policy, local_state, communicator, environment, unit_control_qubit_mask,
-                  [parallel_policy, &function, permutated_qubits..., buffer_first](auto const first, auto const last)
+                  [parallel_policy, &function, permutated_qubits..., buffer_first, cache_size](auto const first, auto const last)
                   {
                     ::ket::gate::cache::some_on_cache::gate(
                       parallel_policy,
@@ -782,11 +759,8 @@ namespace ket
             static_assert(std::is_same<StateInteger, ::ket::meta::state_integer_t<Qubit>>::value, "The state_integer_type of Qubit should be the same as StateInteger");
             using bit_integer_type = ::ket::meta::bit_integer_t<Qubit>;
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-            constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+            auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
 
             // Case 1-1) All operated qubits are on-cache qubits
             //   ex1: ppxx|zzzzzzzzzz
@@ -844,11 +818,8 @@ namespace ket
             using qubit_type = ::ket::qubit<StateInteger>;
             using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-            constexpr auto cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+            auto const cache_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
 
             // Case 1-1) All operated qubits are on-cache qubits
             //   ex1: ppxx|zzzzzzzzzz
@@ -1146,10 +1117,7 @@ namespace ket
             static_assert(std::is_same<StateInteger, ::ket::meta::state_integer_t<Qubit>>::value, "The state_integer_type of Qubit should be the same as StateInteger");
             using bit_integer_type = ::ket::meta::bit_integer_t<Qubit>;
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
             // Case 2) Some operated qubits are page qubits
             //   ex1: pppp|ppzzzzzzzz
@@ -1198,11 +1166,8 @@ namespace ket
             static_assert(std::is_same<StateInteger, ::ket::meta::state_integer_t<Qubit>>::value, "The state_integer_type of Qubit should be the same as StateInteger");
             using bit_integer_type = ::ket::meta::bit_integer_t<Qubit>;
 
-#     ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#       define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#     endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
-            constexpr auto on_cache_state_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
+            auto const on_cache_state_size = ::ket::utility::integer_exp2<StateInteger>(num_on_cache_qubits);
 
             // xxxx|yyyy|zzzzzz: local qubits
             // * xxxx: off-cache qubits
@@ -3222,10 +3187,7 @@ namespace ket
           {
             using qubit_type = ::ket::utility::meta::range_value_t<QubitsRange>;
             using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
             return ::ket::mpi::gate::runtime::ranges::gate(
               mpi_policy, parallel_policy,
@@ -3249,10 +3211,7 @@ namespace ket
           {
             using qubit_type = ::ket::utility::meta::range_value_t<QubitsRange>;
             using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
             return ::ket::mpi::gate::runtime::ranges::gate(
               mpi_policy, parallel_policy,
@@ -3277,10 +3236,7 @@ namespace ket
           {
             using qubit_type = ::ket::utility::meta::range_value_t<QubitsRange>;
             using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
             return ::ket::mpi::gate::runtime::ranges::gate(
               mpi_policy, parallel_policy,
@@ -3305,10 +3261,7 @@ namespace ket
           {
             using qubit_type = ::ket::utility::meta::range_value_t<QubitsRange>;
             using bit_integer_type = ::ket::meta::bit_integer_t<qubit_type>;
-#   ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
-#     define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
-#   endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
-            constexpr auto num_on_cache_qubits = bit_integer_type{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+            auto const num_on_cache_qubits = ::ket::utility::num_on_cache_qubits<bit_integer_type>();
 
             return ::ket::mpi::gate::runtime::ranges::gate(
               mpi_policy, parallel_policy,
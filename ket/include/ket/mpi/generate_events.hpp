@@ -2,36 +2,154 @@
 # define KET_MPI_GENERATE_EVENTS_HPP
 
 # include <cmath>
+# include <cstddef>
 # include <vector>
 # include <iterator>
+# include <algorithm>
+# include <numeric>
+# include <utility>
 
 # include <yampi/environment.hpp>
 # include <yampi/datatype_base.hpp>
 # include <yampi/communicator.hpp>
 # include <yampi/rank.hpp>
 # include <yampi/buffer.hpp>
-# include <yampi/gather.hpp>
+# include <yampi/all_reduce.hpp>
+# include <yampi/binary_operation.hpp>
 # include <yampi/broadcast.hpp>
-# include <yampi/message_envelope.hpp>
-# include <yampi/algorithm/transform.hpp>
 
+# include <ket/generate_events.hpp>
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/positive_random_value_upto.hpp>
 # include <ket/utility/meta/real_of.hpp>
 # include <ket/utility/meta/ranges.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/utility/simple_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
 # include <ket/mpi/utility/logger.hpp>
-# include <ket/mpi/utility/fill.hpp>
-# include <ket/mpi/utility/transform_inclusive_scan_self.hpp>
-# include <ket/mpi/utility/upper_bound.hpp>
 
 
 namespace ket
 {
   namespace mpi
   {
+    namespace generate_events_detail
+    {
+      // returns the inclusive scan of probabilities of blocks for each local range
+      template <typename MpiPolicy, typename ParallelPolicy, typename LocalState>
+      inline auto cumulative_block_probabilities(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy, LocalState& local_state,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      -> std::vector<std::vector< ::ket::utility::meta::real_t< ::ket::utility::meta::range_value_t<LocalState> > >>
+      {
+        using real_type = ::ket::utility::meta::real_t< ::ket::utility::meta::range_value_t<LocalState> >;
+        auto result = std::vector<std::vector<real_type>>{};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [parallel_policy, &result](auto const first, auto const last)
+          { result.push_back(::ket::generate_events_detail::cumulative_block_probabilities(parallel_policy, first, last)); });
+
+        return result;
+      }
+
+      // Each process finds events whose random values are in its part of the cumulative probabilities.
+      // permutated_result[event_index] is set to the found permutated qubit value, and the others are left unchanged.
+      template <
+        typename MpiPolicy, typename LocalState, typename Real, typename StateInteger, typename ResultAllocator>
+      inline auto find_local_events(
+        MpiPolicy const& mpi_policy, LocalState& local_state,
+        std::vector<std::vector<Real>> const& cumulative_block_probabilities,
+        std::vector<Real> const& cumulative_total_probabilities,
+        std::vector<std::pair<Real, int>> const& random_values,
+        std::vector<StateInteger, ResultAllocator>& permutated_result,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      -> void
+      {
+        auto const present_rank = communicator.rank(environment);
+        auto const rank_index = static_cast<std::size_t>(present_rank.mpi_rank());
+        auto const probability_before = [&cumulative_total_probabilities](std::size_t const index)
+        { return index == std::size_t{0u} ? Real{0} : cumulative_total_probabilities[index - std::size_t{1u}]; };
+
+        // Random values beyond the total probability because of rounding errors belong to the last process with nonzero probability
+        auto last_nonzero_rank_index = cumulative_total_probabilities.size() - std::size_t{1u};
+        while (last_nonzero_rank_index > std::size_t{0u}
+               and cumulative_total_probabilities[last_nonzero_rank_index] <= probability_before(last_nonzero_rank_index))
+          --last_nonzero_rank_index;
+
+        if (rank_index > last_nonzero_rank_index)
+          return;
+
+        auto const compare = [](std::pair<Real, int> const& lhs, Real const rhs) { return lhs.first < rhs; };
+        using std::begin;
+        using std::end;
+        auto random_value_first
+          = rank_index == std::size_t{0u}
+            ? begin(random_values)
+            : std::lower_bound(begin(random_values), end(random_values), probability_before(rank_index), compare);
+        auto const random_value_last
+          = rank_index == last_nonzero_rank_index
+            ? end(random_values)
+            : std::lower_bound(random_value_first, end(random_values), cumulative_total_probabilities[rank_index], compare);
+
+        auto local_range_index = std::size_t{0u};
+        auto const num_local_ranges = cumulative_block_probabilities.size();
+        auto base_probability = probability_before(rank_index);
+        auto local_index_offset = StateInteger{0u};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [&mpi_policy, &local_state, &cumulative_block_probabilities, &permutated_result,
+           present_rank, num_local_ranges, random_value_last,
+           &local_range_index, &base_probability, &local_index_offset, &random_value_first, &compare](
+            auto const first, auto const last)
+          {
+            auto const& local_cumulative_block_probabilities = cumulative_block_probabilities[local_range_index];
+            auto const next_base_probability = base_probability + local_cumulative_block_probabilities.back();
+            auto const local_random_value_last
+              = local_range_index + std::size_t{1u} == num_local_ranges
+                ? random_value_last
+                : std::lower_bound(random_value_first, random_value_last, next_base_probability, compare);
+
+            ::ket::generate_events_detail::find_events(
+              first, last, local_cumulative_block_probabilities, base_probability,
+              random_value_first, local_random_value_last,
+              [&mpi_policy, &local_state, &permutated_result, present_rank, &local_index_offset](
+                int const event_index, std::size_t const index)
+              {
+                permutated_result[event_index]
+                  = ::ket::mpi::utility::rank_index_to_qubit_value(
+                      mpi_policy, local_state, present_rank, local_index_offset + static_cast<StateInteger>(index));
+              });
+
+            random_value_first = local_random_value_last;
+            base_probability = next_base_probability;
+            local_index_offset += static_cast<StateInteger>(last - first);
+            ++local_range_index;
+          });
+      }
+
+      // All processes generate the same sorted random values from a seed given by the root process
+      template <typename Real, typename RandomNumberGenerator>
+      inline auto generate_sorted_random_values(
+        int const num_events, Real const total_probability,
+        typename RandomNumberGenerator::result_type const seed, RandomNumberGenerator const&)
+      -> std::vector<std::pair<Real, int>>
+      {
+        auto random_number_generator = RandomNumberGenerator(seed);
+        auto result = std::vector<std::pair<Real, int>>{};
+        result.reserve(num_events);
+        for (auto event_index = 0; event_index < num_events; ++event_index)
+          result.emplace_back(
+            ::ket::utility::positive_random_value_upto(total_probability, random_number_generator), event_index);
+
+        using std::begin;
+        using std::end;
+        std::sort(begin(result), end(result));
+        return result;
+      }
+    } // namespace generate_events_detail
+
     // generate_events
+    // The state is not modified. All events are generated by one scan of the local state in each process and one all-reduce of results, instead of collective communications for each event.
     template <
       typename MpiPolicy, typename ParallelPolicy,
       typename ResultAllocator,
@@ -49,85 +167,46 @@ namespace ket
     {
       ket::mpi::utility::log_with_time_guard<char> print{"Generate Events", environment};
 
-      result.clear();
-      result.reserve(num_events);
-
-      using complex_type = ::ket::utility::meta::range_value_t<LocalState>;
-      using std::real;
-      auto const total_probability
-        = real(::ket::mpi::utility::transform_inclusive_scan_self(
-            parallel_policy, local_state,
-            [](complex_type const& lhs, complex_type const& rhs)
-            { using std::real; return static_cast<complex_type>(real(lhs) + real(rhs)); },
-            [](complex_type const& value)
-            { using std::norm; return static_cast<complex_type>(norm(value)); },
-            environment));
+      auto const cumulative_block_probabilities
+        = ::ket::mpi::generate_events_detail::cumulative_block_probabilities(
+            mpi_policy, parallel_policy, local_state, communicator, environment);
 
+      using real_type = ::ket::utility::meta::real_t< ::ket::utility::meta::range_value_t<LocalState> >;
       auto const present_rank = communicator.rank(environment);
-      constexpr auto root_rank = yampi::rank{0};
-
-      using real_type = ::ket::utility::meta::real_t<complex_type>;
-      auto total_probabilities = std::vector<real_type>{};
-      if (present_rank == root_rank)
-        total_probabilities.resize(communicator.size(environment));
+      auto cumulative_total_probabilities = std::vector<real_type>(communicator.size(environment), real_type{0});
+      for (auto const& local_cumulative_block_probabilities: cumulative_block_probabilities)
+        cumulative_total_probabilities[present_rank.mpi_rank()] += local_cumulative_block_probabilities.back();
 
+      yampi::all_reduce(
+        yampi::in_place, yampi::range_to_buffer(cumulative_total_probabilities), yampi::binary_operation{::yampi::tags::plus},
+        communicator, environment);
       using std::begin;
-      yampi::gather(
-        yampi::make_buffer(total_probability), begin(total_probabilities),
-        root_rank, communicator, environment);
+      using std::end;
+      std::partial_sum(begin(cumulative_total_probabilities), end(cumulative_total_probabilities), begin(cumulative_total_probabilities));
 
+      constexpr auto root_rank = yampi::rank{0};
+      auto seed = typename RandomNumberGenerator::result_type{};
       if (present_rank == root_rank)
-        ::ket::utility::ranges::inclusive_scan(total_probabilities, begin(total_probabilities));
+        seed = random_number_generator();
+      yampi::broadcast(yampi::make_buffer(seed), root_rank, communicator, environment);
 
-      for (auto event_index = 0; event_index < num_events; ++event_index)
-      {
-        auto random_value = real_type{};
-        auto result_rank = yampi::rank{};
-        if (present_rank == root_rank)
-        {
-          random_value
-            = ::ket::utility::positive_random_value_upto(
-                total_probabilities.back(), random_number_generator);
-          using std::end;
-          result_rank
-            = static_cast<yampi::rank>(static_cast<StateInteger>(
-                std::upper_bound(begin(total_probabilities), end(total_probabilities), random_value)
-                - begin(total_probabilities)));
-        }
-
-        auto result_mpi_rank = result_rank.mpi_rank();
-        yampi::broadcast(yampi::make_buffer(result_mpi_rank), root_rank, communicator, environment);
-        result_rank = static_cast<yampi::rank>(result_mpi_rank);
-
-        yampi::algorithm::transform(
-          yampi::ignore_status,
-          yampi::make_buffer(random_value),
-          yampi::make_buffer(random_value),
-          [&total_probabilities, result_rank](real_type const random_value)
-          { return random_value - total_probabilities[result_rank.mpi_rank() - 1]; },
-          ::yampi::message_envelope(root_rank, result_rank, communicator),
-          environment);
-
-        auto permutated_result = StateInteger{};
-        if (present_rank == result_rank)
-        {
-          auto const local_result
-            = static_cast<StateInteger>(
-                ::ket::mpi::utility::upper_bound(
-                  local_state, static_cast<complex_type>(random_value),
-                  [](complex_type const& lhs, complex_type const& rhs)
-                  { using std::real; return real(lhs) < real(rhs); },
-                  environment));
-
-          permutated_result
-            = ::ket::mpi::utility::rank_index_to_qubit_value(
-                mpi_policy, local_state, result_rank, local_result);
-        }
-
-        yampi::broadcast(yampi::make_buffer(permutated_result), result_rank, communicator, environment);
-
-        result.push_back(::ket::mpi::inverse_permutate_bits(permutation, permutated_result));
-      }
+      auto const random_values
+        = ::ket::mpi::generate_events_detail::generate_sorted_random_values(
+            num_events, cumulative_total_probabilities.back(), seed, random_number_generator);
+
+      auto permutated_result = std::vector<StateInteger>(num_events, StateInteger{0u});
+      ::ket::mpi::generate_events_detail::find_local_events(
+        mpi_policy, local_state, cumulative_block_probabilities, cumulative_total_probabilities, random_values,
+        permutated_result, communicator, environment);
+
+      yampi::all_reduce(
+        yampi::in_place, yampi::range_to_buffer(permutated_result), yampi::binary_operation{::yampi::tags::plus},
+        communicator, environment);
+
+      result.clear();
+      result.reserve(num_events);
+      for (auto const permutated_value: permutated_result)
+        result.push_back(::ket::mpi::inverse_permutate_bits(permutation, permutated_value));
     }
 
     template <
@@ -150,85 +229,46 @@ namespace ket
     {
       ket::mpi::utility::log_with_time_guard<char> print{"Generate Events", environment};
 
-      result.clear();
-      result.reserve(num_events);
-
-      using complex_type = ::ket::utility::meta::range_value_t<LocalState>;
-      using std::real;
-      auto const total_probability
-        = real(::ket::mpi::utility::transform_inclusive_scan_self(
-            parallel_policy, local_state,
-            [](complex_type const& lhs, complex_type const& rhs)
-            { using std::real; return static_cast<complex_type>(real(lhs) + real(rhs)); },
-            [](complex_type const& value)
-            { using std::norm; return static_cast<complex_type>(norm(value)); },
-            environment));
+      auto const cumulative_block_probabilities
+        = ::ket::mpi::generate_events_detail::cumulative_block_probabilities(
+            mpi_policy, parallel_policy, local_state, communicator, environment);
 
+      using real_type = ::ket::utility::meta::real_t< ::ket::utility::meta::range_value_t<LocalState> >;
       auto const present_rank = communicator.rank(environment);
-      constexpr auto root_rank = yampi::rank{0};
-
-      using real_type = ::ket::utility::meta::real_t<complex_type>;
-      auto total_probabilities = std::vector<real_type>{};
-      if (present_rank == root_rank)
-        total_probabilities.resize(communicator.size(environment));
+      auto cumulative_total_probabilities = std::vector<real_type>(communicator.size(environment), real_type{0});
+      for (auto const& local_cumulative_block_probabilities: cumulative_block_probabilities)
+        cumulative_total_probabilities[present_rank.mpi_rank()] += local_cumulative_block_probabilities.back();
 
+      yampi::all_reduce(
+        yampi::in_place, yampi::range_to_buffer(cumulative_total_probabilities, real_datatype), yampi::binary_operation{::yampi::tags::plus},
+        communicator, environment);
       using std::begin;
-      yampi::gather(
-        yampi::make_buffer(total_probability, real_datatype), begin(total_probabilities),
-        root_rank, communicator, environment);
+      using std::end;
+      std::partial_sum(begin(cumulative_total_probabilities), end(cumulative_total_probabilities), begin(cumulative_total_probabilities));
 
+      constexpr auto root_rank = yampi::rank{0};
+      auto seed = typename RandomNumberGenerator::result_type{};
       if (present_rank == root_rank)
-        ::ket::utility::ranges::inclusive_scan(total_probabilities, begin(total_probabilities));
+        seed = random_number_generator();
+      yampi::broadcast(yampi::make_buffer(seed), root_rank, communicator, environment);
 
-      for (auto event_index = 0; event_index < num_events; ++event_index)
-      {
-        auto random_value = real_type{};
-        auto result_rank = yampi::rank{};
-        if (present_rank == root_rank)
-        {
-          random_value
-            = ::ket::utility::positive_random_value_upto(
-                total_probabilities.back(), random_number_generator);
-          using std::end;
-          result_rank
-            = static_cast<yampi::rank>(static_cast<StateInteger>(
-                std::upper_bound(begin(total_probabilities), end(total_probabilities), random_value)
-                - begin(total_probabilities)));
-        }
-
-        auto result_mpi_rank = result_rank.mpi_rank();
-        yampi::broadcast(yampi::make_buffer(result_mpi_rank), root_rank, communicator, environment);
-        result_rank = static_cast<yampi::rank>(result_mpi_rank);
-
-        yampi::algorithm::transform(
-          yampi::ignore_status,
-          yampi::make_buffer(random_value, real_datatype),
-          yampi::make_buffer(random_value, real_datatype),
-          [&total_probabilities, result_rank](real_type const random_value)
-          { return random_value - total_probabilities[result_rank.mpi_rank() - 1]; },
-          ::yampi::message_envelope(root_rank, result_rank, communicator),
-          environment);
-
-        StateInteger permutated_result;
-        if (present_rank == result_rank)
-        {
-          StateInteger const local_result
-            = static_cast<StateInteger>(
-                ::ket::mpi::utility::upper_bound(
-                  local_state, static_cast<complex_type>(random_value),
-                  [](complex_type const& lhs, complex_type const& rhs)
-                  { using std::real; return real(lhs) < real(rhs); },
-                  environment));
-
-          permutated_result
-            = ::ket::mpi::utility::rank_index_to_qubit_value(
-                mpi_policy, local_state, result_rank, local_result);
-        }
-
-        yampi::broadcast(yampi::make_buffer(permutated_result, state_integer_datatype), result_rank, communicator, environment);
-
-        result.push_back(::ket::mpi::inverse_permutate_bits(permutation, permutated_result));
-      }
+      auto const random_values
+        = ::ket::mpi::generate_events_detail::generate_sorted_random_values(
+            num_events, cumulative_total_probabilities.back(), seed, random_number_generator);
+
+      auto permutated_result = std::vector<StateInteger>(num_events, StateInteger{0u});
+      ::ket::mpi::generate_events_detail::find_local_events(
+        mpi_policy, local_state, cumulative_block_probabilities, cumulative_total_probabilities, random_values,
+        permutated_result, communicator, environment);
+
+      yampi::all_reduce(
+        yampi::in_place, yampi::range_to_buffer(permutated_result, state_integer_datatype), yampi::binary_operation{::yampi::tags::plus},
+        communicator, environment);
+
+      result.clear();
+      result.reserve(num_events);
+      for (auto const permutated_value: permutated_result)
+        result.push_back(::ket::mpi::inverse_permutate_bits(permutation, permutated_value));
     }
 
     template <
@@ -1,14 +1,17 @@
 #ifndef KET_MPI_PAGE_SPIN_EXPECTATION_VALUE_HPP
 # define KET_MPI_PAGE_SPIN_EXPECTATION_VALUE_HPP
 
+# include <cstddef>
 # include <vector>
 # include <array>
 # include <numeric>
 # include <iterator>
+# include <utility>
 
 # include <boost/math/constants/constants.hpp>
 
 # include <ket/qubit.hpp>
+# include <ket/all_spin_expectation_values.hpp>
 # include <ket/utility/meta/real_of.hpp>
 # include <ket/utility/meta/ranges.hpp>
 # include <ket/mpi/state.hpp>
@@ -101,6 +104,53 @@ namespace ket
 
         return spin;
       }
+
+      template <typename ParallelPolicy, typename RandomAccessRange>
+      [[noreturn]] inline
+      std::vector<std::array< ::ket::utility::meta::real_t< ::ket::utility::meta::range_value_t<RandomAccessRange> >, 3u >>
+      all_spin_expectation_values(ParallelPolicy const, RandomAccessRange&)
+      { throw ::ket::mpi::gate::page::unsupported_page_gate_operation{"all_spin_expectation_values"}; }
+
+      template <typename ParallelPolicy, typename Complex, typename Allocator>
+      [[noreturn]] inline
+      std::vector<std::array< ::ket::utility::meta::real_t<Complex>, 3u >>
+      all_spin_expectation_values(ParallelPolicy const, ::ket::mpi::state<Complex, false, Allocator>&)
+      { throw ::ket::mpi::gate::page::unsupported_page_gate_operation{"all_spin_expectation_values"}; }
+
+      // Spins of all local qubits (nonpage qubits and page qubits), which are summed over data blocks but are not reduced among processes.
+      // A page is regarded as a contiguous part of a data block, so page qubits are dealt with in the same sweeps as upper nonpage qubits
+      template <typename ParallelPolicy, typename Complex, typename Allocator>
+      inline
+      std::vector<std::array< ::ket::utility::meta::real_t<Complex>, 3u >>
+      all_spin_expectation_values(
+        ParallelPolicy const parallel_policy, ::ket::mpi::state<Complex, true, Allocator>& local_state)
+      {
+        auto const num_local_qubits = local_state.num_local_qubits();
+        auto const num_nonpage_qubits = num_local_qubits - local_state.num_page_qubits();
+        auto const nonpage_index_mask = (std::size_t{1u} << num_nonpage_qubits) - std::size_t{1u};
+
+        using hd_spin_type = ::ket::all_spin_expectation_values_detail::hd_spin_type;
+        auto spins_in_threads
+          = std::vector<std::vector<hd_spin_type>>(
+              ::ket::utility::num_threads(parallel_policy), std::vector<hd_spin_type>(num_local_qubits, hd_spin_type{}));
+
+        auto const num_data_blocks = local_state.num_data_blocks();
+        for (auto data_block_index = std::size_t{0u}; data_block_index < num_data_blocks; ++data_block_index)
+          ::ket::all_spin_expectation_values_detail::accumulate_spins<std::size_t>(
+            parallel_policy, num_local_qubits, num_nonpage_qubits,
+            [&local_state, data_block_index, num_nonpage_qubits, nonpage_index_mask](std::size_t const index)
+            {
+              using std::begin;
+              return begin(local_state.page_range(std::make_pair(data_block_index, index >> num_nonpage_qubits)))
+                + (index bitand nonpage_index_mask);
+            },
+            spins_in_threads);
+
+        using spin_type = std::array< ::ket::utility::meta::real_t<Complex>, 3u >;
+        auto result = std::vector<spin_type>{};
+        ::ket::all_spin_expectation_values_detail::reduce_spins_in_threads(spins_in_threads, result);
+        return result;
+      }
     } // namespace page
   } // namespace mpi
 } // namespace ket
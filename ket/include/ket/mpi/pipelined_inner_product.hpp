@@ -0,0 +1,330 @@
+#ifndef KET_MPI_PIPELINED_INNER_PRODUCT_HPP
+# define KET_MPI_PIPELINED_INNER_PRODUCT_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <complex>
+# include <vector>
+# include <array>
+# include <string>
+# include <algorithm>
+# include <iterator>
+# include <numeric>
+# include <functional>
+
+# include <yampi/environment.hpp>
+# include <yampi/datatype_base.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/intercommunicator.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/rank.hpp>
+# include <yampi/tag.hpp>
+# include <yampi/request.hpp>
+# include <yampi/send.hpp>
+# include <yampi/receive.hpp>
+# include <yampi/send_receive.hpp>
+# include <yampi/all_reduce.hpp>
+# include <yampi/binary_operation.hpp>
+
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/meta/ranges.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+# include <ket/mpi/utility/simple_mpi.hpp>
+# include <ket/mpi/utility/resize_buffer_if_empty.hpp>
+# include <ket/mpi/utility/logger.hpp>
+# include <ket/mpi/utility/detail/intercircuit_layout.hpp>
+
+# ifndef KET_NUM_INNER_PRODUCT_PIPELINE_STAGES
+#   define KET_NUM_INNER_PRODUCT_PIPELINE_STAGES 2
+# endif // KET_NUM_INNER_PRODUCT_PIPELINE_STAGES
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    // <Psi_{remote}|Psi_{local}> between circuits whose processes are connected by intercommunicator, for the simple MPI policy.
+    // Unlike inner_product with intercommunicator, only the process with sends_local_state == true sends its amplitudes,
+    // and the other process reduces chunks of received amplitudes while the following chunks are being received.
+    // Permutations of qubits of two circuits may differ: amplitudes are sent in the order of local indices of receiver processes
+    // as far as possible, and each sender process sends them to 2^k receiver processes if k qubits are global only in one circuit.
+    // sends_local_state must be true in all processes of one circuit and false in all processes of the other circuit,
+    // and both circuits must have the same numbers of qubits and processes
+    namespace pipelined_inner_product_detail
+    {
+      // returns positions of qubits of the corresponding process of the other circuit, followed by the buffer size of it
+      template <typename StateInteger, typename BitInteger>
+      inline auto exchange_layouts(
+        std::vector<BitInteger> const& positions, StateInteger const buffer_size,
+        yampi::rank const rank, yampi::intercommunicator const& intercommunicator, yampi::environment const& environment)
+      -> std::vector<StateInteger>
+      {
+        auto local_layout = std::vector<StateInteger>(positions.begin(), positions.end());
+        local_layout.push_back(buffer_size);
+        auto result = std::vector<StateInteger>(local_layout.size());
+
+        auto const tag = yampi::tag{0};
+        yampi::send_receive(
+          yampi::ignore_status,
+          yampi::make_buffer(local_layout.begin(), local_layout.end()), rank, tag,
+          yampi::make_buffer(result.begin(), result.end()), rank, tag,
+          intercommunicator, environment);
+
+        return result;
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator, typename BufferIterator,
+        typename StateInteger, typename BitInteger, typename MakeBuffer>
+      inline auto send_amplitudes(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const local_first, BufferIterator const buffer_first, StateInteger const chunk_size,
+        ::ket::mpi::utility::detail::intercircuit_layout<StateInteger, BitInteger> const& layout,
+        MakeBuffer make_buffer, StateInteger const sender_rank,
+        yampi::intercommunicator const& intercommunicator, yampi::environment const& environment)
+      -> void
+      {
+        constexpr auto num_stages = StateInteger{KET_NUM_INNER_PRODUCT_PIPELINE_STAGES};
+        auto requests = std::array<yampi::request, KET_NUM_INNER_PRODUCT_PIPELINE_STAGES>{};
+        // Messages between two processes with the same tag are not overtaken, so one tag is enough
+        auto const tag = yampi::tag{0};
+
+        auto const num_elements = layout.num_elements_per_partner();
+        auto chunk_index = StateInteger{0u};
+        for (auto partner_index = StateInteger{0u}; partner_index < layout.num_partners(); ++partner_index)
+        {
+          auto const receiver_rank = yampi::rank{static_cast<int>(layout.receiver_rank(sender_rank, partner_index))};
+          auto const partner_bits = layout.sender_partner_bits(partner_index);
+
+          for (auto first_index = StateInteger{0u}; first_index < num_elements; first_index += chunk_size, ++chunk_index)
+          {
+            auto const stage = chunk_index % num_stages;
+            auto const present_chunk_size = std::min(chunk_size, num_elements - first_index);
+            // The stage cannot be overwritten until its chunk has been sent
+            if (chunk_index >= num_stages)
+              requests[stage].wait(environment);
+
+            if (layout.is_packed_contiguously())
+            {
+              yampi::send(
+                requests[stage], make_buffer(local_first + first_index, local_first + first_index + present_chunk_size),
+                receiver_rank, tag, intercommunicator, environment);
+              continue;
+            }
+
+            auto const stage_first = buffer_first + stage * chunk_size;
+            ::ket::utility::loop_n(
+              parallel_policy, present_chunk_size,
+              [local_first, stage_first, first_index, partner_bits, &layout](StateInteger const index, int const)
+              { stage_first[index] = local_first[layout.packed_index(first_index + index) bitor partner_bits]; });
+
+            yampi::send(
+              requests[stage], make_buffer(stage_first, stage_first + present_chunk_size),
+              receiver_rank, tag, intercommunicator, environment);
+          }
+        }
+
+        for (auto stage = StateInteger{0u}; stage < std::min(num_stages, chunk_index); ++stage)
+          requests[stage].wait(environment);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator, typename BufferIterator,
+        typename StateInteger, typename BitInteger, typename MakeBuffer>
+      inline auto receive_and_reduce_amplitudes(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const local_first, BufferIterator const buffer_first, StateInteger const chunk_size,
+        ::ket::mpi::utility::detail::intercircuit_layout<StateInteger, BitInteger> const& layout,
+        MakeBuffer make_buffer, StateInteger const receiver_rank,
+        yampi::intercommunicator const& intercommunicator, yampi::environment const& environment)
+      -> typename std::iterator_traits<RandomAccessIterator>::value_type
+      {
+        constexpr auto num_stages = StateInteger{KET_NUM_INNER_PRODUCT_PIPELINE_STAGES};
+        auto requests = std::array<yampi::request, KET_NUM_INNER_PRODUCT_PIPELINE_STAGES>{};
+        auto const tag = yampi::tag{0};
+
+        auto const num_elements = layout.num_elements_per_partner();
+        auto const num_chunks_per_partner = (num_elements + chunk_size - StateInteger{1u}) / chunk_size;
+        auto const num_chunks = layout.num_partners() * num_chunks_per_partner;
+
+        auto const post
+          = [buffer_first, chunk_size, num_elements, num_chunks_per_partner, &layout, &make_buffer, receiver_rank,
+             tag, &intercommunicator, &environment, &requests](StateInteger const chunk_index)
+            {
+              auto const stage = chunk_index % num_stages;
+              auto const first_index = (chunk_index % num_chunks_per_partner) * chunk_size;
+              auto const present_chunk_size = std::min(chunk_size, num_elements - first_index);
+              auto const sender_rank = layout.sender_rank(receiver_rank, chunk_index / num_chunks_per_partner);
+              auto const stage_first = buffer_first + stage * chunk_size;
+
+              yampi::receive(
+                requests[stage], make_buffer(stage_first, stage_first + present_chunk_size),
+                yampi::rank{static_cast<int>(sender_rank)}, tag, intercommunicator, environment);
+            };
+
+        for (auto chunk_index = StateInteger{0u}; chunk_index < std::min(num_stages, num_chunks); ++chunk_index)
+          post(chunk_index);
+
+        using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        auto result = complex_type{};
+        auto partial_sums = std::vector<complex_type>(::ket::utility::num_threads(parallel_policy), complex_type{});
+        for (auto chunk_index = StateInteger{0u}; chunk_index < num_chunks; ++chunk_index)
+        {
+          auto const stage = chunk_index % num_stages;
+          requests[stage].wait(environment);
+
+          auto const first_index = (chunk_index % num_chunks_per_partner) * chunk_size;
+          auto const present_chunk_size = std::min(chunk_size, num_elements - first_index);
+          auto const stage_first = buffer_first + stage * chunk_size;
+
+          // <Psi_{remote}|Psi_{local}> = sum_n a_{remote}(n)^* a_{local}(n)
+          if (layout.is_translated_contiguously())
+            result
+              = ::ket::utility::transform_reduce(
+                  parallel_policy,
+                  local_first + first_index, local_first + first_index + present_chunk_size, stage_first, result,
+                  std::plus<complex_type>{},
+                  [](complex_type const& local_coefficient, complex_type const& remote_coefficient)
+                  { using std::conj; return conj(remote_coefficient) * local_coefficient; });
+          else
+          {
+            auto const sender_rank = layout.sender_rank(receiver_rank, chunk_index / num_chunks_per_partner);
+            auto const constant_bits = layout.receiver_constant_bits(sender_rank);
+            ::ket::utility::loop_n(
+              parallel_policy, present_chunk_size,
+              [local_first, stage_first, first_index, constant_bits, &layout, &partial_sums](StateInteger const index, int const thread_index)
+              {
+                using std::conj;
+                partial_sums[thread_index]
+                  += conj(stage_first[index]) * local_first[layout.translated_index(first_index + index) bitor constant_bits];
+              });
+          }
+
+          if (chunk_index + num_stages < num_chunks)
+            post(chunk_index + num_stages);
+        }
+
+        return std::accumulate(partial_sums.begin(), partial_sums.end(), result);
+      }
+
+      template <
+        typename ParallelPolicy, typename LocalState,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+        typename MakeBuffer, typename MakeValueBuffer>
+      inline auto pipelined_inner_product(
+        ::ket::mpi::utility::policy::simple_mpi const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState const& local_state,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        std::vector< ::ket::utility::meta::range_value_t<LocalState>, BufferAllocator >& buffer,
+        bool const sends_local_state, MakeBuffer make_buffer, MakeValueBuffer make_value_buffer,
+        yampi::communicator const& intracommunicator, yampi::intercommunicator const& intercommunicator, yampi::environment const& environment)
+      -> ::ket::utility::meta::range_value_t<LocalState>
+      {
+        auto const rank = intracommunicator.rank(environment);
+        assert(rank == intercommunicator.rank(environment));
+        assert(intracommunicator.size(environment) == intercommunicator.remote_size(environment));
+
+        ::ket::mpi::utility::resize_buffer_if_empty(
+          local_state, buffer,
+          ::ket::mpi::utility::policy::data_block_size(mpi_policy, local_state, intracommunicator, environment));
+        if (buffer.size() < std::size_t{KET_NUM_INNER_PRODUCT_PIPELINE_STAGES})
+          buffer.resize(std::size_t{KET_NUM_INNER_PRODUCT_PIPELINE_STAGES});
+
+        auto const positions = ::ket::mpi::utility::detail::permutated_positions(permutation);
+        auto const remote_layout
+          = ::ket::mpi::pipelined_inner_product_detail::exchange_layouts(
+              positions, static_cast<StateInteger>(buffer.size()), rank, intercommunicator, environment);
+        auto const remote_positions = std::vector<BitInteger>(remote_layout.begin(), std::prev(remote_layout.end()));
+
+        using std::begin;
+        using std::end;
+        auto const num_local_qubits = ::ket::utility::integer_log2<BitInteger>(static_cast<StateInteger>(end(local_state) - begin(local_state)));
+        auto const layout
+          = sends_local_state
+            ? ::ket::mpi::utility::detail::intercircuit_layout<StateInteger, BitInteger>{positions, remote_positions, num_local_qubits}
+            : ::ket::mpi::utility::detail::intercircuit_layout<StateInteger, BitInteger>{remote_positions, positions, num_local_qubits};
+
+        // Both processes of a pair choose the same chunk size so that every message fits in a stage of the receiver
+        constexpr auto num_stages = StateInteger{KET_NUM_INNER_PRODUCT_PIPELINE_STAGES};
+        auto const chunk_size
+          = std::min(
+              layout.num_elements_per_partner(),
+              std::max(StateInteger{1u}, std::min(static_cast<StateInteger>(buffer.size()), remote_layout.back()) / num_stages));
+
+        using complex_type = ::ket::utility::meta::range_value_t<LocalState>;
+        auto result = complex_type{};
+        auto const tag = yampi::tag{0};
+        if (sends_local_state)
+        {
+          ::ket::mpi::pipelined_inner_product_detail::send_amplitudes(
+            parallel_policy, begin(local_state), begin(buffer), chunk_size, layout, make_buffer,
+            static_cast<StateInteger>(rank.mpi_rank()), intercommunicator, environment);
+
+          // <Psi_{remote}|Psi_{local}> is the complex conjugate of the result of the receiver circuit
+          yampi::receive(make_value_buffer(result), rank, tag, intercommunicator, environment);
+          return result;
+        }
+
+        result
+          = ::ket::mpi::pipelined_inner_product_detail::receive_and_reduce_amplitudes(
+              parallel_policy, begin(local_state), begin(buffer), chunk_size, layout, make_buffer,
+              static_cast<StateInteger>(rank.mpi_rank()), intercommunicator, environment);
+
+        yampi::all_reduce(
+          yampi::in_place, make_value_buffer(result), yampi::binary_operation{::yampi::tags::plus},
+          intracommunicator, environment);
+
+        using std::conj;
+        auto const remote_result = conj(result);
+        yampi::send(make_value_buffer(remote_result), rank, tag, intercommunicator, environment);
+
+        return result;
+      }
+    } // namespace pipelined_inner_product_detail
+
+    template <
+      typename ParallelPolicy, typename LocalState,
+      typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+    inline auto pipelined_inner_product(
+      ::ket::mpi::utility::policy::simple_mpi const& mpi_policy, ParallelPolicy const parallel_policy,
+      LocalState const& local_state,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+      std::vector< ::ket::utility::meta::range_value_t<LocalState>, BufferAllocator >& buffer, bool const sends_local_state,
+      yampi::communicator const& intracommunicator, yampi::intercommunicator const& intercommunicator, yampi::environment const& environment)
+    -> ::ket::utility::meta::range_value_t<LocalState>
+    {
+      ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"Pipelined inner product"}), environment};
+
+      return ::ket::mpi::pipelined_inner_product_detail::pipelined_inner_product(
+        mpi_policy, parallel_policy, local_state, permutation, buffer, sends_local_state,
+        [](auto const first, auto const last) { return yampi::make_buffer(first, last); },
+        [](auto& value) { return yampi::make_buffer(value); },
+        intracommunicator, intercommunicator, environment);
+    }
+
+    template <
+      typename ParallelPolicy, typename LocalState,
+      typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+    inline auto pipelined_inner_product(
+      ::ket::mpi::utility::policy::simple_mpi const& mpi_policy, ParallelPolicy const parallel_policy,
+      LocalState const& local_state,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+      std::vector< ::ket::utility::meta::range_value_t<LocalState>, BufferAllocator >& buffer, bool const sends_local_state,
+      yampi::datatype_base<DerivedDatatype> const& datatype,
+      yampi::communicator const& intracommunicator, yampi::intercommunicator const& intercommunicator, yampi::environment const& environment)
+    -> ::ket::utility::meta::range_value_t<LocalState>
+    {
+      ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"Pipelined inner product"}), environment};
+
+      return ::ket::mpi::pipelined_inner_product_detail::pipelined_inner_product(
+        mpi_policy, parallel_policy, local_state, permutation, buffer, sends_local_state,
+        [&datatype](auto const first, auto const last) { return yampi::make_buffer(first, last, datatype); },
+        [&datatype](auto& value) { return yampi::make_buffer(value, datatype); },
+        intracommunicator, intercommunicator, environment);
+    }
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_PIPELINED_INNER_PRODUCT_HPP
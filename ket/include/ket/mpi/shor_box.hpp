@@ -2,7 +2,10 @@
 # define KET_MPI_SHOR_BOX_HPP
 
 # include <cassert>
+# include <cmath>
 # include <iterator>
+# include <vector>
+# include <algorithm>
 # include <type_traits>
 
 # ifndef NDEBUG
@@ -68,32 +71,89 @@ namespace ket
       using std::end;
       auto const num_exponent_qubits = static_cast<BitInteger>(std::distance(begin(exponent_qubits), end(exponent_qubits)));
       auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-      auto modular_exponentiation_value = StateInteger{1u};
+      auto const num_qubits
+        = num_exponent_qubits
+          + static_cast<BitInteger>(std::distance(begin(modular_exponentiation_qubits), end(modular_exponentiation_qubits)));
 
       using std::pow;
       auto const constant_coefficient
         = static_cast<complex_type>(static_cast<real_type>(pow(static_cast<real_type>(num_exponents), -0.5)));
 
+      // A permutated qubit value v is in this process iff v >> L is one of owned_nonlocal_values, and then its local index is
+      // nonlocal_value_offsets[v >> L] + (v mod 2^L). These tables are made in advance because MPI should not be called in loop_n
+      auto const num_local_qubits
+        = static_cast<BitInteger>(::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+      auto const num_nonlocal_qubits = num_qubits > num_local_qubits ? num_qubits - num_local_qubits : BitInteger{0u};
+      auto const nonlocal_shift = num_qubits - num_nonlocal_qubits;
+      auto const num_nonlocal_values = ::ket::utility::integer_exp2<StateInteger>(num_nonlocal_qubits);
+      auto const local_mask = ::ket::utility::integer_exp2<StateInteger>(nonlocal_shift) - StateInteger{1u};
+
       auto const present_rank = communicator.rank(environment);
-      auto const first = begin(local_state);
-      for (auto exponent = StateInteger{0u}; exponent < num_exponents; ++exponent)
+      auto owned_nonlocal_values = std::vector<StateInteger>{};
+      auto is_owned_nonlocal_values = std::vector<char>(num_nonlocal_values, char{false});
+      auto nonlocal_value_offsets = std::vector<StateInteger>(num_nonlocal_values);
+      for (auto nonlocal_value = StateInteger{0u}; nonlocal_value < num_nonlocal_values; ++nonlocal_value)
       {
-        auto const qubit_value
-          = ::ket::shor_box_detail::calculate_index(
-              ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
-              modular_exponentiation_value, modular_exponentiation_qubits);
-
         auto const rank_index
           = ::ket::mpi::utility::qubit_value_to_rank_index(
-              mpi_policy, local_state, ::ket::mpi::permutate_bits(permutation, qubit_value),
-              communicator, environment);
+              mpi_policy, local_state, nonlocal_value << nonlocal_shift, communicator, environment);
+        if (rank_index.first != present_rank)
+          continue;
 
-        if (rank_index.first == present_rank)
-          *(first + rank_index.second) = constant_coefficient;
+        owned_nonlocal_values.push_back(nonlocal_value);
+        is_owned_nonlocal_values[nonlocal_value] = char{true};
+        nonlocal_value_offsets[nonlocal_value] = rank_index.second;
+      }
 
-        modular_exponentiation_value *= base;
-        modular_exponentiation_value %= divisor;
+      // Exponent bits on nonlocal qubits are determined by the nonlocal part of owned qubit values, so only exponents
+      // matching one of them are enumerated. Modular exponentiation bits on nonlocal qubits are checked for each exponent
+      auto nonlocal_exponent_mask = StateInteger{0u};
+      auto nonlocal_exponent_patterns = std::vector<StateInteger>{};
+      nonlocal_exponent_patterns.reserve(owned_nonlocal_values.size());
+      for (auto const owned_nonlocal_value: owned_nonlocal_values)
+      {
+        auto pattern = StateInteger{0u};
+        // exponent bit k is put on exponent_qubits[n_x - 1 - k] because of reverse_bits
+        for (auto exponent_bit = BitInteger{0u}; exponent_bit < num_exponent_qubits; ++exponent_bit)
+        {
+          auto const exponent_qubit = *(begin(exponent_qubits) + (num_exponent_qubits - BitInteger{1u} - exponent_bit));
+          auto const permutated_bit = static_cast<BitInteger>(permutation[exponent_qubit].qubit());
+          if (permutated_bit < nonlocal_shift)
+            continue;
+
+          nonlocal_exponent_mask |= StateInteger{1u} << exponent_bit;
+          pattern
+            |= ((owned_nonlocal_value >> (permutated_bit - nonlocal_shift)) bitand StateInteger{1u}) << exponent_bit;
+        }
+        nonlocal_exponent_patterns.push_back(pattern);
       }
+      std::sort(begin(nonlocal_exponent_patterns), end(nonlocal_exponent_patterns));
+      nonlocal_exponent_patterns.erase(
+        std::unique(begin(nonlocal_exponent_patterns), end(nonlocal_exponent_patterns)), end(nonlocal_exponent_patterns));
+
+      auto const modular_squares = ::ket::shor_box_detail::make_modular_squares(base, divisor, num_exponent_qubits);
+      auto const first = begin(local_state);
+      for (auto const pattern: nonlocal_exponent_patterns)
+        ::ket::shor_box_detail::for_each_modular_exponentiation(
+          parallel_policy, modular_squares, divisor,
+          pattern, (num_exponents - StateInteger{1u}) bitand compl nonlocal_exponent_mask,
+          [first, num_exponent_qubits, constant_coefficient, &exponent_qubits, &modular_exponentiation_qubits, &permutation,
+           nonlocal_shift, local_mask, &is_owned_nonlocal_values, &nonlocal_value_offsets](
+            StateInteger const exponent, StateInteger const modular_exponentiation_value)
+          {
+            auto const permutated_qubit_value
+              = ::ket::mpi::permutate_bits(
+                  permutation,
+                  ::ket::shor_box_detail::calculate_index(
+                    ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
+                    modular_exponentiation_value, modular_exponentiation_qubits));
+
+            auto const nonlocal_value = permutated_qubit_value >> nonlocal_shift;
+            if (not is_owned_nonlocal_values[nonlocal_value])
+              return;
+
+            *(first + (nonlocal_value_offsets[nonlocal_value] + (permutated_qubit_value bitand local_mask))) = constant_coefficient;
+          });
 
       return local_state;
     }
@@ -3,6 +3,7 @@
 
 # include <cstddef>
 # include <cassert>
+# include <cstdint>
 # include <iterator>
 # include <vector>
 # include <algorithm>
@@ -46,6 +47,7 @@
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/ranges.hpp>
 # include <ket/utility/meta/real_of.hpp>
+# include <ket/utility/profiler.hpp>
 # include <ket/inner_product.hpp>
 # include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
@@ -323,6 +325,25 @@ namespace ket
           buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)}
       { assert(num_page_qubits_ >= BitInteger{1u} and num_local_qubits_ > num_page_qubits_); }
 
+      // Amplitudes are zero-filled by parallel_policy, so pages are first touched by the threads applying gates to them
+      // if Allocator does not initialize elements, e.g. ::ket::utility::first_touch_allocator
+      template <typename ParallelPolicy, typename MpiPolicy, typename BitInteger, typename StateInteger, typename PermutationAllocator>
+      state(
+        ParallelPolicy const parallel_policy, MpiPolicy const& mpi_policy,
+        BitInteger const num_local_qubits, BitInteger const num_page_qubits,
+        StateInteger const initial_integer,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, PermutationAllocator> const& permutation,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+        : data_{generate_initial_data(
+            parallel_policy, mpi_policy, num_local_qubits, StateInteger{1u} << num_page_qubits, initial_integer, permutation, communicator, environment)},
+          num_local_qubits_{static_cast<std::size_t>(num_local_qubits)},
+          num_page_qubits_{static_cast<std::size_t>(num_page_qubits)},
+          num_pages_{std::size_t{1u} << num_page_qubits},
+          num_data_blocks_{static_cast<std::size_t>(::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment))},
+          page_ranges_{generate_initial_page_ranges(data_, num_pages_, num_data_blocks_)},
+          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)}
+      { assert(num_page_qubits_ >= BitInteger{1u} and num_local_qubits_ > num_page_qubits_); }
+
       auto assign(std::initializer_list<value_type> initializer_list) -> void
       { assign(initializer_list, std::size_t{1u}, std::size_t{1u}); }
 
@@ -588,6 +609,47 @@ namespace ket
         data.resize(data_size);
       }
 
+      template <
+        typename ParallelPolicy, typename MpiPolicy, typename BitInteger, typename StateInteger,
+        typename PermutationAllocator>
+      auto initialize_data(
+        data_type& data,
+        ParallelPolicy const parallel_policy, MpiPolicy const& mpi_policy,
+        BitInteger const num_local_qubits, StateInteger const num_pages,
+        StateInteger const initial_integer,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, PermutationAllocator> const&
+          permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment) const
+      -> void
+      {
+        auto const data_block_size = ::ket::utility::integer_exp2<std::size_t>(num_local_qubits);
+        auto const num_data_blocks = ::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment);
+        auto const state_size = data_block_size * static_cast<std::size_t>(num_data_blocks);
+        auto const data_size = state_size + data_block_size / static_cast<std::size_t>(num_pages);
+
+        assert(state_size % (num_pages * num_data_blocks) == 0);
+
+        // The buffer page is also zero-filled because it is first touched here
+        data.clear();
+        data.reserve(data_size);
+        data.resize(state_size);
+
+        auto const rank_index
+          = ::ket::mpi::utility::qubit_value_to_rank_index(
+              mpi_policy, data, ::ket::mpi::permutate_bits(permutation, initial_integer),
+              communicator, environment);
+
+        data.resize(data_size);
+        using std::begin;
+        using std::end;
+        ::ket::utility::fill(parallel_policy, begin(data), end(data), value_type{0});
+
+        if (communicator.rank(environment) == rank_index.first)
+          data[rank_index.second] = value_type{1};
+      }
+
       auto generate_initial_data(
         std::initializer_list<value_type> initializer_list,
         std::size_t const num_pages, std::size_t const num_data_blocks,
@@ -618,6 +680,25 @@ namespace ket
         return result;
       }
 
+      template <
+        typename ParallelPolicy, typename MpiPolicy, typename BitInteger, typename StateInteger,
+        typename PermutationAllocator>
+      auto generate_initial_data(
+        ParallelPolicy const parallel_policy, MpiPolicy const& mpi_policy,
+        BitInteger const num_local_qubits, StateInteger const num_pages,
+        StateInteger const initial_integer,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, PermutationAllocator> const&
+          permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment) const
+      -> data_type
+      {
+        auto result = data_type{};
+        initialize_data(result, parallel_policy, mpi_policy, num_local_qubits, num_pages, initial_integer, permutation, communicator, environment);
+        return result;
+      }
+
       auto generate_initial_page_ranges(data_type& data, std::size_t const num_pages, std::size_t const num_data_blocks) const
       -> std::vector<page_range_type>
       {
@@ -886,8 +967,9 @@ namespace ket
       struct interchange_qubits
       {
         template <
-          typename Allocator, typename Complex, typename Allocator_, typename StateInteger>
+          typename ParallelPolicy, typename Allocator, typename Complex, typename Allocator_, typename StateInteger>
         static auto call(
+          ParallelPolicy const,
           ::ket::mpi::state<Complex, has_page_qubits, Allocator>& local_state,
           std::vector<Complex, Allocator_>&,
           StateInteger const data_block_index, StateInteger const data_block_size,
@@ -907,6 +989,7 @@ namespace ket
               page_iterator const first, page_iterator const last,
               page_iterator const buffer_first, page_iterator const buffer_last)
             {
+              ::ket::utility::profiler::instance().add_moved_bytes(static_cast<std::uint64_t>(last - first) * sizeof(Complex));
               yampi::algorithm::swap(
                 yampi::ignore_status,
                 yampi::make_buffer(first, last),
@@ -916,9 +999,10 @@ namespace ket
         }
 
         template <
-          typename Allocator, typename Complex, typename Allocator_, typename StateInteger,
+          typename ParallelPolicy, typename Allocator, typename Complex, typename Allocator_, typename StateInteger,
           typename DerivedDatatype>
         static auto call(
+          ParallelPolicy const,
           ::ket::mpi::state<Complex, has_page_qubits, Allocator>& local_state,
           std::vector<Complex, Allocator_>&,
           StateInteger const data_block_index, StateInteger const data_block_size,
@@ -938,6 +1022,7 @@ namespace ket
               page_iterator const first, page_iterator const last,
               page_iterator const buffer_first, page_iterator const buffer_last)
             {
+              ::ket::utility::profiler::instance().add_moved_bytes(static_cast<std::uint64_t>(last - first) * sizeof(Complex));
               yampi::algorithm::swap(
                 yampi::ignore_status,
                 yampi::make_buffer(first, last, datatype),
@@ -2232,8 +2317,9 @@ namespace ket
       struct interchange_qubits<false>
       {
         template <
-          typename Allocator, typename Complex, typename Allocator_, typename StateInteger>
+          typename ParallelPolicy, typename Allocator, typename Complex, typename Allocator_, typename StateInteger>
         static auto call(
+          ParallelPolicy const parallel_policy,
           ::ket::mpi::state<Complex, false, Allocator>& local_state,
           std::vector<Complex, Allocator_>& buffer,
           StateInteger const data_block_index, StateInteger const data_block_size,
@@ -2247,15 +2333,16 @@ namespace ket
           assert(data_block_size == ::ket::utility::integer_exp2<std::size_t>(local_state.num_local_qubits()));
 
           ::ket::mpi::utility::detail::interchange_qubits(
-            local_state.data(), buffer, data_block_index, data_block_size,
+            parallel_policy, local_state.data(), buffer, data_block_index, data_block_size,
             source_local_first_index, source_local_last_index,
             target_rank, communicator, environment);
         }
 
         template <
-          typename Allocator, typename Complex, typename Allocator_, typename StateInteger,
+          typename ParallelPolicy, typename Allocator, typename Complex, typename Allocator_, typename StateInteger,
           typename DerivedDatatype>
         static auto call(
+          ParallelPolicy const parallel_policy,
           ::ket::mpi::state<Complex, false, Allocator>& local_state,
           std::vector<Complex, Allocator_>& buffer,
           StateInteger const data_block_index, StateInteger const data_block_size,
@@ -2269,7 +2356,7 @@ namespace ket
           assert(data_block_size == ::ket::utility::integer_exp2<std::size_t>(local_state.num_local_qubits()));
 
           ::ket::mpi::utility::detail::interchange_qubits(
-            local_state.data(), buffer, data_block_index, data_block_size,
+            parallel_policy, local_state.data(), buffer, data_block_index, data_block_size,
             source_local_first_index, source_local_last_index,
             datatype, target_rank, communicator, environment);
         }
@@ -9823,8 +9910,9 @@ namespace ket
         template <typename Complex, bool has_page_qubits, typename Allocator>
         struct interchange_qubits< ::ket::mpi::state<Complex, has_page_qubits, Allocator> >
         {
-          template <typename Allocator_, typename StateInteger>
+          template <typename ParallelPolicy, typename Allocator_, typename StateInteger>
           static auto call(
+            ParallelPolicy const parallel_policy,
             ::ket::mpi::state<Complex, has_page_qubits, Allocator>& local_state,
             std::vector<Complex, Allocator_>& buffer,
             StateInteger const data_block_index, StateInteger const data_block_size,
@@ -9835,13 +9923,14 @@ namespace ket
           -> void
           {
             ::ket::mpi::state_detail::interchange_qubits<has_page_qubits>::call(
-              local_state, buffer, data_block_index, data_block_size,
+              parallel_policy, local_state, buffer, data_block_index, data_block_size,
               source_local_first_index, source_local_last_index,
               target_rank, communicator, environment);
           }
 
-          template <typename Allocator_, typename StateInteger, typename DerivedDatatype>
+          template <typename ParallelPolicy, typename Allocator_, typename StateInteger, typename DerivedDatatype>
           static auto call(
+            ParallelPolicy const parallel_policy,
             ::ket::mpi::state<Complex, has_page_qubits, Allocator>& local_state,
             std::vector<Complex, Allocator_>& buffer,
             StateInteger const data_block_index, StateInteger const data_block_size,
@@ -9852,7 +9941,7 @@ namespace ket
           -> void
           {
             ::ket::mpi::state_detail::interchange_qubits<has_page_qubits>::call(
-              local_state, buffer, data_block_index, data_block_size,
+              parallel_policy, local_state, buffer, data_block_index, data_block_size,
               source_local_first_index, source_local_last_index,
               datatype, target_rank, communicator, environment);
           }
@@ -17,10 +17,14 @@
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/real_of.hpp>
 # include <ket/utility/meta/ranges.hpp>
+# include <ket/swapped_fourier_transform.hpp>
+# include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/gate/hadamard.hpp>
 # include <ket/mpi/gate/controlled_phase_shift.hpp>
+# include <ket/mpi/page/any_on_page.hpp>
 # include <ket/mpi/utility/simple_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
 # include <ket/mpi/utility/logger.hpp>
 # include <ket/utility/integer_exp2.hpp>
 # ifndef NDEBUG
@@ -32,6 +36,58 @@ namespace ket
 {
   namespace mpi
   {
+    namespace swapped_fourier_transform_detail
+    {
+      // All global qubits of the register are made local by one exchange, and then the butterfly passes of ket::swapped_fourier_transform
+      // are applied to each local range. Gates are applied one by one if the register does not fit in local qubits or some qubits are on pages
+      template <
+        typename MpiPolicy, typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename Qubits>
+      inline auto is_local_fourier_transform_applicable(
+        MpiPolicy const& mpi_policy, RandomAccessRange const& local_state,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator, yampi::environment const& environment,
+        Qubits const& qubits)
+      -> bool
+      {
+        using std::begin;
+        using std::end;
+        return static_cast<BitInteger>(std::distance(begin(qubits), end(qubits)))
+          <= ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment);
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename RandomAccessRange, typename StateInteger, typename BitInteger, typename Allocator, typename Qubits>
+      inline auto maybe_apply_local_fourier_transform(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator, yampi::environment const& environment,
+        Qubits const& qubits, bool const is_adjoint)
+      -> bool
+      {
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        auto permutated_qubits = std::vector< ::ket::mpi::permutated<qubit_type> >{};
+        for (auto const& qubit: qubits)
+          permutated_qubits.push_back(permutation[qubit]);
+
+        if (::ket::mpi::page::runtime::ranges::any_on_page(local_state, permutated_qubits))
+          return false;
+
+        auto local_qubits = std::vector<qubit_type>{};
+        local_qubits.reserve(permutated_qubits.size());
+        for (auto const& permutated_qubit: permutated_qubits)
+          local_qubits.push_back(permutated_qubit.qubit());
+
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [parallel_policy, &local_qubits, is_adjoint](auto const first, auto const last)
+          { ::ket::swapped_fourier_transform_detail::fourier_transform(parallel_policy, first, last, local_qubits, is_adjoint); });
+        return true;
+      }
+    } // namespace swapped_fourier_transform_detail
+
     template <
       typename MpiPolicy, typename ParallelPolicy,
       typename RandomAccessRange, typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
@@ -59,6 +115,16 @@ namespace ket
       auto const register_size = static_cast<BitInteger>(std::distance(begin(qubits), end(qubits)));
       ::ket::utility::generate_phase_coefficients(phase_coefficients, register_size);
 
+      if (::ket::mpi::swapped_fourier_transform_detail::is_local_fourier_transform_applicable(
+            mpi_policy, local_state, permutation, communicator, environment, qubits))
+      {
+        ::ket::mpi::utility::runtime::ranges::maybe_interchange_qubits(
+          mpi_policy, parallel_policy, local_state, permutation, buffer, communicator, environment, qubits);
+        if (::ket::mpi::swapped_fourier_transform_detail::maybe_apply_local_fourier_transform(
+              mpi_policy, parallel_policy, local_state, permutation, communicator, environment, qubits, false))
+          return local_state;
+      }
+
       auto const qubits_first = begin(qubits);
 
       for (auto index = BitInteger{0u}; index < register_size; ++index)
@@ -137,6 +203,16 @@ namespace ket
       auto const register_size = static_cast<BitInteger>(std::distance(begin(qubits), end(qubits)));
       ::ket::utility::generate_phase_coefficients(phase_coefficients, register_size);
 
+      if (::ket::mpi::swapped_fourier_transform_detail::is_local_fourier_transform_applicable(
+            mpi_policy, local_state, permutation, communicator, environment, qubits))
+      {
+        ::ket::mpi::utility::runtime::ranges::maybe_interchange_qubits(
+          mpi_policy, parallel_policy, local_state, permutation, buffer, datatype, communicator, environment, qubits);
+        if (::ket::mpi::swapped_fourier_transform_detail::maybe_apply_local_fourier_transform(
+              mpi_policy, parallel_policy, local_state, permutation, communicator, environment, qubits, false))
+          return local_state;
+      }
+
       auto const qubits_first = begin(qubits);
 
       for (auto index = BitInteger{0u}; index < register_size; ++index)
@@ -677,6 +753,16 @@ namespace ket
       auto const register_size = static_cast<BitInteger>(std::distance(begin(qubits), end(qubits)));
       ::ket::utility::generate_phase_coefficients(phase_coefficients, register_size);
 
+      if (::ket::mpi::swapped_fourier_transform_detail::is_local_fourier_transform_applicable(
+            mpi_policy, local_state, permutation, communicator, environment, qubits))
+      {
+        ::ket::mpi::utility::runtime::ranges::maybe_interchange_qubits(
+          mpi_policy, parallel_policy, local_state, permutation, buffer, communicator, environment, qubits);
+        if (::ket::mpi::swapped_fourier_transform_detail::maybe_apply_local_fourier_transform(
+              mpi_policy, parallel_policy, local_state, permutation, communicator, environment, qubits, true))
+          return local_state;
+      }
+
       auto const qubits_first = begin(qubits);
 
       for (auto target_bit = BitInteger{0u}; target_bit < register_size; ++target_bit)
@@ -753,6 +839,16 @@ namespace ket
       auto const register_size = static_cast<BitInteger>(std::distance(begin(qubits), end(qubits)));
       ::ket::utility::generate_phase_coefficients(phase_coefficients, register_size);
 
+      if (::ket::mpi::swapped_fourier_transform_detail::is_local_fourier_transform_applicable(
+            mpi_policy, local_state, permutation, communicator, environment, qubits))
+      {
+        ::ket::mpi::utility::runtime::ranges::maybe_interchange_qubits(
+          mpi_policy, parallel_policy, local_state, permutation, buffer, datatype, communicator, environment, qubits);
+        if (::ket::mpi::swapped_fourier_transform_detail::maybe_apply_local_fourier_transform(
+              mpi_policy, parallel_policy, local_state, permutation, communicator, environment, qubits, true))
+          return local_state;
+      }
+
       auto const qubits_first = begin(qubits);
 
       for (auto target_bit = BitInteger{0u}; target_bit < register_size; ++target_bit)
@@ -2,8 +2,11 @@
 # define KET_MPI_UTILITY_DETAIL_INTERCHANGE_QUBITS_HPP
 
 # include <cassert>
+# include <cstdint>
 # include <vector>
+# include <array>
 # include <iterator>
+# include <algorithm>
 # include <utility>
 # include <type_traits>
 
@@ -12,10 +15,18 @@
 # include <yampi/communicator.hpp>
 # include <yampi/buffer.hpp>
 # include <yampi/rank.hpp>
-# include <yampi/status.hpp>
-# include <yampi/algorithm/swap.hpp>
+# include <yampi/tag.hpp>
+# include <yampi/request.hpp>
+# include <yampi/send.hpp>
+# include <yampi/receive.hpp>
 
+# include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/ranges.hpp>
+# include <ket/utility/profiler.hpp>
+
+# ifndef KET_NUM_INTERCHANGE_PIPELINE_STAGES
+#   define KET_NUM_INTERCHANGE_PIPELINE_STAGES 2
+# endif // KET_NUM_INTERCHANGE_PIPELINE_STAGES
 
 
 namespace ket
@@ -24,13 +35,81 @@ namespace ket
   {
     namespace utility
     {
+      namespace interchange_qubits_detail
+      {
+        // Exchanges [first, last) with the same range of the target process through a pipeline of nonblocking communications.
+        // The buffer is divided into (at most) KET_NUM_INTERCHANGE_PIPELINE_STAGES chunks, and while a received chunk is copied back to [first, last) the following chunks are communicated.
+        template <typename ParallelPolicy, typename RandomAccessIterator, typename BufferIterator, typename StateInteger, typename MakeBuffer>
+        inline auto pipelined_swap(
+          ParallelPolicy const parallel_policy,
+          RandomAccessIterator const first, RandomAccessIterator const last,
+          BufferIterator const buffer_first, StateInteger const buffer_size,
+          MakeBuffer make_buffer, yampi::rank const target_rank,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        -> void
+        {
+          assert(buffer_size > StateInteger{0u});
+
+          auto const size = static_cast<StateInteger>(last - first);
+          constexpr auto max_num_stages = StateInteger{KET_NUM_INTERCHANGE_PIPELINE_STAGES};
+          auto const chunk_size = std::max(StateInteger{1u}, buffer_size / max_num_stages);
+          auto const num_stages = std::min(max_num_stages, buffer_size / chunk_size);
+          auto const num_chunks = (size + chunk_size - StateInteger{1u}) / chunk_size;
+          ::ket::utility::profiler::instance().add_moved_bytes(
+            static_cast<std::uint64_t>(size) * sizeof(typename std::iterator_traits<RandomAccessIterator>::value_type));
+
+          auto send_requests = std::array<yampi::request, KET_NUM_INTERCHANGE_PIPELINE_STAGES>{};
+          auto receive_requests = std::array<yampi::request, KET_NUM_INTERCHANGE_PIPELINE_STAGES>{};
+          // Messages between two processes with the same tag are not overtaken, so one tag is enough
+          auto const tag = yampi::tag{0};
+
+          auto const post
+            = [first, buffer_first, size, chunk_size, num_stages, &make_buffer, target_rank, tag, &communicator, &environment,
+               &send_requests, &receive_requests](StateInteger const chunk_index)
+              {
+                auto const stage = chunk_index % num_stages;
+                auto const chunk_first_index = chunk_index * chunk_size;
+                auto const present_chunk_size = std::min(chunk_size, size - chunk_first_index);
+                auto const chunk_buffer_first = buffer_first + stage * chunk_size;
+
+                yampi::receive(
+                  receive_requests[stage], make_buffer(chunk_buffer_first, chunk_buffer_first + present_chunk_size),
+                  target_rank, tag, communicator, environment);
+                yampi::send(
+                  send_requests[stage], make_buffer(first + chunk_first_index, first + chunk_first_index + present_chunk_size),
+                  target_rank, tag, communicator, environment);
+              };
+
+          for (auto chunk_index = StateInteger{0u}; chunk_index < std::min(num_stages, num_chunks); ++chunk_index)
+            post(chunk_index);
+
+          for (auto chunk_index = StateInteger{0u}; chunk_index < num_chunks; ++chunk_index)
+          {
+            auto const stage = chunk_index % num_stages;
+            receive_requests[stage].wait(environment);
+            // The chunk cannot be overwritten until it has been sent
+            send_requests[stage].wait(environment);
+
+            auto const chunk_first_index = chunk_index * chunk_size;
+            ::ket::utility::copy_n(
+              parallel_policy,
+              buffer_first + stage * chunk_size, std::min(chunk_size, size - chunk_first_index),
+              first + chunk_first_index);
+
+            if (chunk_index + num_stages < num_chunks)
+              post(chunk_index + num_stages);
+          }
+        }
+      } // namespace interchange_qubits_detail
+
       namespace dispatch
       {
         template <typename LocalState_>
         struct interchange_qubits
         {
-          template <typename LocalState, typename Allocator, typename StateInteger>
+          template <typename ParallelPolicy, typename LocalState, typename Allocator, typename StateInteger>
           static auto call(
+            ParallelPolicy const parallel_policy,
             LocalState&& local_state,
             std::vector< ::ket::utility::meta::range_value_t<LocalState>, Allocator >& buffer,
             StateInteger const data_block_index, StateInteger const data_block_size,
@@ -50,13 +129,6 @@ namespace ket
             if (new_size > buffer.capacity())
               std::vector< ::ket::utility::meta::range_value_t<LocalState>, Allocator >{}.swap(buffer);
             buffer.resize(new_size);
-
-            using std::end;
-            yampi::algorithm::swap(
-              yampi::ignore_status,
-              yampi::make_buffer(first, last), yampi::make_buffer(begin(buffer), end(buffer)),
-              target_rank, communicator, environment);
-            std::copy(begin(buffer), end(buffer), first);
 #else // BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
             if (buffer.empty())
             {
@@ -64,50 +136,20 @@ namespace ket
               if (new_size > buffer.capacity())
                 std::vector< ::ket::utility::meta::range_value_t<LocalState>, Allocator >{}.swap(buffer);
               buffer.resize(new_size);
-
-              using std::end;
-              yampi::algorithm::swap(
-                yampi::ignore_status,
-                yampi::make_buffer(first, last), yampi::make_buffer(begin(buffer), end(buffer)),
-                target_rank, communicator, environment);
-              std::copy(begin(buffer), end(buffer), first);
-            }
-            else
-            {
-              auto const buffer_size = buffer.size();
-              auto const num_iterations = (source_local_last_index - source_local_first_index) / buffer_size;
-
-              auto present_first = first;
-              for (auto count = decltype(num_iterations){0}; count < num_iterations; ++count)
-              {
-                using std::end;
-                yampi::algorithm::swap(
-                  yampi::ignore_status,
-                  yampi::make_buffer(present_first, present_first + buffer_size),
-                  yampi::make_buffer(begin(buffer), end(buffer)),
-                  target_rank, communicator, environment);
-                std::copy(begin(buffer), end(buffer), present_first);
-
-                present_first += buffer_size;
-              }
-
-              auto const remainder_size = (source_local_last_index - source_local_first_index) % buffer_size;
-              if (remainder_size > decltype(remainder_size){0})
-              {
-                using std::end;
-                yampi::algorithm::swap(
-                  yampi::ignore_status,
-                  yampi::make_buffer(present_first, present_first + remainder_size),
-                  yampi::make_buffer(begin(buffer), begin(buffer) + remainder_size),
-                  target_rank, communicator, environment);
-                std::copy_n(begin(buffer), remainder_size, present_first);
-              }
             }
 #endif // BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
+            if (first == last)
+              return;
+
+            ::ket::mpi::utility::interchange_qubits_detail::pipelined_swap(
+              parallel_policy, first, last, begin(buffer), static_cast<StateInteger>(buffer.size()),
+              [](auto const buffer_first, auto const buffer_last) { return yampi::make_buffer(buffer_first, buffer_last); },
+              target_rank, communicator, environment);
           }
 
-          template <typename LocalState, typename Allocator, typename StateInteger, typename DerivedDatatype>
+          template <typename ParallelPolicy, typename LocalState, typename Allocator, typename StateInteger, typename DerivedDatatype>
           static auto call(
+            ParallelPolicy const parallel_policy,
             LocalState&& local_state,
             std::vector< ::ket::utility::meta::range_value_t<LocalState>, Allocator >& buffer,
             StateInteger const data_block_index, StateInteger const data_block_size,
@@ -124,65 +166,26 @@ namespace ket
 
 #ifndef BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
             buffer.resize(source_local_last_index - source_local_first_index);
-            using std::end;
-            yampi::algorithm::swap(
-              yampi::ignore_status,
-              yampi::make_buffer(first, last, datatype),
-              yampi::make_buffer(begin(buffer), end(buffer), datatype),
-              target_rank, communicator, environment);
-            std::copy(begin(buffer), end(buffer), first);
 #else // BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
             if (buffer.empty())
-            {
               buffer.resize(source_local_last_index - source_local_first_index);
-              using std::end;
-              yampi::algorithm::swap(
-                yampi::ignore_status,
-                yampi::make_buffer(first, last, datatype),
-                yampi::make_buffer(begin(buffer), end(buffer), datatype),
-                target_rank, communicator, environment);
-              std::copy(begin(buffer), end(buffer), first);
-            }
-            else
-            {
-              auto const buffer_size = buffer.size();
-              auto const num_iterations = (source_local_last_index - source_local_first_index) / buffer_size;
-
-              auto present_first = first;
-              for (auto count = decltype(num_iterations){0}; count < num_iterations; ++count)
-              {
-                using std::end;
-                yampi::algorithm::swap(
-                  yampi::ignore_status,
-                  yampi::make_buffer(present_first, present_first + buffer_size, datatype),
-                  yampi::make_buffer(begin(buffer), end(buffer), datatype),
-                  target_rank, communicator, environment);
-                std::copy(begin(buffer), end(buffer), present_first);
-
-                present_first += buffer_size;
-              }
-
-              auto const remainder_size = (source_local_last_index - source_local_first_index) % buffer_size;
-              if (remainder_size > decltype(remainder_size){0})
-              {
-                using std::end;
-                yampi::algorithm::swap(
-                  yampi::ignore_status,
-                  yampi::make_buffer(present_first, present_first + remainder_size, datatype),
-                  yampi::make_buffer(begin(buffer), begin(buffer) + remainder_size, datatype),
-                  target_rank, communicator, environment);
-                std::copy_n(begin(buffer), remainder_size, present_first);
-              }
-            }
 #endif // BRAKET_ENABLE_MULTIPLE_USES_OF_BUFFER_FOR_ONE_DATA_TRANSFER_IF_NO_PAGE_EXISTS
+            if (first == last)
+              return;
+
+            ::ket::mpi::utility::interchange_qubits_detail::pipelined_swap(
+              parallel_policy, first, last, begin(buffer), static_cast<StateInteger>(buffer.size()),
+              [&datatype](auto const buffer_first, auto const buffer_last) { return yampi::make_buffer(buffer_first, buffer_last, datatype); },
+              target_rank, communicator, environment);
           }
         }; // struct interchange_qubits<LocalState_>
       } // namespace dispatch
 
       namespace detail
       {
-        template <typename LocalState, typename Allocator, typename StateInteger>
+        template <typename ParallelPolicy, typename LocalState, typename Allocator, typename StateInteger>
         inline auto interchange_qubits(
+          ParallelPolicy const parallel_policy,
           LocalState&& local_state,
           std::vector< ::ket::utility::meta::range_value_t<LocalState>, Allocator >& buffer,
           StateInteger const data_block_index, StateInteger const data_block_size,
@@ -194,14 +197,15 @@ namespace ket
           using interchange_qubits_
             = ::ket::mpi::utility::dispatch::interchange_qubits<std::remove_cv_t<std::remove_reference_t<LocalState>>>;
           interchange_qubits_::call(
-            std::forward<LocalState>(local_state), buffer,
+            parallel_policy, std::forward<LocalState>(local_state), buffer,
             data_block_index, data_block_size,
             source_local_first_index, source_local_last_index,
             target_rank, communicator, environment);
         }
 
-        template <typename LocalState, typename Allocator, typename StateInteger, typename DerivedDatatype>
+        template <typename ParallelPolicy, typename LocalState, typename Allocator, typename StateInteger, typename DerivedDatatype>
         inline auto interchange_qubits(
+          ParallelPolicy const parallel_policy,
           LocalState&& local_state,
           std::vector< ::ket::utility::meta::range_value_t<LocalState>, Allocator >& buffer,
           StateInteger const data_block_index, StateInteger const data_block_size,
@@ -213,7 +217,7 @@ namespace ket
           using interchange_qubits_
             = ::ket::mpi::utility::dispatch::interchange_qubits<std::remove_cv_t<std::remove_reference_t<LocalState>>>;
           interchange_qubits_::call(
-            std::forward<LocalState>(local_state), buffer,
+            parallel_policy, std::forward<LocalState>(local_state), buffer,
             data_block_index, data_block_size,
             source_local_first_index, source_local_last_index,
             datatype, target_rank, communicator, environment);
@@ -0,0 +1,219 @@
+#ifndef KET_MPI_UTILITY_DETAIL_INTERCIRCUIT_LAYOUT_HPP
+# define KET_MPI_UTILITY_DETAIL_INTERCIRCUIT_LAYOUT_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <vector>
+# include <utility>
+
+# include <ket/qubit.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace utility
+    {
+      namespace detail
+      {
+        // Scatters bit i of a value to bit destinations[i] by looking up a table for each byte of the value
+        template <typename StateInteger>
+        class bit_deposit_table
+        {
+          static constexpr auto num_byte_patterns = std::size_t{256u};
+
+          // table_[byte_index * num_byte_patterns + byte]
+          std::vector<StateInteger> table_;
+          bool is_identity_;
+
+         public:
+          bit_deposit_table() : table_{}, is_identity_{true} { }
+
+          template <typename BitInteger>
+          explicit bit_deposit_table(std::vector<BitInteger> const& destinations)
+            : table_(((destinations.size() + std::size_t{7u}) / std::size_t{8u}) * num_byte_patterns, StateInteger{0u}),
+              is_identity_{true}
+          {
+            auto const num_bits = destinations.size();
+            for (auto bit = std::size_t{0u}; bit < num_bits; ++bit)
+            {
+              is_identity_ = is_identity_ and static_cast<std::size_t>(destinations[bit]) == bit;
+
+              auto const byte_index = bit / std::size_t{8u};
+              auto const mask = std::size_t{1u} << (bit % std::size_t{8u});
+              auto const destination = StateInteger{1u} << destinations[bit];
+              for (auto byte = std::size_t{0u}; byte < num_byte_patterns; ++byte)
+                if ((byte bitand mask) != std::size_t{0u})
+                  table_[byte_index * num_byte_patterns + byte] |= destination;
+            }
+          }
+
+          auto is_identity() const noexcept -> bool { return is_identity_; }
+
+          auto operator()(StateInteger value) const noexcept -> StateInteger
+          {
+            auto result = StateInteger{0u};
+            for (auto first = table_.data(), last = table_.data() + table_.size(); first != last; first += num_byte_patterns, value >>= 8u)
+              result |= first[static_cast<std::size_t>(value bitand StateInteger{0xFFu})];
+            return result;
+          }
+        }; // class bit_deposit_table<StateInteger>
+
+        // Correspondence of local indices and ranks between two circuits with the same numbers of qubits and processes
+        // but different qubit permutations, where processes of the "sender" circuit send their amplitudes to ones of the "receiver" circuit.
+        //
+        // Some qubits may be local in one circuit and global in the other. If k qubits are so, each sender process has 2^k partner processes
+        // and sends 2^(L-k) amplitudes to each partner, where L is the number of local qubits. For the partner_index-th partner,
+        // the m-th sent amplitude is at the local index packed_index(m) bitor sender_partner_bits(partner_index) of the sender process,
+        // and corresponds to the local index translated_index(m) bitor receiver_constant_bits(sender_rank) of the receiver process.
+        // Partners of a process are enumerated in increasing order of ranks on both sides, so that blocking on the partners in order never deadlocks.
+        template <typename StateInteger, typename BitInteger>
+        class intercircuit_layout
+        {
+          BitInteger num_local_qubits_;
+
+          ::ket::mpi::utility::detail::bit_deposit_table<StateInteger> packed_index_table_;
+          ::ket::mpi::utility::detail::bit_deposit_table<StateInteger> translated_index_table_;
+
+          // pairs of bits of sender and receiver ranks for qubits which are global in both circuits
+          std::vector<std::pair<BitInteger, BitInteger>> common_rank_bits_;
+          // for qubits which are local in the sender circuit and global in the receiver circuit
+          std::vector<BitInteger> receiver_partner_rank_bits_;
+          std::vector<BitInteger> sender_partner_positions_;
+          // for qubits which are global in the sender circuit and local in the receiver circuit
+          std::vector<BitInteger> sender_partner_rank_bits_;
+          std::vector<BitInteger> receiver_constant_positions_;
+
+         public:
+          // sender_positions[qubit] and receiver_positions[qubit] are permutated positions of qubit in each circuit
+          intercircuit_layout(
+            std::vector<BitInteger> const& sender_positions, std::vector<BitInteger> const& receiver_positions,
+            BitInteger const num_local_qubits)
+            : num_local_qubits_{num_local_qubits},
+              packed_index_table_{}, translated_index_table_{},
+              common_rank_bits_{}, receiver_partner_rank_bits_{}, sender_partner_positions_{},
+              sender_partner_rank_bits_{}, receiver_constant_positions_{}
+          {
+            assert(sender_positions.size() == receiver_positions.size());
+            assert(static_cast<std::size_t>(num_local_qubits) <= sender_positions.size());
+
+            auto const num_qubits = sender_positions.size();
+            auto sender_qubits = std::vector<BitInteger>(num_qubits);
+            auto receiver_qubits = std::vector<BitInteger>(num_qubits);
+            for (auto qubit = std::size_t{0u}; qubit < num_qubits; ++qubit)
+            {
+              sender_qubits[sender_positions[qubit]] = static_cast<BitInteger>(qubit);
+              receiver_qubits[receiver_positions[qubit]] = static_cast<BitInteger>(qubit);
+            }
+
+            auto packed_index_destinations = std::vector<BitInteger>{};
+            auto translated_index_destinations = std::vector<BitInteger>{};
+            for (auto position = BitInteger{0u}; position < num_local_qubits; ++position)
+            {
+              auto const receiver_position = receiver_positions[sender_qubits[position]];
+              if (receiver_position >= num_local_qubits)
+                continue;
+
+              packed_index_destinations.push_back(position);
+              translated_index_destinations.push_back(receiver_position);
+            }
+            packed_index_table_ = ::ket::mpi::utility::detail::bit_deposit_table<StateInteger>{packed_index_destinations};
+            translated_index_table_ = ::ket::mpi::utility::detail::bit_deposit_table<StateInteger>{translated_index_destinations};
+
+            for (auto position = num_local_qubits; position < static_cast<BitInteger>(num_qubits); ++position)
+            {
+              auto const sender_position = sender_positions[receiver_qubits[position]];
+              if (sender_position < num_local_qubits)
+              {
+                receiver_partner_rank_bits_.push_back(position - num_local_qubits);
+                sender_partner_positions_.push_back(sender_position);
+              }
+              else
+                common_rank_bits_.emplace_back(sender_position - num_local_qubits, position - num_local_qubits);
+
+              auto const receiver_position = receiver_positions[sender_qubits[position]];
+              if (receiver_position < num_local_qubits)
+              {
+                sender_partner_rank_bits_.push_back(position - num_local_qubits);
+                receiver_constant_positions_.push_back(receiver_position);
+              }
+            }
+            assert(receiver_partner_rank_bits_.size() == sender_partner_rank_bits_.size());
+          }
+
+          auto num_partner_qubits() const noexcept -> BitInteger { return static_cast<BitInteger>(receiver_partner_rank_bits_.size()); }
+          auto num_partners() const noexcept -> StateInteger { return StateInteger{1u} << num_partner_qubits(); }
+          auto num_elements_per_partner() const noexcept -> StateInteger
+          { return StateInteger{1u} << (num_local_qubits_ - num_partner_qubits()); }
+
+          // If true, the amplitudes sent to the only partner are contiguous in the sender process
+          auto is_packed_contiguously() const noexcept -> bool { return receiver_partner_rank_bits_.empty(); }
+          // If true, the received amplitudes are in the same order as the local amplitudes of the receiver process
+          auto is_translated_contiguously() const noexcept -> bool
+          { return receiver_partner_rank_bits_.empty() and translated_index_table_.is_identity(); }
+
+          auto packed_index(StateInteger const index) const noexcept -> StateInteger { return packed_index_table_(index); }
+          auto translated_index(StateInteger const index) const noexcept -> StateInteger { return translated_index_table_(index); }
+
+          auto sender_partner_bits(StateInteger const partner_index) const noexcept -> StateInteger
+          { return deposit(partner_index, sender_partner_positions_); }
+
+          auto receiver_constant_bits(StateInteger const sender_rank) const noexcept -> StateInteger
+          {
+            auto result = StateInteger{0u};
+            for (auto index = std::size_t{0u}; index < sender_partner_rank_bits_.size(); ++index)
+              if (((sender_rank >> sender_partner_rank_bits_[index]) bitand StateInteger{1u}) != StateInteger{0u})
+                result |= StateInteger{1u} << receiver_constant_positions_[index];
+            return result;
+          }
+
+          auto receiver_rank(StateInteger const sender_rank, StateInteger const partner_index) const noexcept -> StateInteger
+          {
+            auto result = deposit(partner_index, receiver_partner_rank_bits_);
+            for (auto const& rank_bits: common_rank_bits_)
+              if (((sender_rank >> rank_bits.first) bitand StateInteger{1u}) != StateInteger{0u})
+                result |= StateInteger{1u} << rank_bits.second;
+            return result;
+          }
+
+          auto sender_rank(StateInteger const receiver_rank, StateInteger const partner_index) const noexcept -> StateInteger
+          {
+            auto result = deposit(partner_index, sender_partner_rank_bits_);
+            for (auto const& rank_bits: common_rank_bits_)
+              if (((receiver_rank >> rank_bits.second) bitand StateInteger{1u}) != StateInteger{0u})
+                result |= StateInteger{1u} << rank_bits.first;
+            return result;
+          }
+
+         private:
+          static auto deposit(StateInteger const value, std::vector<BitInteger> const& destinations) noexcept -> StateInteger
+          {
+            auto result = StateInteger{0u};
+            for (auto index = std::size_t{0u}; index < destinations.size(); ++index)
+              if (((value >> index) bitand StateInteger{1u}) != StateInteger{0u})
+                result |= StateInteger{1u} << destinations[index];
+            return result;
+          }
+        }; // class intercircuit_layout<StateInteger, BitInteger>
+
+        // positions[qubit] = permutation[qubit]
+        template <typename StateInteger, typename BitInteger, typename Allocator>
+        inline auto permutated_positions(::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation)
+        -> std::vector<BitInteger>
+        {
+          auto result = std::vector<BitInteger>{};
+          result.reserve(permutation.size());
+          auto const num_qubits = static_cast<BitInteger>(permutation.size());
+          for (auto bit = BitInteger{0u}; bit < num_qubits; ++bit)
+            result.push_back(static_cast<BitInteger>(permutation[::ket::make_qubit<StateInteger>(bit)].qubit()));
+          return result;
+        }
+      } // namespace detail
+    } // namespace utility
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_UTILITY_DETAIL_INTERCIRCUIT_LAYOUT_HPP
@@ -21,6 +21,8 @@
 #   include <yampi/lowest_io_process.hpp>
 # endif // KET_PRINT_LOG
 
+# include <ket/utility/profiler.hpp>
+
 
 namespace ket
 {
@@ -181,14 +183,24 @@ namespace ket
         ::ket::mpi::utility::logger logger_;
         string_type string_;
         yampi::environment const* environment_ptr_;
+        ::ket::utility::profile_guard profile_guard_;
 
        public:
         log_with_time_guard(char const* c_str, yampi::environment const& environment)
-          : logger_{environment}, string_{c_str}, environment_ptr_{&environment}
-        { logger_.print("[start] " + string_, *environment_ptr_); }
+          : log_with_time_guard{c_str, ::ket::utility::profile_phase::none, environment}
+        { }
 
         log_with_time_guard(string_type const& string, yampi::environment const& environment)
-          : logger_{environment}, string_{string}, environment_ptr_{&environment}
+          : log_with_time_guard{string, ::ket::utility::profile_phase::none, environment}
+        { }
+
+        // The elapsed time is also added to the counter of the phase in ::ket::utility::profiler if it is enabled
+        log_with_time_guard(char const* c_str, ::ket::utility::profile_phase const phase, yampi::environment const& environment)
+          : logger_{environment}, string_{c_str}, environment_ptr_{&environment}, profile_guard_{phase}
+        { logger_.print("[start] " + string_, *environment_ptr_); }
+
+        log_with_time_guard(string_type const& string, ::ket::utility::profile_phase const phase, yampi::environment const& environment)
+          : logger_{environment}, string_{string}, environment_ptr_{&environment}, profile_guard_{phase}
         { logger_.print("[start] " + string_, *environment_ptr_); }
 
         ~log_with_time_guard()
@@ -209,14 +221,24 @@ namespace ket
         ::ket::mpi::utility::logger logger_;
         string_type string_;
         yampi::environment const* environment_ptr_;
+        ::ket::utility::profile_guard profile_guard_;
 
        public:
         log_with_time_guard(wchar_t const* c_str, yampi::environment const& environment)
-          : logger_{environment}, string_{c_str}, environment_ptr_{&environment}
-        { logger_.print(L"[start] " + string_, *environment_ptr_); }
+          : log_with_time_guard{c_str, ::ket::utility::profile_phase::none, environment}
+        { }
 
         log_with_time_guard(string_type const& string, yampi::environment const& environment)
-          : logger_{environment}, string_{string}, environment_ptr_{&environment}
+          : log_with_time_guard{string, ::ket::utility::profile_phase::none, environment}
+        { }
+
+        // The elapsed time is also added to the counter of the phase in ::ket::utility::profiler if it is enabled
+        log_with_time_guard(wchar_t const* c_str, ::ket::utility::profile_phase const phase, yampi::environment const& environment)
+          : logger_{environment}, string_{c_str}, environment_ptr_{&environment}, profile_guard_{phase}
+        { logger_.print(L"[start] " + string_, *environment_ptr_); }
+
+        log_with_time_guard(string_type const& string, ::ket::utility::profile_phase const phase, yampi::environment const& environment)
+          : logger_{environment}, string_{string}, environment_ptr_{&environment}, profile_guard_{phase}
         { logger_.print(L"[start] " + string_, *environment_ptr_); }
 
         ~log_with_time_guard()
@@ -313,12 +335,27 @@ namespace ket
         typename Allocator = std::allocator<Character> >
       class log_with_time_guard
       {
+        ::ket::utility::profile_guard profile_guard_;
+
        public:
-        log_with_time_guard(Character const*, yampi::environment const&) { }
+        log_with_time_guard(Character const*, yampi::environment const&)
+          : profile_guard_{::ket::utility::profile_phase::none}
+        { }
 
         log_with_time_guard(
           std::basic_string<Character, CharacterTraits, Allocator> const&,
           yampi::environment const&)
+          : profile_guard_{::ket::utility::profile_phase::none}
+        { }
+
+        log_with_time_guard(Character const*, ::ket::utility::profile_phase const phase, yampi::environment const&)
+          : profile_guard_{phase}
+        { }
+
+        log_with_time_guard(
+          std::basic_string<Character, CharacterTraits, Allocator> const&,
+          ::ket::utility::profile_phase const phase, yampi::environment const&)
+          : profile_guard_{phase}
         { }
 
         ~log_with_time_guard() = default;
@@ -37,6 +37,7 @@
 # include <ket/utility/integer_log2.hpp>
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/ranges.hpp>
+# include <ket/utility/profiler.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # ifndef NDEBUG
 #   include <ket/mpi/page/is_on_page.hpp>
@@ -654,7 +655,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer](
+                [parallel_policy, &buffer](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -662,7 +663,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     target_rank, communicator, environment);
@@ -673,7 +674,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer](
+                [parallel_policy, &buffer](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -681,7 +682,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     target_rank, communicator, environment);
@@ -745,7 +746,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer, &datatype](
+                [parallel_policy, &buffer, &datatype](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -753,7 +754,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     datatype, target_rank, communicator, environment);
@@ -764,7 +765,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer, &datatype](
+                [parallel_policy, &buffer, &datatype](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -772,7 +773,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     datatype, target_rank, communicator, environment);
@@ -1097,10 +1098,13 @@ namespace ket
               assert(permutated_global_operated_qubits.size() == global_operated_qubits.size());
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
 
-              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), environment};
+              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), ::ket::utility::profile_phase::interchange, environment};
 
               using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
               using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -1118,7 +1122,10 @@ namespace ket
               update_permutation(permutation, communicator, environment, swap_qubits, global_operated_qubits);
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
             }
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
@@ -1142,10 +1149,13 @@ namespace ket
               assert(permutated_global_operated_qubits.size() == global_operated_qubits.size());
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
 
-              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), environment};
+              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), ::ket::utility::profile_phase::interchange, environment};
 
               using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
               using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -1162,7 +1172,10 @@ namespace ket
               update_permutation(permutation, communicator, environment, swap_qubits, global_operated_qubits);
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
             }
 # endif // KET_USE_COLLECTIVE_COMMUNICATIONS
@@ -1225,7 +1238,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer](
+              [parallel_policy, &buffer](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1233,7 +1246,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   target_rank, communicator, environment);
@@ -1244,7 +1257,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer](
+              [parallel_policy, &buffer](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1252,7 +1265,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   target_rank, communicator, environment);
@@ -1313,7 +1326,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer, &datatype](
+              [parallel_policy, &buffer, &datatype](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1321,7 +1334,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   datatype, target_rank, communicator, environment);
@@ -1332,7 +1345,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer, &datatype](
+              [parallel_policy, &buffer, &datatype](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1340,7 +1353,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   datatype, target_rank, communicator, environment);
@@ -1653,10 +1666,13 @@ namespace ket
           -> void
           {
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
 
-            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), environment};
+            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), ::ket::utility::profile_phase::interchange, environment};
 
             using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
             using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -1674,7 +1690,10 @@ namespace ket
             update_permutation(permutation, communicator, environment, local_swap_qubits, qubits);
 
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
           }
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
@@ -1696,10 +1715,13 @@ namespace ket
           -> void
           {
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
 
-            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), environment};
+            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), ::ket::utility::profile_phase::interchange, environment};
 
             using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
             using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -1716,7 +1738,10 @@ namespace ket
             update_permutation(permutation, communicator, environment, local_swap_qubits, qubits);
 
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
           }
 # endif // KET_USE_COLLECTIVE_COMMUNICATIONS
@@ -35,6 +35,7 @@
 # include <ket/utility/integer_log2.hpp>
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/ranges.hpp>
+# include <ket/utility/profiler.hpp>
 # include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # ifndef NDEBUG
@@ -487,7 +488,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer](
+                [parallel_policy, &buffer](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -495,7 +496,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     target_rank, communicator, environment);
@@ -518,7 +519,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer](
+                [parallel_policy, &buffer](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -526,7 +527,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     target_rank, communicator, environment);
@@ -584,7 +585,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer, &datatype](
+                [parallel_policy, &buffer, &datatype](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -592,7 +593,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     datatype, target_rank, communicator, environment);
@@ -615,7 +616,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
               do_call(
                 mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-                [&buffer, &datatype](
+                [parallel_policy, &buffer, &datatype](
                   LocalState& local_state,
                   StateInteger const data_block_index, StateInteger const data_block_size,
                   StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -623,7 +624,7 @@ namespace ket
                   yampi::communicator const& communicator, yampi::environment const& environment)
                 {
                   ::ket::mpi::utility::detail::interchange_qubits(
-                    local_state, buffer,
+                    parallel_policy, local_state, buffer,
                     data_block_index, data_block_size,
                     source_local_first_index, source_local_last_index,
                     datatype, target_rank, communicator, environment);
@@ -1312,10 +1313,13 @@ namespace ket
               assert(permutated_nonlocal_operated_qubits.size() == nonlocal_operated_qubits.size());
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
 
-              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), environment};
+              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), ::ket::utility::profile_phase::interchange, environment};
 
               using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
               using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -1333,7 +1337,10 @@ namespace ket
               update_permutation(permutation, communicator, environment, swap_qubits, nonlocal_operated_qubits);
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
             }
 # else //KET_USE_COLLECTIVE_COMMUNICATIONS
@@ -1357,10 +1364,13 @@ namespace ket
               assert(permutated_nonlocal_operated_qubits.size() == nonlocal_operated_qubits.size());
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
 
-              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), environment};
+              ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits"}), ::ket::utility::profile_phase::interchange, environment};
 
               using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
               using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -1377,7 +1387,10 @@ namespace ket
               update_permutation(permutation, communicator, environment, swap_qubits, nonlocal_operated_qubits);
 
 #   ifdef KET_USE_BARRIER
-              ::yampi::barrier(communicator, environment);
+              {
+                ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+                ::yampi::barrier(communicator, environment);
+              }
 #   endif // KET_USE_BARRIER
             }
 # endif //KET_USE_COLLECTIVE_COMMUNICATIONS
@@ -1440,7 +1453,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer](
+              [parallel_policy, &buffer](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1448,7 +1461,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   target_rank, communicator, environment);
@@ -1471,7 +1484,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer](
+              [parallel_policy, &buffer](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1479,7 +1492,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   target_rank, communicator, environment);
@@ -1536,7 +1549,7 @@ namespace ket
 # ifdef KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer, &datatype](
+              [parallel_policy, &buffer, &datatype](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1544,7 +1557,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   datatype, target_rank, communicator, environment);
@@ -1567,7 +1580,7 @@ namespace ket
 # else // KET_USE_COLLECTIVE_COMMUNICATIONS
             do_call(
               mpi_policy, parallel_policy, local_state, permutation, communicator, environment,
-              [&buffer, &datatype](
+              [parallel_policy, &buffer, &datatype](
                 LocalState& local_state,
                 StateInteger const data_block_index, StateInteger const data_block_size,
                 StateInteger const source_local_first_index, StateInteger const source_local_last_index,
@@ -1575,7 +1588,7 @@ namespace ket
                 yampi::communicator const& communicator, yampi::environment const& environment)
               {
                 ::ket::mpi::utility::detail::interchange_qubits(
-                  local_state, buffer,
+                  parallel_policy, local_state, buffer,
                   data_block_index, data_block_size,
                   source_local_first_index, source_local_last_index,
                   datatype, target_rank, communicator, environment);
@@ -2261,10 +2274,13 @@ namespace ket
           -> void
           {
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
 
-            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), environment};
+            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), ::ket::utility::profile_phase::interchange, environment};
 
             using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
             using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -2282,7 +2298,10 @@ namespace ket
             update_permutation(permutation, communicator, environment, local_swap_qubits, qubits);
 
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
           }
 # else //KET_USE_COLLECTIVE_COMMUNICATIONS
@@ -2303,10 +2322,13 @@ namespace ket
           -> void
           {
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
 
-            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), environment};
+            ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"interchange_qubits<"}, num_qubits_of_operation, '>'), ::ket::utility::profile_phase::interchange, environment};
 
             using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
             using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
@@ -2323,7 +2345,10 @@ namespace ket
             update_permutation(permutation, communicator, environment, local_swap_qubits, qubits);
 
 #   ifdef KET_USE_BARRIER
-            ::yampi::barrier(communicator, environment);
+            {
+              ::ket::utility::profile_guard profile_guard{::ket::utility::profile_phase::barrier};
+              ::yampi::barrier(communicator, environment);
+            }
 #   endif // KET_USE_BARRIER
           }
 # endif //KET_USE_COLLECTIVE_COMMUNICATIONS
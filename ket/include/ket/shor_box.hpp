@@ -1,14 +1,18 @@
 #ifndef KET_SHOR_BOX_HPP
 # define KET_SHOR_BOX_HPP
 
+# include <cassert>
+# include <cstddef>
 # include <cmath>
-//# include <vector>
+# include <vector>
 # include <iterator>
+# include <algorithm>
 # include <type_traits>
 
 # include <ket/qubit.hpp>
 # include <ket/meta/state_integer_of.hpp>
 # include <ket/meta/bit_integer_of.hpp>
+# include <ket/utility/loop_n.hpp>
 # include <ket/utility/integer_exp2.hpp>
 # include <ket/utility/meta/real_of.hpp>
 # include <ket/utility/meta/ranges.hpp>
@@ -61,6 +65,86 @@ namespace ket
         ::ket::shor_box_detail::make_filtered_integer(exponent, exponent_qubits)
         bitor ::ket::shor_box_detail::make_filtered_integer(modular_exponentiation_value, modular_exponentiation_qubits);
     }
+
+    // modular_squares[k] = base^(2^k) mod divisor
+    template <typename StateInteger, typename BitInteger>
+    inline auto make_modular_squares(StateInteger const base, StateInteger const divisor, BitInteger const num_exponent_qubits)
+    -> std::vector<StateInteger>
+    {
+      assert(divisor > StateInteger{0u});
+
+      auto result = std::vector<StateInteger>{};
+      result.reserve(num_exponent_qubits);
+      if (num_exponent_qubits == BitInteger{0u})
+        return result;
+
+      result.push_back(base % divisor);
+      for (auto bit = BitInteger{1u}; bit < num_exponent_qubits; ++bit)
+        result.push_back((result.back() * result.back()) % divisor);
+
+      return result;
+    }
+
+    // Calls function(exponent, base^exponent mod divisor) for each exponent whose bits are fixed_exponent outside free_exponent_mask.
+    // Free bits are split into "table bits", whose partial products are tabulated once, and "block bits", one loop_n count per pattern,
+    // so that each call costs a single modular multiplication like the serial recurrence while different counts are independent.
+    // function is called concurrently for different exponents if parallel_policy is parallel
+    template <typename ParallelPolicy, typename StateInteger, typename Function>
+    inline auto for_each_modular_exponentiation(
+      ParallelPolicy const parallel_policy,
+      std::vector<StateInteger> const& modular_squares, StateInteger const divisor,
+      StateInteger const fixed_exponent, StateInteger const free_exponent_mask, Function&& function)
+    -> void
+    {
+      assert((fixed_exponent bitand free_exponent_mask) == StateInteger{0u});
+
+      auto free_bits = std::vector<unsigned int>{};
+      auto fixed_value = StateInteger{1u};
+      for (auto bit = 0u; bit < static_cast<unsigned int>(modular_squares.size()); ++bit)
+        if (((free_exponent_mask >> bit) bitand StateInteger{1u}) == StateInteger{1u})
+          free_bits.push_back(bit);
+        else if (((fixed_exponent >> bit) bitand StateInteger{1u}) == StateInteger{1u})
+          fixed_value = (fixed_value * modular_squares[bit]) % divisor;
+
+      constexpr auto max_num_table_bits = 10u;
+      auto const num_free_bits = static_cast<unsigned int>(free_bits.size());
+      auto const num_table_bits = std::min(max_num_table_bits, num_free_bits / 2u);
+      auto const table_size = ::ket::utility::integer_exp2<std::size_t>(num_table_bits);
+
+      auto table_exponents = std::vector<StateInteger>(table_size);
+      auto table_values = std::vector<StateInteger>(table_size);
+      table_exponents.front() = StateInteger{0u};
+      table_values.front() = StateInteger{1u};
+      for (auto table_bit = 0u; table_bit < num_table_bits; ++table_bit)
+      {
+        auto const num_filled = ::ket::utility::integer_exp2<std::size_t>(table_bit);
+        for (auto index = std::size_t{0u}; index < num_filled; ++index)
+        {
+          table_exponents[num_filled + index] = table_exponents[index] bitor (StateInteger{1u} << free_bits[table_bit]);
+          table_values[num_filled + index] = (table_values[index] * modular_squares[free_bits[table_bit]]) % divisor;
+        }
+      }
+
+      ::ket::utility::loop_n(
+        parallel_policy, ::ket::utility::integer_exp2<StateInteger>(num_free_bits - num_table_bits),
+        [&modular_squares, divisor, fixed_exponent, fixed_value, &free_bits, num_free_bits, num_table_bits,
+         &table_exponents, &table_values, &function](
+          StateInteger const block_index, int const)
+        {
+          auto block_exponent = fixed_exponent;
+          auto block_value = fixed_value;
+          for (auto block_bit = num_table_bits; block_bit < num_free_bits; ++block_bit)
+            if (((block_index >> (block_bit - num_table_bits)) bitand StateInteger{1u}) == StateInteger{1u})
+            {
+              block_exponent |= StateInteger{1u} << free_bits[block_bit];
+              block_value = (block_value * modular_squares[free_bits[block_bit]]) % divisor;
+            }
+
+          auto const table_size = table_values.size();
+          for (auto index = std::size_t{0u}; index < table_size; ++index)
+            function(block_exponent bitor table_exponents[index], (block_value * table_values[index]) % divisor);
+        });
+    }
   } // namespace shor_box_detail
 
 
@@ -90,86 +174,22 @@ namespace ket
     using std::end;
     auto const num_exponent_qubits = static_cast<bit_integer_type>(std::distance(begin(exponent_qubits), end(exponent_qubits)));
     auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-    auto modular_exponentiation_value = StateInteger{1u};
 
     using std::pow;
     auto const constant_coefficient = complex_type{pow(static_cast<real_type>(num_exponents), real_type{-0.5})};
 
-    for (auto exponent = StateInteger{0u}; exponent < num_exponents; ++exponent)
-    {
-      auto const index
-        = ::ket::shor_box_detail::calculate_index(
-            ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
-            modular_exponentiation_value, modular_exponentiation_qubits);
-
-      *(first + index) = constant_coefficient;
-
-      modular_exponentiation_value *= base;
-      modular_exponentiation_value %= divisor;
-    }
-
-
-    /*
-    // preliminary implement of parallel shor box
-    using std::begin;
-    using std::end;
-    auto const num_exponent_qubits = static_cast<bit_integer_type>(std::distance(begin(exponent_qubits), end(exponent_qubits)));
-    auto const num_modular_exponentiation_qubits
-      = static_cast<bit_integer_type>(std::distance(begin(modular_exponentiation_qubits), end(modular_exponentiation_qubits)));
-
-    using qubit_type = ::ket::utility::meta::range_value_t<Qubits>;
-
-    static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
-    static_assert(
-      std::is_unsigned< ::ket::meta::bit_integer_t<qubit_type> >::value,
-      "BitInteger should be unsigned");
-
-    auto modular_squares = std::vector<StateInteger>{};
-    modular_squares.reserve(num_exponent_qubits);
-    modular_squares.push_back(base);
-    ::ket::utility::loop_n(
-      ::ket::utility::policy::make_sequential(), num_exponent_qubits - decltype(num_exponent_qubits){1u},
-      [&modular_squares, divisor](decltype(num_exponent_qubits) const, int const)
-      { modular_squares.push_back((modular_squares.back() * modular_squares.back()) % divisor); });
-
-    auto modular_exponentiation_values = std::vector<StateInteger>{};
-    modular_exponentiation_values.reserve(::ket::utility::num_threads());
-
-    ::ket::utility::loop_n(
-      parallel_policy, static_cast<StateInteger>(std::distance(begin(state), end(state))),
-      [first](StateInteger const index, int const)
-      { *(first + index) = complex_type{real_type{0}}; });
-
-    using std::pow;
-    auto const constant_coefficient = complex_type{pow(num_exponents, -0.5)};
-    auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-    auto modular_exponentiation_value = StateInteger{1u};
-    auto const num_threads = ::ket::utility::num_threads();
-    ::ket::utility::loop_n(
-      parallel_policy, num_exponents,
-      [](StateInteger const exponent, int const thread_index)
+    ::ket::shor_box_detail::for_each_modular_exponentiation(
+      parallel_policy,
+      ::ket::shor_box_detail::make_modular_squares(base, divisor, num_exponent_qubits), divisor,
+      StateInteger{0u}, num_exponents - StateInteger{1u},
+      [first, num_exponent_qubits, constant_coefficient, &exponent_qubits, &modular_exponentiation_qubits](
+        StateInteger const exponent, StateInteger const modular_exponentiation_value)
       {
-        a
+        *(first + ::ket::shor_box_detail::calculate_index(
+           ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
+           modular_exponentiation_value, modular_exponentiation_qubits))
+          = constant_coefficient;
       });
-
-
-    using std::pow;
-    auto const constant_coefficient = complex_type{pow(num_exponents, -0.5)};
-    auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-    auto modular_exponentiation_value = StateInteger{1u};
-    for (auto exponent = StateInteger{0u}; exponent < num_exponents; ++exponent)
-    {
-      auto const index
-        = ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits)
-          bitor (modular_exponentiation_value << num_exponent_qubits);
-
-      *(first + convert(index, exponent_qubits, modular_exponentiation_qubits))
-        = constant_coefficient;
-
-      modular_exponentiation_value *= base;
-      modular_exponentiation_value %= divisor;
-    }
-    */
   }
 
   template <typename RandomAccessIterator, typename StateInteger, typename Qubits>
@@ -3,6 +3,7 @@
 
 # include <cstddef>
 # include <vector>
+# include <iterator>
 # include <type_traits>
 
 # include <ket/qubit.hpp>
@@ -21,9 +22,9 @@ namespace ket
   inline void subtraction_assignment(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
-    Qubits const& lhs_qubits, Qubits const& rhs_qubits_range,
+    Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   { ::ket::adj_addition_assignment(parallel_policy, first, last, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
@@ -35,7 +36,7 @@ namespace ket
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   { ::ket::adj_addition_assignment(first, last, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
@@ -46,7 +47,7 @@ namespace ket
   subtraction_assignment(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
-    Qubits const& lhs_qubits, Qubits const& rhs_qubits_range)
+    Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
   { ::ket::adj_addition_assignment(parallel_policy, first, last, lhs_qubits, rhs_qubits_range); }
 
   template <typename RandomAccessIterator, typename Qubits, typename QubitsRange>
@@ -64,11 +65,11 @@ namespace ket
       typename PhaseCoefficientsAllocator>
     inline RandomAccessRange& subtraction_assignment(
       ParallelPolicy const parallel_policy, RandomAccessRange& state,
-      Qubits const& lhs_qubits, Qubits const& rhs_qubits_range,
+      Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
       std::vector<
         ::ket::utility::meta::range_value_t<RandomAccessRange>,
         PhaseCoefficientsAllocator>& phase_coefficients)
-    { return ::ket::adj_addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
+    { return ::ket::ranges::adj_addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
     template <
       typename RandomAccessRange, typename Qubits, typename QubitsRange,
@@ -82,7 +83,7 @@ namespace ket
       std::vector<
         ::ket::utility::meta::range_value_t<RandomAccessRange>,
         PhaseCoefficientsAllocator>& phase_coefficients)
-    { return ::ket::adj_addition_assignment(state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
+    { return ::ket::ranges::adj_addition_assignment(state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
     template <
       typename ParallelPolicy,
@@ -92,15 +93,15 @@ namespace ket
       RandomAccessRange&>
     subtraction_assignment(
       ParallelPolicy const parallel_policy, RandomAccessRange& state,
-      Qubits const& lhs_qubits, Qubits const& rhs_qubits_range)
-    { return ::ket::adj_addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range); }
+      Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
+    { return ::ket::ranges::adj_addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range); }
 
     template <
       typename RandomAccessRange, typename Qubits, typename QubitsRange>
     inline RandomAccessRange& subtraction_assignment(
       RandomAccessRange& state,
       Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
-    { return ::ket::adj_addition_assignment(state, lhs_qubits, rhs_qubits_range); }
+    { return ::ket::ranges::adj_addition_assignment(state, lhs_qubits, rhs_qubits_range); }
   } // namespace ranges
 
 
@@ -111,9 +112,9 @@ namespace ket
   inline void adj_subtraction_assignment(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
-    Qubits const& lhs_qubits, Qubits const& rhs_qubits_range,
+    Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   { ::ket::addition_assignment(parallel_policy, first, last, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
@@ -125,7 +126,7 @@ namespace ket
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   { ::ket::addition_assignment(first, last, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
@@ -136,7 +137,7 @@ namespace ket
   adj_subtraction_assignment(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
-    Qubits const& lhs_qubits, Qubits const& rhs_qubits_range)
+    Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
   { ::ket::addition_assignment(parallel_policy, first, last, lhs_qubits, rhs_qubits_range); }
 
   template <typename RandomAccessIterator, typename Qubits, typename QubitsRange>
@@ -154,11 +155,11 @@ namespace ket
       typename PhaseCoefficientsAllocator>
     inline RandomAccessRange& adj_subtraction_assignment(
       ParallelPolicy const parallel_policy, RandomAccessRange& state,
-      Qubits const& lhs_qubits, Qubits const& rhs_qubits_range,
+      Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
       std::vector<
         ::ket::utility::meta::range_value_t<RandomAccessRange>,
         PhaseCoefficientsAllocator>& phase_coefficients)
-    { return ::ket::addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
+    { return ::ket::ranges::addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
     template <
       typename RandomAccessRange, typename Qubits, typename QubitsRange,
@@ -172,7 +173,7 @@ namespace ket
       std::vector<
         ::ket::utility::meta::range_value_t<RandomAccessRange>,
         PhaseCoefficientsAllocator>& phase_coefficients)
-    { return ::ket::addition_assignment(state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
+    { return ::ket::ranges::addition_assignment(state, lhs_qubits, rhs_qubits_range, phase_coefficients); }
 
     template <
       typename ParallelPolicy,
@@ -182,15 +183,15 @@ namespace ket
       RandomAccessRange&>
     adj_subtraction_assignment(
       ParallelPolicy const parallel_policy, RandomAccessRange& state,
-      Qubits const& lhs_qubits, Qubits const& rhs_qubits_range)
-    { return ::ket::addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range); }
+      Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
+    { return ::ket::ranges::addition_assignment(parallel_policy, state, lhs_qubits, rhs_qubits_range); }
 
     template <
       typename RandomAccessRange, typename Qubits, typename QubitsRange>
     inline RandomAccessRange& adj_subtraction_assignment(
       RandomAccessRange& state,
       Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
-    { return ::ket::addition_assignment(state, lhs_qubits, rhs_qubits_range); }
+    { return ::ket::ranges::addition_assignment(state, lhs_qubits, rhs_qubits_range); }
   } // namespace ranges
 } // namespace ket
 
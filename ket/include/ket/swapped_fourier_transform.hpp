@@ -4,33 +4,270 @@
 # include <cassert>
 # include <cstddef>
 # include <cmath>
+# include <complex>
+# include <vector>
 # include <iterator>
+# include <algorithm>
+# include <utility>
 # include <type_traits>
 
-# include <ket/control.hpp>
-# include <ket/gate/hadamard.hpp>
-# include <ket/gate/controlled_phase_shift.hpp>
+# include <boost/math/constants/constants.hpp>
+
 # include <ket/meta/state_integer_of.hpp>
 # include <ket/meta/bit_integer_of.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/exp_i.hpp>
 # include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/num_on_cache_qubits.hpp>
 # ifndef NDEBUG
 #   include <ket/utility/is_unique_if_sorted.hpp>
 # endif
 # include <ket/utility/generate_phase_coefficients.hpp>
+# include <ket/utility/meta/real_of.hpp>
 # include <ket/utility/meta/ranges.hpp>
 
 
 namespace ket
 {
+  // The swapped Fourier transform is the circuit of H and controlled phase shifts without the final swaps, which is equivalent to
+  // n butterfly passes of the decimation-in-frequency FFT. The pass for the t-th qubit of the register is
+  //   (a, b) => ((a + b)/sqrt(2), (a - b)/sqrt(2) * exp(2 pi i l / 2^(t+1))),
+  // where a and b are amplitudes whose t-th qubits are 0 and 1, and l is the value of the lower qubits 0, ..., t-1 of the register.
+  // Passes on qubits lower than ::ket::utility::num_on_cache_qubits() are done block by block, and other passes are paired into radix-4 sweeps
+  namespace swapped_fourier_transform_detail
+  {
+    // twiddle_factors(m) = exp(2 pi i m / 2^n) for 0 <= m < 2^(n-1), which is the product of two table entries
+    template <typename Complex, typename StateInteger>
+    class twiddle_factors
+    {
+      unsigned int num_lower_bits_;
+      StateInteger lower_mask_;
+      std::vector<Complex> lower_factors_;
+      std::vector<Complex> upper_factors_;
+
+     public:
+      explicit twiddle_factors(unsigned int const num_register_qubits)
+        : num_lower_bits_{num_register_qubits > 0u ? (num_register_qubits - 1u) / 2u : 0u},
+          lower_mask_{(StateInteger{1u} << num_lower_bits_) - StateInteger{1u}},
+          lower_factors_(::ket::utility::integer_exp2<std::size_t>(num_lower_bits_)),
+          upper_factors_(::ket::utility::integer_exp2<std::size_t>(num_register_qubits > 0u ? num_register_qubits - 1u - num_lower_bits_ : 0u))
+      {
+        using real_type = ::ket::utility::meta::real_t<Complex>;
+        using boost::math::constants::two_pi;
+        auto const unit_phase = two_pi<real_type>() / static_cast<real_type>(::ket::utility::integer_exp2<StateInteger>(num_register_qubits));
+
+        for (auto index = std::size_t{0u}; index < lower_factors_.size(); ++index)
+          lower_factors_[index] = ::ket::utility::exp_i<Complex>(unit_phase * static_cast<real_type>(index));
+        for (auto index = std::size_t{0u}; index < upper_factors_.size(); ++index)
+          upper_factors_[index]
+            = ::ket::utility::exp_i<Complex>(unit_phase * static_cast<real_type>(::ket::utility::integer_exp2<StateInteger>(num_lower_bits_) * index));
+      }
+
+      auto operator()(StateInteger const exponent) const -> Complex
+      { return upper_factors_[exponent >> num_lower_bits_] * lower_factors_[exponent bitand lower_mask_]; }
+    }; // class twiddle_factors<Complex, StateInteger>
+
+    template <typename StateInteger, typename BitInteger>
+    inline auto insert_zero_bit(StateInteger const value, BitInteger const bit) -> StateInteger
+    {
+      auto const lower_mask = (StateInteger{1u} << bit) - StateInteger{1u};
+      return ((value bitand compl lower_mask) << 1u) bitor (value bitand lower_mask);
+    }
+
+    // Positions of the register qubits in the state, and the value of the register qubits lower than each qubit
+    template <typename StateInteger, typename BitInteger>
+    class register_layout
+    {
+      std::vector<BitInteger> bits_;
+      bool is_contiguous_;
+
+     public:
+      template <typename Qubits>
+      explicit register_layout(Qubits const& qubits)
+        : bits_{}, is_contiguous_{true}
+      {
+        for (auto const& qubit: qubits)
+          bits_.push_back(static_cast<BitInteger>(qubit));
+
+        for (auto index = std::size_t{1u}; index < bits_.size(); ++index)
+          if (bits_[index] != bits_.front() + static_cast<BitInteger>(index))
+          {
+            is_contiguous_ = false;
+            break;
+          }
+      }
+
+      auto size() const noexcept -> BitInteger { return static_cast<BitInteger>(bits_.size()); }
+      auto bit(BitInteger const register_bit) const -> BitInteger { return bits_[register_bit]; }
+
+      auto lower_value(StateInteger const index, BitInteger const register_bit) const -> StateInteger
+      {
+        if (is_contiguous_)
+          return (index >> bits_.front()) bitand ((StateInteger{1u} << register_bit) - StateInteger{1u});
+
+        auto result = StateInteger{0u};
+        for (auto lower_bit = BitInteger{0u}; lower_bit < register_bit; ++lower_bit)
+          result |= ((index >> bits_[lower_bit]) bitand StateInteger{1u}) << lower_bit;
+        return result;
+      }
+    }; // class register_layout<StateInteger, BitInteger>
+
+    // Applies the pass (or its adjoint) for register_bit to the pair of amplitudes, where index is the index of zero_iter
+    template <typename Iterator, typename StateInteger, typename BitInteger, typename Complex>
+    inline auto butterfly(
+      Iterator const zero_iter, Iterator const one_iter, StateInteger const index, BitInteger const register_bit, bool const is_adjoint,
+      ::ket::swapped_fourier_transform_detail::register_layout<StateInteger, BitInteger> const& layout,
+      ::ket::swapped_fourier_transform_detail::twiddle_factors<Complex, StateInteger> const& twiddles)
+    -> void
+    {
+      using real_type = ::ket::utility::meta::real_t<Complex>;
+      using boost::math::constants::one_div_root_two;
+      auto const twiddle = twiddles(layout.lower_value(index, register_bit) << (layout.size() - BitInteger{1u} - register_bit));
+
+      auto const zero_value = *zero_iter;
+      if (is_adjoint)
+      {
+        auto const one_value = *one_iter * std::conj(twiddle);
+        *zero_iter = (zero_value + one_value) * one_div_root_two<real_type>();
+        *one_iter = (zero_value - one_value) * one_div_root_two<real_type>();
+        return;
+      }
+
+      auto const one_value = *one_iter;
+      *zero_iter = (zero_value + one_value) * one_div_root_two<real_type>();
+      *one_iter = (zero_value - one_value) * (one_div_root_two<real_type>() * twiddle);
+    }
+
+    // passes are applied from front to back: register bits n-1, ..., 0 for the transform, and 0, ..., n-1 for its adjoint
+    template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger, typename BitInteger>
+    inline auto fourier_transform(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      ::ket::swapped_fourier_transform_detail::register_layout<StateInteger, BitInteger> const& layout,
+      bool const is_adjoint)
+    -> void
+    {
+      using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+      auto const num_register_qubits = layout.size();
+      if (num_register_qubits == BitInteger{0u})
+        return;
+
+      auto const twiddles = ::ket::swapped_fourier_transform_detail::twiddle_factors<complex_type, StateInteger>{num_register_qubits};
+      auto passes = std::vector<BitInteger>(num_register_qubits);
+      for (auto index = BitInteger{0u}; index < num_register_qubits; ++index)
+        passes[index] = is_adjoint ? index : num_register_qubits - BitInteger{1u} - index;
+
+      // Blocks should not be too large to keep all threads busy
+      auto const state_size = static_cast<StateInteger>(std::distance(first, last));
+      auto const num_state_qubits = ::ket::utility::integer_log2<BitInteger>(state_size);
+      auto const num_threads = static_cast<StateInteger>(::ket::utility::num_threads(parallel_policy));
+      auto const num_thread_qubits = ::ket::utility::integer_log2<BitInteger>(num_threads) + (num_threads bitand (num_threads - StateInteger{1u}) ? 1u : 0u);
+      auto const num_block_qubits
+        = static_cast<BitInteger>(std::min<std::size_t>(
+            ::ket::utility::num_on_cache_qubits<std::size_t>(), num_state_qubits > num_thread_qubits ? num_state_qubits - num_thread_qubits : 0u));
+
+      auto pass_iter = passes.begin();
+      while (pass_iter != passes.end())
+      {
+        if (layout.bit(*pass_iter) < num_block_qubits)
+        {
+          auto const block_passes_first = pass_iter;
+          while (pass_iter != passes.end() and layout.bit(*pass_iter) < num_block_qubits)
+            ++pass_iter;
+          auto const block_passes_last = pass_iter;
+
+          auto const block_size = ::ket::utility::integer_exp2<StateInteger>(num_block_qubits);
+          ::ket::utility::loop_n(
+            parallel_policy, state_size >> num_block_qubits,
+            ::ket::utility::make_independent_loop_function(
+              [first, block_size, block_passes_first, block_passes_last, is_adjoint, &layout, &twiddles](
+                StateInteger const block_index, int const)
+              {
+                auto const block_first_index = block_index * block_size;
+                for (auto block_pass_iter = block_passes_first; block_pass_iter != block_passes_last; ++block_pass_iter)
+                {
+                  auto const register_bit = *block_pass_iter;
+                  auto const one_mask = StateInteger{1u} << layout.bit(register_bit);
+                  for (auto count = StateInteger{0u}; count < block_size / StateInteger{2u}; ++count)
+                  {
+                    auto const zero_index = block_first_index bitor ::ket::swapped_fourier_transform_detail::insert_zero_bit(count, layout.bit(register_bit));
+                    ::ket::swapped_fourier_transform_detail::butterfly(
+                      first + zero_index, first + (zero_index bitor one_mask), zero_index, register_bit, is_adjoint, layout, twiddles);
+                  }
+                }
+              }));
+          continue;
+        }
+
+        auto const register_bit = *pass_iter++;
+        auto const one_mask = StateInteger{1u} << layout.bit(register_bit);
+        if (pass_iter == passes.end() or layout.bit(*pass_iter) < num_block_qubits)
+        {
+          ::ket::utility::loop_n(
+            parallel_policy, state_size / StateInteger{2u},
+            ::ket::utility::make_independent_loop_function(
+              [first, register_bit, one_mask, is_adjoint, &layout, &twiddles](StateInteger const count, int const)
+              {
+                auto const zero_index = ::ket::swapped_fourier_transform_detail::insert_zero_bit(count, layout.bit(register_bit));
+                ::ket::swapped_fourier_transform_detail::butterfly(
+                  first + zero_index, first + (zero_index bitor one_mask), zero_index, register_bit, is_adjoint, layout, twiddles);
+              }));
+          continue;
+        }
+
+        // radix-4: two consecutive passes are applied to each quadruple of amplitudes in one sweep
+        auto const next_register_bit = *pass_iter++;
+        auto const next_one_mask = StateInteger{1u} << layout.bit(next_register_bit);
+        auto const minmax_bits = std::minmax<BitInteger>({layout.bit(register_bit), layout.bit(next_register_bit)});
+        ::ket::utility::loop_n(
+          parallel_policy, state_size / StateInteger{4u},
+          ::ket::utility::make_independent_loop_function(
+            [first, register_bit, one_mask, next_register_bit, next_one_mask, minmax_bits, is_adjoint, &layout, &twiddles](
+              StateInteger const count, int const)
+            {
+              auto const index
+                = ::ket::swapped_fourier_transform_detail::insert_zero_bit(
+                    ::ket::swapped_fourier_transform_detail::insert_zero_bit(count, minmax_bits.first), minmax_bits.second);
+              ::ket::swapped_fourier_transform_detail::butterfly(
+                first + index, first + (index bitor one_mask), index, register_bit, is_adjoint, layout, twiddles);
+              ::ket::swapped_fourier_transform_detail::butterfly(
+                first + (index bitor next_one_mask), first + (index bitor next_one_mask bitor one_mask),
+                index bitor next_one_mask, register_bit, is_adjoint, layout, twiddles);
+              ::ket::swapped_fourier_transform_detail::butterfly(
+                first + index, first + (index bitor next_one_mask), index, next_register_bit, is_adjoint, layout, twiddles);
+              ::ket::swapped_fourier_transform_detail::butterfly(
+                first + (index bitor one_mask), first + (index bitor one_mask bitor next_one_mask),
+                index bitor one_mask, next_register_bit, is_adjoint, layout, twiddles);
+            }));
+      }
+    }
+
+    template <typename ParallelPolicy, typename RandomAccessIterator, typename Qubits>
+    inline auto fourier_transform(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Qubits const& qubits, bool const is_adjoint)
+    -> void
+    {
+      using qubit_type = ::ket::utility::meta::range_value_t<Qubits>;
+      ::ket::swapped_fourier_transform_detail::fourier_transform(
+        parallel_policy, first, last,
+        ::ket::swapped_fourier_transform_detail::register_layout<
+          ::ket::meta::state_integer_t<qubit_type>, ::ket::meta::bit_integer_t<qubit_type> >{qubits},
+        is_adjoint);
+    }
+  } // namespace swapped_fourier_transform_detail
+
   template <
     typename ParallelPolicy, typename RandomAccessIterator, typename Qubits,
-    typename PhaseCoefficientsAllocator>>
+    typename PhaseCoefficientsAllocator>
   inline void swapped_fourier_transform(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& qubits,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   {
     using std::begin;
@@ -48,40 +285,24 @@ namespace ket
     static_assert(std::is_unsigned<bit_integer_type>::value, "BitInteger should be unsigned");
     assert(
       ::ket::utility::integer_exp2< ::ket::meta::state_integer_t<qubit_type> >(num_qubits)
-        <= static_cast< ::ket::meta::state_integer_t<qubit_type> >(std::distance(begin(state), end(state)))
+        <= static_cast< ::ket::meta::state_integer_t<qubit_type> >(std::distance(first, last))
       and ::ket::utility::ranges::is_unique_if_sorted(qubits));
 
-    for (auto index = std::size_t{0u}; index < num_qubits; ++index)
-    {
-      auto target_bit = num_qubits - index - std::size_t{1u};
-
-      ::ket::gate::hadamard(parallel_policy, first, last, qubits_first[target_bit]);
-
-      for (auto phase_exponent = std::size_t{2u};
-           phase_exponent <= num_qubits - index; ++phase_exponent)
-      {
-        auto const control_bit = target_bit - (phase_exponent - std::size_t{1u});
-
-        ::ket::gate::controlled_phase_shift(
-          parallel_policy,
-          first, last, phase_coefficients[phase_exponent],
-          qubits_first[target_bit], ::ket::make_control(qubits_first[control_bit]));
-      }
-    }
+    ::ket::swapped_fourier_transform_detail::fourier_transform(parallel_policy, first, last, qubits, false);
   }
 
   template <typename RandomAccessIterator, typename Qubits, typename PhaseCoefficientsAllocator>
-  inline std::enable_if_t<not ::ket::utility::policy::is_loop_n_policy<RandomAccessIterator>::value, void>
+  inline std::enable_if_t<not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessIterator>::value, void>
   swapped_fourier_transform(
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& qubits,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   { ::ket::swapped_fourier_transform(::ket::utility::policy::make_sequential(), first, last, qubits, phase_coefficients); }
 
   template <typename ParallelPolicy, typename RandomAccessIterator, typename Qubits>
-  inline std::enable_if_t< ::ket::utility::policy::is_loop_n_policy<ParallelPolicy>::value, void >
+  inline std::enable_if_t< ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, void >
   swapped_fourier_transform(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
@@ -89,14 +310,16 @@ namespace ket
   {
     using std::begin;
     using std::end;
-    using complex_type = std::iterator_traits<RandomAccessIterator>::value_type;
+    using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    using bit_integer_type = ::ket::meta::bit_integer_t< ::ket::utility::meta::range_value_t<Qubits> >;
     auto phase_coefficients
-      = ::ket::utility::generate_phase_coefficients<complex_type>(std::distance(begin(lhs_qubits), end(lhs_qubits)));
+      = ::ket::utility::generate_phase_coefficients<complex_type>(
+          static_cast<bit_integer_type>(std::distance(begin(qubits), end(qubits))));
 
     ::ket::swapped_fourier_transform(parallel_policy, first, last, qubits, phase_coefficients);
   }
 
-  template <typename ParallelPolicy, typename RandomAccessIterator, typename Qubits>
+  template <typename RandomAccessIterator, typename Qubits>
   inline void swapped_fourier_transform(
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& qubits)
@@ -123,7 +346,7 @@ namespace ket
 
     template <typename RandomAccessRange, typename Qubits, typename PhaseCoefficientsAllocator>
     inline std::enable_if_t<
-      not ::ket::utility::policy::is_loop_n_policy<RandomAccessRange>::value, RandomAccessRange&>
+      not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value, RandomAccessRange&>
     swapped_fourier_transform(
       RandomAccessRange& state, Qubits const& qubits,
       std::vector<
@@ -138,7 +361,7 @@ namespace ket
 
     template <typename ParallelPolicy, typename RandomAccessRange, typename Qubits>
     inline std::enable_if_t<
-      ::ket::utility::policy::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange&>
+      ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange&>
     swapped_fourier_transform(ParallelPolicy const parallel_policy, RandomAccessRange& state, Qubits const& qubits)
     {
       using std::begin;
@@ -147,7 +370,7 @@ namespace ket
       return state;
     }
 
-    template <typename RandomAccessRange, typename Qubits, typename PhaseCoefficientsAllocator>
+    template <typename RandomAccessRange, typename Qubits>
     inline RandomAccessRange& swapped_fourier_transform(RandomAccessRange& state, Qubits const& qubits)
     {
       using std::begin;
@@ -160,13 +383,13 @@ namespace ket
 
   template <
     typename ParallelPolicy, typename RandomAccessIterator, typename Qubits,
-    typename PhaseCoefficientsAllocator>>
+    typename PhaseCoefficientsAllocator>
   inline void adj_swapped_fourier_transform(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& qubits,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   {
     using std::begin;
@@ -184,38 +407,24 @@ namespace ket
     static_assert(std::is_unsigned<bit_integer_type>::value, "BitInteger should be unsigned");
     assert(
       ::ket::utility::integer_exp2< ::ket::meta::state_integer_t<qubit_type> >(num_qubits)
-        <= static_cast< ::ket::meta::state_integer_t<qubit_type> >(std::distance(begin(state), end(state)))
+        <= static_cast< ::ket::meta::state_integer_t<qubit_type> >(std::distance(first, last))
       and ::ket::utility::ranges::is_unique_if_sorted(qubits));
 
-    for (auto target_bit = std::size_t{0u}; target_bit < num_qubits; ++target_bit)
-    {
-      for (auto index = std::size_t{0u}; index < target_bit; ++index)
-      {
-        auto const phase_exponent = std::size_t{1u} + target_bit - index;
-        auto const control_bit = target_bit - (phase_exponent - std::size_t{1u});
-
-        ::ket::gate::adj_controlled_phase_shift(
-          parallel_policy,
-          first, last, phase_coefficients[phase_exponent], qubits_first[target_bit],
-          ::ket::make_control(qubits_first[control_bit]));
-      }
-
-      ::ket::gate::adj_hadamard(parallel_policy, first, last, qubits_first[target_bit]);
-    }
+    ::ket::swapped_fourier_transform_detail::fourier_transform(parallel_policy, first, last, qubits, true);
   }
 
   template <typename RandomAccessIterator, typename Qubits, typename PhaseCoefficientsAllocator>
-  inline std::enable_if_t<not ::ket::utility::policy::is_loop_n_policy<RandomAccessIterator>::value, void>
+  inline std::enable_if_t<not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessIterator>::value, void>
   adj_swapped_fourier_transform(
     RandomAccessIterator const first, RandomAccessIterator const last, Qubits const& qubits,
     std::vector<
-      ::ket::utility::meta::range_value_t<RandomAccessRange>,
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   { ::ket::adj_swapped_fourier_transform(::ket::utility::policy::make_sequential(), first, last, qubits, phase_coefficients); }
 
   template <
     typename ParallelPolicy, typename RandomAccessIterator, typename Qubits>
-  inline std::enable_if_t< ::ket::utility::policy::is_loop_n_policy<ParallelPolicy>::value, void >
+  inline std::enable_if_t< ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, void >
   adj_swapped_fourier_transform(
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last, Qubits const& qubits)
@@ -223,7 +432,7 @@ namespace ket
     using std::begin;
     using std::end;
     using bit_integer_type = ::ket::meta::bit_integer_t< ::ket::utility::meta::range_value_t<Qubits> >;
-    using complex_type = std::iterator_traits<RandomAccessIterator>::value_type;
+    using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
     auto phase_coefficients
       = ::ket::utility::generate_phase_coefficients<complex_type>(
           static_cast<bit_integer_type>(std::distance(begin(qubits), end(qubits))));
@@ -231,8 +440,7 @@ namespace ket
     ::ket::adj_swapped_fourier_transform(parallel_policy, first, last, qubits, phase_coefficients);
   }
 
-  template <
-    typename ParallelPolicy, typename RandomAccessIterator, typename Qubits>
+  template <typename RandomAccessIterator, typename Qubits>
   inline void adj_swapped_fourier_transform(
     RandomAccessIterator const first, RandomAccessIterator const last, Qubits const& qubits)
   { ::ket::adj_swapped_fourier_transform(::ket::utility::policy::make_sequential(), first, last, qubits); }
@@ -257,7 +465,7 @@ namespace ket
     }
 
     template <typename RandomAccessRange, typename Qubits, typename PhaseCoefficientsAllocator>
-    inline std::enable_if_t<not ::ket::utility::policy::is_loop_n_policy<RandomAccessRange>::value, RandomAccessRange&>
+    inline std::enable_if_t<not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value, RandomAccessRange&>
     adj_swapped_fourier_transform(
       RandomAccessRange& state, Qubits const& qubits,
       std::vector<
@@ -271,7 +479,7 @@ namespace ket
     }
 
     template <typename ParallelPolicy, typename RandomAccessRange, typename Qubits>
-    inline std::enable_if_t< ::ket::utility::policy::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange& >
+    inline std::enable_if_t< ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange& >
     adj_swapped_fourier_transform(ParallelPolicy const parallel_policy, RandomAccessRange& state, Qubits const& qubits)
     {
       using std::begin;
@@ -280,7 +488,7 @@ namespace ket
       return state;
     }
 
-    template <typename RandomAccessRange, typename Qubits, typename PhaseCoefficientsAllocator>
+    template <typename RandomAccessRange, typename Qubits>
     inline RandomAccessRange& adj_swapped_fourier_transform(RandomAccessRange& state, Qubits const& qubits)
     {
       using std::begin;
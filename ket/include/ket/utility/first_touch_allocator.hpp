@@ -0,0 +1,158 @@
+#ifndef KET_UTILITY_FIRST_TOUCH_ALLOCATOR_HPP
+# define KET_UTILITY_FIRST_TOUCH_ALLOCATOR_HPP
+
+# include <cstddef>
+# include <limits>
+# include <new>
+# include <utility>
+# include <type_traits>
+
+// Huge pages are available only on POSIX systems.
+// KET_USE_TRANSPARENT_HUGE_PAGES: large allocations are aligned to huge pages and advised to be backed by transparent huge pages
+// KET_USE_HUGETLBFS: large allocations are backed by reserved huge pages (MAP_HUGETLB) if possible, and by transparent huge pages otherwise
+# if (defined(KET_USE_TRANSPARENT_HUGE_PAGES) || defined(KET_USE_HUGETLBFS)) && (defined(__unix__) || defined(__APPLE__))
+#   define KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+#   include <cstdint>
+#   include <sys/mman.h>
+#   ifndef KET_HUGE_PAGE_SIZE
+#     define KET_HUGE_PAGE_SIZE 2097152
+#   endif // KET_HUGE_PAGE_SIZE
+# endif // (defined(KET_USE_TRANSPARENT_HUGE_PAGES) || defined(KET_USE_HUGETLBFS)) && (defined(__unix__) || defined(__APPLE__))
+
+
+namespace ket
+{
+  namespace utility
+  {
+# ifdef KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+    namespace first_touch_allocator_detail
+    {
+      constexpr auto huge_page_size = std::size_t{KET_HUGE_PAGE_SIZE};
+
+      // Allocations smaller than a huge page are not worth mapping
+      inline auto uses_huge_pages(std::size_t const num_bytes) noexcept -> bool
+      { return num_bytes >= huge_page_size; }
+
+      inline auto mapped_size(std::size_t const num_bytes) noexcept -> std::size_t
+      { return (num_bytes + huge_page_size - std::size_t{1u}) / huge_page_size * huge_page_size; }
+
+      inline auto allocate_huge_pages(std::size_t const num_bytes) -> void*
+      {
+        auto const size = mapped_size(num_bytes);
+#   if defined(KET_USE_HUGETLBFS) && defined(MAP_HUGETLB)
+        auto const hugetlb_address
+          = ::mmap(nullptr, size, PROT_READ bitor PROT_WRITE, MAP_PRIVATE bitor MAP_ANONYMOUS bitor MAP_HUGETLB, -1, 0);
+        if (hugetlb_address != MAP_FAILED)
+          return hugetlb_address;
+#   endif // defined(KET_USE_HUGETLBFS) && defined(MAP_HUGETLB)
+
+        // An extra huge page is mapped so that the region can be aligned to huge pages, and the unaligned head and tail are unmapped
+        auto const address = ::mmap(nullptr, size + huge_page_size, PROT_READ bitor PROT_WRITE, MAP_PRIVATE bitor MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED)
+          throw std::bad_alloc{};
+
+        auto const first = reinterpret_cast<std::uintptr_t>(address);
+        auto const aligned_first = (first + huge_page_size - std::uintptr_t{1u}) / huge_page_size * huge_page_size;
+        if (aligned_first != first)
+          ::munmap(address, aligned_first - first);
+        ::munmap(reinterpret_cast<void*>(aligned_first + size), first + huge_page_size - aligned_first);
+
+        auto const result = reinterpret_cast<void*>(aligned_first);
+#   ifdef MADV_HUGEPAGE
+        ::madvise(result, size, MADV_HUGEPAGE);
+#   endif // MADV_HUGEPAGE
+        return result;
+      }
+
+      inline auto deallocate_huge_pages(void* const pointer, std::size_t const num_bytes) noexcept -> void
+      { ::munmap(pointer, mapped_size(num_bytes)); }
+    } // namespace first_touch_allocator_detail
+# endif // KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+
+    // Allocator for state vectors. Default construction of trivially copyable elements, e.g. by std::vector<T, Allocator>(n) or resize(n),
+    // leaves them uninitialized, so that each page of the storage is touched first by the thread which fills it, e.g. by
+    // ::ket::utility::fill(parallel_policy, first, last, value). Then pages are placed on the NUMA node of the thread using them in later loops
+    template <typename T>
+    class first_touch_allocator
+    {
+     public:
+      using value_type = T;
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using propagate_on_container_move_assignment = std::true_type;
+      using is_always_equal = std::true_type;
+
+      template <typename U>
+      struct rebind
+      {
+        using other = ::ket::utility::first_touch_allocator<U>;
+      }; // struct rebind<U>
+
+      first_touch_allocator() noexcept = default;
+
+      template <typename U>
+      first_touch_allocator(::ket::utility::first_touch_allocator<U> const&) noexcept
+      { }
+
+      auto allocate(std::size_t const n) -> T*
+      {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+          throw std::bad_array_new_length{};
+
+# ifdef KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+        if (::ket::utility::first_touch_allocator_detail::uses_huge_pages(n * sizeof(T)))
+          return static_cast<T*>(::ket::utility::first_touch_allocator_detail::allocate_huge_pages(n * sizeof(T)));
+# endif // KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+      }
+
+      auto deallocate(T* const pointer, std::size_t const n) noexcept -> void
+      {
+# ifdef KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+        if (::ket::utility::first_touch_allocator_detail::uses_huge_pages(n * sizeof(T)))
+        {
+          ::ket::utility::first_touch_allocator_detail::deallocate_huge_pages(pointer, n * sizeof(T));
+          return;
+        }
+# else // KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+        static_cast<void>(n);
+# endif // KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+
+        ::operator delete(pointer);
+      }
+
+      template <typename U>
+      auto construct(U* const pointer) -> void
+      { do_construct(pointer, std::is_trivially_copyable<U>{}); }
+
+      template <typename U, typename... Arguments>
+      auto construct(U* const pointer, Arguments&&... arguments) -> void
+      { ::new(static_cast<void*>(pointer)) U(std::forward<Arguments>(arguments)...); }
+
+      template <typename U>
+      auto destroy(U* const pointer) -> void
+      { pointer->~U(); }
+
+     private:
+      template <typename U>
+      static auto do_construct(U* const, std::true_type const) noexcept -> void
+      { }
+
+      template <typename U>
+      static auto do_construct(U* const pointer, std::false_type const) -> void
+      { ::new(static_cast<void*>(pointer)) U(); }
+    }; // class first_touch_allocator<T>
+
+    template <typename T, typename U>
+    inline constexpr auto operator==(::ket::utility::first_touch_allocator<T> const&, ::ket::utility::first_touch_allocator<U> const&) noexcept -> bool
+    { return true; }
+
+    template <typename T, typename U>
+    inline constexpr auto operator!=(::ket::utility::first_touch_allocator<T> const&, ::ket::utility::first_touch_allocator<U> const&) noexcept -> bool
+    { return false; }
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_FIRST_TOUCH_ALLOCATOR_HPP
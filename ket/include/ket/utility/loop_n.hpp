@@ -61,6 +61,46 @@ namespace ket
     { return ::ket::utility::dispatch::num_threads<ParallelPolicy>::call(policy); }
 
 
+    // Function object for loop_n whose calls for different counts neither depend on each other nor throw,
+    // e.g. a gate kernel touching only amplitudes determined by its count. Parallel loop_n vectorizes loops of it by "omp simd"
+    template <typename Function>
+    class independent_loop_function
+    {
+      Function function_;
+
+     public:
+      explicit independent_loop_function(Function const& function)
+        : function_{function}
+      { }
+
+      explicit independent_loop_function(Function&& function)
+        : function_{std::move(function)}
+      { }
+
+      template <typename Integer>
+      auto operator()(Integer const count, int const thread_index) const noexcept -> void
+      { function_(count, thread_index); }
+    }; // class independent_loop_function<Function>
+
+    template <typename Function>
+    inline auto make_independent_loop_function(Function&& function)
+    -> ::ket::utility::independent_loop_function<std::remove_cv_t<std::remove_reference_t<Function>>>
+    { return ::ket::utility::independent_loop_function<std::remove_cv_t<std::remove_reference_t<Function>>>{std::forward<Function>(function)}; }
+
+    namespace meta
+    {
+      template <typename T>
+      struct is_independent_loop_function
+        : std::false_type
+      { }; // struct is_independent_loop_function<T>
+
+      template <typename Function>
+      struct is_independent_loop_function< ::ket::utility::independent_loop_function<Function> >
+        : std::true_type
+      { }; // struct is_independent_loop_function< ::ket::utility::independent_loop_function<Function> >
+    } // namespace meta
+
+
     namespace dispatch
     {
       template <typename ParallelPolicy, typename Integer>
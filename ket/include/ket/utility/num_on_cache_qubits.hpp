@@ -0,0 +1,143 @@
+#ifndef KET_UTILITY_NUM_ON_CACHE_QUBITS_HPP
+# define KET_UTILITY_NUM_ON_CACHE_QUBITS_HPP
+
+# include <cstddef>
+# include <string>
+# include <fstream>
+# include <vector>
+# include <atomic>
+# include <chrono>
+# include <limits>
+# include <complex>
+
+# include <ket/utility/integer_log2.hpp>
+
+// The initial value of ::ket::utility::num_on_cache_qubits(), which is used until ::ket::utility::set_num_on_cache_qubits is called
+# ifndef KET_DEFAULT_NUM_ON_CACHE_QUBITS
+#   define KET_DEFAULT_NUM_ON_CACHE_QUBITS 16
+# endif // KET_DEFAULT_NUM_ON_CACHE_QUBITS
+
+
+namespace ket
+{
+  namespace utility
+  {
+    namespace num_on_cache_qubits_detail
+    {
+      inline auto value() noexcept -> std::atomic<unsigned int>&
+      {
+        static std::atomic<unsigned int> result{KET_DEFAULT_NUM_ON_CACHE_QUBITS};
+        return result;
+      }
+
+      // ex: "2048K" => 2097152
+      inline auto to_num_bytes(std::string const& size) -> std::size_t
+      {
+        auto result = std::size_t{0u};
+        auto iter = size.begin();
+        for (; iter != size.end() and *iter >= '0' and *iter <= '9'; ++iter)
+          result = result * std::size_t{10u} + static_cast<std::size_t>(*iter - '0');
+
+        if (iter == size.end())
+          return result;
+        if (*iter == 'K')
+          return result << 10u;
+        if (*iter == 'M')
+          return result << 20u;
+        if (*iter == 'G')
+          return result << 30u;
+        return result;
+      }
+    } // namespace num_on_cache_qubits_detail
+
+    // Cache-aware gate functions treat 2^num_on_cache_qubits() amplitudes as on cache. The value is read at each call of them,
+    // so it should be changed before applying gates, not while gates are applied
+    template <typename BitInteger = unsigned int>
+    inline auto num_on_cache_qubits() noexcept -> BitInteger
+    { return static_cast<BitInteger>(::ket::utility::num_on_cache_qubits_detail::value().load(std::memory_order_relaxed)); }
+
+    inline auto set_num_on_cache_qubits(unsigned int const num_on_cache_qubits) noexcept -> void
+    { ::ket::utility::num_on_cache_qubits_detail::value().store(num_on_cache_qubits, std::memory_order_relaxed); }
+
+    // Returns the number of qubits whose amplitudes fill the largest private (level 1 or 2) data cache of CPU 0 described in sysfs,
+    // or 0 if the cache topology is unavailable, e.g. on non-Linux systems
+    inline auto detect_num_on_cache_qubits(std::size_t const num_bytes_per_amplitude) -> unsigned int
+    {
+      auto cache_size = std::size_t{0u};
+      for (auto index = 0; ; ++index)
+      {
+        auto const directory = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        auto level_stream = std::ifstream{directory + "level"};
+        auto type_stream = std::ifstream{directory + "type"};
+        auto size_stream = std::ifstream{directory + "size"};
+        if (not level_stream or not type_stream or not size_stream)
+          break;
+
+        auto level = 0;
+        auto type = std::string{};
+        auto size = std::string{};
+        if (not (level_stream >> level) or not (type_stream >> type) or not (size_stream >> size))
+          continue;
+
+        if (level > 2 or type == "Instruction")
+          continue;
+
+        auto const num_bytes = ::ket::utility::num_on_cache_qubits_detail::to_num_bytes(size);
+        if (num_bytes > cache_size)
+          cache_size = num_bytes;
+      }
+
+      if (cache_size < num_bytes_per_amplitude or num_bytes_per_amplitude == std::size_t{0u})
+        return 0u;
+
+      return ::ket::utility::integer_log2<unsigned int>(cache_size / num_bytes_per_amplitude);
+    }
+
+    // Returns the largest number of qubits in [min_num_qubits, max_num_qubits] whose amplitudes are swept as fast as on cache.
+    // Each 2^n amplitudes are swept repeatedly, and n is rejected if its sweeps are much slower than the fastest sweeps of smaller n
+    template <typename Complex>
+    inline auto tune_num_on_cache_qubits(unsigned int const min_num_qubits, unsigned int const max_num_qubits) -> unsigned int
+    {
+      auto buffer = std::vector<Complex>(std::size_t{1u} << max_num_qubits, Complex{1});
+      auto const increment = Complex{0.5, -0.5};
+      auto const num_updates = std::size_t{1u} << max_num_qubits;
+
+      auto result = min_num_qubits;
+      auto min_duration = std::numeric_limits<double>::max();
+      for (auto num_qubits = min_num_qubits; num_qubits <= max_num_qubits; ++num_qubits)
+      {
+        auto const size = std::size_t{1u} << num_qubits;
+        for (auto index = std::size_t{0u}; index < size; ++index)
+          buffer[index] += increment;
+
+        // The shortest of a few trials is taken to reduce noise
+        auto duration = std::numeric_limits<double>::max();
+        for (auto trial = 0; trial < 5; ++trial)
+        {
+          auto const start = std::chrono::steady_clock::now();
+          for (auto num_sweeps = num_updates >> num_qubits; num_sweeps > std::size_t{0u}; --num_sweeps)
+            for (auto index = std::size_t{0u}; index < size; ++index)
+              buffer[index] += increment;
+          auto const trial_duration = std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count();
+          if (trial_duration < duration)
+            duration = trial_duration;
+        }
+
+        if (duration > 1.5 * min_duration)
+          break;
+
+        result = num_qubits;
+        if (duration < min_duration)
+          min_duration = duration;
+      }
+
+      // The buffer is read so that the sweeps are not optimized away
+      auto volatile sink = std::real(buffer.front());
+      static_cast<void>(sink);
+      return result;
+    }
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_NUM_ON_CACHE_QUBITS_HPP
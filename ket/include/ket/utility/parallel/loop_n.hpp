@@ -7,13 +7,13 @@
 # include <algorithm>
 # include <numeric>
 # include <utility>
-# include <mutex> // lock_guard and unique_lock; mutex unless using OpenMP
+# include <mutex> // lock_guard
 # if defined(_OPENMP) && defined(KET_USE_OPENMP)
 #   include <stdexcept>
 # else // defined(_OPENMP) && defined(KET_USE_OPENMP)
+#   include <atomic>
 #   include <thread>
 #   include <future>
-#   include <condition_variable>
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
 # include <type_traits>
 
@@ -24,6 +24,18 @@
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
 
 # include <ket/utility/loop_n.hpp>
+# if !(defined(_OPENMP) && defined(KET_USE_OPENMP))
+#   include <ket/utility/parallel/thread_pool.hpp>
+# endif // !(defined(_OPENMP) && defined(KET_USE_OPENMP))
+
+# if defined(_OPENMP) && defined(KET_USE_OPENMP)
+#   ifndef KET_LOOP_N_PAGE_COUNTS
+#     define KET_LOOP_N_PAGE_COUNTS 256
+#   endif // KET_LOOP_N_PAGE_COUNTS
+#   ifndef KET_LOOP_N_CACHE_LINE_COUNTS
+#     define KET_LOOP_N_CACHE_LINE_COUNTS 4
+#   endif // KET_LOOP_N_CACHE_LINE_COUNTS
+# endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
 
 
 namespace ket
@@ -147,6 +159,65 @@ namespace ket
           : std::runtime_error{"nonstandard exception is thrown in OpenMP block"}
         { }
       }; // class omp_nonstandard_exception
+
+      // Chunks of counts for "schedule(static, chunk_size)" are multiples of KET_LOOP_N_PAGE_COUNTS counts if they are large enough
+      // and multiples of KET_LOOP_N_CACHE_LINE_COUNTS counts otherwise, so that no two threads write into the same page or cache line
+      // in loops over amplitudes. The default values are the numbers of std::complex<double> in 4 KiB and 64 bytes.
+      template <typename Integer>
+      inline auto aligned_chunk_size(Integer const n, int const num_threads) -> Integer
+      {
+        auto const chunk_size = (n + static_cast<Integer>(num_threads) - Integer{1}) / static_cast<Integer>(num_threads);
+        auto const alignment
+          = chunk_size >= static_cast<Integer>(KET_LOOP_N_PAGE_COUNTS)
+            ? static_cast<Integer>(KET_LOOP_N_PAGE_COUNTS)
+            : static_cast<Integer>(KET_LOOP_N_CACHE_LINE_COUNTS);
+        return std::max((chunk_size + alignment - Integer{1}) / alignment * alignment, alignment);
+      }
+
+      // 0: function may throw, 1: function does not throw, 2: function is ::ket::utility::independent_loop_function
+      template <typename Integer, typename Function>
+      using loop_n_kind
+        = std::integral_constant<
+            int,
+#   if defined(KET_CATCH_EXCEPTIONS_IN_LOOP_N)
+            0
+#   elif defined(KET_DONT_USE_OMP_SIMD_IN_LOOP_N)
+            noexcept(std::declval<Function&>()(std::declval<Integer>(), int{})) ? 1 : 0
+#   else // defined(KET_CATCH_EXCEPTIONS_IN_LOOP_N)
+            ::ket::utility::meta::is_independent_loop_function<std::remove_cv_t<std::remove_reference_t<Function>>>::value
+            ? 2
+            : noexcept(std::declval<Function&>()(std::declval<Integer>(), int{})) ? 1 : 0
+#   endif // defined(KET_CATCH_EXCEPTIONS_IN_LOOP_N)
+          >;
+# else // defined(_OPENMP) && defined(KET_USE_OPENMP)
+      // Calls function(thread_index) for each thread_index in [0, num_threads) on the thread pool.
+      // If the pool is running another job, e.g. in nested parallel loops, threads are launched just for this call instead
+      template <typename Function>
+      inline auto run_on_threads(int const num_threads, Function&& function) -> void
+      {
+        assert(num_threads > 0);
+
+        if (num_threads == 1)
+        {
+          function(0);
+          return;
+        }
+
+        if (::ket::utility::thread_pool::instance().try_run(num_threads, function))
+          return;
+
+        auto const num_futures = num_threads - 1;
+        auto futures = std::vector<std::future<void>>{};
+        futures.reserve(num_futures);
+
+        for (auto thread_index = 0; thread_index < num_futures; ++thread_index)
+          futures.push_back(std::async(std::launch::async, [&function, thread_index] { function(thread_index); }));
+
+        function(num_futures);
+
+        for (auto& future: futures)
+          future.get();
+      }
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
     } // namespace parallel_loop_n_detail
 
@@ -163,7 +234,57 @@ namespace ket
         -> void
         {
           assert(::ket::utility::num_threads(parallel_policy) > 0u);
+          do_call(
+            parallel_policy, n, function,
+            ::ket::utility::parallel_loop_n_detail::loop_n_kind<Integer, Function>{});
+        }
+
+       private:
+        // The loop body is a plain call of function, so that the compiler can unroll (and vectorize) it
+        template <typename Function>
+        static auto do_call(
+          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          Integer const n, Function& function, std::integral_constant<int, 1> const)
+        -> void
+        {
+          auto const chunk_size
+            = ::ket::utility::parallel_loop_n_detail::aligned_chunk_size(
+                n, static_cast<int>(::ket::utility::num_threads(parallel_policy)));
+
+#   pragma omp parallel
+          {
+            auto const thread_index = static_cast<int>(omp_get_thread_num());
+#   pragma omp for schedule(static, chunk_size)
+            for (auto count = Integer{0}; count < n; ++count)
+              function(count, thread_index);
+          }
+        }
+
+        template <typename Function>
+        static auto do_call(
+          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          Integer const n, Function& function, std::integral_constant<int, 2> const)
+        -> void
+        {
+          auto const chunk_size
+            = ::ket::utility::parallel_loop_n_detail::aligned_chunk_size(
+                n, static_cast<int>(::ket::utility::num_threads(parallel_policy)));
+
+#   pragma omp parallel
+          {
+            auto const thread_index = static_cast<int>(omp_get_thread_num());
+#   pragma omp for simd schedule(simd: static, chunk_size)
+            for (auto count = Integer{0}; count < n; ++count)
+              function(count, thread_index);
+          }
+        }
 
+        template <typename Function>
+        static auto do_call(
+          ::ket::utility::policy::parallel<NumThreads> const,
+          Integer const n, Function& function, std::integral_constant<int, 0> const)
+        -> void
+        {
           auto maybe_error = boost::optional<std::exception>{};
           auto is_nonstandard_exception_thrown = false;
 
@@ -213,41 +334,25 @@ namespace ket
 
           auto const num_threads
             = static_cast<NumThreads>(::ket::utility::num_threads(parallel_policy));
-          auto const num_futures = num_threads - NumThreads{1u};
-          auto futures = std::vector<std::future<void>>{};
-          futures.reserve(num_futures);
-
           auto const local_num_counts = static_cast<NumThreads>(n) / num_threads;
           auto const remainder = static_cast<NumThreads>(n) % num_threads;
-          auto first_count = Integer{0};
-
-          for (auto thread_index = NumThreads{0u}; thread_index < num_futures; ++thread_index)
-          {
-            auto const last_count
-              = static_cast<Integer>(
-                  local_num_counts * (thread_index + NumThreads{1u})
-                  + std::min(remainder, thread_index + NumThreads{1u}));
-
-            futures.push_back(std::async(
-              std::launch::async,
-              [&function, first_count, last_count, thread_index]
-              {
-                for (auto count = first_count; count < last_count; ++count)
-                  function(count, static_cast<int>(thread_index));
-              }));
-
-            first_count = last_count;
-          }
-
-          auto const last_count
-            = static_cast<Integer>(
-                local_num_counts * num_threads + std::min(remainder, num_threads));
-
-          for (auto count = first_count; count < last_count; ++count)
-            function(count, static_cast<int>(num_futures));
 
-          for (auto const& future: futures)
-            future.wait();
+          ::ket::utility::parallel_loop_n_detail::run_on_threads(
+            static_cast<int>(num_threads),
+            [&function, local_num_counts, remainder](int const thread_index)
+            {
+              auto const first_count
+                = static_cast<Integer>(
+                    local_num_counts * static_cast<NumThreads>(thread_index)
+                    + std::min(remainder, static_cast<NumThreads>(thread_index)));
+              auto const last_count
+                = static_cast<Integer>(
+                    local_num_counts * static_cast<NumThreads>(thread_index + 1)
+                    + std::min(remainder, static_cast<NumThreads>(thread_index + 1)));
+
+              for (auto count = first_count; count < last_count; ++count)
+                function(count, thread_index);
+            });
         }
       }; // struct loop_n< ::ket::utility::policy::parallel<NumThreads>, Integer >
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
@@ -344,42 +449,29 @@ namespace ket
       template <typename NumThreads>
       class execute< ::ket::utility::policy::parallel<NumThreads> >
       {
-        std::mutex mutex_;
-        std::condition_variable cond_;
-        std::vector<int> barrier_counters_;
+        ::ket::utility::spin_barrier barrier_;
+        std::atomic<int> num_single_arrivals_;
 
         using parallel_policy_type = ::ket::utility::policy::parallel<NumThreads>;
-        friend class loop_n_in_execute<parallel_policy_type>;
         friend class barrier<parallel_policy_type>;
         friend class single_execute<parallel_policy_type>;
 
        public:
         execute()
-          : mutex_{}, cond_{}, barrier_counters_{}
-        { barrier_counters_.reserve(64); }
+          : barrier_{}, num_single_arrivals_{0}
+        { }
 
         template <typename Function>
         auto invoke(::ket::utility::policy::parallel<NumThreads> const parallel_policy, Function&& function) -> void
         {
           assert(::ket::utility::num_threads(parallel_policy) > 0u);
 
-          auto const num_threads = static_cast<NumThreads>(::ket::utility::num_threads(parallel_policy));
-          barrier_counters_.push_back(num_threads);
-
-          auto const num_futures = num_threads - NumThreads{1u};
-          auto futures = std::vector<std::future<void>>{};
-          futures.reserve(num_futures);
-
-          for (auto thread_index = NumThreads{0u}; thread_index < num_futures; ++thread_index)
-            futures.push_back(std::async(
-              std::launch::async,
-              [&function, thread_index, this]
-              { function(static_cast<int>(thread_index), *this); }));
+          auto const num_threads = static_cast<int>(::ket::utility::num_threads(parallel_policy));
+          barrier_.reset(num_threads);
+          num_single_arrivals_.store(0, std::memory_order_relaxed);
 
-          function(static_cast<int>(num_futures), *this);
-
-          for (auto const& future: futures)
-            future.wait();
+          ::ket::utility::parallel_loop_n_detail::run_on_threads(
+            num_threads, [&function, this](int const thread_index) { function(thread_index, *this); });
         }
       }; // class execute< ::ket::utility::policy::parallel<NumThreads> >
 
@@ -413,25 +505,10 @@ namespace ket
       struct barrier< ::ket::utility::policy::parallel<NumThreads> >
       {
         static auto call(
-          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          ::ket::utility::policy::parallel<NumThreads> const,
           ::ket::utility::dispatch::execute< ::ket::utility::policy::parallel<NumThreads> >& executor)
         -> void
-        {
-          auto const index = static_cast<std::size_t>(executor.barrier_counters_.size()) - std::size_t{1u};
-
-          if (executor.barrier_counters_[index] == 1)
-          {
-            std::lock_guard<std::mutex> lock{executor.mutex_};
-            executor.barrier_counters_.push_back(static_cast<int>(::ket::utility::num_threads(parallel_policy)));
-            --executor.barrier_counters_[index];
-            executor.cond_.notify_all();
-            return;
-          }
-
-          auto lock = std::unique_lock<std::mutex>{executor.mutex_};
-          --executor.barrier_counters_[index];
-          executor.cond_.wait(lock, [&executor, index] { return executor.barrier_counters_[index] == 0; });
-        }
+        { executor.barrier_.arrive_and_wait(); }
       }; // struct barrier< ::ket::utility::policy::parallel<NumThreads> >
 
       template <typename NumThreads>
@@ -444,27 +521,12 @@ namespace ket
           Function&& function)
         -> void
         {
-          auto const index = static_cast<std::size_t>(executor.barrier_counters_.size()) - std::size_t{1u};
-
-          if (executor.barrier_counters_[index]
-              == static_cast<int>(::ket::utility::num_threads(parallel_policy)))
-          {
-            std::lock_guard<std::mutex> lock{executor.mutex_};
+          // The first arriving thread calls function, and the others wait for it at the barrier like "omp single"
+          auto const num_threads = static_cast<int>(::ket::utility::num_threads(parallel_policy));
+          if (executor.num_single_arrivals_.fetch_add(1, std::memory_order_relaxed) % num_threads == 0)
             function();
-          }
-
-          if (executor.barrier_counters_[index] == 1)
-          {
-            std::lock_guard<std::mutex> lock{executor.mutex_};
-            executor.barrier_counters_.push_back(static_cast<int>(::ket::utility::num_threads(parallel_policy)));
-            --executor.barrier_counters_[index];
-            executor.cond_.notify_all();
-            return;
-          }
 
-          auto lock = std::unique_lock<std::mutex>{executor.mutex_};
-          --executor.barrier_counters_[index];
-          executor.cond_.wait(lock, [&executor, index] { return executor.barrier_counters_[index] == 0; });
+          executor.barrier_.arrive_and_wait();
         }
       }; // struct single_execute< ::ket::utility::policy::parallel<NumThreads> >
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
@@ -950,10 +1012,12 @@ namespace ket
           std::random_access_iterator_tag const)
         -> void
         {
+          // Filling uses the same static partition as gate kernels, so that each page is touched first by the thread using it later
           using difference_type = typename std::iterator_traits<RandomAccessIterator>::difference_type;
           ::ket::utility::loop_n(
             parallel_policy, last - first,
-            [first, &value](difference_type const n, int) { first[n] = value; });
+            ::ket::utility::make_independent_loop_function(
+              [first, value](difference_type const n, int) { first[n] = value; }));
         }
       }; // struct fill< ::ket::utility::policy::parallel<NumThreads> >
     } // namespace dispatch
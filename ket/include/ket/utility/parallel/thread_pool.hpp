@@ -0,0 +1,376 @@
+#ifndef KET_UTILITY_PARALLEL_THREAD_POOL_HPP
+# define KET_UTILITY_PARALLEL_THREAD_POOL_HPP
+
+# include <cassert>
+# include <cstdint>
+# include <vector>
+# include <atomic>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+# include <exception>
+# if defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+#   include <pthread.h>
+#   include <sched.h>
+# endif // defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+# if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+# endif // defined(__x86_64__) || defined(__i386__)
+
+// Number of polls before an idle worker (or a thread waiting at spin_barrier) stops busy-waiting, which is 0 on single-core machines
+# ifndef KET_THREAD_POOL_SPIN_COUNT
+#   define KET_THREAD_POOL_SPIN_COUNT 65536
+# endif // KET_THREAD_POOL_SPIN_COUNT
+
+
+namespace ket
+{
+  namespace utility
+  {
+    namespace thread_pool_detail
+    {
+      inline auto pause() noexcept -> void
+      {
+# if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+# elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+# endif
+      }
+
+      // Busy-waiting is useless if there is only one hardware thread
+      inline auto spin_count() -> int
+      {
+        static auto const result = std::thread::hardware_concurrency() > 1u ? KET_THREAD_POOL_SPIN_COUNT : 0;
+        return result;
+      }
+
+      // CPUs which the constructing thread may run on. Threads are pinned only if KET_PIN_POOL_THREADS is defined,
+      // because processes sharing a node without their own CPU sets, e.g. MPI processes, would be pinned to the same CPUs
+      class thread_affinity
+      {
+# if defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+        cpu_set_t cpus_;
+        bool is_valid_;
+# endif // defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+
+       public:
+        thread_affinity() noexcept
+# if defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+          : cpus_{}, is_valid_{false}
+        {
+          CPU_ZERO(&cpus_);
+          is_valid_ = pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus_) == 0;
+        }
+# else // defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+        { }
+# endif // defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+
+        // Pins the calling thread to the index-th CPU of the CPUs, so that processes bound to disjoint CPU sets stay disjoint
+        auto pin_this_thread(unsigned int const index) const noexcept -> void
+        {
+# if defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+          if (not is_valid_)
+            return;
+
+          auto const num_cpus = static_cast<unsigned int>(CPU_COUNT(&cpus_));
+          if (num_cpus <= 1u)
+            return;
+
+          auto const cpu_index = index % num_cpus;
+          auto count = 0u;
+          for (auto cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &cpus_) and count++ == cpu_index)
+            {
+              auto cpus = cpu_set_t{};
+              CPU_ZERO(&cpus);
+              CPU_SET(cpu, &cpus);
+              pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+              return;
+            }
+# else // defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+          static_cast<void>(index);
+# endif // defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+        }
+
+        // Lets the calling thread run on the CPUs again
+        auto restore_this_thread() const noexcept -> void
+        {
+# if defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+          if (is_valid_)
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus_);
+# endif // defined(__linux__) && defined(KET_PIN_POOL_THREADS)
+        }
+      }; // class thread_affinity
+    } // namespace thread_pool_detail
+
+    // Sense-reversing barrier: the last arriving thread resets the counter and flips the sense, and the others spin until the sense is flipped
+    class spin_barrier
+    {
+      int num_threads_;
+      std::atomic<int> num_remaining_threads_;
+      std::atomic<bool> sense_;
+
+     public:
+      explicit spin_barrier(int const num_threads = 1) noexcept
+        : num_threads_{num_threads}, num_remaining_threads_{num_threads}, sense_{false}
+      { }
+
+      spin_barrier(spin_barrier const&) = delete;
+      spin_barrier& operator=(spin_barrier const&) = delete;
+
+      // Should not be called while some threads wait at this barrier
+      auto reset(int const num_threads) noexcept -> void
+      {
+        num_threads_ = num_threads;
+        num_remaining_threads_.store(num_threads, std::memory_order_relaxed);
+      }
+
+      auto arrive_and_wait() noexcept -> void
+      {
+        // sense_ cannot be flipped before this thread arrives
+        auto const next_sense = not sense_.load(std::memory_order_relaxed);
+
+        if (num_remaining_threads_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+          num_remaining_threads_.store(num_threads_, std::memory_order_relaxed);
+          sense_.store(next_sense, std::memory_order_release);
+          return;
+        }
+
+        auto const spin_count = ::ket::utility::thread_pool_detail::spin_count();
+        for (auto num_polls = 0; sense_.load(std::memory_order_acquire) != next_sense; ++num_polls)
+          if (num_polls < spin_count)
+            ::ket::utility::thread_pool_detail::pause();
+          else
+            std::this_thread::yield();
+      }
+    }; // class spin_barrier
+
+    // Persistent worker threads for ket::utility::policy::parallel without OpenMP.
+    // A job is published by incrementing generation_, so dispatching it takes no lock unless some workers sleep.
+    // Idle workers poll generation_ KET_THREAD_POOL_SPIN_COUNT times and then sleep on a condition variable.
+    // instance() is shared by all threads unless another pool is bound to the calling thread by ket::utility::scoped_thread_pool
+    class thread_pool
+    {
+      using job_function_type = void(*)(void*, int);
+
+      unsigned int first_cpu_index_; // the thread running jobs is expected on this CPU, and workers are pinned to the following CPUs
+      // taken before the constructing thread is pinned, because workers inherit the affinity of the thread running the first job
+      ::ket::utility::thread_pool_detail::thread_affinity affinity_;
+      std::vector<std::thread> workers_;
+      std::atomic<bool> is_running_job_; // also detects nested or concurrent calls
+      std::atomic<bool> is_stopping_;
+
+      // job descriptor, which is read as a seqlock guarded by generation_
+      std::atomic<std::uint64_t> generation_;
+      std::atomic<job_function_type> job_function_;
+      std::atomic<void*> job_context_;
+      std::atomic<int> num_job_workers_;
+      std::atomic<int> num_remaining_job_workers_;
+
+      std::mutex mutex_;
+      std::condition_variable condition_;
+      std::atomic<int> num_sleeping_workers_;
+
+      std::mutex exception_mutex_;
+      std::exception_ptr exception_;
+
+     public:
+      explicit thread_pool(unsigned int const first_cpu_index = 0u)
+        : first_cpu_index_{first_cpu_index}, affinity_{}, workers_{}, is_running_job_{false}, is_stopping_{false},
+          generation_{0u}, job_function_{nullptr}, job_context_{nullptr}, num_job_workers_{0}, num_remaining_job_workers_{0},
+          mutex_{}, condition_{}, num_sleeping_workers_{0},
+          exception_mutex_{}, exception_{}
+      { }
+
+      thread_pool(thread_pool const&) = delete;
+      thread_pool& operator=(thread_pool const&) = delete;
+
+      ~thread_pool()
+      {
+        {
+          std::lock_guard<std::mutex> lock{mutex_};
+          is_stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto& worker: workers_)
+          worker.join();
+      }
+
+      static auto instance() -> thread_pool&
+      {
+        if (auto const bound_pool = bound_pool_pointer())
+          return *bound_pool;
+
+        static thread_pool result;
+        return result;
+      }
+
+      // the pool bound to the calling thread, or nullptr if instance() returns the shared pool
+      static auto bound_pool_pointer() noexcept -> thread_pool*&
+      {
+        static thread_local thread_pool* result = nullptr;
+        return result;
+      }
+
+      // Calls function(thread_index) for each thread_index in [0, num_threads), where the calling thread takes (num_threads - 1).
+      // Returns false without calling function if another job is running, e.g. if this is called from function of another job.
+      template <typename Function>
+      auto try_run(int const num_threads, Function& function) -> bool
+      {
+        assert(num_threads > 0);
+
+        if (is_running_job_.exchange(true, std::memory_order_acquire))
+          return false;
+
+        auto const num_workers = num_threads - 1;
+        add_workers(num_workers);
+
+        job_function_.store(&thread_pool::call<Function>, std::memory_order_relaxed);
+        job_context_.store(static_cast<void*>(&function), std::memory_order_relaxed);
+        num_job_workers_.store(num_workers, std::memory_order_relaxed);
+        num_remaining_job_workers_.store(num_workers, std::memory_order_relaxed);
+        generation_.fetch_add(1u); // seq_cst, paired with num_sleeping_workers_ in wait_for_job
+
+        if (num_sleeping_workers_.load() > 0)
+        {
+          std::lock_guard<std::mutex> lock{mutex_};
+          condition_.notify_all();
+        }
+
+        try
+        {
+          function(num_workers);
+        }
+        catch (...)
+        {
+          save_exception();
+        }
+
+        auto const spin_count = ::ket::utility::thread_pool_detail::spin_count();
+        for (auto num_polls = 0; num_remaining_job_workers_.load(std::memory_order_acquire) > 0; ++num_polls)
+          if (num_polls < spin_count)
+            ::ket::utility::thread_pool_detail::pause();
+          else
+            std::this_thread::yield();
+
+        auto exception = std::exception_ptr{};
+        std::swap(exception, exception_);
+        is_running_job_.store(false, std::memory_order_release);
+
+        if (exception)
+          std::rethrow_exception(exception);
+        return true;
+      }
+
+     private:
+      template <typename Function>
+      static auto call(void* const context, int const thread_index) -> void
+      { (*static_cast<Function*>(context))(thread_index); }
+
+      auto save_exception() -> void
+      {
+        std::lock_guard<std::mutex> lock{exception_mutex_};
+        if (not exception_)
+          exception_ = std::current_exception();
+      }
+
+      // Only called by the thread running a job, so workers_ is not modified concurrently
+      auto add_workers(int const num_workers) -> void
+      {
+        auto const generation = generation_.load(std::memory_order_relaxed);
+        for (auto worker_index = static_cast<int>(workers_.size()); worker_index < num_workers; ++worker_index)
+          workers_.emplace_back([this, worker_index, generation] { this->work(worker_index, generation); });
+      }
+
+      auto wait_for_job(std::uint64_t const last_generation) -> std::uint64_t
+      {
+        for (auto num_polls = 0, spin_count = ::ket::utility::thread_pool_detail::spin_count(); num_polls < spin_count; ++num_polls)
+        {
+          auto const generation = generation_.load(std::memory_order_acquire);
+          if (generation != last_generation or is_stopping_.load(std::memory_order_relaxed))
+            return generation;
+
+          ::ket::utility::thread_pool_detail::pause();
+        }
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        ++num_sleeping_workers_; // seq_cst, paired with generation_ in try_run
+        condition_.wait(lock, [this, last_generation] { return generation_.load() != last_generation or is_stopping_.load(); });
+        --num_sleeping_workers_;
+        return generation_.load(std::memory_order_acquire);
+      }
+
+      auto work(int const worker_index, std::uint64_t last_generation) -> void
+      {
+        affinity_.pin_this_thread(first_cpu_index_ + static_cast<unsigned int>(worker_index) + 1u);
+        // Nested jobs of this worker are rejected by this pool instead of being run by another pool
+        bound_pool_pointer() = this;
+
+        while (true)
+        {
+          auto const generation = wait_for_job(last_generation);
+          if (is_stopping_.load(std::memory_order_relaxed))
+            return;
+
+          auto const job_function = job_function_.load(std::memory_order_relaxed);
+          auto const job_context = job_context_.load(std::memory_order_relaxed);
+          auto const num_job_workers = num_job_workers_.load(std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_acquire);
+          // A newer job has been published while reading the descriptor, so this worker did not take part in the older one
+          if (generation_.load(std::memory_order_relaxed) != generation)
+            continue;
+
+          last_generation = generation;
+          if (worker_index >= num_job_workers)
+            continue;
+
+          try
+          {
+            job_function(job_context, worker_index);
+          }
+          catch (...)
+          {
+            save_exception();
+          }
+
+          num_remaining_job_workers_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+      }
+    }; // class thread_pool
+
+    // Binds a thread_pool of its own to the calling thread in its lifetime, so that threads running independent tasks
+    // (e.g. circuits) have disjoint groups of workers. If KET_PIN_POOL_THREADS is defined, the calling thread is pinned to first_cpu_index
+    // until the end of the lifetime, and workers are pinned to the following CPUs
+    class scoped_thread_pool
+    {
+      ::ket::utility::thread_pool_detail::thread_affinity caller_affinity_;
+      ::ket::utility::thread_pool pool_;
+      ::ket::utility::thread_pool* previous_pool_;
+
+     public:
+      explicit scoped_thread_pool(unsigned int const first_cpu_index)
+        : caller_affinity_{}, pool_{first_cpu_index}, previous_pool_{::ket::utility::thread_pool::bound_pool_pointer()}
+      {
+        caller_affinity_.pin_this_thread(first_cpu_index);
+        ::ket::utility::thread_pool::bound_pool_pointer() = &pool_;
+      }
+
+      ~scoped_thread_pool()
+      {
+        ::ket::utility::thread_pool::bound_pool_pointer() = previous_pool_;
+        caller_affinity_.restore_this_thread();
+      }
+
+      scoped_thread_pool(scoped_thread_pool const&) = delete;
+      scoped_thread_pool& operator=(scoped_thread_pool const&) = delete;
+      scoped_thread_pool(scoped_thread_pool&&) = delete;
+      scoped_thread_pool& operator=(scoped_thread_pool&&) = delete;
+    }; // class scoped_thread_pool
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_PARALLEL_THREAD_POOL_HPP
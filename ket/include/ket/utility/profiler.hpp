@@ -0,0 +1,130 @@
+#ifndef KET_UTILITY_PROFILER_HPP
+# define KET_UTILITY_PROFILER_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <array>
+# include <chrono>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    // Phases of operations which are measured inside ket, e.g. interchanges of qubits between MPI processes.
+    // The others in applications of gates are regarded as computation by applications
+    enum class profile_phase : int { none = -1, interchange = 0, barrier = 1 };
+
+    // Counters of elapsed times of profiled phases and the number of bytes moved by interchanges.
+    // Applications enable it and take the counters after each operation, e.g. a gate.
+    // Counting is not thread-safe, and it should be done by the thread calling MPI functions
+    class profiler
+    {
+     public:
+      using clock_type = std::chrono::steady_clock;
+      static constexpr auto num_phases = std::size_t{2u};
+
+      struct counters_type
+      {
+        std::array<double, num_phases> seconds; // seconds[static_cast<int>(phase)]
+        std::uint64_t num_moved_bytes;
+      }; // struct counters_type
+
+     private:
+      bool is_enabled_;
+      counters_type counters_;
+      ::ket::utility::profile_phase active_phase_;
+
+      profiler() noexcept
+        : is_enabled_{false}, counters_{{}, std::uint64_t{0u}}, active_phase_{::ket::utility::profile_phase::none}
+      { }
+
+     public:
+      ~profiler() = default;
+      profiler(profiler const&) = delete;
+      profiler& operator=(profiler const&) = delete;
+      profiler(profiler&&) = delete;
+      profiler& operator=(profiler&&) = delete;
+
+      static auto instance() noexcept -> profiler&
+      {
+        static profiler result;
+        return result;
+      }
+
+      auto is_enabled() const noexcept -> bool { return is_enabled_; }
+      auto enable() noexcept -> void { is_enabled_ = true; }
+      auto disable() noexcept -> void { is_enabled_ = false; }
+
+      auto add(::ket::utility::profile_phase const phase, double const seconds) noexcept -> void
+      { counters_.seconds[static_cast<int>(phase)] += seconds; }
+
+      // the phase of the innermost living profile_guard
+      auto active_phase() const noexcept -> ::ket::utility::profile_phase { return active_phase_; }
+      auto active_phase(::ket::utility::profile_phase const phase) noexcept -> void { active_phase_ = phase; }
+
+      auto add_moved_bytes(std::uint64_t const num_bytes) noexcept -> void
+      {
+        if (is_enabled_)
+          counters_.num_moved_bytes += num_bytes;
+      }
+
+      // returns counters accumulated since the last call, and resets them
+      auto take() noexcept -> counters_type
+      {
+        auto const result = counters_;
+        counters_ = counters_type{{}, std::uint64_t{0u}};
+        return result;
+      }
+    }; // class profiler
+
+    // Adds the elapsed time in its lifetime to the counter of the phase if the profiler is enabled at its construction.
+    // Phases are exclusive: the elapsed time of a nested guard is subtracted from the phase of the enclosing guard,
+    // e.g. barriers in an interchange of qubits are counted only as barriers
+    class profile_guard
+    {
+      ::ket::utility::profile_phase phase_;
+      ::ket::utility::profile_phase outer_phase_;
+      ::ket::utility::profiler::clock_type::time_point start_time_;
+
+     public:
+      explicit profile_guard(::ket::utility::profile_phase const phase) noexcept
+        : phase_{
+            phase != ::ket::utility::profile_phase::none and ::ket::utility::profiler::instance().is_enabled()
+            ? phase : ::ket::utility::profile_phase::none},
+          outer_phase_{::ket::utility::profile_phase::none},
+          start_time_{}
+      {
+        if (phase_ == ::ket::utility::profile_phase::none)
+          return;
+
+        auto& profiler = ::ket::utility::profiler::instance();
+        outer_phase_ = profiler.active_phase();
+        profiler.active_phase(phase_);
+        start_time_ = ::ket::utility::profiler::clock_type::now();
+      }
+
+      ~profile_guard() noexcept
+      {
+        if (phase_ == ::ket::utility::profile_phase::none)
+          return;
+
+        auto const seconds = std::chrono::duration<double>{::ket::utility::profiler::clock_type::now() - start_time_}.count();
+        auto& profiler = ::ket::utility::profiler::instance();
+        profiler.add(phase_, seconds);
+        if (outer_phase_ != ::ket::utility::profile_phase::none)
+          profiler.add(outer_phase_, -seconds);
+        profiler.active_phase(outer_phase_);
+      }
+
+      profile_guard() = delete;
+      profile_guard(profile_guard const&) = delete;
+      profile_guard& operator=(profile_guard const&) = delete;
+      profile_guard(profile_guard&&) = delete;
+      profile_guard& operator=(profile_guard&&) = delete;
+    }; // class profile_guard
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_PROFILER_HPP
@@ -0,0 +1,89 @@
+// Small tiles make several sweeps even for small states
+#define KET_DEFAULT_NUM_ON_CACHE_QUBITS 6
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/all_spin_expectation_values.hpp>
+#include <ket/spin_expectation_value.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+
+  auto make_state(bit_integer_type const num_qubits) -> std::vector<complex_type>
+  {
+    auto random_number_generator = std::mt19937_64{20240701u};
+    auto distribution = std::normal_distribution<double>{};
+    auto result = std::vector<complex_type>(std::size_t{1u} << num_qubits);
+    for (auto& value: result)
+      value = complex_type{distribution(random_number_generator), distribution(random_number_generator)};
+    return result;
+  }
+
+  template <typename ParallelPolicy>
+  auto run_case(std::string const& name, ParallelPolicy const parallel_policy, bit_integer_type const num_qubits) -> bool
+  {
+    auto const state = make_state(num_qubits);
+    auto const actual = ket::ranges::all_spin_expectation_values<qubit_type>(parallel_policy, state);
+
+    if (actual.size() != num_qubits)
+    {
+      std::cerr << name << " failed: " << actual.size() << " spins are returned\n";
+      return false;
+    }
+
+    auto passed = true;
+    for (auto qubit = qubit_type{bit_integer_type{0u}}; qubit < qubit_type{num_qubits}; ++qubit)
+    {
+      auto const expected = ket::ranges::spin_expectation_value(state, qubit);
+      auto const& actual_spin = actual[static_cast<bit_integer_type>(qubit)];
+      for (auto component = 0u; component < 3u; ++component)
+        if (std::abs(actual_spin[component] - expected[component]) > 1e-9 * (1.0 + std::abs(expected[component])))
+        {
+          std::cerr
+            << name << " failed: qubit " << static_cast<bit_integer_type>(qubit) << ", component " << component
+            << ": actual = " << actual_spin[component] << ", expected = " << expected[component] << '\n';
+          passed = false;
+        }
+    }
+
+    return passed;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  run(run_case("sequential, 1 qubit", sequential, 1u));
+  run(run_case("sequential, 3 qubits", sequential, 3u));
+  run(run_case("sequential, 6 qubits", sequential, 6u));
+  run(run_case("sequential, 14 qubits", sequential, 14u));
+  run(run_case("parallel, 5 qubits", parallel, 5u));
+  run(run_case("parallel, 13 qubits", parallel, 13u));
+  run(run_case("parallel, 17 qubits", parallel, 17u));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "non-MPI all_spin_expectation_values tests passed\n";
+  return EXIT_SUCCESS;
+}
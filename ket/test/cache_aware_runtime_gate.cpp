@@ -0,0 +1,112 @@
+// Tests ket::gate::runtime::ranges::gate with operated qubits which are all off-cache, some on-cache and all on-cache
+// (meaningful if KET_ENABLE_CACHE_AWARE_GATE_FUNCTION is defined and NDEBUG is not defined)
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/control.hpp>
+#include <ket/gate/gate.hpp>
+#include <ket/gate/hadamard.hpp>
+#include <ket/gate/pauli_x.hpp>
+#include <ket/gate/fused/hadamard.hpp>
+#include <ket/gate/fused/pauli_x.hpp>
+#include <ket/utility/num_on_cache_qubits.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+  using control_qubit_type = ket::control<qubit_type>;
+
+  using namespace ket::literals::qubit_literals;
+  using namespace ket::literals::control_literals;
+
+  constexpr auto num_qubits = bit_integer_type{10u};
+  constexpr auto num_on_cache_qubits = bit_integer_type{4u};
+
+  auto initial_state() -> std::vector<complex_type>
+  {
+    auto result = std::vector<complex_type>(std::size_t{1u} << num_qubits);
+    for (auto index = std::size_t{0u}; index < result.size(); ++index)
+      result[index] = complex_type{
+        0.125 * static_cast<double>(index % 13u + 1u),
+        -0.0625 * static_cast<double>((index * 3u + 1u) % 7u)};
+    return result;
+  }
+
+  auto max_error(std::vector<complex_type> const& lhs, std::vector<complex_type> const& rhs) -> double
+  {
+    auto result = 0.0;
+    for (auto index = std::size_t{0u}; index < lhs.size(); ++index)
+      result = std::max(result, std::abs(lhs[index] - rhs[index]));
+    return result;
+  }
+
+  // CH_{qubits[0], qubits[1]} followed by X_{qubits[1]} in one runtime gate, compared with the separate gates
+  template <typename ParallelPolicy>
+  auto run_case(std::string const& name, ParallelPolicy const parallel_policy, std::vector<qubit_type> const& qubits) -> bool
+  {
+    auto state = initial_state();
+    auto reference_state = state;
+
+    ket::utility::set_num_on_cache_qubits(num_on_cache_qubits);
+    ket::gate::runtime::ranges::gate(
+      parallel_policy, state,
+      [](auto const first, state_integer_type const index_wo_qubits, auto const& unsorted_qubits_or_masks, auto const& sorted_qubits_with_sentinel_or_index_masks, int const)
+      {
+        ket::gate::fused::runtime::ranges::hadamard(
+          first, index_wo_qubits, unsorted_qubits_or_masks, sorted_qubits_with_sentinel_or_index_masks,
+          0_q, std::vector<control_qubit_type>{1_cq});
+        ket::gate::fused::runtime::ranges::pauli_x(
+          first, index_wo_qubits, unsorted_qubits_or_masks, sorted_qubits_with_sentinel_or_index_masks,
+          std::vector<qubit_type>{1_q}, std::vector<control_qubit_type>{});
+      },
+      qubits);
+
+    ket::utility::set_num_on_cache_qubits(num_qubits);
+    auto const sequential = ket::utility::policy::make_sequential();
+    ket::gate::runtime::ranges::hadamard(sequential, reference_state, qubits[0], std::vector<control_qubit_type>{ket::make_control(qubits[1])});
+    ket::gate::runtime::ranges::pauli_x(sequential, reference_state, std::vector<qubit_type>{qubits[1]}, std::vector<control_qubit_type>{});
+
+    auto const error = max_error(state, reference_state);
+    if (error < 1e-12)
+      return true;
+
+    std::cerr << name << " failed: max error = " << error << '\n';
+    return false;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  auto const none_on_cache = std::vector<qubit_type>{9_q, 6_q};
+  auto const some_on_cache = std::vector<qubit_type>{1_q, 8_q};
+  auto const all_on_cache = std::vector<qubit_type>{3_q, 0_q};
+  run(run_case("sequential, none on cache", sequential, none_on_cache));
+  run(run_case("parallel, none on cache", parallel, none_on_cache));
+  run(run_case("sequential, some on cache", sequential, some_on_cache));
+  run(run_case("parallel, some on cache", parallel, some_on_cache));
+  run(run_case("sequential, all on cache", sequential, all_on_cache));
+  run(run_case("parallel, all on cache", parallel, all_on_cache));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "cache-aware runtime gate tests passed\n";
+  return EXIT_SUCCESS;
+}
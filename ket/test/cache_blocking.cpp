@@ -0,0 +1,147 @@
+// Tests ket::gate::for_each_cache_block: runs of gates applied block by block give the same state as gates applied one by one
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <ket/qubit.hpp>
+#include <ket/control.hpp>
+#include <ket/gate/hadamard.hpp>
+#include <ket/gate/exponential_pauli_x.hpp>
+#include <ket/gate/cache_blocking.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using layout_type = ket::gate::cache_block_layout<state_integer_type, bit_integer_type>;
+
+  auto random_number_generator = std::mt19937_64{20240917u};
+
+  auto make_random_values(std::size_t const size) -> std::vector<complex_type>
+  {
+    auto distribution = std::normal_distribution<double>{};
+    auto result = std::vector<complex_type>(size);
+    for (auto& value: result)
+      value = complex_type{distribution(random_number_generator), distribution(random_number_generator)};
+    return result;
+  }
+
+  // gates[i] = {target qubit, control qubit}, where control qubit == target qubit means no control qubit
+  using gate_type = std::pair<bit_integer_type, bit_integer_type>;
+
+  template <typename Iterator>
+  auto apply_gates(Iterator const first, Iterator const last, std::vector<gate_type> const& gates, layout_type const* layout_ptr) -> void
+  {
+    auto const to_qubit
+      = [layout_ptr](bit_integer_type const bit)
+        { return ket::make_qubit<state_integer_type>(layout_ptr == nullptr ? bit : layout_ptr->block_qubit(bit)); };
+
+    for (auto const& gate: gates)
+      if (gate.first == gate.second)
+      {
+        ket::gate::hadamard(first, last, to_qubit(gate.first));
+        ket::gate::exponential_pauli_x(first, last, 0.1 * static_cast<double>(gate.first + 1u), to_qubit(gate.first));
+      }
+      else
+        ket::gate::hadamard(first, last, to_qubit(gate.first), ket::make_control(to_qubit(gate.second)));
+  }
+
+  template <typename ParallelPolicy>
+  auto run_case(
+    std::string const& name, ParallelPolicy const parallel_policy, bit_integer_type const num_qubits, bit_integer_type const num_block_qubits,
+    std::vector<gate_type> const& gates, bool const expects_contiguous)
+  -> bool
+  {
+    auto layout = layout_type{num_block_qubits};
+    for (auto const& gate: gates)
+      if (not layout.add((state_integer_type{1u} << gate.first) bitor (state_integer_type{1u} << gate.second)))
+      {
+        std::cerr << name << " failed: gates do not fit in a block\n";
+        return false;
+      }
+
+    if (layout.is_contiguous() != expects_contiguous)
+    {
+      std::cerr << name << " failed: contiguity of blocks\n";
+      return false;
+    }
+
+    auto const initial_state = make_random_values(std::size_t{1u} << num_qubits);
+    auto expected = initial_state;
+    apply_gates(expected.begin(), expected.end(), gates, nullptr);
+
+    auto actual = initial_state;
+    auto buffer = std::vector<complex_type>(static_cast<std::size_t>(ket::utility::num_threads(parallel_policy)) << num_block_qubits);
+    ket::gate::ranges::for_each_cache_block(
+      parallel_policy, actual, layout, buffer,
+      [&gates, &layout](std::vector<complex_type>::iterator const first, std::vector<complex_type>::iterator const last)
+      { apply_gates(first, last, gates, &layout); });
+
+    for (auto index = std::size_t{0u}; index < expected.size(); ++index)
+      if (actual[index] != expected[index])
+      {
+        std::cerr << name << " failed: amplitude " << index << '\n';
+        return false;
+      }
+
+    return true;
+  }
+
+  auto check_layout(bool& failed) -> void
+  {
+    auto layout = layout_type{6u};
+    auto const check
+      = [&failed](bool const condition, std::string const& message)
+        {
+          if (condition)
+            return;
+          std::cerr << "layout failed: " << message << '\n';
+          failed = true;
+        };
+
+    check(layout.add(state_integer_type{0b10001u}), "low qubits");
+    check(layout.is_contiguous() and layout.num_low_qubits() == 6u, "low qubits are contiguous");
+    check(layout.add(state_integer_type{1u} << 9u), "one high qubit");
+    check(layout.num_low_qubits() == 5u and layout.high_qubits() == std::vector<bit_integer_type>{9u}, "qubit 5 is not operated");
+    check(layout.block_qubit(9u) == 5u and layout.block_qubit(4u) == 4u, "positions in a block");
+    check(layout.add(state_integer_type{1u} << 8u), "two high qubits");
+    check(layout.num_low_qubits() == 3u and layout.high_qubits() == (std::vector<bit_integer_type>{4u, 8u, 9u}), "qubit 4 becomes high");
+    check(not layout.add(state_integer_type{1u} << 10u), "too many qubits");
+    check(layout.num_low_qubits() == 3u and layout.high_qubits().size() == 3u, "failed addition does not change layout");
+    layout.clear();
+    check(layout.empty() and layout.is_contiguous(), "clear");
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  check_layout(failed);
+
+  auto const low_gates = std::vector<gate_type>{{0u, 0u}, {3u, 3u}, {1u, 4u}, {5u, 5u}, {2u, 0u}, {4u, 5u}, {0u, 3u}};
+  run(run_case("sequential, contiguous blocks", sequential, 10u, 6u, low_gates, true));
+  run(run_case("parallel, contiguous blocks", parallel, 11u, 6u, low_gates, true));
+
+  auto const high_gates = std::vector<gate_type>{{0u, 0u}, {9u, 9u}, {1u, 9u}, {7u, 2u}, {9u, 7u}, {3u, 3u}, {7u, 7u}};
+  run(run_case("sequential, gathered blocks", sequential, 10u, 6u, high_gates, false));
+  run(run_case("parallel, gathered blocks", parallel, 11u, 6u, high_gates, false));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "cache blocking tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/control.hpp>
+#include <ket/gate/diagonal.hpp>
+#include <ket/gate/pauli_z.hpp>
+#include <ket/gate/phase_shift.hpp>
+#include <ket/gate/controlled_phase_shift.hpp>
+#include <ket/gate/exponential_pauli_z.hpp>
+#include <ket/addition_assignment.hpp>
+#include <ket/utility/exp_i.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+  using accumulator_type = ket::gate::diagonal_accumulator<complex_type, state_integer_type>;
+
+  auto random_number_generator = std::mt19937_64{20240817u};
+
+  auto make_random_state(std::size_t const size) -> std::vector<complex_type>
+  {
+    auto distribution = std::normal_distribution<double>{};
+    auto result = std::vector<complex_type>(size);
+    for (auto& value: result)
+      value = complex_type{distribution(random_number_generator), distribution(random_number_generator)};
+    return result;
+  }
+
+  auto is_close(std::vector<complex_type> const& actual, std::vector<complex_type> const& expected) -> bool
+  {
+    for (auto index = std::size_t{0u}; index < expected.size(); ++index)
+      if (std::abs(actual[index] - expected[index]) > 1e-10 * (1.0 + std::abs(expected[index])))
+        return false;
+    return true;
+  }
+
+  auto mask(bit_integer_type const bit) -> state_integer_type
+  { return state_integer_type{1u} << bit; }
+
+  // Applies random Z, U1, CU1, CCZ, eZ and eZZ gates one by one and by an accumulator
+  template <typename ParallelPolicy>
+  auto run_gate_case(std::string const& name, ParallelPolicy const parallel_policy, bit_integer_type const num_qubits, int const num_gates)
+  -> bool
+  {
+    auto const initial_state = make_random_state(std::size_t{1u} << num_qubits);
+    auto expected = initial_state;
+    auto accumulator = accumulator_type{};
+
+    auto bit_distribution = std::uniform_int_distribution<bit_integer_type>{0u, num_qubits - 1u};
+    auto phase_distribution = std::uniform_real_distribution<double>{-3.0, 3.0};
+    auto const random_bits
+      = [&bit_distribution](std::size_t const num_bits)
+        {
+          auto result = std::vector<bit_integer_type>{};
+          while (result.size() < num_bits)
+          {
+            auto const bit = bit_distribution(random_number_generator);
+            if (std::find(result.begin(), result.end(), bit) == result.end())
+              result.push_back(bit);
+          }
+          return result;
+        };
+
+    for (auto gate_index = 0; gate_index < num_gates; ++gate_index)
+    {
+      auto const phase = phase_distribution(random_number_generator);
+      switch (gate_index % 6)
+      {
+       case 0:
+       {
+        auto const bits = random_bits(1u);
+        ket::gate::ranges::pauli_z(parallel_policy, expected, ket::make_control(ket::make_qubit<state_integer_type>(bits[0])));
+        accumulator.add_phase(complex_type{-1.0}, mask(bits[0]));
+        break;
+       }
+       case 1:
+       {
+        auto const bits = random_bits(1u);
+        ket::gate::ranges::phase_shift_coeff(
+          parallel_policy, expected, ket::utility::exp_i<complex_type>(phase), ket::make_control(ket::make_qubit<state_integer_type>(bits[0])));
+        accumulator.add_phase(ket::utility::exp_i<complex_type>(phase), mask(bits[0]));
+        break;
+       }
+       case 2:
+       {
+        auto const bits = random_bits(2u);
+        ket::gate::ranges::controlled_phase_shift_coeff(
+          parallel_policy, expected, ket::utility::exp_i<complex_type>(phase),
+          ket::make_control(ket::make_qubit<state_integer_type>(bits[0])), ket::make_control(ket::make_qubit<state_integer_type>(bits[1])));
+        accumulator.add_phase(ket::utility::exp_i<complex_type>(phase), mask(bits[0]) | mask(bits[1]));
+        break;
+       }
+       case 3:
+       {
+        auto const bits = random_bits(3u);
+        ket::gate::ranges::pauli_z(
+          parallel_policy, expected,
+          ket::make_control(ket::make_qubit<state_integer_type>(bits[0])), ket::make_control(ket::make_qubit<state_integer_type>(bits[1])),
+          ket::make_control(ket::make_qubit<state_integer_type>(bits[2])));
+        accumulator.add_phase(complex_type{-1.0}, mask(bits[0]) | mask(bits[1]) | mask(bits[2]));
+        break;
+       }
+       case 4:
+       {
+        auto const bits = random_bits(1u);
+        ket::gate::ranges::exponential_pauli_z(parallel_policy, expected, phase, ket::make_qubit<state_integer_type>(bits[0]));
+        accumulator.add_parity_phase(ket::utility::exp_i<complex_type>(phase), ket::utility::exp_i<complex_type>(-phase), mask(bits[0]));
+        break;
+       }
+       default:
+       {
+        auto const bits = random_bits(2u);
+        ket::gate::ranges::exponential_pauli_z(
+          parallel_policy, expected, phase, ket::make_qubit<state_integer_type>(bits[0]), ket::make_qubit<state_integer_type>(bits[1]));
+        accumulator.add_parity_phase(
+          ket::utility::exp_i<complex_type>(phase), ket::utility::exp_i<complex_type>(-phase), mask(bits[0]) | mask(bits[1]));
+        break;
+       }
+      }
+    }
+
+    auto actual = initial_state;
+    ket::gate::ranges::diagonal(parallel_policy, actual, accumulator);
+    if (not is_close(actual, expected))
+    {
+      std::cerr << name << " failed: diagonal gates\n";
+      return false;
+    }
+
+    return true;
+  }
+
+  // |a>|b> => |a+b mod 2^n>|b>, where lhs qubits are the lower n qubits
+  template <typename ParallelPolicy>
+  auto run_addition_case(std::string const& name, ParallelPolicy const parallel_policy, bit_integer_type const register_size) -> bool
+  {
+    auto lhs_qubits = std::vector<qubit_type>{};
+    auto rhs_qubits = std::vector<qubit_type>{};
+    for (auto bit = bit_integer_type{0u}; bit < register_size; ++bit)
+    {
+      lhs_qubits.push_back(ket::make_qubit<state_integer_type>(bit));
+      rhs_qubits.push_back(ket::make_qubit<state_integer_type>(bit + register_size));
+    }
+    auto const rhs_qubits_range = std::vector<std::vector<qubit_type>>{rhs_qubits};
+
+    auto const num_values = state_integer_type{1u} << register_size;
+    for (auto const lhs_value: {state_integer_type{0u}, state_integer_type{1u}, num_values / 2u + 1u, num_values - 1u})
+      for (auto const rhs_value: {state_integer_type{0u}, state_integer_type{3u} % num_values, num_values - 1u})
+      {
+        auto state = std::vector<complex_type>(std::size_t{1u} << (2u * register_size));
+        state[(rhs_value << register_size) | lhs_value] = complex_type{1.0};
+
+        ket::addition_assignment(parallel_policy, state.begin(), state.end(), lhs_qubits, rhs_qubits_range);
+        auto const expected_index = (rhs_value << register_size) | ((lhs_value + rhs_value) % num_values);
+        if (std::abs(std::abs(state[expected_index]) - 1.0) > 1e-10)
+        {
+          std::cerr << name << " failed: " << lhs_value << " + " << rhs_value << '\n';
+          return false;
+        }
+
+        ket::adj_addition_assignment(parallel_policy, state.begin(), state.end(), lhs_qubits, rhs_qubits_range);
+        if (std::abs(state[(rhs_value << register_size) | lhs_value] - complex_type{1.0}) > 1e-10)
+        {
+          std::cerr << name << " failed: (" << lhs_value << " + " << rhs_value << ") - " << rhs_value << '\n';
+          return false;
+        }
+      }
+
+    return true;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  run(run_gate_case("sequential, 4 qubits", sequential, 4u, 30));
+  run(run_gate_case("sequential, 13 qubits", sequential, 13u, 100));
+  run(run_gate_case("parallel, 14 qubits", parallel, 14u, 200));
+  run(run_addition_case("sequential, 3+3 qubits", sequential, 3u));
+  run(run_addition_case("parallel, 6+6 qubits", parallel, 6u));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "diagonal gate tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+// Tests ket::utility::first_touch_allocator with zero-filling by ket::utility::fill.
+// Build also with -DKET_USE_TRANSPARENT_HUGE_PAGES or -DKET_USE_HUGETLBFS to test allocations on huge pages
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+#include <ket/utility/first_touch_allocator.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using allocator_type = ket::utility::first_touch_allocator<complex_type>;
+  using data_type = std::vector<complex_type, allocator_type>;
+
+  auto check(bool const condition, std::string const& message, bool& failed) -> void
+  {
+    if (condition)
+      return;
+
+    std::cerr << "failed: " << message << '\n';
+    failed = true;
+  }
+
+  auto test_fill(unsigned int const max_num_threads, bool& failed) -> void
+  {
+    auto const parallel_policy = ket::utility::policy::make_parallel(max_num_threads);
+    auto const num_threads = std::to_string(ket::utility::num_threads(parallel_policy));
+
+    // 2^18 amplitudes occupy 4 MiB, which is on huge pages if they are enabled
+    for (auto const num_qubits: {0u, 3u, 10u, 18u})
+    {
+      auto data = data_type(std::size_t{1u} << num_qubits);
+      ket::utility::ranges::fill(parallel_policy, data, complex_type{0.0});
+      data[data.size() / 2u] = complex_type{1.0};
+
+      check(
+        std::count(data.begin(), data.end(), complex_type{0.0}) == static_cast<std::ptrdiff_t>(data.size()) - 1
+          and data[data.size() / 2u] == complex_type{1.0},
+        "filling " + std::to_string(num_qubits) + " qubits with " + num_threads + " threads", failed);
+
+      // copies and growth keep values of elements
+      auto copied_data = data;
+      copied_data.resize(data.size() * 2u, complex_type{2.0});
+      check(
+        std::equal(data.begin(), data.end(), copied_data.begin())
+          and std::all_of(
+                copied_data.begin() + data.size(), copied_data.end(),
+                [](complex_type const& value) { return value == complex_type{2.0}; }),
+        "copying and resizing " + std::to_string(num_qubits) + " qubits", failed);
+    }
+  }
+
+  auto test_alignment(bool& failed) -> void
+  {
+#ifdef KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+    auto const data = data_type(std::size_t{1u} << 18u);
+    check(
+      reinterpret_cast<std::uintptr_t>(data.data()) % std::uintptr_t{KET_HUGE_PAGE_SIZE} == 0u,
+      "large allocations are aligned to huge pages", failed);
+#endif // KET_FIRST_TOUCH_ALLOCATOR_USES_HUGE_PAGES
+
+    auto const small_data = data_type(std::size_t{4u});
+    check(
+      reinterpret_cast<std::uintptr_t>(small_data.data()) % alignof(complex_type) == 0u,
+      "small allocations are aligned to elements", failed);
+  }
+
+  // Only trivially copyable elements are left uninitialized by default construction
+  auto test_nontrivial_elements(bool& failed) -> void
+  {
+    using rebound_allocator_type = typename allocator_type::template rebind<std::string>::other;
+    static_assert(std::is_same<rebound_allocator_type, ket::utility::first_touch_allocator<std::string>>::value, "rebind");
+
+    auto strings = std::vector<std::string, rebound_allocator_type>(10u);
+    check(
+      std::all_of(strings.begin(), strings.end(), [](std::string const& string) { return string.empty(); }),
+      "strings are default-constructed", failed);
+    check(rebound_allocator_type{} == allocator_type{}, "allocators are always equal", failed);
+  }
+} // namespace
+
+int main()
+{
+  auto failed = false;
+  for (auto const max_num_threads: {1u, 2u, 4u})
+    test_fill(max_num_threads, failed);
+  test_alignment(failed);
+  test_nontrivial_elements(failed);
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "first_touch_allocator tests passed\n";
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ket/generate_events.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+#include <ket/utility/positive_random_value_upto.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using real_type = double;
+  using state_integer_type = std::uint64_t;
+  using random_number_generator_type = std::mt19937_64;
+
+  constexpr auto num_events = 1000;
+  constexpr auto seed = random_number_generator_type::result_type{20240601u};
+
+  // Amplitudes are dyadic rationals so that all partial sums of probabilities are exact
+  auto make_state(std::size_t const state_size) -> std::vector<complex_type>
+  {
+    auto result = std::vector<complex_type>(state_size);
+    for (auto index = std::size_t{0u}; index < result.size(); ++index)
+      result[index] = complex_type{
+        0.0625 * static_cast<double>((index * 5u + 3u) % 17u),
+        -0.03125 * static_cast<double>((index * 7u + 1u) % 13u)};
+    return result;
+  }
+
+  // Events are generated in the same way as the original destructive implementation
+  auto expected_events(std::vector<complex_type> state) -> std::vector<state_integer_type>
+  {
+    auto probability = real_type{0};
+    for (auto& value: state)
+    {
+      probability += std::norm(value);
+      value = complex_type{probability};
+    }
+
+    auto random_number_generator = random_number_generator_type{seed};
+    auto result = std::vector<state_integer_type>{};
+    for (auto event_index = 0; event_index < num_events; ++event_index)
+    {
+      auto const random_value
+        = ket::utility::positive_random_value_upto(probability, random_number_generator);
+      auto const found
+        = std::upper_bound(
+            state.begin(), state.end(), complex_type{random_value},
+            [](complex_type const& lhs, complex_type const& rhs) { return lhs.real() < rhs.real(); });
+      result.push_back(static_cast<state_integer_type>(found - state.begin()));
+    }
+
+    return result;
+  }
+
+  template <typename ParallelPolicy>
+  auto run_case(std::string const& name, ParallelPolicy const parallel_policy, std::size_t const state_size) -> bool
+  {
+    auto const state = make_state(state_size);
+    auto state_copy = state;
+
+    auto random_number_generator = random_number_generator_type{seed};
+    auto actual = std::vector<state_integer_type>{};
+    ket::generate_events(parallel_policy, actual, state_copy.begin(), state_copy.end(), num_events, random_number_generator);
+
+    auto passed = true;
+    if (state_copy != state)
+    {
+      std::cerr << name << " failed: the state is modified\n";
+      passed = false;
+    }
+
+    auto const expected = expected_events(state);
+    for (auto event_index = 0; event_index < num_events; ++event_index)
+      if (actual[event_index] != expected[event_index])
+      {
+        std::cerr
+          << name << " failed: event " << event_index
+          << ": actual = " << actual[event_index] << ", expected = " << expected[event_index] << '\n';
+        passed = false;
+        break;
+      }
+
+    return passed;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  run(run_case("sequential, 4 qubits", sequential, std::size_t{1u} << 4u));
+  run(run_case("sequential, 12 qubits", sequential, std::size_t{1u} << 12u));
+  run(run_case("parallel, 12 qubits", parallel, std::size_t{1u} << 12u));
+  run(run_case("parallel, 13 qubits", parallel, std::size_t{1u} << 13u));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "non-MPI generate_events tests passed\n";
+  return EXIT_SUCCESS;
+}
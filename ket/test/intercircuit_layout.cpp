@@ -0,0 +1,162 @@
+// Tests ket::mpi::utility::detail::intercircuit_layout: amplitudes streamed from sender processes to receiver processes
+// give the inner product of two states distributed with different qubit permutations
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/mpi/qubit_permutation.hpp>
+#include <ket/mpi/utility/detail/intercircuit_layout.hpp>
+
+namespace
+{
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using complex_type = std::complex<double>;
+  using permutation_type = ket::mpi::qubit_permutation<state_integer_type, bit_integer_type>;
+
+  auto check(bool const condition, std::string const& message, bool& failed) -> void
+  {
+    if (condition)
+      return;
+
+    std::cerr << "failed: " << message << '\n';
+    failed = true;
+  }
+
+  auto make_state(bit_integer_type const num_qubits, double const phase) -> std::vector<complex_type>
+  {
+    auto result = std::vector<complex_type>(state_integer_type{1u} << num_qubits);
+    for (auto index = state_integer_type{0u}; index < result.size(); ++index)
+      result[index] = std::polar(1.0 + 0.1 * static_cast<double>(index), phase * static_cast<double>(index * index));
+    return result;
+  }
+
+  // local_states[rank][local_index]
+  auto distribute(
+    std::vector<complex_type> const& state, std::vector<bit_integer_type> const& positions, bit_integer_type const num_local_qubits)
+  -> std::vector<std::vector<complex_type>>
+  {
+    auto const num_qubits = static_cast<bit_integer_type>(positions.size());
+    auto result
+      = std::vector<std::vector<complex_type>>(
+          state_integer_type{1u} << (num_qubits - num_local_qubits),
+          std::vector<complex_type>(state_integer_type{1u} << num_local_qubits));
+    for (auto index = state_integer_type{0u}; index < state.size(); ++index)
+    {
+      auto permutated_index = state_integer_type{0u};
+      for (auto qubit = bit_integer_type{0u}; qubit < num_qubits; ++qubit)
+        permutated_index |= ((index >> qubit) bitand state_integer_type{1u}) << positions[qubit];
+
+      result[permutated_index >> num_local_qubits][permutated_index bitand ((state_integer_type{1u} << num_local_qubits) - 1u)] = state[index];
+    }
+    return result;
+  }
+
+  auto test(
+    permutation_type const& sender_permutation, permutation_type const& receiver_permutation,
+    bit_integer_type const num_local_qubits, std::string const& name, bool& failed)
+  -> void
+  {
+    auto const num_qubits = static_cast<bit_integer_type>(sender_permutation.size());
+    auto const sender_state = make_state(num_qubits, 0.3);
+    auto const receiver_state = make_state(num_qubits, -0.7);
+    auto expected = complex_type{};
+    for (auto index = state_integer_type{0u}; index < sender_state.size(); ++index)
+      expected += std::conj(sender_state[index]) * receiver_state[index];
+
+    auto const sender_positions = ket::mpi::utility::detail::permutated_positions(sender_permutation);
+    auto const receiver_positions = ket::mpi::utility::detail::permutated_positions(receiver_permutation);
+    auto const sender_local_states = distribute(sender_state, sender_positions, num_local_qubits);
+    auto const receiver_local_states = distribute(receiver_state, receiver_positions, num_local_qubits);
+
+    auto const layout
+      = ket::mpi::utility::detail::intercircuit_layout<state_integer_type, bit_integer_type>{
+          sender_positions, receiver_positions, num_local_qubits};
+    auto const num_processes = static_cast<state_integer_type>(sender_local_states.size());
+
+    // streams[sender_rank][receiver_rank]: amplitudes in the order of sending
+    auto streams = std::vector<std::vector<std::vector<complex_type>>>(num_processes, std::vector<std::vector<complex_type>>(num_processes));
+    for (auto sender_rank = state_integer_type{0u}; sender_rank < num_processes; ++sender_rank)
+    {
+      auto previous_receiver_rank = state_integer_type{0u};
+      for (auto partner_index = state_integer_type{0u}; partner_index < layout.num_partners(); ++partner_index)
+      {
+        auto const receiver_rank = layout.receiver_rank(sender_rank, partner_index);
+        check(
+          partner_index == 0u or receiver_rank > previous_receiver_rank,
+          name + ": receivers are enumerated in increasing order", failed);
+        previous_receiver_rank = receiver_rank;
+
+        auto const partner_bits = layout.sender_partner_bits(partner_index);
+        for (auto index = state_integer_type{0u}; index < layout.num_elements_per_partner(); ++index)
+          streams[sender_rank][receiver_rank].push_back(sender_local_states[sender_rank][layout.packed_index(index) bitor partner_bits]);
+      }
+    }
+
+    auto result = complex_type{};
+    auto num_received_elements = state_integer_type{0u};
+    for (auto receiver_rank = state_integer_type{0u}; receiver_rank < num_processes; ++receiver_rank)
+      for (auto partner_index = state_integer_type{0u}; partner_index < layout.num_partners(); ++partner_index)
+      {
+        auto const sender_rank = layout.sender_rank(receiver_rank, partner_index);
+        auto const& stream = streams[sender_rank][receiver_rank];
+        check(stream.size() == layout.num_elements_per_partner(), name + ": receivers agree with senders on partners", failed);
+        if (stream.size() != layout.num_elements_per_partner())
+          continue;
+
+        auto const constant_bits = layout.receiver_constant_bits(sender_rank);
+        for (auto index = state_integer_type{0u}; index < stream.size(); ++index)
+          result += std::conj(stream[index]) * receiver_local_states[receiver_rank][layout.translated_index(index) bitor constant_bits];
+        num_received_elements += static_cast<state_integer_type>(stream.size());
+      }
+
+    check(num_received_elements == sender_state.size(), name + ": all amplitudes are received", failed);
+    check(std::abs(result - expected) < 1.0e-9 * std::abs(expected), name + ": inner product", failed);
+  }
+}
+
+int main()
+{
+  auto failed = false;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+
+  auto const identity = permutation_type(6u);
+  test(identity, identity, 4u, "identical layouts", failed);
+
+  auto local_swapped = identity;
+  local_swapped.permutate(qubit_type{0u}, qubit_type{3u});
+  local_swapped.permutate(qubit_type{1u}, qubit_type{2u});
+  test(identity, local_swapped, 4u, "permutated local qubits", failed);
+
+  auto global_swapped = identity;
+  global_swapped.permutate(qubit_type{4u}, qubit_type{5u});
+  test(global_swapped, identity, 4u, "permutated global qubits", failed);
+
+  auto mixed = identity;
+  mixed.permutate(qubit_type{1u}, qubit_type{5u});
+  auto other_mixed = identity;
+  other_mixed.permutate(qubit_type{0u}, qubit_type{4u});
+  other_mixed.permutate(qubit_type{2u}, qubit_type{3u});
+  test(mixed, other_mixed, 4u, "one qubit is global only in each circuit", failed);
+  test(identity, mixed, 3u, "one qubit is global only in the receiver circuit", failed);
+
+  auto exchanged = identity;
+  exchanged.permutate(qubit_type{0u}, qubit_type{4u});
+  exchanged.permutate(qubit_type{1u}, qubit_type{5u});
+  test(exchanged, identity, 4u, "all global qubits are local in the other circuit", failed);
+
+  auto wide = permutation_type(10u);
+  wide.permutate(qubit_type{2u}, qubit_type{9u});
+  wide.permutate(qubit_type{8u}, qubit_type{0u});
+  test(permutation_type(10u), wide, 9u, "more than one byte of local qubits", failed);
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "intercircuit layout tests passed\n";
+}
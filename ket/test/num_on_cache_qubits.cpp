@@ -0,0 +1,124 @@
+// Tests ket::utility::num_on_cache_qubits: gates give the same state for any number of on-cache qubits given at runtime
+// (meaningful if KET_ENABLE_CACHE_AWARE_GATE_FUNCTION is defined)
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/control.hpp>
+#include <ket/gate/hadamard.hpp>
+#include <ket/gate/pauli_x.hpp>
+#include <ket/gate/exponential_pauli_x.hpp>
+#include <ket/utility/num_on_cache_qubits.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+
+  auto random_number_generator = std::mt19937_64{20241001u};
+
+  auto make_random_values(std::size_t const size) -> std::vector<complex_type>
+  {
+    auto distribution = std::normal_distribution<double>{};
+    auto result = std::vector<complex_type>(size);
+    for (auto& value: result)
+      value = complex_type{distribution(random_number_generator), distribution(random_number_generator)};
+    return result;
+  }
+
+  // gates[i] = {target qubit, control qubit}, where control qubit == target qubit means no control qubit
+  using gate_type = std::pair<bit_integer_type, bit_integer_type>;
+
+  template <typename ParallelPolicy>
+  auto apply_gates(ParallelPolicy const parallel_policy, std::vector<complex_type>& state, std::vector<gate_type> const& gates) -> void
+  {
+    for (auto const& gate: gates)
+    {
+      auto const target_qubit = ket::make_qubit<state_integer_type>(gate.first);
+      if (gate.first == gate.second)
+      {
+        ket::gate::ranges::hadamard(parallel_policy, state, target_qubit);
+        ket::gate::ranges::exponential_pauli_x(parallel_policy, state, 0.1 * static_cast<double>(gate.first + 1u), target_qubit);
+      }
+      else
+      {
+        auto const control_qubit = ket::make_control(ket::make_qubit<state_integer_type>(gate.second));
+        ket::gate::ranges::pauli_x(parallel_policy, state, target_qubit, control_qubit);
+        ket::gate::ranges::hadamard(parallel_policy, state, target_qubit, control_qubit);
+      }
+    }
+  }
+
+  template <typename ParallelPolicy>
+  auto run_case(std::string const& name, ParallelPolicy const parallel_policy, bit_integer_type const num_qubits, unsigned int const num_on_cache_qubits)
+  -> bool
+  {
+    auto bit_distribution = std::uniform_int_distribution<bit_integer_type>{0u, num_qubits - 1u};
+    auto gates = std::vector<gate_type>{};
+    for (auto index = 0; index < 40; ++index)
+      gates.emplace_back(bit_distribution(random_number_generator), bit_distribution(random_number_generator));
+
+    auto const initial_state = make_random_values(std::size_t{1u} << num_qubits);
+
+    // The whole state vector is on cache
+    ket::utility::set_num_on_cache_qubits(num_qubits);
+    auto expected = initial_state;
+    apply_gates(parallel_policy, expected, gates);
+
+    ket::utility::set_num_on_cache_qubits(num_on_cache_qubits);
+    auto actual = initial_state;
+    apply_gates(parallel_policy, actual, gates);
+
+    for (auto index = std::size_t{0u}; index < expected.size(); ++index)
+      if (std::abs(actual[index] - expected[index]) > 1e-10 * (1.0 + std::abs(expected[index])))
+      {
+        std::cerr << name << " failed: amplitude " << index << '\n';
+        return false;
+      }
+
+    return true;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  if (ket::utility::num_on_cache_qubits() != KET_DEFAULT_NUM_ON_CACHE_QUBITS)
+  {
+    std::cerr << "initial value failed\n";
+    failed = true;
+  }
+
+  for (auto const num_on_cache_qubits: {3u, 4u, 6u, 9u})
+  {
+    auto const suffix = ", " + std::to_string(num_on_cache_qubits) + " on-cache qubits";
+    run(run_case("sequential" + suffix, sequential, 10u, num_on_cache_qubits));
+    run(run_case("parallel" + suffix, parallel, 10u, num_on_cache_qubits));
+  }
+
+  auto const tuned_num_on_cache_qubits = ket::utility::tune_num_on_cache_qubits<complex_type>(8u, 12u);
+  if (tuned_num_on_cache_qubits < 8u or tuned_num_on_cache_qubits > 12u)
+  {
+    std::cerr << "tuning failed: " << tuned_num_on_cache_qubits << '\n';
+    failed = true;
+  }
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "num_on_cache_qubits tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+// Tests the three loops of ket::utility::loop_n with the parallel policy: noexcept functions,
+// ket::utility::independent_loop_function, and functions which may throw
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  auto check(bool const condition, std::string const& message, bool& failed) -> void
+  {
+    if (condition)
+      return;
+
+    std::cerr << "failed: " << message << '\n';
+    failed = true;
+  }
+}
+
+int main()
+{
+  auto failed = false;
+  auto const parallel_policy = ket::utility::policy::make_parallel<int>();
+
+  for (auto const n: {0, 1, 3, 255, 256, 257, 4097, 100000})
+  {
+    auto counts = std::vector<int>(n);
+    ket::utility::loop_n(parallel_policy, n, [&counts](int const count, int const) noexcept { ++counts[count]; });
+    ket::utility::loop_n(
+      parallel_policy, n,
+      ket::utility::make_independent_loop_function([&counts](int const count, int const) { ++counts[count]; }));
+    ket::utility::loop_n(parallel_policy, n, [&counts](int const count, int const) { ++counts[count]; });
+
+    auto is_visited_once_each = true;
+    for (auto const count: counts)
+      if (count != 3)
+        is_visited_once_each = false;
+    check(is_visited_once_each, "each count is visited once by each loop (n = " + std::to_string(n) + ")", failed);
+  }
+
+  auto is_caught = false;
+  try
+  {
+    ket::utility::loop_n(
+      parallel_policy, 1000,
+      [](int const count, int const)
+      {
+        if (count == 500)
+          throw std::runtime_error{"error in loop_n"};
+      });
+  }
+  catch (std::exception const&)
+  {
+    is_caught = true;
+  }
+  check(is_caught, "exception thrown by function is rethrown", failed);
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "parallel loop_n tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <ket/gate/utility/pauli_index_coeff.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+
+  constexpr auto num_qubits = 4u;
+
+  // All 4^num_qubits Pauli strings are generated from base-4 digits
+  auto make_pauli_string(unsigned int code) -> std::string
+  {
+    auto result = std::string(num_qubits, 'I');
+    for (auto& character: result)
+    {
+      character = "IXYZ"[code % 4u];
+      code /= 4u;
+    }
+    return result;
+  }
+}
+
+int main()
+{
+  auto const scalar = complex_type{0.75, -0.5};
+
+  auto failed = false;
+  for (auto code = 0u; code < (1u << (2u * num_qubits)); ++code)
+  {
+    auto const pauli_string = make_pauli_string(code);
+    auto const masks = ket::gate::utility::make_pauli_masks<state_integer_type>(pauli_string, scalar);
+
+    for (auto index = state_integer_type{0u}; index < (state_integer_type{1u} << num_qubits); ++index)
+    {
+      auto const expected = ket::gate::utility::pauli_index_coeff<complex_type>(pauli_string, index);
+      auto const actual = ket::gate::utility::pauli_index_coeff<complex_type>(masks, index);
+
+      if (actual.first != expected.first or std::abs(actual.second - scalar * expected.second) > 1e-15)
+      {
+        std::cerr
+          << pauli_string << " failed: index = " << index
+          << ": actual = (" << actual.first << ", " << actual.second << ")"
+          << ", expected = (" << expected.first << ", " << scalar * expected.second << ")\n";
+        failed = true;
+      }
+    }
+  }
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "Pauli masks tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+// Tests ket::utility::profiler and ket::utility::profile_guard: counters are kept only while enabled,
+// guards switch the active phase and feed its counter, and counters are accumulated until they are taken.
+// Measured durations are not compared with each other because they depend on the machine
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <ket/utility/profiler.hpp>
+
+namespace
+{
+  auto check(bool const condition, std::string const& message, bool& failed) -> void
+  {
+    if (condition)
+      return;
+
+    std::cerr << "failed: " << message << '\n';
+    failed = true;
+  }
+
+  // makes a guard alive at this point measure a positive time without depending on how long it takes
+  auto wait_for_clock_tick() -> void
+  {
+    auto const start_time = ket::utility::profiler::clock_type::now();
+    while (ket::utility::profiler::clock_type::now() == start_time)
+      ;
+  }
+}
+
+int main()
+{
+  auto failed = false;
+  auto& profiler = ket::utility::profiler::instance();
+  constexpr auto interchange = static_cast<int>(ket::utility::profile_phase::interchange);
+  constexpr auto barrier = static_cast<int>(ket::utility::profile_phase::barrier);
+
+  {
+    ket::utility::profile_guard guard{ket::utility::profile_phase::interchange};
+    check(profiler.active_phase() == ket::utility::profile_phase::none, "no phase is active while disabled", failed);
+    profiler.add_moved_bytes(std::uint64_t{16u});
+    wait_for_clock_tick();
+  }
+  auto const disabled_counters = profiler.take();
+  check(
+    disabled_counters.seconds[interchange] == 0.0 and disabled_counters.seconds[barrier] == 0.0 and disabled_counters.num_moved_bytes == 0u,
+    "nothing is counted while disabled", failed);
+
+  profiler.enable();
+  {
+    ket::utility::profile_guard interchange_guard{ket::utility::profile_phase::interchange};
+    check(profiler.active_phase() == ket::utility::profile_phase::interchange, "the interchange is active", failed);
+    profiler.add_moved_bytes(std::uint64_t{16u});
+    wait_for_clock_tick();
+    {
+      ket::utility::profile_guard barrier_guard{ket::utility::profile_phase::barrier};
+      check(profiler.active_phase() == ket::utility::profile_phase::barrier, "the nested barrier is active", failed);
+      wait_for_clock_tick();
+    }
+    check(profiler.active_phase() == ket::utility::profile_phase::interchange, "the interchange is active again", failed);
+    {
+      ket::utility::profile_guard none_guard{ket::utility::profile_phase::none};
+      check(profiler.active_phase() == ket::utility::profile_phase::interchange, "a guard of no phase keeps the active phase", failed);
+      profiler.add_moved_bytes(std::uint64_t{32u});
+    }
+  }
+  check(profiler.active_phase() == ket::utility::profile_phase::none, "the phase is restored", failed);
+
+  auto const counters = profiler.take();
+  check(counters.num_moved_bytes == 48u, "moved bytes are summed up", failed);
+  check(counters.seconds[barrier] > 0.0, "the nested barrier is counted", failed);
+  // The time of the interchange guard includes a clock tick outside the nested barrier
+  check(counters.seconds[interchange] > 0.0, "the interchange except for the nested barrier is counted", failed);
+
+  auto const taken_counters = profiler.take();
+  check(
+    taken_counters.seconds[interchange] == 0.0 and taken_counters.seconds[barrier] == 0.0 and taken_counters.num_moved_bytes == 0u,
+    "counters are reset by take", failed);
+
+  for (auto count = 0; count < 3; ++count)
+  {
+    profiler.add(ket::utility::profile_phase::barrier, 0.25);
+    profiler.add_moved_bytes(std::uint64_t{8u});
+  }
+  profiler.add(ket::utility::profile_phase::interchange, 0.5);
+  auto const accumulated_counters = profiler.take();
+  check(
+    accumulated_counters.seconds[barrier] == 0.75 and accumulated_counters.seconds[interchange] == 0.5 and accumulated_counters.num_moved_bytes == 24u,
+    "counters are accumulated until they are taken", failed);
+
+  {
+    ket::utility::profile_guard barrier_guard{ket::utility::profile_phase::barrier};
+    profiler.disable();
+    wait_for_clock_tick();
+  }
+  check(profiler.take().seconds[barrier] > 0.0, "a guard made while enabled is counted", failed);
+  check(profiler.active_phase() == ket::utility::profile_phase::none, "the phase is restored after disabled", failed);
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "profiler tests passed\n";
+}
@@ -0,0 +1,137 @@
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/shor_box.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+
+  // The serial recurrence over all exponents, which ket::shor_box used before
+  auto make_reference(
+    bit_integer_type const num_qubits, state_integer_type const base, state_integer_type const divisor,
+    std::vector<qubit_type> const& exponent_qubits, std::vector<qubit_type> const& modular_exponentiation_qubits)
+  -> std::vector<complex_type>
+  {
+    auto result = std::vector<complex_type>(std::size_t{1u} << num_qubits);
+    auto const num_exponent_qubits = static_cast<bit_integer_type>(exponent_qubits.size());
+    auto const num_exponents = state_integer_type{1u} << num_exponent_qubits;
+    auto modular_exponentiation_value = state_integer_type{1u};
+    for (auto exponent = state_integer_type{0u}; exponent < num_exponents; ++exponent)
+    {
+      auto const index
+        = ket::shor_box_detail::calculate_index(
+            ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
+            modular_exponentiation_value, modular_exponentiation_qubits);
+      result[index] = complex_type{std::pow(static_cast<double>(num_exponents), -0.5)};
+
+      modular_exponentiation_value *= base;
+      modular_exponentiation_value %= divisor;
+    }
+    return result;
+  }
+
+  template <typename ParallelPolicy>
+  auto run_case(
+    std::string const& name, ParallelPolicy const parallel_policy,
+    bit_integer_type const num_exponent_qubits, bit_integer_type const num_modular_exponentiation_qubits,
+    state_integer_type const base, state_integer_type const divisor)
+  -> bool
+  {
+    auto passed = true;
+    auto const num_qubits = num_exponent_qubits + num_modular_exponentiation_qubits;
+
+    auto exponent_qubits = std::vector<qubit_type>(num_exponent_qubits);
+    std::iota(exponent_qubits.begin(), exponent_qubits.end(), qubit_type{num_modular_exponentiation_qubits});
+    auto modular_exponentiation_qubits = std::vector<qubit_type>(num_modular_exponentiation_qubits);
+    std::iota(modular_exponentiation_qubits.begin(), modular_exponentiation_qubits.end(), qubit_type{0u});
+
+    auto const expected = make_reference(num_qubits, base, divisor, exponent_qubits, modular_exponentiation_qubits);
+
+    auto actual = std::vector<complex_type>(expected.size(), complex_type{1.0});
+    ket::ranges::shor_box(parallel_policy, actual, base, divisor, exponent_qubits, modular_exponentiation_qubits);
+    if (actual != expected)
+    {
+      std::cerr << name << " failed: shor_box\n";
+      passed = false;
+    }
+
+    // Exponents are enumerated as ket::mpi::shor_box does when the two lowest exponent bits are fixed by the rank
+    auto const modular_squares = ket::shor_box_detail::make_modular_squares(base, divisor, num_exponent_qubits);
+    auto const num_exponents = state_integer_type{1u} << num_exponent_qubits;
+    auto const fixed_mask = state_integer_type{3u} & (num_exponents - state_integer_type{1u});
+    auto reference_values = std::vector<state_integer_type>(num_exponents);
+    auto reference_value = state_integer_type{1u};
+    for (auto& value: reference_values)
+    {
+      value = reference_value;
+      reference_value = (reference_value * base) % divisor;
+    }
+
+    auto counts = std::vector<int>(num_exponents);
+    for (auto pattern = state_integer_type{0u}; pattern <= fixed_mask; ++pattern)
+    {
+      if ((pattern & fixed_mask) != pattern)
+        continue;
+
+      ket::shor_box_detail::for_each_modular_exponentiation(
+        ket::utility::policy::make_sequential(), modular_squares, divisor,
+        pattern, (num_exponents - state_integer_type{1u}) & ~fixed_mask,
+        [&counts, &reference_values, &passed, &name, fixed_mask, pattern](
+          state_integer_type const exponent, state_integer_type const modular_exponentiation_value)
+        {
+          ++counts[exponent];
+          if ((exponent & fixed_mask) != pattern or modular_exponentiation_value != reference_values[exponent])
+          {
+            std::cerr << name << " failed: exponent " << exponent << " with fixed bits " << pattern << '\n';
+            passed = false;
+          }
+        });
+    }
+
+    for (auto const count: counts)
+      if (count != 1)
+      {
+        std::cerr << name << " failed: some exponents are not enumerated exactly once\n";
+        passed = false;
+        break;
+      }
+
+    return passed;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  run(run_case("sequential, 1+4 qubits", sequential, 1u, 4u, 7u, 15u));
+  run(run_case("sequential, 4+4 qubits", sequential, 4u, 4u, 7u, 15u));
+  run(run_case("sequential, 9+5 qubits", sequential, 9u, 5u, 5u, 21u));
+  run(run_case("parallel, 8+4 qubits", parallel, 8u, 4u, 2u, 15u));
+  run(run_case("parallel, 14+6 qubits", parallel, 14u, 6u, 3u, 35u));
+  run(run_case("parallel, 17+5 qubits", parallel, 17u, 5u, 11u, 21u));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "Shor box tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/gate/split/layout.hpp>
+#include <ket/gate/split/gate.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+
+  auto random_number_generator = std::mt19937_64{20240801u};
+
+  auto make_random_values(std::size_t const size) -> std::vector<complex_type>
+  {
+    auto distribution = std::normal_distribution<double>{};
+    auto result = std::vector<complex_type>(size);
+    for (auto& value: result)
+      value = complex_type{distribution(random_number_generator), distribution(random_number_generator)};
+    return result;
+  }
+
+  // Applies a dense matrix to an interleaved state vector without any trick
+  auto apply_reference(
+    std::vector<complex_type>& state, std::vector<complex_type> const& matrix, std::vector<bit_integer_type> const& bits)
+  -> void
+  {
+    auto const num_indices = std::size_t{1u} << bits.size();
+    auto operated_mask = std::size_t{0u};
+    for (auto const bit: bits)
+      operated_mask |= std::size_t{1u} << bit;
+
+    auto const old_state = state;
+    for (auto index = std::size_t{0u}; index < state.size(); ++index)
+    {
+      auto row = std::size_t{0u};
+      for (auto i = std::size_t{0u}; i < bits.size(); ++i)
+        row |= ((index >> bits[i]) & std::size_t{1u}) << i;
+
+      auto value = complex_type{};
+      for (auto column = std::size_t{0u}; column < num_indices; ++column)
+      {
+        auto column_index = index & ~operated_mask;
+        for (auto i = std::size_t{0u}; i < bits.size(); ++i)
+          column_index |= ((column >> i) & std::size_t{1u}) << bits[i];
+        value += matrix[row * num_indices + column] * old_state[column_index];
+      }
+      state[index] = value;
+    }
+  }
+
+  auto is_close(std::vector<complex_type> const& split_state, std::vector<complex_type> const& expected) -> bool
+  {
+    for (auto index = std::size_t{0u}; index < expected.size(); ++index)
+      if (std::abs(ket::gate::split::amplitude(split_state.begin(), index) - expected[index]) > 1e-10 * (1.0 + std::abs(expected[index])))
+        return false;
+    return true;
+  }
+
+  template <typename ParallelPolicy>
+  auto run_case(std::string const& name, ParallelPolicy const parallel_policy, bit_integer_type const num_qubits) -> bool
+  {
+    auto passed = true;
+    auto const initial_state = make_random_values(std::size_t{1u} << num_qubits);
+
+    {
+      auto state = initial_state;
+      ket::gate::split::ranges::to_split_layout(parallel_policy, state);
+      if (not is_close(state, initial_state))
+      {
+        std::cerr << name << " failed: to_split_layout\n";
+        passed = false;
+      }
+      ket::gate::split::ranges::to_interleaved_layout(parallel_policy, state);
+      if (state != initial_state)
+      {
+        std::cerr << name << " failed: to_interleaved_layout\n";
+        passed = false;
+      }
+    }
+
+    for (auto bit = bit_integer_type{0u}; bit < num_qubits; ++bit)
+    {
+      auto const values = make_random_values(4u);
+      auto matrix = std::array<complex_type, 4u>{};
+      std::copy(values.begin(), values.end(), matrix.begin());
+
+      auto expected = initial_state;
+      apply_reference(expected, values, {bit});
+
+      auto actual = initial_state;
+      ket::gate::split::ranges::to_split_layout(parallel_policy, actual);
+      ket::gate::split::ranges::gate(parallel_policy, actual, matrix, ket::make_qubit<state_integer_type>(bit));
+
+      if (not is_close(actual, expected))
+      {
+        std::cerr << name << " failed: 1-qubit gate on qubit " << bit << '\n';
+        passed = false;
+      }
+    }
+
+    for (auto bit1 = bit_integer_type{0u}; bit1 < num_qubits; ++bit1)
+      for (auto bit2 = bit_integer_type{0u}; bit2 < num_qubits; ++bit2)
+      {
+        if (bit1 == bit2)
+          continue;
+
+        auto const values = make_random_values(16u);
+        auto matrix = std::array<complex_type, 16u>{};
+        std::copy(values.begin(), values.end(), matrix.begin());
+
+        auto expected = initial_state;
+        apply_reference(expected, values, {bit1, bit2});
+
+        auto actual = initial_state;
+        ket::gate::split::ranges::to_split_layout(parallel_policy, actual);
+        ket::gate::split::ranges::gate(
+          parallel_policy, actual, matrix, ket::make_qubit<state_integer_type>(bit1), ket::make_qubit<state_integer_type>(bit2));
+
+        if (not is_close(actual, expected))
+        {
+          std::cerr << name << " failed: 2-qubit gate on qubits " << bit1 << " and " << bit2 << '\n';
+          passed = false;
+        }
+      }
+
+    return passed;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  // at least vector_width amplitudes are needed
+  run(run_case("sequential, minimum qubits", sequential, static_cast<bit_integer_type>(ket::gate::split::vector_width_bits)));
+  run(run_case("sequential, 5 qubits", sequential, 5u));
+  run(run_case("sequential, 9 qubits", sequential, 9u));
+  run(run_case("parallel, 6 qubits", parallel, 6u));
+  run(run_case("parallel, 10 qubits", parallel, 10u));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "split layout gate tests passed\n";
+  return EXIT_SUCCESS;
+}
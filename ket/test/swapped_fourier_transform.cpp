@@ -0,0 +1,133 @@
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ket/qubit.hpp>
+#include <ket/control.hpp>
+#include <ket/gate/hadamard.hpp>
+#include <ket/gate/controlled_phase_shift.hpp>
+#include <ket/swapped_fourier_transform.hpp>
+#include <ket/utility/generate_phase_coefficients.hpp>
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  using complex_type = std::complex<double>;
+  using state_integer_type = std::uint64_t;
+  using bit_integer_type = unsigned int;
+  using qubit_type = ket::qubit<state_integer_type, bit_integer_type>;
+
+  auto random_number_generator = std::mt19937_64{20241017u};
+
+  auto make_random_state(std::size_t const size) -> std::vector<complex_type>
+  {
+    auto distribution = std::normal_distribution<double>{};
+    auto result = std::vector<complex_type>(size);
+    for (auto& value: result)
+      value = complex_type{distribution(random_number_generator), distribution(random_number_generator)};
+    return result;
+  }
+
+  auto is_close(std::vector<complex_type> const& actual, std::vector<complex_type> const& expected) -> bool
+  {
+    for (auto index = std::size_t{0u}; index < expected.size(); ++index)
+      if (std::abs(actual[index] - expected[index]) > 1e-10 * (1.0 + std::abs(expected[index])))
+        return false;
+    return true;
+  }
+
+  // The circuit of H and controlled phase shifts, which ket::swapped_fourier_transform used before
+  auto apply_reference(std::vector<complex_type>& state, std::vector<qubit_type> const& qubits, bool const is_adjoint) -> void
+  {
+    auto const num_qubits = static_cast<bit_integer_type>(qubits.size());
+    auto const phase_coefficients = ket::utility::generate_phase_coefficients<complex_type>(num_qubits);
+
+    if (not is_adjoint)
+    {
+      for (auto index = bit_integer_type{0u}; index < num_qubits; ++index)
+      {
+        auto const target_bit = num_qubits - index - 1u;
+        ket::gate::hadamard(state.begin(), state.end(), qubits[target_bit]);
+        for (auto phase_exponent = bit_integer_type{2u}; phase_exponent <= num_qubits - index; ++phase_exponent)
+          ket::gate::controlled_phase_shift_coeff(
+            state.begin(), state.end(), phase_coefficients[phase_exponent],
+            ket::make_control(qubits[target_bit]), ket::make_control(qubits[target_bit - (phase_exponent - 1u)]));
+      }
+      return;
+    }
+
+    for (auto target_bit = bit_integer_type{0u}; target_bit < num_qubits; ++target_bit)
+    {
+      for (auto index = bit_integer_type{0u}; index < target_bit; ++index)
+        ket::gate::adj_controlled_phase_shift_coeff(
+          state.begin(), state.end(), phase_coefficients[1u + target_bit - index],
+          ket::make_control(qubits[target_bit]), ket::make_control(qubits[index]));
+      ket::gate::adj_hadamard(state.begin(), state.end(), qubits[target_bit]);
+    }
+  }
+
+  template <typename ParallelPolicy>
+  auto run_case(
+    std::string const& name, ParallelPolicy const parallel_policy,
+    bit_integer_type const num_qubits, std::vector<bit_integer_type> const& bits)
+  -> bool
+  {
+    auto qubits = std::vector<qubit_type>{};
+    for (auto const bit: bits)
+      qubits.push_back(ket::make_qubit<state_integer_type>(bit));
+
+    auto const initial_state = make_random_state(std::size_t{1u} << num_qubits);
+    auto passed = true;
+
+    auto expected = initial_state;
+    apply_reference(expected, qubits, false);
+    auto actual = initial_state;
+    ket::ranges::swapped_fourier_transform(parallel_policy, actual, qubits);
+    if (not is_close(actual, expected))
+    {
+      std::cerr << name << " failed: swapped_fourier_transform\n";
+      passed = false;
+    }
+
+    expected = initial_state;
+    apply_reference(expected, qubits, true);
+    actual = initial_state;
+    ket::ranges::adj_swapped_fourier_transform(parallel_policy, actual, qubits);
+    if (not is_close(actual, expected))
+    {
+      std::cerr << name << " failed: adj_swapped_fourier_transform\n";
+      passed = false;
+    }
+
+    return passed;
+  }
+}
+
+int main()
+{
+  auto const sequential = ket::utility::policy::make_sequential();
+  auto const parallel = ket::utility::policy::make_parallel(4u);
+
+  auto failed = false;
+  auto const run = [&failed](bool const passed) { failed = failed or not passed; };
+
+  run(run_case("sequential, 1 of 3 qubits", sequential, 3u, {1u}));
+  run(run_case("sequential, 6 of 6 qubits", sequential, 6u, {0u, 1u, 2u, 3u, 4u, 5u}));
+  run(run_case("sequential, 5 of 18 qubits", sequential, 18u, {13u, 14u, 15u, 16u, 17u}));
+  run(run_case("sequential, 7 of 18 qubits, scattered", sequential, 18u, {17u, 2u, 9u, 16u, 0u, 11u, 5u}));
+  run(run_case("parallel, 10 of 10 qubits", parallel, 10u, {0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u}));
+  run(run_case("parallel, 8 of 12 qubits", parallel, 12u, {3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u}));
+  run(run_case("parallel, 9 of 12 qubits, scattered", parallel, 12u, {11u, 0u, 6u, 3u, 10u, 1u, 8u, 5u, 9u}));
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "swapped Fourier transform tests passed\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,271 @@
+// Tests ket::utility::policy::parallel without OpenMP, which runs on ket::utility::thread_pool
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+#endif // __linux__
+
+#undef KET_USE_OPENMP
+#include <ket/utility/loop_n.hpp>
+#include <ket/utility/parallel/loop_n.hpp>
+
+namespace
+{
+  auto check(bool const condition, std::string const& message, bool& failed) -> void
+  {
+    if (condition)
+      return;
+
+    std::cerr << "failed: " << message << '\n';
+    failed = true;
+  }
+
+  // ket::utility::policy::parallel uses at most std::thread::hardware_concurrency() threads
+  auto test_loop_n(int const max_num_threads, bool& failed) -> void
+  {
+    auto const parallel_policy = ket::utility::policy::make_parallel(max_num_threads);
+    auto const num_threads = static_cast<int>(ket::utility::num_threads(parallel_policy));
+
+    for (auto const n: {0, 1, 3, 17, 1000})
+      for (auto repetition = 0; repetition < 10; ++repetition)
+      {
+        auto counts = std::vector<int>(n);
+        auto thread_indices = std::vector<int>(n, -1);
+        ket::utility::loop_n(
+          parallel_policy, n,
+          [&counts, &thread_indices](int const count, int const thread_index)
+          { ++counts[count]; thread_indices[count] = thread_index; });
+
+        check(
+          std::all_of(counts.begin(), counts.end(), [](int const count) { return count == 1; }),
+          "loop_n with " + std::to_string(num_threads) + " threads visits each count once", failed);
+        check(
+          std::is_sorted(thread_indices.begin(), thread_indices.end())
+            and std::all_of(
+                  thread_indices.begin(), thread_indices.end(),
+                  [num_threads](int const thread_index) { return thread_index >= 0 and thread_index < num_threads; }),
+          "loop_n with " + std::to_string(num_threads) + " threads partitions counts contiguously", failed);
+      }
+  }
+
+  auto test_execute(int const max_num_threads, bool& failed) -> void
+  {
+    auto const parallel_policy = ket::utility::policy::make_parallel(max_num_threads);
+    auto const num_threads = static_cast<int>(ket::utility::num_threads(parallel_policy));
+    constexpr auto num_phases = 100;
+
+    auto values = std::vector<int>(num_threads);
+    std::atomic<int> num_single_calls{0};
+    std::atomic<bool> is_consistent{true};
+
+    ket::utility::execute(
+      parallel_policy,
+      [&](int const thread_index, auto& executor)
+      {
+        for (auto phase = 0; phase < num_phases; ++phase)
+        {
+          values[thread_index] = phase;
+          ket::utility::barrier(parallel_policy, executor);
+
+          // every thread should see the values written in this phase
+          for (auto const value: values)
+            if (value != phase)
+              is_consistent = false;
+
+          ket::utility::single_execute(parallel_policy, executor, [&num_single_calls] { ++num_single_calls; });
+        }
+      });
+
+    check(is_consistent, "barrier with " + std::to_string(num_threads) + " threads", failed);
+    check(num_single_calls == num_phases, "single_execute with " + std::to_string(num_threads) + " threads", failed);
+  }
+
+  // uses the pool directly because the parallel policy may have only one thread on this machine
+  auto test_thread_pool(int const num_threads, bool& failed) -> void
+  {
+    constexpr auto num_phases = 100;
+    auto values = std::vector<int>(num_threads);
+    ket::utility::spin_barrier barrier{num_threads};
+    std::atomic<bool> is_consistent{true};
+
+    for (auto repetition = 0; repetition < 10; ++repetition)
+    {
+      auto thread_index_counts = std::vector<std::atomic<int>>(num_threads);
+      auto function
+        = [&](int const thread_index)
+          {
+            ++thread_index_counts[thread_index];
+            for (auto phase = 0; phase < num_phases; ++phase)
+            {
+              values[thread_index] = phase;
+              barrier.arrive_and_wait();
+
+              for (auto const value: values)
+                if (value != phase)
+                  is_consistent = false;
+              barrier.arrive_and_wait();
+            }
+          };
+
+      check(ket::utility::thread_pool::instance().try_run(num_threads, function), "thread_pool::try_run", failed);
+      check(
+        std::all_of(
+          thread_index_counts.begin(), thread_index_counts.end(),
+          [](std::atomic<int> const& count) { return count == 1; }),
+        "thread_pool with " + std::to_string(num_threads) + " threads calls function once for each thread index", failed);
+    }
+
+    check(is_consistent, "spin_barrier with " + std::to_string(num_threads) + " threads", failed);
+
+    // nested call is rejected
+    auto is_nested_call_rejected = true;
+    auto inner_function = [](int const) { };
+    auto outer_function
+      = [&is_nested_call_rejected, &inner_function](int const)
+        {
+          if (ket::utility::thread_pool::instance().try_run(2, inner_function))
+            is_nested_call_rejected = false;
+        };
+    ket::utility::thread_pool::instance().try_run(1, outer_function);
+    check(is_nested_call_rejected, "nested thread_pool::try_run", failed);
+  }
+
+  // threads with scoped pools run jobs at the same time, which would be rejected by the shared pool
+  auto test_scoped_thread_pool(bool& failed) -> void
+  {
+    auto& shared_pool = ket::utility::thread_pool::instance();
+    constexpr auto num_groups = 3;
+    ket::utility::spin_barrier barrier{num_groups * 2};
+    auto is_run = std::vector<int>(num_groups, 0);
+    auto is_shared_pool_used = std::vector<int>(num_groups, 1);
+
+    auto groups = std::vector<std::thread>{};
+    for (auto group_index = 0; group_index < num_groups; ++group_index)
+      groups.emplace_back(
+        [group_index, &shared_pool, &barrier, &is_run, &is_shared_pool_used]
+        {
+          ket::utility::scoped_thread_pool scoped_pool{static_cast<unsigned int>(group_index * 2)};
+          is_shared_pool_used[group_index] = &ket::utility::thread_pool::instance() == &shared_pool;
+
+          // every job waits for the others, so the jobs must be running simultaneously
+          auto function = [&barrier](int const) { barrier.arrive_and_wait(); };
+          is_run[group_index] = ket::utility::thread_pool::instance().try_run(2, function);
+        });
+    for (auto& group: groups)
+      group.join();
+
+    check(std::none_of(is_shared_pool_used.begin(), is_shared_pool_used.end(), [](int const value) { return value; }), "scoped_thread_pool is bound", failed);
+    check(std::all_of(is_run.begin(), is_run.end(), [](int const value) { return value; }), "concurrent jobs on scoped_thread_pool", failed);
+    check(&ket::utility::thread_pool::instance() == &shared_pool, "the shared pool is not replaced in other threads", failed);
+  }
+
+#ifdef __linux__
+  auto this_thread_affinity() -> cpu_set_t
+  {
+    auto result = cpu_set_t{};
+    CPU_ZERO(&result);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &result);
+    return result;
+  }
+
+  // the calling thread is pinned only if KET_PIN_POOL_THREADS is defined, and it runs on its CPUs again after the scoped pool
+  auto test_scoped_thread_pool_affinity(bool& failed) -> void
+  {
+    auto const affinity = this_thread_affinity();
+    {
+      ket::utility::scoped_thread_pool scoped_pool{1u};
+      auto function = [](int const) { };
+      ket::utility::thread_pool::instance().try_run(2, function);
+
+      auto const scoped_affinity = this_thread_affinity();
+# ifdef KET_PIN_POOL_THREADS
+      check(CPU_COUNT(&affinity) <= 1 or CPU_COUNT(&scoped_affinity) == 1, "the calling thread is pinned", failed);
+# else // KET_PIN_POOL_THREADS
+      check(CPU_EQUAL(&scoped_affinity, &affinity), "the calling thread is not pinned", failed);
+# endif // KET_PIN_POOL_THREADS
+    }
+    auto const restored_affinity = this_thread_affinity();
+    check(CPU_EQUAL(&restored_affinity, &affinity), "the affinity of the calling thread is restored", failed);
+  }
+#endif // __linux__
+
+  auto test_nested_loop_n(bool& failed) -> void
+  {
+    auto const parallel_policy = ket::utility::policy::make_parallel(3);
+
+    auto sums = std::vector<std::atomic<int>>(4);
+    ket::utility::loop_n(
+      parallel_policy, 4,
+      [parallel_policy, &sums](int const outer_count, int const)
+      {
+        ket::utility::loop_n(
+          parallel_policy, 10,
+          [outer_count, &sums](int const inner_count, int const) { sums[outer_count] += inner_count; });
+      });
+
+    check(
+      std::all_of(sums.begin(), sums.end(), [](std::atomic<int> const& sum) { return sum == 45; }),
+      "nested loop_n", failed);
+  }
+
+  auto test_exception(bool& failed) -> void
+  {
+    auto const parallel_policy = ket::utility::policy::make_parallel(4);
+
+    auto is_caught = false;
+    try
+    {
+      ket::utility::loop_n(
+        parallel_policy, 100,
+        [](int const count, int const)
+        {
+          if (count == 10)
+            throw std::runtime_error{"error in loop_n"};
+        });
+    }
+    catch (std::runtime_error const&)
+    {
+      is_caught = true;
+    }
+    check(is_caught, "exception thrown in loop_n", failed);
+
+    // the pool should be still usable
+    std::atomic<int> sum{0};
+    ket::utility::loop_n(parallel_policy, 100, [&sum](int const count, int const) { sum += count; });
+    check(sum == 4950, "loop_n after exception", failed);
+  }
+}
+
+int main()
+{
+  auto failed = false;
+
+  for (auto const num_threads: {1, 2, 3, 4, 8})
+  {
+    test_loop_n(num_threads, failed);
+    test_execute(num_threads, failed);
+  }
+  for (auto const num_threads: {2, 3, 4, 8})
+    test_thread_pool(num_threads, failed);
+  test_scoped_thread_pool(failed);
+#ifdef __linux__
+  test_scoped_thread_pool_affinity(failed);
+#endif // __linux__
+  test_nested_loop_n(failed);
+  test_exception(failed);
+
+  if (failed)
+    return EXIT_FAILURE;
+
+  std::cout << "thread pool tests passed\n";
+  return EXIT_SUCCESS;
+}